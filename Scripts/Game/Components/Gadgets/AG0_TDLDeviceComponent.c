@@ -893,6 +893,10 @@ class AG0_TDLDeviceComponent : ScriptGameComponent
         if (!Replication.IsServer()) return;
         m_bIsPowered = powered;
         Replication.BumpMe();
+        
+        AG0_TDLSystem system = AG0_TDLSystem.GetInstance();
+        if (system)
+            system.OnDeviceStateChanged(this);
     }
 	
 	bool IsInNetwork() { return m_iCurrentNetworkID > 0; }
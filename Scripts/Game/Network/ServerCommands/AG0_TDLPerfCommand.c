@@ -0,0 +1,116 @@
+//------------------------------------------------------------------------------------------------
+// AG0_TDLPerfCommand.c
+// Admin server command for TDL performance telemetry: #tdlperf [reset|gzip]
+//------------------------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------------------------
+// TDL Perf Server Command
+//------------------------------------------------------------------------------------------------
+class AG0_TDLPerfCommand : ScrServerCommand
+{
+	//------------------------------------------------------------------------------------------------
+	override string GetKeyword()
+	{
+		return "tdlperf";
+	}
+
+	//------------------------------------------------------------------------------------------------
+	override bool IsServerSide()
+	{
+		return true;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	override int RequiredRCONPermission()
+	{
+		return ERCONPermissions.PERMISSIONS_ADMIN;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	override int RequiredChatPermission()
+	{
+		return EPlayerRole.ADMINISTRATOR;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	override ref ScrServerCmdResult OnChatServerExecution(array<string> argv, int playerId)
+	{
+		return HandleCommand(argv);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	override ref ScrServerCmdResult OnChatClientExecution(array<string> argv, int playerId)
+	{
+		return ScrServerCmdResult(string.Empty, EServerCmdResultType.OK);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	override ref ScrServerCmdResult OnRCONExecution(array<string> argv)
+	{
+		return HandleCommand(argv);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected ScrServerCmdResult HandleCommand(array<string> argv)
+	{
+		AG0_TDLSystem tdlSystem = AG0_TDLSystem.GetInstance();
+		if (!tdlSystem)
+			return ScrServerCmdResult("TDL system unavailable", EServerCmdResultType.ERR);
+
+		AG0_TDLProfiler profiler = tdlSystem.GetProfiler();
+
+		string sub;
+		if (argv.Count() > 1)
+		{
+			sub = argv[1];
+			sub.ToLower();
+		}
+
+		if (sub == "help")
+			return ScrServerCmdResult("TDL Perf Commands:\n#tdlperf - Stage timings and RPC counters\n#tdlperf reset - Clear collected data\n#tdlperf gzip - Benchmark gunzip on the packed terrain payloads (blocks the server)", EServerCmdResultType.OK);
+
+		if (sub == "reset")
+		{
+			profiler.Reset();
+			Print("[TDL_PERF] Profiler reset", LogLevel.NORMAL);
+			return ScrServerCmdResult("TDL perf data reset", EServerCmdResultType.OK);
+		}
+
+		if (sub == "gzip")
+			return BenchmarkTerrainGunzip(tdlSystem);
+
+		if (!sub.IsEmpty())
+			return ScrServerCmdResult("Usage: #tdlperf [reset|gzip|help]", EServerCmdResultType.PARAMETERS);
+
+		string report = profiler.FormatReport(tdlSystem.GetScheduleLag(), tdlSystem.GetScheduledJobCount(), tdlSystem.GetCoalescedJobCount());
+		return ScrServerCmdResult(report, EServerCmdResultType.OK);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! AG0_TDLGzip.Benchmark on the packed (base64 gzip) terrain datasets the server distributes
+	protected ScrServerCmdResult BenchmarkTerrainGunzip(AG0_TDLSystem tdlSystem)
+	{
+		AG0_TDLApiManager apiManager = tdlSystem.GetApiManager();
+		if (!apiManager)
+			return ScrServerCmdResult("TDL API manager unavailable", EServerCmdResultType.ERR);
+
+		string report;
+		AG0_TDLTerrainStructureManager structures = apiManager.GetTerrainStructureManager();
+		if (structures && !structures.GetPackedPayload().IsEmpty())
+			report += AG0_TDLGzip.Benchmark(AG0_Base64.Decode(structures.GetPackedPayload()), "terrain structures") + "\n";
+
+		AG0_TDLTerrainRoadManager roads = apiManager.GetTerrainRoadManager();
+		if (roads && !roads.GetPackedPayload().IsEmpty())
+			report += AG0_TDLGzip.Benchmark(AG0_Base64.Decode(roads.GetPackedPayload()), "terrain roads") + "\n";
+
+		if (report.IsEmpty())
+			return ScrServerCmdResult("No packed terrain payloads loaded", EServerCmdResultType.ERR);
+		return ScrServerCmdResult(report, EServerCmdResultType.OK);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	override ref ScrServerCmdResult OnUpdate()
+	{
+		return ScrServerCmdResult(string.Empty, EServerCmdResultType.OK);
+	}
+}
@@ -23,6 +23,11 @@ modded class SCR_PlayerController
     // Replicated state from server
     protected ref array<int> m_aTDLConnectedPlayerIDs = {};
     protected ref map<int, ref AG0_TDLNetworkMembers> m_mTDLNetworkMembersMap = new map<int, ref AG0_TDLNetworkMembers>();
+    // Last reliable member keyframe per network, the base every member delta applies to
+    protected ref map<int, ref array<ref AG0_TDLNetworkMember>> m_mTDLMemberBaselines = new map<int, ref array<ref AG0_TDLNetworkMember>>();
+    protected ref map<int, int> m_mTDLMemberKeyframeIds = new map<int, int>();
+    protected ref map<int, int> m_mTDLMemberDeltaSeqs = new map<int, int>();
+    protected ref map<int, int> m_mTDLPositionSeqs = new map<int, int>();
     protected ref array<RplId> m_NetworkBroadcastingSources = {};
     protected ref set<RplId> m_AvailableVideoSourcesSet = new set<RplId>();
     
@@ -48,8 +53,11 @@ modded class SCR_PlayerController
 	protected string m_sTerrainStructureBufferedHash;    // Hash of in-flight chunks
 	protected int m_iTerrainStructureExpectedChunks;     // 0 = no transfer in progress
 	protected int m_iTerrainStructureReceivedChunks;
+	protected int m_iTerrainStructureContiguousChunks;  // Received prefix, acked to the server
 	protected ref array<string> m_aTerrainStructureChunkBuffer;
 	protected ref array<bool> m_aTerrainStructureChunkReceived;
+	protected ref AG0_TDLTerrainCodecJob m_TerrainStructureDecodeJob;  // Packed payload being decoded
+	protected bool m_bTerrainStructureDecodeFromCache;                 // ...read from AG0_TDLTerrainCache
 
 	// TDL terrain roads (road network streamed from /api/mod/terrain/roads)
 	// Same chunked-RPC reassembly pattern as structures.
@@ -58,8 +66,16 @@ modded class SCR_PlayerController
 	protected string m_sTerrainRoadBufferedHash;
 	protected int m_iTerrainRoadExpectedChunks;
 	protected int m_iTerrainRoadReceivedChunks;
+	protected int m_iTerrainRoadContiguousChunks;
 	protected ref array<string> m_aTerrainRoadChunkBuffer;
 	protected ref array<bool> m_aTerrainRoadChunkReceived;
+	protected ref AG0_TDLTerrainCodecJob m_TerrainRoadDecodeJob;
+	protected bool m_bTerrainRoadDecodeFromCache;
+
+	// Per-frame budget for decoding packed (base64 + gzip) terrain payloads
+	protected static const int TERRAIN_DECODE_BUDGET_MS = 4;
+	// Ack the received chunk prefix every N chunks (must stay below AG0_TDLTerrainTransfer.WINDOW)
+	protected static const int TERRAIN_ACK_EVERY = 4;
 	
 	// ============================================
 	// EUD SCREEN ADJUSTMENT
@@ -68,8 +84,8 @@ modded class SCR_PlayerController
 	protected TDL_EUDBoneComponent m_CachedEUDBoneComp;
 	protected const float EUD_ADJUST_STEP = 0.1;
 	
-	// Message storage per network
-    protected ref map<int, ref AG0_TDLMessageStore> m_mNetworkMessages = new map<int, ref AG0_TDLMessageStore>();
+	// Message storage per network, then per viewer device (one delta stream each, see AG0_TDLMessageSyncCursor)
+    protected ref map<int, ref map<RplId, ref AG0_TDLMessageStore>> m_mNetworkMessages = new map<int, ref map<RplId, ref AG0_TDLMessageStore>>();
     
     // Local tracking of read messages (client-side)
     protected ref set<int> m_LocallyReadMessages = new set<int>();
@@ -451,24 +467,46 @@ modded class SCR_PlayerController
     {
         Print("Recieved connected players on controller, role is server: ", Replication.IsServer());
         Rpc(RPC_SetTDLConnectedPlayers, connectedPlayerIDs);
+        AG0_TDLProfiler.RecordRpc(AG0_ETDLRpcType.CONNECTED_PLAYERS, 4 + connectedPlayerIDs.Count() * 4);
+    }
+    
+    //------------------------------------------------------------------------------------------------
+    void NotifyNetworkMembersKeyframe(int networkId, int keyframeId, array<ref AG0_TDLNetworkMember> members)
+    {
+        Rpc(RPC_SetTDLNetworkMembers, networkId, keyframeId, members);
+        AG0_TDLProfiler.RecordRpc(AG0_ETDLRpcType.MEMBER_KEYFRAME, 12 + members.Count() * AG0_TDLNetworkMember.DATA_SIZE);
     }
     
     //------------------------------------------------------------------------------------------------
-    void NotifyNetworkMembers(int networkId, array<ref AG0_TDLNetworkMember> members)
+    void NotifyNetworkMembersDelta(int networkId, int keyframeId, int seq, array<int> ops, array<string> names)
     {
-        Rpc(RPC_SetTDLNetworkMembers, networkId, members);
+        Rpc(RPC_UpdateTDLNetworkMembers, networkId, keyframeId, seq, ops, names);
+        
+        int bytes = 20 + ops.Count() * 4;
+        foreach (string name : names)
+            bytes += 4 + name.Length();
+        AG0_TDLProfiler.RecordRpc(AG0_ETDLRpcType.MEMBER_DELTA, bytes);
+    }
+    
+    //------------------------------------------------------------------------------------------------
+    void NotifyMemberPositions(int networkId, int seq, array<int> samples)
+    {
+        Rpc(RPC_UpdateTDLMemberPositions, networkId, seq, samples);
+        AG0_TDLProfiler.RecordRpc(AG0_ETDLRpcType.MEMBER_POSITIONS, 12 + samples.Count() * 4);
     }
     
     //------------------------------------------------------------------------------------------------
     void NotifyClearNetwork(int networkId)
     {
         Rpc(RPC_ClearTDLNetwork, networkId);
+        AG0_TDLProfiler.RecordRpc(AG0_ETDLRpcType.CLEAR_NETWORK, 4);
     }
 
     //------------------------------------------------------------------------------------------------
     void NotifyBroadcastingSources(array<RplId> broadcastingSources)
     {
         Rpc(RPC_SetNetworkBroadcastingSources, broadcastingSources);
+        AG0_TDLProfiler.RecordRpc(AG0_ETDLRpcType.BROADCAST_SOURCES, 4 + broadcastingSources.Count() * 4);
     }
     
     // ============================================
@@ -757,20 +795,105 @@ modded class SCR_PlayerController
     
     //------------------------------------------------------------------------------------------------
     [RplRpc(RplChannel.Reliable, RplRcver.Owner)]
-    protected void RPC_SetTDLNetworkMembers(int networkId, array<ref AG0_TDLNetworkMember> members)
+    protected void RPC_SetTDLNetworkMembers(int networkId, int keyframeId, array<ref AG0_TDLNetworkMember> members)
+    {
+        SetTDLNetworkMembers(networkId, members);
+        
+        // Keyframe ID 0 is a one-off full list with no delta stream behind it
+        if (keyframeId == 0)
+        {
+            m_mTDLMemberBaselines.Remove(networkId);
+            m_mTDLMemberKeyframeIds.Remove(networkId);
+            m_mTDLMemberDeltaSeqs.Remove(networkId);
+            return;
+        }
+        
+        m_mTDLMemberBaselines.Set(networkId, members);
+        m_mTDLMemberKeyframeIds.Set(networkId, keyframeId);
+        m_mTDLMemberDeltaSeqs.Set(networkId, 0);
+    }
+    
+    //------------------------------------------------------------------------------------------------
+    //! Deltas are relative to the last keyframe, so a lost or reordered one costs nothing
+    [RplRpc(RplChannel.Unreliable, RplRcver.Owner)]
+    protected void RPC_UpdateTDLNetworkMembers(int networkId, int keyframeId, int seq, array<int> ops, array<string> names)
+    {
+        array<ref AG0_TDLNetworkMember> baseline = m_mTDLMemberBaselines.Get(networkId);
+        if (!baseline)
+        {
+            Rpc(RpcAsk_RequestTDLMemberKeyframe, networkId);
+            return;
+        }
+        
+        // Built on a keyframe we have not seen yet, or older than what we already show
+        if (keyframeId != m_mTDLMemberKeyframeIds.Get(networkId)) return;
+        if (seq <= m_mTDLMemberDeltaSeqs.Get(networkId)) return;
+        
+        array<ref AG0_TDLNetworkMember> members = {};
+        if (!AG0_TDLNetworkMember.ApplyDelta(baseline, ops, names, members))
+        {
+            Print(string.Format("TDL_PLAYERCONTROLLER: Malformed member delta for network %1, requesting keyframe", networkId), LogLevel.WARNING);
+            m_mTDLMemberBaselines.Remove(networkId);
+            Rpc(RpcAsk_RequestTDLMemberKeyframe, networkId);
+            return;
+        }
+        
+        m_mTDLMemberDeltaSeqs.Set(networkId, seq);
+        SetTDLNetworkMembers(networkId, members);
+    }
+    
+    //------------------------------------------------------------------------------------------------
+    //! Displayed members are copies: position samples update them in place, and the delta
+    //! baseline they were built from must stay untouched
+    protected void SetTDLNetworkMembers(int networkId, array<ref AG0_TDLNetworkMember> members)
     {
+        AG0_TDLNetworkMembers previous = m_mTDLNetworkMembersMap.Get(networkId);
+        float now = GetGame().GetWorld().GetWorldTime();
+        
         AG0_TDLNetworkMembers membersData = new AG0_TDLNetworkMembers();
         foreach (AG0_TDLNetworkMember member : members)
-            membersData.Add(member);
+        {
+            AG0_TDLNetworkMember copy = new AG0_TDLNetworkMember();
+            copy.CopyFrom(member);
+            if (previous)
+                copy.InheritMotion(previous.GetByRplId(member.GetRplId()), now);
+            membersData.Add(copy);
+        }
 
         m_mTDLNetworkMembersMap.Set(networkId, membersData);
     }
     
+    //------------------------------------------------------------------------------------------------
+    //! Fast-path positions between member list updates. Samples are absolute, so a lost one
+    //! only means extrapolating a little longer on the previous velocity.
+    [RplRpc(RplChannel.Unreliable, RplRcver.Owner)]
+    protected void RPC_UpdateTDLMemberPositions(int networkId, int seq, array<int> samples)
+    {
+        if (seq <= m_mTDLPositionSeqs.Get(networkId)) return;
+        m_mTDLPositionSeqs.Set(networkId, seq);
+        
+        AG0_TDLNetworkMembers members = m_mTDLNetworkMembersMap.Get(networkId);
+        if (!members) return;
+        
+        float now = GetGame().GetWorld().GetWorldTime();
+        int stride = AG0_TDLNetworkMember.POSITION_SAMPLE_INTS;
+        for (int i = 0; i + stride <= samples.Count(); i += stride)
+        {
+            AG0_TDLNetworkMember member = members.GetByRplId(samples[i]);
+            if (member)
+                member.ApplyPositionSample(samples[i + 1], samples[i + 2], samples[i + 3], now);
+        }
+    }
+    
     //------------------------------------------------------------------------------------------------
     [RplRpc(RplChannel.Reliable, RplRcver.Owner)]
     protected void RPC_ClearTDLNetwork(int networkId)
     {
         m_mTDLNetworkMembersMap.Remove(networkId);
+        m_mTDLMemberBaselines.Remove(networkId);
+        m_mTDLMemberKeyframeIds.Remove(networkId);
+        m_mTDLMemberDeltaSeqs.Remove(networkId);
+        m_mTDLPositionSeqs.Remove(networkId);
         //Print(string.Format("TDL_PLAYERCONTROLLER: Cleared network %1 data", networkId), LogLevel.DEBUG);
     }
 
@@ -1079,20 +1202,44 @@ modded class SCR_PlayerController
     }
     
     //------------------------------------------------------------------------------------------------
-    // SERVER -> CLIENT: Receive messages update
-    // Called by system when messages change (new message, delivery status change, etc.)
+    // SERVER -> CLIENT: Receive a message log delta
+    // Carries only messages this client has not been sent yet, plus packed status flips
+    // (AG0_TDLMessageClient.PackStatusUpdate) for ones it has. baseSeq 0 starts a fresh log.
     //------------------------------------------------------------------------------------------------
     [RplRpc(RplChannel.Reliable, RplRcver.Owner)]
-	void RpcDo_ReceiveTDLMessages(int networkId, array<ref AG0_TDLMessageClient> messages)
+	void RpcDo_ReceiveTDLMessageDelta(int networkId, RplId viewerRplId, int baseSeq, int seq,
+	                                  array<ref AG0_TDLMessageClient> newMessages, array<int> statusUpdates)
 	{
-	    if (!m_mNetworkMessages.Contains(networkId))
-	        m_mNetworkMessages.Set(networkId, new AG0_TDLMessageStore());
+	    map<RplId, ref AG0_TDLMessageStore> viewerStores = m_mNetworkMessages.Get(networkId);
+	    if (!viewerStores)
+	    {
+	        viewerStores = new map<RplId, ref AG0_TDLMessageStore>();
+	        m_mNetworkMessages.Set(networkId, viewerStores);
+	    }
 	    
-	    AG0_TDLMessageStore store = m_mNetworkMessages.Get(networkId);
+	    AG0_TDLMessageStore store = viewerStores.Get(viewerRplId);
+	    if (!store)
+	    {
+	        store = new AG0_TDLMessageStore();
+	        viewerStores.Set(viewerRplId, store);
+	    }
+	    
+	    if (baseSeq == 0)
+	    {
+	        store.Clear();
+	    }
+	    else if (baseSeq != store.GetSyncSeq())
+	    {
+	        // Missed a delta this one builds on — ask for the full log instead of guessing
+	        Print(string.Format("TDL_MESSAGE_CLIENT: Delta base %1 does not match local seq %2 for network %3, requesting resync",
+	            baseSeq, store.GetSyncSeq(), networkId), LogLevel.DEBUG);
+	        Rpc(RpcAsk_ResyncTDLMessages, networkId, viewerRplId);
+	        return;
+	    }
 	    
 	    array<int> newMessageIds = {};
 	    
-	    foreach (AG0_TDLMessageClient msg : messages)
+	    foreach (AG0_TDLMessageClient msg : newMessages)
 	    {
 	        if (!msg) continue;
 	        
@@ -1103,8 +1250,23 @@ modded class SCR_PlayerController
 	        store.AddOrUpdateMessage(msg);
 	    }
 	    
-	    Print(string.Format("TDL_MESSAGE_CLIENT: Received %1 messages for network %2 (%3 new)",
-	        messages.Count(), networkId, newMessageIds.Count()), LogLevel.DEBUG);
+	    array<int> readMessageIds = {};
+	    foreach (int packed : statusUpdates)
+	    {
+	        AG0_TDLMessageClient target = store.GetByMessageId(AG0_TDLMessageClient.UnpackStatusUpdateMessageId(packed));
+	        if (!target) continue;
+	        
+	        ETDLMessageStatus status = AG0_TDLMessageClient.UnpackStatusUpdateStatus(packed);
+	        if (status == ETDLMessageStatus.READ && target.status != ETDLMessageStatus.READ)
+	            readMessageIds.Insert(target.messageId);
+	        target.status = status;
+	    }
+	    
+	    store.SetSyncSeq(seq);
+	    Rpc(RpcAsk_AckTDLMessages, networkId, viewerRplId, seq);
+	    
+	    Print(string.Format("TDL_MESSAGE_CLIENT: Delta %1 for network %2: %3 new, %4 status updates",
+	        seq, networkId, newMessageIds.Count(), statusUpdates.Count()), LogLevel.DEBUG);
 	    
 	    m_OnMessagesUpdated.Invoke(networkId);
 	    
@@ -1112,29 +1274,47 @@ modded class SCR_PlayerController
 	    {
 	        m_OnNewMessageReceived.Invoke(networkId, newId);
 	    }
+	    
+	    foreach (int readId : readMessageIds)
+	    {
+	        m_OnReadReceiptReceived.Invoke(networkId, readId);
+	    }
 	}
     
     //------------------------------------------------------------------------------------------------
-    // SERVER -> CLIENT: Receive read receipt notification
+    // CLIENT -> SERVER: Acknowledge an applied message delta
     //------------------------------------------------------------------------------------------------
-    [RplRpc(RplChannel.Reliable, RplRcver.Owner)]
-    void RpcDo_ReceiveTDLReadReceipt(int networkId, int messageId, RplId readerRplId)
+    [RplRpc(RplChannel.Reliable, RplRcver.Server)]
+    protected void RpcAsk_AckTDLMessages(int networkId, RplId viewerRplId, int seq)
     {
-        if (!m_mNetworkMessages.Contains(networkId)) return;
+        AG0_TDLSystem system = AG0_TDLSystem.GetInstance();
+        if (!system) return;
         
-        AG0_TDLMessageStore store = m_mNetworkMessages.Get(networkId);
-        AG0_TDLMessageClient msg = store.GetByMessageId(messageId);
+        system.AckTDLMessageSync(GetPlayerId(), networkId, viewerRplId, seq);
+    }
+    
+    //------------------------------------------------------------------------------------------------
+    // CLIENT -> SERVER: Local message store is out of step, request the full log
+    //------------------------------------------------------------------------------------------------
+    [RplRpc(RplChannel.Reliable, RplRcver.Server)]
+    protected void RpcAsk_ResyncTDLMessages(int networkId, RplId viewerRplId)
+    {
+        AG0_TDLSystem system = AG0_TDLSystem.GetInstance();
+        if (!system) return;
         
-        if (msg)
-        {
-            msg.status = ETDLMessageStatus.READ;
-            
-            Print(string.Format("TDL_MESSAGE_CLIENT: Message %1 read by %2",
-                messageId, readerRplId), LogLevel.DEBUG);
-            
-            m_OnReadReceiptReceived.Invoke(networkId, messageId);
-            m_OnMessagesUpdated.Invoke(networkId);
-        }
+        system.ResyncTDLMessages(GetPlayerId(), networkId, viewerRplId);
+    }
+    
+    //------------------------------------------------------------------------------------------------
+    // CLIENT -> SERVER: No baseline for member deltas on this network, request a keyframe
+    //------------------------------------------------------------------------------------------------
+    [RplRpc(RplChannel.Reliable, RplRcver.Server)]
+    protected void RpcAsk_RequestTDLMemberKeyframe(int networkId)
+    {
+        AG0_TDLSystem system = AG0_TDLSystem.GetInstance();
+        if (!system) return;
+        
+        system.RequestNetworkMembersKeyframe(GetPlayerId(), networkId);
     }
 	
 	//------------------------------------------------------------------------------------------------
@@ -1169,6 +1349,7 @@ modded class SCR_PlayerController
 	void ReceiveTDLShapes(string packedShapes, string syncHash)
 	{
 		Rpc(RpcDo_ReceiveTDLShapes, packedShapes, syncHash);
+		AG0_TDLProfiler.RecordRpc(AG0_ETDLRpcType.SHAPES, 8 + packedShapes.Length() + syncHash.Length());
 	}
 
 	//------------------------------------------------------------------------------------------------
@@ -1176,13 +1357,22 @@ modded class SCR_PlayerController
 	//!
 	//! Reassembly contract:
 	//!   - All chunks of one dataset share a syncHash. A new syncHash invalidates
-	//!     any partially-received transfer (server is authoritative — it will
-	//!     re-send from chunk 0 if a delivery is interrupted).
+	//!     any partially-received transfer (server is authoritative).
+	//!   - The server streams chunks under a byte budget and a window ahead of our
+	//!     acks (RpcAsk_TDLTerrainChunkAck, the contiguous received prefix). If a
+	//!     delivery is interrupted it resumes from that prefix, not chunk 0, and a
+	//!     partial buffer for the same hash is kept until then.
 	//!   - We buffer per-index until iReceivedChunks == iExpectedChunks, then
 	//!     concatenate in order and parse once. The manager only sees a fully-
 	//!     assembled payload, so renderers reading mid-flight see consistent state.
 	//!   - Already-applied hash short-circuits (cheap fan-out repeats).
 	//!   - Empty assembled payload is a valid "clear local dataset" signal.
+	//!   - A packed payload (base64(gzip(binary)), see AG0_TDLTerrainPacked.c) is
+	//!     decoded a slice per frame before it reaches the manager; a payload
+	//!     starting with '{' is v1 JSON and is parsed immediately.
+	//!   - Transfers only happen when the terrain cache handshake misses (see
+	//!     RequestTDLTerrainCacheHash); applied payloads are stored in
+	//!     AG0_TDLTerrainCache for the next session.
 	[RplRpc(RplChannel.Reliable, RplRcver.Owner)]
 	protected void RpcDo_ReceiveTDLTerrainStructuresChunk(string syncHash, int totalChunks, int chunkIndex, string chunkData)
 	{
@@ -1204,6 +1394,7 @@ modded class SCR_PlayerController
 			m_sTerrainStructureBufferedHash = syncHash;
 			m_iTerrainStructureExpectedChunks = totalChunks;
 			m_iTerrainStructureReceivedChunks = 0;
+			m_iTerrainStructureContiguousChunks = 0;
 			m_aTerrainStructureChunkBuffer = new array<string>();
 			m_aTerrainStructureChunkBuffer.Resize(totalChunks);
 			m_aTerrainStructureChunkReceived = new array<bool>();
@@ -1222,6 +1413,19 @@ modded class SCR_PlayerController
 		}
 		m_aTerrainStructureChunkBuffer[chunkIndex] = chunkData;
 
+		// Advance the contiguous prefix and ack it every TERRAIN_ACK_EVERY chunks / at the end
+		int prevContiguous = m_iTerrainStructureContiguousChunks;
+		while (m_iTerrainStructureContiguousChunks < m_iTerrainStructureExpectedChunks
+			&& m_aTerrainStructureChunkReceived[m_iTerrainStructureContiguousChunks])
+		{
+			m_iTerrainStructureContiguousChunks = m_iTerrainStructureContiguousChunks + 1;
+		}
+		if (prevContiguous / TERRAIN_ACK_EVERY != m_iTerrainStructureContiguousChunks / TERRAIN_ACK_EVERY
+			|| (m_iTerrainStructureContiguousChunks == m_iTerrainStructureExpectedChunks && prevContiguous != m_iTerrainStructureContiguousChunks))
+		{
+			Rpc(RpcAsk_TDLTerrainChunkAck, AG0_ETDLTerrainDataset.STRUCTURES, syncHash, m_iTerrainStructureContiguousChunks);
+		}
+
 		// All chunks accounted for → reassemble and commit.
 		if (m_iTerrainStructureReceivedChunks == m_iTerrainStructureExpectedChunks)
 		{
@@ -1231,23 +1435,9 @@ modded class SCR_PlayerController
 				fullPayload = fullPayload + m_aTerrainStructureChunkBuffer[i];
 			}
 
-			// Commit the new hash before parse so any error path still updates state.
-			m_sTerrainStructureSyncHash = syncHash;
-
-			if (!m_TDLTerrainStructureManager)
-				m_TDLTerrainStructureManager = new AG0_TDLTerrainStructureManager();
-
-			if (fullPayload.IsEmpty())
-			{
-				m_TDLTerrainStructureManager.Clear();
-				Print("[TDL_STRUCTURES_CLIENT] Cleared (empty payload)", LogLevel.DEBUG);
-			}
-			else
-			{
-				int count = m_TDLTerrainStructureManager.ParseColumnarPayload(fullPayload);
-				Print(string.Format("[TDL_STRUCTURES_CLIENT] Reassembled %1 chunks → %2 structures (hash: %3)",
-					m_iTerrainStructureExpectedChunks, count, syncHash), LogLevel.DEBUG);
-			}
+			Print(string.Format("[TDL_STRUCTURES_CLIENT] Reassembled %1 chunks (%2 chars, hash: %3)",
+				m_iTerrainStructureExpectedChunks, fullPayload.Length(), syncHash), LogLevel.DEBUG);
+			ApplyTerrainStructuresPayload(fullPayload, syncHash, false);
 
 			// Free reassembly buffer; ready for the next transfer.
 			m_aTerrainStructureChunkBuffer = null;
@@ -1255,7 +1445,89 @@ modded class SCR_PlayerController
 			m_sTerrainStructureBufferedHash = string.Empty;
 			m_iTerrainStructureExpectedChunks = 0;
 			m_iTerrainStructureReceivedChunks = 0;
+			m_iTerrainStructureContiguousChunks = 0;
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Commit a complete structures payload (reassembled from RPC chunks, or read
+	//! back from AG0_TDLTerrainCache). Transferred payloads are cached once they
+	//! have parsed successfully.
+	protected void ApplyTerrainStructuresPayload(string payload, string syncHash, bool fromCache)
+	{
+		// Commit the new hash before parse so any error path still updates state.
+		m_sTerrainStructureSyncHash = syncHash;
+
+		if (!m_TDLTerrainStructureManager)
+			m_TDLTerrainStructureManager = new AG0_TDLTerrainStructureManager();
+
+		// A newer dataset supersedes any decode still in progress
+		m_TerrainStructureDecodeJob = null;
+
+		if (payload.IsEmpty())
+		{
+			m_TDLTerrainStructureManager.Clear();
+			AG0_TDLTerrainCache.Delete(AG0_ETDLTerrainDataset.STRUCTURES);
+			Print("[TDL_STRUCTURES_CLIENT] Cleared (empty payload)", LogLevel.DEBUG);
+		}
+		else if (AG0_TDLTerrainPacked.IsPacked(payload))
+		{
+			// The previous dataset stays visible until the decode lands
+			m_TerrainStructureDecodeJob = new AG0_TDLTerrainCodecJob();
+			m_TerrainStructureDecodeJob.InitDecode(payload, m_TDLTerrainStructureManager.CreatePackedReader());
+			m_bTerrainStructureDecodeFromCache = fromCache;
+			GetGame().GetCallqueue().Remove(StepTerrainStructureDecode);
+			GetGame().GetCallqueue().CallLater(StepTerrainStructureDecode, 0, false);
+		}
+		else
+		{
+			int count = m_TDLTerrainStructureManager.ParseColumnarPayload(payload);
+			if (!fromCache && m_TDLTerrainStructureManager.GetLastSyncHash() == syncHash)
+				AG0_TDLTerrainCache.Write(AG0_ETDLTerrainDataset.STRUCTURES, syncHash, payload);
+			Print(string.Format("[TDL_STRUCTURES_CLIENT] Parsed %1 structures (hash: %2)",
+				count, syncHash), LogLevel.DEBUG);
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! One frame of packed terrain structures decoding. Re-schedules itself until
+	//! base64, gunzip and the parse into the manager are done.
+	protected void StepTerrainStructureDecode()
+	{
+		if (!m_TerrainStructureDecodeJob)
+			return;
+
+		if (m_TerrainStructureDecodeJob.Step(TERRAIN_DECODE_BUDGET_MS))
+		{
+			GetGame().GetCallqueue().CallLater(StepTerrainStructureDecode, 0, false);
+			return;
 		}
+
+		AG0_TDLTerrainCodecJob job = m_TerrainStructureDecodeJob;
+		m_TerrainStructureDecodeJob = null;
+
+		int count = job.GetPass().GetCount();
+
+		// Failed decode → forget the hash so the next push of this version is applied;
+		// a bad cache file is dropped and the server asked for a full transfer
+		if (m_TDLTerrainStructureManager.GetLastSyncHash() != m_sTerrainStructureSyncHash)
+		{
+			Print(string.Format("[TDL_STRUCTURES_CLIENT] Packed payload failed to decode (hash: %1, cached: %2)",
+				m_sTerrainStructureSyncHash, m_bTerrainStructureDecodeFromCache), LogLevel.WARNING);
+			m_sTerrainStructureSyncHash = string.Empty;
+			if (m_bTerrainStructureDecodeFromCache)
+			{
+				AG0_TDLTerrainCache.Delete(AG0_ETDLTerrainDataset.STRUCTURES);
+				SendTerrainCacheHash(AG0_ETDLTerrainDataset.STRUCTURES, string.Empty);
+			}
+			return;
+		}
+
+		if (!m_bTerrainStructureDecodeFromCache)
+			AG0_TDLTerrainCache.Write(AG0_ETDLTerrainDataset.STRUCTURES, m_sTerrainStructureSyncHash, job.GetPacked());
+
+		Print(string.Format("[TDL_STRUCTURES_CLIENT] Decoded %1 structures (hash: %2, cached: %3)",
+			count, m_sTerrainStructureSyncHash, m_bTerrainStructureDecodeFromCache), LogLevel.DEBUG);
 	}
 
 	//------------------------------------------------------------------------------------------------
@@ -1271,6 +1543,7 @@ modded class SCR_PlayerController
 	void ReceiveTDLTerrainStructuresChunk(string syncHash, int totalChunks, int chunkIndex, string chunkData)
 	{
 		Rpc(RpcDo_ReceiveTDLTerrainStructuresChunk, syncHash, totalChunks, chunkIndex, chunkData);
+		AG0_TDLProfiler.RecordRpc(AG0_ETDLRpcType.TERRAIN_STRUCTURES, 16 + syncHash.Length() + chunkData.Length());
 	}
 
 	//------------------------------------------------------------------------------------------------
@@ -1293,6 +1566,7 @@ modded class SCR_PlayerController
 			m_sTerrainRoadBufferedHash = syncHash;
 			m_iTerrainRoadExpectedChunks = totalChunks;
 			m_iTerrainRoadReceivedChunks = 0;
+			m_iTerrainRoadContiguousChunks = 0;
 			m_aTerrainRoadChunkBuffer = new array<string>();
 			m_aTerrainRoadChunkBuffer.Resize(totalChunks);
 			m_aTerrainRoadChunkReceived = new array<bool>();
@@ -1309,6 +1583,18 @@ modded class SCR_PlayerController
 		}
 		m_aTerrainRoadChunkBuffer[chunkIndex] = chunkData;
 
+		int prevContiguous = m_iTerrainRoadContiguousChunks;
+		while (m_iTerrainRoadContiguousChunks < m_iTerrainRoadExpectedChunks
+			&& m_aTerrainRoadChunkReceived[m_iTerrainRoadContiguousChunks])
+		{
+			m_iTerrainRoadContiguousChunks = m_iTerrainRoadContiguousChunks + 1;
+		}
+		if (prevContiguous / TERRAIN_ACK_EVERY != m_iTerrainRoadContiguousChunks / TERRAIN_ACK_EVERY
+			|| (m_iTerrainRoadContiguousChunks == m_iTerrainRoadExpectedChunks && prevContiguous != m_iTerrainRoadContiguousChunks))
+		{
+			Rpc(RpcAsk_TDLTerrainChunkAck, AG0_ETDLTerrainDataset.ROADS, syncHash, m_iTerrainRoadContiguousChunks);
+		}
+
 		if (m_iTerrainRoadReceivedChunks == m_iTerrainRoadExpectedChunks)
 		{
 			string fullPayload = string.Empty;
@@ -1317,29 +1603,90 @@ modded class SCR_PlayerController
 				fullPayload = fullPayload + m_aTerrainRoadChunkBuffer[i];
 			}
 
-			m_sTerrainRoadSyncHash = syncHash;
-
-			if (!m_TDLTerrainRoadManager)
-				m_TDLTerrainRoadManager = new AG0_TDLTerrainRoadManager();
-
-			if (fullPayload.IsEmpty())
-			{
-				m_TDLTerrainRoadManager.Clear();
-				Print("[TDL_ROADS_CLIENT] Cleared (empty payload)", LogLevel.DEBUG);
-			}
-			else
-			{
-				int count = m_TDLTerrainRoadManager.ParseColumnarPayload(fullPayload);
-				Print(string.Format("[TDL_ROADS_CLIENT] Reassembled %1 chunks → %2 features (hash: %3)",
-					m_iTerrainRoadExpectedChunks, count, syncHash), LogLevel.DEBUG);
-			}
+			Print(string.Format("[TDL_ROADS_CLIENT] Reassembled %1 chunks (%2 chars, hash: %3)",
+				m_iTerrainRoadExpectedChunks, fullPayload.Length(), syncHash), LogLevel.DEBUG);
+			ApplyTerrainRoadsPayload(fullPayload, syncHash, false);
 
 			m_aTerrainRoadChunkBuffer = null;
 			m_aTerrainRoadChunkReceived = null;
 			m_sTerrainRoadBufferedHash = string.Empty;
 			m_iTerrainRoadExpectedChunks = 0;
 			m_iTerrainRoadReceivedChunks = 0;
+			m_iTerrainRoadContiguousChunks = 0;
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Roads counterpart of ApplyTerrainStructuresPayload.
+	protected void ApplyTerrainRoadsPayload(string payload, string syncHash, bool fromCache)
+	{
+		m_sTerrainRoadSyncHash = syncHash;
+
+		if (!m_TDLTerrainRoadManager)
+			m_TDLTerrainRoadManager = new AG0_TDLTerrainRoadManager();
+
+		m_TerrainRoadDecodeJob = null;
+
+		if (payload.IsEmpty())
+		{
+			m_TDLTerrainRoadManager.Clear();
+			AG0_TDLTerrainCache.Delete(AG0_ETDLTerrainDataset.ROADS);
+			Print("[TDL_ROADS_CLIENT] Cleared (empty payload)", LogLevel.DEBUG);
+		}
+		else if (AG0_TDLTerrainPacked.IsPacked(payload))
+		{
+			m_TerrainRoadDecodeJob = new AG0_TDLTerrainCodecJob();
+			m_TerrainRoadDecodeJob.InitDecode(payload, m_TDLTerrainRoadManager.CreatePackedReader(true));
+			m_bTerrainRoadDecodeFromCache = fromCache;
+			GetGame().GetCallqueue().Remove(StepTerrainRoadDecode);
+			GetGame().GetCallqueue().CallLater(StepTerrainRoadDecode, 0, false);
 		}
+		else
+		{
+			int count = m_TDLTerrainRoadManager.ParseColumnarPayload(payload);
+			if (!fromCache && m_TDLTerrainRoadManager.GetLastSyncHash() == syncHash)
+				AG0_TDLTerrainCache.Write(AG0_ETDLTerrainDataset.ROADS, syncHash, payload);
+			Print(string.Format("[TDL_ROADS_CLIENT] Parsed %1 features (hash: %2)",
+				count, syncHash), LogLevel.DEBUG);
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Roads counterpart of StepTerrainStructureDecode.
+	protected void StepTerrainRoadDecode()
+	{
+		if (!m_TerrainRoadDecodeJob)
+			return;
+
+		if (m_TerrainRoadDecodeJob.Step(TERRAIN_DECODE_BUDGET_MS))
+		{
+			GetGame().GetCallqueue().CallLater(StepTerrainRoadDecode, 0, false);
+			return;
+		}
+
+		AG0_TDLTerrainCodecJob job = m_TerrainRoadDecodeJob;
+		m_TerrainRoadDecodeJob = null;
+
+		int count = job.GetPass().GetCount();
+
+		if (m_TDLTerrainRoadManager.GetLastSyncHash() != m_sTerrainRoadSyncHash)
+		{
+			Print(string.Format("[TDL_ROADS_CLIENT] Packed payload failed to decode (hash: %1, cached: %2)",
+				m_sTerrainRoadSyncHash, m_bTerrainRoadDecodeFromCache), LogLevel.WARNING);
+			m_sTerrainRoadSyncHash = string.Empty;
+			if (m_bTerrainRoadDecodeFromCache)
+			{
+				AG0_TDLTerrainCache.Delete(AG0_ETDLTerrainDataset.ROADS);
+				SendTerrainCacheHash(AG0_ETDLTerrainDataset.ROADS, string.Empty);
+			}
+			return;
+		}
+
+		if (!m_bTerrainRoadDecodeFromCache)
+			AG0_TDLTerrainCache.Write(AG0_ETDLTerrainDataset.ROADS, m_sTerrainRoadSyncHash, job.GetPacked());
+
+		Print(string.Format("[TDL_ROADS_CLIENT] Decoded %1 features (hash: %2, cached: %3)",
+			count, m_sTerrainRoadSyncHash, m_bTerrainRoadDecodeFromCache), LogLevel.DEBUG);
 	}
 
 	AG0_TDLTerrainRoadManager GetTDLTerrainRoadManager()
@@ -1350,37 +1697,149 @@ modded class SCR_PlayerController
 	void ReceiveTDLTerrainRoadsChunk(string syncHash, int totalChunks, int chunkIndex, string chunkData)
 	{
 		Rpc(RpcDo_ReceiveTDLTerrainRoadsChunk, syncHash, totalChunks, chunkIndex, chunkData);
+		AG0_TDLProfiler.RecordRpc(AG0_ETDLRpcType.TERRAIN_ROADS, 16 + syncHash.Length() + chunkData.Length());
+	}
+
+	//------------------------------------------------------------------------------------------------
+	// Terrain cache handshake
+	//   server → RequestTDLTerrainCacheHash(dataset)
+	//   client → RpcAsk_TDLTerrainCacheHash(dataset, hash it holds, in memory or on disk,
+	//            plus the hash / received prefix of any partial transfer)
+	//   server → UseCachedTDLTerrain(dataset, hash) on a match, chunked transfer otherwise
+	//            (resumed from the received prefix when the partial hash is current)
+	//------------------------------------------------------------------------------------------------
+
+	//------------------------------------------------------------------------------------------------
+	//! Server → Client: ask which version of a terrain dataset the client already has.
+	void RequestTDLTerrainCacheHash(AG0_ETDLTerrainDataset dataset)
+	{
+		Rpc(RpcDo_RequestTDLTerrainCacheHash, dataset);
+		AG0_TDLProfiler.RecordRpc(TerrainRpcType(dataset), 4);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	[RplRpc(RplChannel.Reliable, RplRcver.Owner)]
+	protected void RpcDo_RequestTDLTerrainCacheHash(AG0_ETDLTerrainDataset dataset)
+	{
+		string hash;
+		if (dataset == AG0_ETDLTerrainDataset.STRUCTURES)
+			hash = m_sTerrainStructureSyncHash;
+		else
+			hash = m_sTerrainRoadSyncHash;
+
+		if (hash.IsEmpty())
+			hash = AG0_TDLTerrainCache.ReadHash(dataset);
+
+		SendTerrainCacheHash(dataset, hash);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Reply to the handshake with the hash we hold plus any partial transfer, so the
+	//! server can resume that transfer instead of starting it over.
+	protected void SendTerrainCacheHash(AG0_ETDLTerrainDataset dataset, string hash)
+	{
+		if (dataset == AG0_ETDLTerrainDataset.STRUCTURES)
+			Rpc(RpcAsk_TDLTerrainCacheHash, dataset, hash, m_sTerrainStructureBufferedHash, m_iTerrainStructureContiguousChunks);
+		else
+			Rpc(RpcAsk_TDLTerrainCacheHash, dataset, hash, m_sTerrainRoadBufferedHash, m_iTerrainRoadContiguousChunks);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	[RplRpc(RplChannel.Reliable, RplRcver.Server)]
+	protected void RpcAsk_TDLTerrainCacheHash(AG0_ETDLTerrainDataset dataset, string hash, string bufferedHash, int bufferedChunks)
+	{
+		AG0_TDLSystem system = AG0_TDLSystem.GetInstance();
+		if (!system)
+			return;
+
+		system.OnClientTerrainCacheHash(this, dataset, hash, bufferedHash, bufferedChunks);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	[RplRpc(RplChannel.Reliable, RplRcver.Server)]
+	protected void RpcAsk_TDLTerrainChunkAck(AG0_ETDLTerrainDataset dataset, string syncHash, int receivedChunks)
+	{
+		AG0_TDLSystem system = AG0_TDLSystem.GetInstance();
+		if (!system)
+			return;
+
+		system.OnTerrainChunkAck(GetPlayerId(), dataset, syncHash, receivedChunks);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Server → Client: the client's copy of this dataset is current, load it locally.
+	void UseCachedTDLTerrain(AG0_ETDLTerrainDataset dataset, string syncHash)
+	{
+		Rpc(RpcDo_UseCachedTDLTerrain, dataset, syncHash);
+		AG0_TDLProfiler.RecordRpc(TerrainRpcType(dataset), 8 + syncHash.Length());
+	}
+
+	//------------------------------------------------------------------------------------------------
+	[RplRpc(RplChannel.Reliable, RplRcver.Owner)]
+	protected void RpcDo_UseCachedTDLTerrain(AG0_ETDLTerrainDataset dataset, string syncHash)
+	{
+		bool structures = dataset == AG0_ETDLTerrainDataset.STRUCTURES;
+		if (structures && syncHash == m_sTerrainStructureSyncHash)
+			return;
+		if (!structures && syncHash == m_sTerrainRoadSyncHash)
+			return;
+
+		string payload = AG0_TDLTerrainCache.ReadPayload(dataset, syncHash);
+		if (payload.IsEmpty())
+		{
+			// Cache vanished since we advertised it — fall back to a full transfer
+			SendTerrainCacheHash(dataset, string.Empty);
+			return;
+		}
+
+		Print(string.Format("[TDL_TERRAIN_CACHE] Using cached dataset %1 (%2 chars, hash: %3)",
+			typename.EnumToString(AG0_ETDLTerrainDataset, dataset), payload.Length(), syncHash), LogLevel.DEBUG);
+
+		if (structures)
+			ApplyTerrainStructuresPayload(payload, syncHash, true);
+		else
+			ApplyTerrainRoadsPayload(payload, syncHash, true);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected static AG0_ETDLRpcType TerrainRpcType(AG0_ETDLTerrainDataset dataset)
+	{
+		if (dataset == AG0_ETDLTerrainDataset.STRUCTURES)
+			return AG0_ETDLRpcType.TERRAIN_STRUCTURES;
+		return AG0_ETDLRpcType.TERRAIN_ROADS;
 	}
     
     //------------------------------------------------------------------------------------------------
     // PUBLIC API: Called by server-side system to send messages to this client
     //------------------------------------------------------------------------------------------------
-    void ReceiveTDLMessages(int networkId, array<ref AG0_TDLMessageClient> messages)
+    void ReceiveTDLMessageDelta(int networkId, RplId viewerRplId, int baseSeq, int seq,
+                                array<ref AG0_TDLMessageClient> newMessages, array<int> statusUpdates)
 	{
-	    Rpc(RpcDo_ReceiveTDLMessages, networkId, messages);
+	    Rpc(RpcDo_ReceiveTDLMessageDelta, networkId, viewerRplId, baseSeq, seq, newMessages, statusUpdates);
+	    
+	    int bytes = 20 + statusUpdates.Count() * 4;
+	    foreach (AG0_TDLMessageClient message : newMessages)
+	        bytes += message.EstimateWireSize();
+	    AG0_TDLProfiler.RecordRpc(AG0_ETDLRpcType.MESSAGE_DELTA, bytes);
 	}
     
-    void ReceiveTDLReadReceipt(int networkId, int messageId, RplId readerRplId)
-    {
-        Rpc(RpcDo_ReceiveTDLReadReceipt, networkId, messageId, readerRplId);
-    }
-    
     //------------------------------------------------------------------------------------------------
     // CLIENT-SIDE API: Get messages for UI
     //------------------------------------------------------------------------------------------------
     
-    // Get message store for a network
-    AG0_TDLMessageStore GetTDLMessageStore(int networkId)
+    // Get message store for a network as seen from one of our devices
+    AG0_TDLMessageStore GetTDLMessageStore(int networkId, RplId myDeviceRplId)
     {
-        if (!m_mNetworkMessages.Contains(networkId))
+        map<RplId, ref AG0_TDLMessageStore> viewerStores = m_mNetworkMessages.Get(networkId);
+        if (!viewerStores)
             return null;
-        return m_mNetworkMessages.Get(networkId);
+        return viewerStores.Get(myDeviceRplId);
     }
     
     // Get network broadcast messages
-    array<ref AG0_TDLMessageClient> GetNetworkChatMessages(int networkId)
+    array<ref AG0_TDLMessageClient> GetNetworkChatMessages(int networkId, RplId myDeviceRplId)
     {
-        AG0_TDLMessageStore store = GetTDLMessageStore(networkId);
+        AG0_TDLMessageStore store = GetTDLMessageStore(networkId, myDeviceRplId);
         if (!store) return new array<ref AG0_TDLMessageClient>();
         return store.GetNetworkMessages();
     }
@@ -1388,7 +1847,7 @@ modded class SCR_PlayerController
     // Get direct messages with a contact
     array<ref AG0_TDLMessageClient> GetDirectMessages(int networkId, RplId myDeviceRplId, RplId contactRplId)
     {
-        AG0_TDLMessageStore store = GetTDLMessageStore(networkId);
+        AG0_TDLMessageStore store = GetTDLMessageStore(networkId, myDeviceRplId);
         if (!store) return new array<ref AG0_TDLMessageClient>();
         return store.GetDirectMessages(myDeviceRplId, contactRplId);
     }
@@ -1408,7 +1867,7 @@ modded class SCR_PlayerController
     // Get unread count for network chat
     int GetNetworkChatUnreadCount(int networkId, RplId myDeviceRplId)
     {
-        AG0_TDLMessageStore store = GetTDLMessageStore(networkId);
+        AG0_TDLMessageStore store = GetTDLMessageStore(networkId, myDeviceRplId);
         if (!store) return 0;
         return store.CountUnreadInConversation(myDeviceRplId, "NETWORK", m_LocallyReadMessages);
     }
@@ -1416,7 +1875,7 @@ modded class SCR_PlayerController
     // Get unread count for a direct conversation
     int GetDirectChatUnreadCount(int networkId, RplId myDeviceRplId, RplId contactRplId)
     {
-        AG0_TDLMessageStore store = GetTDLMessageStore(networkId);
+        AG0_TDLMessageStore store = GetTDLMessageStore(networkId, myDeviceRplId);
         if (!store) return 0;
         return store.CountUnreadInConversation(myDeviceRplId, contactRplId.ToString(), m_LocallyReadMessages);
     }
@@ -1424,7 +1883,7 @@ modded class SCR_PlayerController
     // Get total unread count
     int GetTotalUnreadCount(int networkId, RplId myDeviceRplId)
     {
-        AG0_TDLMessageStore store = GetTDLMessageStore(networkId);
+        AG0_TDLMessageStore store = GetTDLMessageStore(networkId, myDeviceRplId);
         if (!store) return 0;
         return store.CountTotalUnread(myDeviceRplId, m_LocallyReadMessages);
     }
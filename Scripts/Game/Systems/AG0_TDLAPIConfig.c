@@ -16,6 +16,11 @@ class AG0_TDLApiConfigData : JsonApiStruct
     bool enabled;
     int pollIntervalSeconds;
 	int stateSyncIntervalSeconds;
+	int positionBudgetBytesPerSecond;
+	bool includePerfInHeartbeat;
+	int stateSyncKeyframeInterval;
+	int compressThresholdBytes;
+	int terrainBudgetBytesPerSecond;
 
     
     //------------------------------------------------------------------------------------------------
@@ -27,6 +32,11 @@ class AG0_TDLApiConfigData : JsonApiStruct
         RegV("enabled");
         RegV("pollIntervalSeconds");
 		RegV("stateSyncIntervalSeconds");
+		RegV("positionBudgetBytesPerSecond");
+		RegV("includePerfInHeartbeat");
+		RegV("stateSyncKeyframeInterval");
+		RegV("compressThresholdBytes");
+		RegV("terrainBudgetBytesPerSecond");
         
         // Set defaults
         apiKey = "";
@@ -34,6 +44,11 @@ class AG0_TDLApiConfigData : JsonApiStruct
         enabled = true;
         pollIntervalSeconds = 5;
 		stateSyncIntervalSeconds = 5; // default 5s for sync worker
+		positionBudgetBytesPerSecond = 8192; // fast-path member positions, all players combined
+		includePerfInHeartbeat = false; // attach AG0_TDLProfiler tables to heartbeats
+		stateSyncKeyframeInterval = 12; // full state every N sync intervals (empty ones count), deltas in between (1 = always full)
+		compressThresholdBytes = 16384; // /submit bodies at least this large go up as base64(gzip); negative = never
+		terrainBudgetBytesPerSecond = 32768; // terrain dataset chunks to clients, all players combined
     }
     
     //------------------------------------------------------------------------------------------------
@@ -94,6 +109,155 @@ class AG0_TDLApiSubmitCallback : RestCallback
     }
 }
 
+//------------------------------------------------------------------------------------------------
+// REST Callback for state_sync / state_delta submissions. Separate from the generic submit
+// callback so the response can be matched to the one state payload in flight.
+//------------------------------------------------------------------------------------------------
+class AG0_TDLApiStateSyncCallback : RestCallback
+{
+    protected AG0_TDLApiManager m_Manager;
+    
+    //------------------------------------------------------------------------------------------------
+    void AG0_TDLApiStateSyncCallback(AG0_TDLApiManager manager)
+    {
+        m_Manager = manager;
+        SetOnSuccess(OnSuccessHandler);
+        SetOnError(OnErrorHandler);
+    }
+    
+    //------------------------------------------------------------------------------------------------
+    void OnSuccessHandler(RestCallback cb)
+    {
+        string data = cb.GetData();
+        if (m_Manager)
+            m_Manager.OnStateSyncSuccess(data);
+    }
+    
+    //------------------------------------------------------------------------------------------------
+    void OnErrorHandler(RestCallback cb)
+    {
+        if (cb.GetRestResult() == ERestResult.EREST_ERROR_TIMEOUT)
+        {
+            Print("[TDL_API] State sync request timed out", LogLevel.DEBUG);
+            if (m_Manager)
+                m_Manager.OnStateSyncFailed(0);
+            return;
+        }
+        
+        if (m_Manager)
+            m_Manager.OnStateSyncFailed(cb.GetHttpCode());
+    }
+}
+
+//------------------------------------------------------------------------------------------------
+// REST Callback for batched event submissions from the outbox
+//------------------------------------------------------------------------------------------------
+class AG0_TDLApiEventBatchCallback : RestCallback
+{
+    protected AG0_TDLApiManager m_Manager;
+    
+    //------------------------------------------------------------------------------------------------
+    void AG0_TDLApiEventBatchCallback(AG0_TDLApiManager manager)
+    {
+        m_Manager = manager;
+        SetOnSuccess(OnSuccessHandler);
+        SetOnError(OnErrorHandler);
+    }
+    
+    //------------------------------------------------------------------------------------------------
+    void OnSuccessHandler(RestCallback cb)
+    {
+        if (m_Manager)
+            m_Manager.OnEventBatchSuccess(cb.GetData());
+    }
+    
+    //------------------------------------------------------------------------------------------------
+    void OnErrorHandler(RestCallback cb)
+    {
+        if (cb.GetRestResult() == ERestResult.EREST_ERROR_TIMEOUT)
+        {
+            Print("[TDL_API] Event batch request timed out", LogLevel.DEBUG);
+            if (m_Manager)
+                m_Manager.OnEventBatchFailed(0);
+            return;
+        }
+        
+        if (m_Manager)
+            m_Manager.OnEventBatchFailed(cb.GetHttpCode());
+    }
+}
+
+//------------------------------------------------------------------------------------------------
+// One queued API event. Events sharing a non-empty coalesce key describe the same thing;
+// the outbox keeps only the one with the highest rank (the newest on a tie).
+//------------------------------------------------------------------------------------------------
+class AG0_TDLApiOutboxEvent
+{
+    string m_sJson;
+    string m_sCoalesceKey;
+    int m_iRank;
+    
+    //------------------------------------------------------------------------------------------------
+    void AG0_TDLApiOutboxEvent(string json, string coalesceKey, int rank)
+    {
+        m_sJson = json;
+        m_sCoalesceKey = coalesceKey;
+        m_iRank = rank;
+    }
+}
+
+//------------------------------------------------------------------------------------------------
+// One /submit body being compressed across frames: gzip, then base64 (the REST body is a
+// script string and not binary-safe, same reason downloads arrive base64-wrapped).
+//------------------------------------------------------------------------------------------------
+class AG0_TDLApiUploadJob
+{
+    protected RestCallback m_Callback;
+    protected int m_iRawSize;
+    protected ref AG0_TDLGzipEncoder m_Gzip;
+    protected ref AG0_TDLBase64Encoder m_Base64;
+    
+    //------------------------------------------------------------------------------------------------
+    void AG0_TDLApiUploadJob(RestCallback callback, string jsonData)
+    {
+        m_Callback = callback;
+        m_iRawSize = jsonData.Length();
+        m_Gzip = new AG0_TDLGzipEncoder();
+        m_Gzip.InitString(jsonData);
+    }
+    
+    //------------------------------------------------------------------------------------------------
+    //! @return true while encoding remains
+    bool Step(int timeBudgetMs)
+    {
+        int startTick = System.GetTickCount();
+        
+        if (m_Gzip)
+        {
+            if (m_Gzip.Step(timeBudgetMs))
+                return true;
+            
+            m_Base64 = new AG0_TDLBase64Encoder();
+            m_Base64.Init(m_Gzip.GetOutput());
+            m_Gzip = null;
+        }
+        
+        int remaining = timeBudgetMs - (System.GetTickCount() - startTick);
+        return m_Base64.Step(Math.Max(remaining, 1));
+    }
+    
+    //------------------------------------------------------------------------------------------------
+    string BuildBody()
+    {
+        return string.Format("{\"type\":\"compressed\",\"encoding\":\"gzip+base64\",\"rawSize\":%1,\"data\":\"", m_iRawSize)
+            + m_Base64.GetOutput() + "\"}";
+    }
+    
+    //------------------------------------------------------------------------------------------------
+    RestCallback GetCallback() { return m_Callback; }
+    int GetRawSize() { return m_iRawSize; }
+}
+
 //------------------------------------------------------------------------------------------------
 // REST Callback for API Queue polling endpoint
 //------------------------------------------------------------------------------------------------
@@ -320,6 +484,35 @@ class AG0_TDLApiManager
     
     // REST Callbacks (must be kept as references)
     protected ref AG0_TDLApiSubmitCallback m_SubmitCallback;
+    protected ref AG0_TDLApiStateSyncCallback m_StateSyncCallback;
+    protected ref AG0_TDLApiEventBatchCallback m_EventBatchCallback;
+    
+    // Event outbox: ApiNotify* events are queued, coalesced and POSTed as one "event_batch".
+    // Flushed every OUTBOX_FLUSH_INTERVAL, or sooner once OUTBOX_FLUSH_BYTES are queued.
+    // One batch in flight at a time; a failed batch goes back to the front of the queue and
+    // the next attempt waits with exponential backoff.
+    protected static const float OUTBOX_FLUSH_INTERVAL = 1.0;
+    protected static const int OUTBOX_FLUSH_BYTES = 32768;
+    protected static const int OUTBOX_MAX_BATCH_EVENTS = 100;
+    protected static const int OUTBOX_MAX_BATCH_BYTES = 262144;     // well under the 1 MB request ceiling
+    protected static const int OUTBOX_MAX_EVENTS = 1000;
+    protected static const int OUTBOX_MAX_BYTES = 1048576;
+    protected static const float OUTBOX_MAX_BACKOFF = 60.0;
+    protected ref array<ref AG0_TDLApiOutboxEvent> m_aOutbox = {};
+    protected ref map<string, AG0_TDLApiOutboxEvent> m_mOutboxByKey = new map<string, AG0_TDLApiOutboxEvent>();
+    protected ref array<ref AG0_TDLApiOutboxEvent> m_aOutboxInFlight = {};
+    protected int m_iOutboxBytes = 0;
+    protected float m_fTimeSinceOutboxFlush = 0;
+    protected float m_fOutboxBackoff = 0;           // seconds to wait before the next attempt after a failure
+    protected int m_iOutboxFailures = 0;
+    protected int m_iOutboxDropped = 0;
+    protected int m_iOutboxCoalesced = 0;
+    
+    // Compressed uploads: large /submit bodies are gzipped and base64-encoded a slice per frame
+    // before they are POSTed (see PostSubmit / StepUploadJobs)
+    protected static const int UPLOAD_BUDGET_MS = 2;
+    protected static const int MAX_UPLOAD_JOBS = 8;
+    protected ref array<ref AG0_TDLApiUploadJob> m_aUploadJobs = {};
     protected ref AG0_TDLApiQueueCallback m_QueueCallback;
     protected ref AG0_TDLApiValidateCallback m_ValidateCallback;
     
@@ -336,7 +529,7 @@ class AG0_TDLApiManager
 
     // Terrain structures (building footprints, streamed from /api/mod/terrain/structures)
     // Populated once after key-validation and on terrain_structures_refresh queue commands.
-    // The manager retains the raw JSON so AG0_TDLSystem can forward it to clients verbatim.
+    // The manager retains the packed payload so AG0_TDLSystem can forward it to clients verbatim.
     protected ref AG0_TDLApiTerrainStructuresCallback m_TerrainStructuresCallback;
     protected ref AG0_TDLTerrainStructureManager m_TerrainStructureManager;
     protected bool m_bTerrainStructuresPollInProgress = false;
@@ -353,6 +546,13 @@ class AG0_TDLApiManager
     protected int m_iSuccessfulTerrainRoadsPolls = 0;
     protected int m_iFailedTerrainRoadsPolls = 0;
 
+    // Packed terrain transcoding: a v2 response is base64/gunzip-decoded and parsed, a v1 JSON
+    // response is packed and compressed for client redistribution — either way a slice per
+    // Update, every stage included (see StepTerrainJobs)
+    protected static const int TERRAIN_CODEC_BUDGET_MS = 4;
+    protected ref AG0_TDLTerrainCodecJob m_TerrainStructuresJob;
+    protected ref AG0_TDLTerrainCodecJob m_TerrainRoadsJob;
+
     // Statistics
     protected int m_iSuccessfulSubmits = 0;
     protected int m_iFailedSubmits = 0;
@@ -363,6 +563,8 @@ class AG0_TDLApiManager
     void AG0_TDLApiManager()
     {
         m_SubmitCallback = new AG0_TDLApiSubmitCallback(this);
+        m_StateSyncCallback = new AG0_TDLApiStateSyncCallback(this);
+        m_EventBatchCallback = new AG0_TDLApiEventBatchCallback(this);
         m_QueueCallback = new AG0_TDLApiQueueCallback(this);
         m_ValidateCallback = new AG0_TDLApiValidateCallback(this);
 		m_ShapesCallback = new AG0_TDLApiShapesCallback(this);
@@ -460,6 +662,30 @@ class AG0_TDLApiManager
 	        needsSave = true;
 	    }
 	    
+	    if (m_Config.positionBudgetBytesPerSecond <= 0)
+	    {
+	        m_Config.positionBudgetBytesPerSecond = 8192;
+	        needsSave = true;
+	    }
+	    
+	    if (m_Config.stateSyncKeyframeInterval <= 0)
+	    {
+	        m_Config.stateSyncKeyframeInterval = 12;
+	        needsSave = true;
+	    }
+	    
+	    if (m_Config.compressThresholdBytes == 0)
+	    {
+	        m_Config.compressThresholdBytes = 16384;
+	        needsSave = true;
+	    }
+	    
+	    if (m_Config.terrainBudgetBytesPerSecond <= 0)
+	    {
+	        m_Config.terrainBudgetBytesPerSecond = 32768;
+	        needsSave = true;
+	    }
+	    
 	    if (needsSave)
 	    {
 	        SaveConfig();
@@ -581,6 +807,49 @@ class AG0_TDLApiManager
 	    
 	    return Math.Clamp(m_Config.stateSyncIntervalSeconds, 1, 60);
 	}
+	
+	//! Server-wide byte budget per second for fast-path member position updates
+	int GetPositionUpdateBudget()
+	{
+	    if (!m_Config || m_Config.positionBudgetBytesPerSecond <= 0)
+	        return 8192;
+	    
+	    return Math.ClampInt(m_Config.positionBudgetBytesPerSecond, 512, 262144);
+	}
+	
+	bool IsPerfInHeartbeatEnabled()
+	{
+	    return m_Config && m_Config.includePerfInHeartbeat;
+	}
+	
+	//! Server-wide byte budget per second for streaming terrain dataset chunks to clients
+	int GetTerrainTransferBudget()
+	{
+	    if (!m_Config || m_Config.terrainBudgetBytesPerSecond <= 0)
+	        return 32768;
+	    
+	    return Math.ClampInt(m_Config.terrainBudgetBytesPerSecond, 4096, 1048576);
+	}
+	
+	//! Minimum /submit body size that is sent compressed; 0 = compression off
+	int GetCompressThreshold()
+	{
+	    if (!m_Config || m_Config.compressThresholdBytes < 0)
+	        return 0;
+	    if (m_Config.compressThresholdBytes == 0)
+	        return 16384;
+	    
+	    return Math.Max(m_Config.compressThresholdBytes, 1024);
+	}
+	
+	//! Full state_sync keyframe every N acknowledged syncs; state_delta in between
+	int GetStateSyncKeyframeInterval()
+	{
+	    if (!m_Config || m_Config.stateSyncKeyframeInterval <= 0)
+	        return 12;
+	    
+	    return Math.ClampInt(m_Config.stateSyncKeyframeInterval, 1, 720);
+	}
     
     //------------------------------------------------------------------------------------------------
     //! Update function - call from system's OnUpdatePoint
@@ -590,6 +859,8 @@ class AG0_TDLApiManager
         if (!m_bInitialized || !m_Config || !m_Config.enabled)
             return;
         
+        StepTerrainJobs();
+        
         if (!m_bApiKeyValid)
             return;
         
@@ -602,6 +873,12 @@ class AG0_TDLApiManager
             PollQueue();
             m_fTimeSinceLastPoll = 0;
         }
+        
+        m_fTimeSinceOutboxFlush += timeSlice;
+        if (m_fTimeSinceOutboxFlush >= OUTBOX_FLUSH_INTERVAL + m_fOutboxBackoff)
+            FlushOutbox();
+        
+        StepUploadJobs();
     }
     
     //------------------------------------------------------------------------------------------------
@@ -616,6 +893,36 @@ class AG0_TDLApiManager
             return false;
         }
         
+        Print(string.Format("[TDL_API] Submitting data: %1 bytes", jsonData.Length()), LogLevel.DEBUG);
+        
+        return PostSubmit(m_SubmitCallback, jsonData);
+    }
+    
+    //------------------------------------------------------------------------------------------------
+    //! POST a /submit body, or queue it for compression when it is over the configured threshold.
+    //! Compressed bodies are sent as
+    //!   {"type":"compressed","encoding":"gzip+base64","rawSize":N,"data":"<base64(gzip(json))>"}
+    //! and answered through the same callback as the plain body would have been.
+    protected bool PostSubmit(RestCallback callback, string jsonData)
+    {
+        int threshold = GetCompressThreshold();
+        if (threshold > 0 && jsonData.Length() >= threshold)
+        {
+            if (m_aUploadJobs.Count() < MAX_UPLOAD_JOBS)
+            {
+                m_aUploadJobs.Insert(new AG0_TDLApiUploadJob(callback, jsonData));
+                return true;
+            }
+            
+            Print("[TDL_API] Compression queue full, submitting uncompressed", LogLevel.DEBUG);
+        }
+        
+        return PostRaw(callback, jsonData);
+    }
+    
+    //------------------------------------------------------------------------------------------------
+    protected bool PostRaw(RestCallback callback, string body)
+    {
         RestContext ctx = GetGame().GetRestApi().GetContext(API_BASE_URL);
         if (!ctx)
         {
@@ -628,14 +935,172 @@ class AG0_TDLApiManager
         string headers = string.Format("Authorization,Bearer %1,Content-Type,application/json", m_Config.apiKey);
         ctx.SetHeaders(headers);
         
-        Print(string.Format("[TDL_API] Submitting data: %1 bytes", jsonData.Length()), LogLevel.DEBUG);
-        
         // POST(callback, request_path, data)
-        ctx.POST(m_SubmitCallback, "/submit", jsonData);
+        ctx.POST(callback, "/submit", body);
         
         return true;
     }
     
+    //------------------------------------------------------------------------------------------------
+    //! Advance the oldest compression job by one frame's budget; POST it once encoded.
+    //! Jobs are sent in the order they were queued.
+    protected void StepUploadJobs()
+    {
+        if (m_aUploadJobs.IsEmpty())
+            return;
+        
+        AG0_TDLApiUploadJob job = m_aUploadJobs[0];
+        if (job.Step(UPLOAD_BUDGET_MS))
+            return;
+        
+        string body = job.BuildBody();
+        Print(string.Format("[TDL_API] Submitting compressed: %1 -> %2 bytes", job.GetRawSize(), body.Length()), LogLevel.DEBUG);
+        
+        RestCallback callback = job.GetCallback();
+        m_aUploadJobs.RemoveOrdered(0);
+        if (!PostRaw(callback, body))
+        {
+            Print("[TDL_API] Compressed submit could not be sent", LogLevel.WARNING);
+            OnUploadJobFailed(callback);
+        }
+    }
+    
+    //------------------------------------------------------------------------------------------------
+    //! A queued body that could not be POSTed fails the way its callback would have, so the
+    //! owner's in-flight state (outbox batch, state payload awaiting ack) is released.
+    //! Synchronous submits get the same handling from their PostSubmit return value.
+    protected void OnUploadJobFailed(RestCallback callback)
+    {
+        if (callback == m_EventBatchCallback)
+            OnEventBatchFailed(0);
+        else if (callback == m_StateSyncCallback)
+            OnStateSyncFailed(0);
+        else
+            OnSubmitTimeout();
+    }
+    
+    //------------------------------------------------------------------------------------------------
+    //! Queue an event for the next batched submit.
+    //! @param jsonData Complete event document ({"type":"event", "event":...})
+    //! @param coalesceKey Events with the same key supersede each other; empty = never coalesced
+    //! @param rank On a key collision the higher rank survives, the newer one on a tie
+    //!        (e.g. message_read ranks above message_delivered for the same message/recipient)
+    void QueueEvent(string jsonData, string coalesceKey = "", int rank = 0)
+    {
+        if (!CanCommunicate())
+            return;
+        
+        if (!coalesceKey.IsEmpty())
+        {
+            AG0_TDLApiOutboxEvent existing = m_mOutboxByKey.Get(coalesceKey);
+            if (existing)
+            {
+                m_iOutboxCoalesced++;
+                if (existing.m_iRank > rank)
+                    return;
+                
+                RemoveOutboxEvent(existing);
+            }
+        }
+        
+        AG0_TDLApiOutboxEvent evt = new AG0_TDLApiOutboxEvent(jsonData, coalesceKey, rank);
+        m_aOutbox.Insert(evt);
+        m_iOutboxBytes += jsonData.Length();
+        if (!coalesceKey.IsEmpty())
+            m_mOutboxByKey.Set(coalesceKey, evt);
+        
+        TrimOutbox();
+        
+        if (m_iOutboxBytes >= OUTBOX_FLUSH_BYTES || m_aOutbox.Count() >= OUTBOX_MAX_BATCH_EVENTS)
+        {
+            if (m_fOutboxBackoff <= 0)
+                FlushOutbox();
+        }
+    }
+    
+    //------------------------------------------------------------------------------------------------
+    protected void RemoveOutboxEvent(AG0_TDLApiOutboxEvent evt)
+    {
+        int index = m_aOutbox.Find(evt);
+        if (index < 0)
+            return;
+        
+        if (!evt.m_sCoalesceKey.IsEmpty())
+            m_mOutboxByKey.Remove(evt.m_sCoalesceKey);
+        m_iOutboxBytes -= evt.m_sJson.Length();
+        m_aOutbox.RemoveOrdered(index);
+    }
+    
+    //------------------------------------------------------------------------------------------------
+    //! Keep the outbox bounded while the API is unreachable: drop the oldest events
+    protected void TrimOutbox()
+    {
+        while (m_aOutbox.Count() > OUTBOX_MAX_EVENTS || (m_iOutboxBytes > OUTBOX_MAX_BYTES && m_aOutbox.Count() > 1))
+        {
+            RemoveOutboxEvent(m_aOutbox[0]);
+            m_iOutboxDropped++;
+        }
+    }
+    
+    //------------------------------------------------------------------------------------------------
+    //! POST the oldest queued events as one batch: {"type":"event_batch", "events":[...]}.
+    //! Each element is the same document a standalone event submit used to send.
+    protected void FlushOutbox()
+    {
+        m_fTimeSinceOutboxFlush = 0;
+        
+        if (m_aOutbox.IsEmpty() || !m_aOutboxInFlight.IsEmpty())
+            return;
+        
+        if (!CanCommunicate())
+            return;
+        
+        string events;
+        int batchBytes = 0;
+        while (!m_aOutbox.IsEmpty() && m_aOutboxInFlight.Count() < OUTBOX_MAX_BATCH_EVENTS)
+        {
+            AG0_TDLApiOutboxEvent evt = m_aOutbox[0];
+            int eventBytes = evt.m_sJson.Length();
+            if (!m_aOutboxInFlight.IsEmpty() && batchBytes + eventBytes > OUTBOX_MAX_BATCH_BYTES)
+                break;
+            
+            if (!events.IsEmpty())
+                events += ",";
+            events += evt.m_sJson;
+            batchBytes += eventBytes;
+            
+            m_aOutboxInFlight.Insert(evt);
+            RemoveOutboxEvent(evt);
+        }
+        
+        string jsonData = string.Format("{\"type\":\"event_batch\",\"timestamp\":%1,\"events\":[%2]}", System.GetUnixTime(), events);
+        
+        Print(string.Format("[TDL_API] Submitting %1 events: %2 bytes", m_aOutboxInFlight.Count(), jsonData.Length()), LogLevel.DEBUG);
+        
+        if (!PostSubmit(m_EventBatchCallback, jsonData))
+            OnEventBatchFailed(0);
+    }
+    
+    //------------------------------------------------------------------------------------------------
+    //! Queued events plus the batch in flight
+    int GetOutboxCount() { return m_aOutbox.Count() + m_aOutboxInFlight.Count(); }
+    int GetOutboxDropped() { return m_iOutboxDropped; }
+    int GetOutboxCoalesced() { return m_iOutboxCoalesced; }
+    
+    //------------------------------------------------------------------------------------------------
+    //! Submit a state_sync / state_delta payload. Same endpoint as SubmitData, but the response
+    //! is reported to AG0_TDLSystem so the payload can be acknowledged.
+    //! @return true if request was initiated
+    bool SubmitStateSync(string jsonData)
+    {
+        if (!CanCommunicate())
+            return false;
+        
+        Print(string.Format("[TDL_API] Submitting state: %1 bytes", jsonData.Length()), LogLevel.DEBUG);
+        
+        return PostSubmit(m_StateSyncCallback, jsonData);
+    }
+    
     //------------------------------------------------------------------------------------------------
     //! Poll the queue for pending commands
     protected void PollQueue()
@@ -704,6 +1169,91 @@ class AG0_TDLApiManager
         m_iFailedSubmits++;
     }
     
+    void OnEventBatchSuccess(string data)
+    {
+        m_iSuccessfulSubmits++;
+        m_aOutboxInFlight.Clear();
+        m_iOutboxFailures = 0;
+        m_fOutboxBackoff = 0;
+        
+        if (!data.IsEmpty())
+            ProcessSubmitResponse(data);
+        
+        // More than one batch queued up: don't wait for the timer
+        if (m_iOutboxBytes >= OUTBOX_FLUSH_BYTES || m_aOutbox.Count() >= OUTBOX_MAX_BATCH_EVENTS)
+            FlushOutbox();
+    }
+    
+    //! @param errorCode HTTP status, 0 on timeout
+    void OnEventBatchFailed(int errorCode)
+    {
+        if (errorCode != 0)
+            OnSubmitError(errorCode);
+        else
+            OnSubmitTimeout();
+        
+        // Put the batch back at the front in its original order. Anything queued meanwhile
+        // under the same key with an equal or higher rank already supersedes it.
+        for (int i = m_aOutboxInFlight.Count() - 1; i >= 0; i--)
+        {
+            AG0_TDLApiOutboxEvent evt = m_aOutboxInFlight[i];
+            if (!evt.m_sCoalesceKey.IsEmpty())
+            {
+                AG0_TDLApiOutboxEvent newer = m_mOutboxByKey.Get(evt.m_sCoalesceKey);
+                if (newer && newer.m_iRank >= evt.m_iRank)
+                    continue;
+                if (newer)
+                    RemoveOutboxEvent(newer);
+                m_mOutboxByKey.Set(evt.m_sCoalesceKey, evt);
+            }
+            
+            m_aOutbox.InsertAt(evt, 0);
+            m_iOutboxBytes += evt.m_sJson.Length();
+        }
+        m_aOutboxInFlight.Clear();
+        TrimOutbox();
+        
+        // 2, 4, 8 ... seconds, capped
+        m_iOutboxFailures++;
+        m_fOutboxBackoff = Math.Min(Math.Pow(2, m_iOutboxFailures), OUTBOX_MAX_BACKOFF);
+        m_fTimeSinceOutboxFlush = 0;
+        
+        Print(string.Format("[TDL_API] Event batch failed (%1), %2 events queued, retry in %3s",
+            errorCode, m_aOutbox.Count(), m_fOutboxBackoff), LogLevel.DEBUG);
+    }
+    
+    //! The API may answer a state payload with {"resync": true} when its baseSeq doesn't match
+    //! what it last applied; the payload is still acknowledged, but the next one is a keyframe.
+    void OnStateSyncSuccess(string data)
+    {
+        m_iSuccessfulSubmits++;
+        
+        bool resync = false;
+        if (!data.IsEmpty())
+        {
+            SCR_JsonLoadContext json = new SCR_JsonLoadContext();
+            if (json.ImportFromString(data))
+                json.ReadValue("resync", resync);
+        }
+        
+        AG0_TDLSystem tdlSystem = AG0_TDLSystem.GetInstance();
+        if (tdlSystem)
+            tdlSystem.OnApiStateSyncResult(true, resync);
+    }
+    
+    //! @param errorCode HTTP status, 0 on timeout
+    void OnStateSyncFailed(int errorCode)
+    {
+        if (errorCode != 0)
+            OnSubmitError(errorCode);
+        else
+            OnSubmitTimeout();
+        
+        AG0_TDLSystem tdlSystem = AG0_TDLSystem.GetInstance();
+        if (tdlSystem)
+            tdlSystem.OnApiStateSyncResult(false, false);
+    }
+    
     void OnQueuePollSuccess(string data)
     {
         m_bPollInProgress = false;
@@ -850,12 +1400,26 @@ class AG0_TDLApiManager
                 HandleMessageMarkReadCommand(cmdJson);
                 break;
 
+            case "state_resync":
+                HandleStateResyncCommand();
+                break;
+
             default:
                 Print(string.Format("[TDL_API] Unknown command type: %1", cmdType), LogLevel.WARNING);
                 break;
         }
     }
     
+    //------------------------------------------------------------------------------------------------
+    //! Handle state_resync command: the API lost track of state_delta sequencing
+    protected void HandleStateResyncCommand()
+    {
+        Print("[TDL_API] state_resync command received, next state sync is a keyframe", LogLevel.DEBUG);
+        AG0_TDLSystem tdlSystem = AG0_TDLSystem.GetInstance();
+        if (tdlSystem)
+            tdlSystem.RequestApiStateKeyframe();
+    }
+    
     //------------------------------------------------------------------------------------------------
     //! Handle broadcast command from API
     protected void HandleBroadcastCommand(SCR_JsonLoadContext cmdJson)
@@ -1647,7 +2211,7 @@ class AG0_TDLApiManager
 		if (!CanCommunicate())
 			return;
 
-		if (m_bTerrainStructuresPollInProgress)
+		if (m_bTerrainStructuresPollInProgress || m_TerrainStructuresJob)
 			return;
 
 		RestContext ctx = GetGame().GetRestApi().GetContext(API_BASE_URL);
@@ -1660,9 +2224,10 @@ class AG0_TDLApiManager
 		// Auth only — do NOT send Accept-Encoding: gzip here.
 		// The Reforger REST stack does not transparently decompress for this
 		// endpoint, so requesting gzip causes ImportFromString to fail with
-		// "invalid JSON" on the (still-compressed) bytes. The dataset is small
-		// enough uncompressed that this isn't a problem in practice; if/when
-		// payloads grow we can add a manual gunzip step using AG0_TDLGzip.
+		// "invalid JSON" on the (still-compressed) bytes. Compression is instead
+		// requested with ?format=packed, which returns base64(gzip(binary)) inside
+		// a JSON envelope that we unpack with AG0_TDLGzip ourselves. Servers that
+		// don't know the parameter keep answering v1 JSON.
 		string headers = string.Format("Authorization,Bearer %1", m_Config.apiKey);
 		ctx.SetHeaders(headers);
 
@@ -1670,12 +2235,12 @@ class AG0_TDLApiManager
 
 		// Build path. Server short-circuits to 304 when ?since= matches the
 		// current content hash; we treat that as "keep current dataset".
-		string path = "/terrain/structures";
+		string path = "/terrain/structures?format=packed";
 		if (m_TerrainStructureManager)
 		{
 			string lastHash = m_TerrainStructureManager.GetLastSyncHash();
 			if (!lastHash.IsEmpty())
-				path = string.Format("/terrain/structures?since=%1", lastHash);
+				path = string.Format("/terrain/structures?format=packed&since=%1", lastHash);
 		}
 
 		Print(string.Format("[TDL_API] Fetching terrain structures: GET %1", path), LogLevel.DEBUG);
@@ -1695,6 +2260,17 @@ class AG0_TDLApiManager
 			return;
 		}
 
+		// Packed (v2) response: decode over the next frames; StepTerrainJobs commits it
+		string packed = AG0_TDLTerrainPacked.ReadEnvelope(data);
+		if (!packed.IsEmpty())
+		{
+			m_TerrainStructuresJob = new AG0_TDLTerrainCodecJob();
+			m_TerrainStructuresJob.InitDecode(packed, m_TerrainStructureManager.CreatePackedReader());
+			Print(string.Format("[TDL_API] Terrain structures poll: packed payload (%1 chars), decoding",
+				packed.Length()), LogLevel.DEBUG);
+			return;
+		}
+
 		string prevHash;
 		if (m_TerrainStructureManager)
 			prevHash = m_TerrainStructureManager.GetLastSyncHash();
@@ -1702,12 +2278,11 @@ class AG0_TDLApiManager
 		int parsed = m_TerrainStructureManager.ParseColumnarPayload(data);
 		string newHash = m_TerrainStructureManager.GetLastSyncHash();
 
-		// Only fan out to clients when the dataset actually changed.
+		// Only fan out to clients when the dataset actually changed — once it has been packed.
 		if (newHash != prevHash)
 		{
-			AG0_TDLSystem tdlSystem = AG0_TDLSystem.GetInstance();
-			if (tdlSystem)
-				tdlSystem.DistributeTerrainStructuresToClients();
+			m_TerrainStructuresJob = new AG0_TDLTerrainCodecJob();
+			m_TerrainStructuresJob.InitEncode(m_TerrainStructureManager.CreatePackedWriter());
 		}
 
 		Print(string.Format("[TDL_API] Terrain structures poll: %1 buildings, hash=%2",
@@ -1784,7 +2359,7 @@ class AG0_TDLApiManager
 	{
 		if (!CanCommunicate())
 			return;
-		if (m_bTerrainRoadsPollInProgress)
+		if (m_bTerrainRoadsPollInProgress || m_TerrainRoadsJob)
 			return;
 
 		RestContext ctx = GetGame().GetRestApi().GetContext(API_BASE_URL);
@@ -1795,18 +2370,18 @@ class AG0_TDLApiManager
 		}
 
 		// Auth only — no Accept-Encoding (REST stack does not transparently
-		// decompress; matches structures path).
+		// decompress; matches structures path, including ?format=packed).
 		string headers = string.Format("Authorization,Bearer %1", m_Config.apiKey);
 		ctx.SetHeaders(headers);
 
 		m_bTerrainRoadsPollInProgress = true;
 
-		string path = "/terrain/roads";
+		string path = "/terrain/roads?format=packed";
 		if (m_TerrainRoadManager)
 		{
 			string lastHash = m_TerrainRoadManager.GetLastSyncHash();
 			if (!lastHash.IsEmpty())
-				path = string.Format("/terrain/roads?since=%1", lastHash);
+				path = string.Format("/terrain/roads?format=packed&since=%1", lastHash);
 		}
 
 		Print(string.Format("[TDL_API] Fetching terrain roads: GET %1", path), LogLevel.DEBUG);
@@ -1824,6 +2399,16 @@ class AG0_TDLApiManager
 			return;
 		}
 
+		string packed = AG0_TDLTerrainPacked.ReadEnvelope(data);
+		if (!packed.IsEmpty())
+		{
+			m_TerrainRoadsJob = new AG0_TDLTerrainCodecJob();
+			m_TerrainRoadsJob.InitDecode(packed, m_TerrainRoadManager.CreatePackedReader());
+			Print(string.Format("[TDL_API] Terrain roads poll: packed payload (%1 chars), decoding",
+				packed.Length()), LogLevel.DEBUG);
+			return;
+		}
+
 		string prevHash;
 		if (m_TerrainRoadManager)
 			prevHash = m_TerrainRoadManager.GetLastSyncHash();
@@ -1833,9 +2418,8 @@ class AG0_TDLApiManager
 
 		if (newHash != prevHash)
 		{
-			AG0_TDLSystem tdlSystem = AG0_TDLSystem.GetInstance();
-			if (tdlSystem)
-				tdlSystem.DistributeTerrainRoadsToClients();
+			m_TerrainRoadsJob = new AG0_TDLTerrainCodecJob();
+			m_TerrainRoadsJob.InitEncode(m_TerrainRoadManager.CreatePackedWriter());
 		}
 
 		Print(string.Format("[TDL_API] Terrain roads poll: %1 features, hash=%2",
@@ -1889,11 +2473,90 @@ class AG0_TDLApiManager
 	{
 		return m_TerrainRoadManager;
 	}
+
+	//------------------------------------------------------------------------------------------------
+	// Packed terrain transcoding
+	//------------------------------------------------------------------------------------------------
+
+	//------------------------------------------------------------------------------------------------
+	//! Advance the structures / roads codec jobs by one slice each. When one finishes,
+	//! the manager holds both the expanded dataset and its packed payload, and clients
+	//! are sent the packed form if the hash changed.
+	protected void StepTerrainJobs()
+	{
+		if (m_TerrainStructuresJob && !m_TerrainStructuresJob.Step(TERRAIN_CODEC_BUDGET_MS))
+		{
+			AG0_TDLTerrainCodecJob structuresJob = m_TerrainStructuresJob;
+			m_TerrainStructuresJob = null;
+			if (CommitTerrainJob(structuresJob, m_TerrainStructureManager, null))
+			{
+				AG0_TDLSystem structuresSystem = AG0_TDLSystem.GetInstance();
+				if (structuresSystem)
+					structuresSystem.DistributeTerrainStructuresToClients();
+			}
+		}
+
+		if (m_TerrainRoadsJob && !m_TerrainRoadsJob.Step(TERRAIN_CODEC_BUDGET_MS))
+		{
+			AG0_TDLTerrainCodecJob roadsJob = m_TerrainRoadsJob;
+			m_TerrainRoadsJob = null;
+			if (CommitTerrainJob(roadsJob, null, m_TerrainRoadManager))
+			{
+				AG0_TDLSystem roadsSystem = AG0_TDLSystem.GetInstance();
+				if (roadsSystem)
+					roadsSystem.DistributeTerrainRoadsToClients();
+			}
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Apply a finished codec job to whichever manager is passed.
+	//! @return true if clients should be sent the (new) packed dataset
+	protected bool CommitTerrainJob(AG0_TDLTerrainCodecJob job, AG0_TDLTerrainStructureManager structures, AG0_TDLTerrainRoadManager roads)
+	{
+		string packed = job.GetPacked();
+
+		if (job.IsEncode())
+		{
+			// Dataset replaced or cleared while it was being packed — nothing current to send
+			if (!job.GetBytes())
+				return false;
+
+			if (packed.IsEmpty())
+			{
+				// Clients fall back to the raw JSON (see PushPlayerTerrainStructures)
+				Print("[TDL_API] Terrain packing produced no output, forwarding JSON", LogLevel.WARNING);
+				return true;
+			}
+		}
+		else
+		{
+			array<int> bytes = job.GetBytes();
+			if (!bytes || bytes.IsEmpty())
+			{
+				Print("[TDL_API] Terrain packed payload failed to decode", LogLevel.WARNING);
+				return false;
+			}
+
+			// The job's reader has already committed the dataset (or rejected it)
+			if (!job.GetPass().HasNewHash())
+				return false;
+		}
+
+		if (structures)
+			structures.SetPackedPayload(packed);
+		else if (roads)
+			roads.SetPackedPayload(packed);
+
+		Print(string.Format("[TDL_API] Terrain packed payload ready: %1 chars", packed.Length()), LogLevel.DEBUG);
+		return true;
+	}
 }
 
 class AG0_TDLDeviceState
 {
     int rplId;
+    string networkStableId;     // owning network; lets state_delta carry devices outside their network
     string callsign;
     int capabilities;
     bool isPowered;
@@ -1935,4 +2598,21 @@ class AG0_TDLMapMarkerState
     string ownerPlayerName;
     string customText;
     int colorIndex;
+}
+
+class AG0_TDLPerfStageState
+{
+    string stage;       // AG0_ETDLProfileStage name
+    int count;
+    float totalMs;
+    float p50Ms;        // over the profiler's rolling window
+    float p99Ms;
+    float maxMs;
+}
+
+class AG0_TDLPerfRpcState
+{
+    string rpc;         // AG0_ETDLRpcType name
+    int count;
+    int bytes;          // estimated payload bytes
 }
\ No newline at end of file
@@ -0,0 +1,271 @@
+//------------------------------------------------------------------------------------------------
+// AG0_TDLApiStateSync.c
+// Diff-based state_sync for the web API. AG0_TDLSystem collects a snapshot each sync interval;
+// the tracker compares it against the last snapshot the API acknowledged and emits either a full
+// keyframe ("state_sync") or only the added / changed / removed entities ("state_delta").
+// Server-side only.
+//------------------------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------------------------
+// One sync interval's worth of API state, plus a signature per entity for diffing.
+// Devices without a valid RplId have no stable key, so they only travel in keyframes.
+//------------------------------------------------------------------------------------------------
+class AG0_TDLApiStateSnapshot
+{
+	// Positions are compared at this resolution (metres) so idle jitter doesn't count as a change
+	static const float POSITION_QUANTUM = 1.0;
+
+	ref array<ref AG0_TDLNetworkState> m_aNetworks = {};
+	ref array<ref AG0_TDLMapMarkerState> m_aMarkers = {};
+	int m_iTotalDevices;
+
+	ref map<string, AG0_TDLNetworkState> m_mNetworks = new map<string, AG0_TDLNetworkState>();
+	ref map<int, AG0_TDLDeviceState> m_mDevices = new map<int, AG0_TDLDeviceState>();
+	ref map<int, AG0_TDLMapMarkerState> m_mMarkers = new map<int, AG0_TDLMapMarkerState>();
+
+	ref map<string, string> m_mNetworkSigs = new map<string, string>();
+	ref map<int, string> m_mDeviceSigs = new map<int, string>();
+	ref map<int, string> m_mMarkerSigs = new map<int, string>();
+
+	//------------------------------------------------------------------------------------------------
+	void AddNetwork(AG0_TDLNetworkState netState)
+	{
+		m_aNetworks.Insert(netState);
+		m_mNetworks.Set(netState.networkStableId, netState);
+		m_mNetworkSigs.Set(netState.networkStableId, string.Format("%1|%2|%3|%4|%5",
+			netState.networkId, netState.networkName, netState.waveform, netState.deviceCount, netState.messageCount));
+	}
+
+	//------------------------------------------------------------------------------------------------
+	void AddDevice(AG0_TDLNetworkState netState, AG0_TDLDeviceState devState)
+	{
+		netState.devices.Insert(devState);
+		if (devState.rplId == 0)
+			return;
+
+		m_mDevices.Set(devState.rplId, devState);
+		string sig = string.Format("%1|%2|%3|%4|%5|%6|%7",
+			devState.networkStableId, devState.callsign, devState.capabilities, devState.isPowered,
+			devState.playerName, devState.playerIdentityId, devState.playerPlatform);
+		sig += string.Format("|%1 %2 %3", Quantize(devState.posX), Quantize(devState.posY), Quantize(devState.posZ));
+		m_mDeviceSigs.Set(devState.rplId, sig);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	void AddMarker(AG0_TDLMapMarkerState markerState)
+	{
+		m_aMarkers.Insert(markerState);
+		m_mMarkers.Set(markerState.markerId, markerState);
+		m_mMarkerSigs.Set(markerState.markerId, string.Format("%1|%2|%3|%4|%5|%6|%7",
+			markerState.markerType, Quantize(markerState.posX), Quantize(markerState.posZ),
+			markerState.ownerPlayerId, markerState.ownerPlayerName, markerState.customText, markerState.colorIndex));
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected static int Quantize(float value)
+	{
+		return Math.Round(value / POSITION_QUANTUM);
+	}
+}
+
+//------------------------------------------------------------------------------------------------
+// Owned by AG0_TDLSystem. At most one state payload is in flight; the API's response to it
+// (AG0_TDLApiManager state-sync callback) either promotes it to the acknowledged base or
+// drops it, in which case the next delta is still taken against the older acknowledged base.
+//
+// Every payload carries "seq". Deltas also carry "baseSeq", the seq the API must have applied
+// for the delta to be valid. If it doesn't match, the API answers {"resync": true} or queues a
+// state_resync command, and the next payload is a keyframe.
+//------------------------------------------------------------------------------------------------
+class AG0_TDLApiStateTracker
+{
+	// A payload with no response after this long is treated as lost
+	protected static const int PENDING_TIMEOUT_MS = 30000;
+
+	protected int m_iKeyframeInterval;
+	protected int m_iSeq;
+	protected int m_iAckedSeq;					// 0 = the API holds nothing we can diff against
+	protected int m_iSyncsSinceKeyframe;
+	protected bool m_bKeyframeRequested = true;
+
+	// Signatures of the last acknowledged snapshot
+	protected ref map<string, string> m_mAckedNetworks = new map<string, string>();
+	protected ref map<int, string> m_mAckedDevices = new map<int, string>();
+	protected ref map<int, string> m_mAckedMarkers = new map<int, string>();
+
+	protected ref AG0_TDLApiStateSnapshot m_PendingSnapshot;
+	protected int m_iPendingSeq;
+	protected bool m_bPendingKeyframe;
+	protected int m_iPendingSinceTick;
+
+	//------------------------------------------------------------------------------------------------
+	//! @param keyframeInterval Send a full keyframe every N sync intervals, including ones skipped
+	//!        because nothing changed (1 = always full)
+	void AG0_TDLApiStateTracker(int keyframeInterval)
+	{
+		m_iKeyframeInterval = Math.Max(keyframeInterval, 1);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	bool IsAwaitingAck()
+	{
+		if (!m_PendingSnapshot)
+			return false;
+
+		if (System.GetTickCount() - m_iPendingSinceTick < PENDING_TIMEOUT_MS)
+			return true;
+
+		Print(string.Format("[TDL_API] state seq %1 never answered, dropping", m_iPendingSeq), LogLevel.DEBUG);
+		OnSyncFailed();
+		return false;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Next payload is a full keyframe (API resync request, or local state the API can't have)
+	void RequestKeyframe()
+	{
+		m_bKeyframeRequested = true;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	int GetSeq() { return m_iSeq; }
+	int GetAckedSeq() { return m_iAckedSeq; }
+
+	//------------------------------------------------------------------------------------------------
+	//! Write the state part of the payload for this snapshot and mark it in flight.
+	//! @return false if nothing changed since the acknowledged base (nothing to send)
+	bool WritePayload(SCR_JsonSaveContext json, AG0_TDLApiStateSnapshot snapshot)
+	{
+		bool keyframe = m_bKeyframeRequested || m_iAckedSeq == 0 || m_iSyncsSinceKeyframe + 1 >= m_iKeyframeInterval;
+		if (keyframe)
+		{
+			json.WriteValue("type", "state_sync");
+			json.WriteValue("seq", m_iSeq + 1);
+			json.WriteValue("keyframe", true);
+			json.WriteValue("networks", snapshot.m_aNetworks);
+			json.WriteValue("totalDevices", snapshot.m_iTotalDevices);
+			json.WriteValue("markers", snapshot.m_aMarkers);
+			m_bKeyframeRequested = false;
+		}
+		else
+		{
+			// Counted per sync interval, sent or not, so a static world still gets its keyframe
+			m_iSyncsSinceKeyframe++;
+			if (!WriteDelta(json, snapshot))
+				return false;
+		}
+
+		m_iSeq++;
+		m_PendingSnapshot = snapshot;
+		m_iPendingSeq = m_iSeq;
+		m_bPendingKeyframe = keyframe;
+		m_iPendingSinceTick = System.GetTickCount();
+		return true;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected bool WriteDelta(SCR_JsonSaveContext json, AG0_TDLApiStateSnapshot snapshot)
+	{
+		string ackedSig;
+
+		// Network entries are headers only; device changes travel in "devices"
+		array<ref AG0_TDLNetworkState> networks = {};
+		foreach (string stableId, string netSig : snapshot.m_mNetworkSigs)
+		{
+			if (m_mAckedNetworks.Find(stableId, ackedSig) && ackedSig == netSig)
+				continue;
+
+			AG0_TDLNetworkState full = snapshot.m_mNetworks.Get(stableId);
+			AG0_TDLNetworkState header = new AG0_TDLNetworkState();
+			header.networkId = full.networkId;
+			header.networkStableId = full.networkStableId;
+			header.networkName = full.networkName;
+			header.waveform = full.waveform;
+			header.deviceCount = full.deviceCount;
+			header.messageCount = full.messageCount;
+			networks.Insert(header);
+		}
+
+		array<string> networksRemoved = {};
+		foreach (string ackedStableId, string ackedNetSig : m_mAckedNetworks)
+		{
+			if (!snapshot.m_mNetworkSigs.Contains(ackedStableId))
+				networksRemoved.Insert(ackedStableId);
+		}
+
+		array<ref AG0_TDLDeviceState> devices = {};
+		foreach (int rplId, string devSig : snapshot.m_mDeviceSigs)
+		{
+			if (m_mAckedDevices.Find(rplId, ackedSig) && ackedSig == devSig)
+				continue;
+			devices.Insert(snapshot.m_mDevices.Get(rplId));
+		}
+
+		array<int> devicesRemoved = {};
+		foreach (int ackedRplId, string ackedDevSig : m_mAckedDevices)
+		{
+			if (!snapshot.m_mDeviceSigs.Contains(ackedRplId))
+				devicesRemoved.Insert(ackedRplId);
+		}
+
+		array<ref AG0_TDLMapMarkerState> markers = {};
+		foreach (int markerId, string markerSig : snapshot.m_mMarkerSigs)
+		{
+			if (m_mAckedMarkers.Find(markerId, ackedSig) && ackedSig == markerSig)
+				continue;
+			markers.Insert(snapshot.m_mMarkers.Get(markerId));
+		}
+
+		array<int> markersRemoved = {};
+		foreach (int ackedMarkerId, string ackedMarkerSig : m_mAckedMarkers)
+		{
+			if (!snapshot.m_mMarkerSigs.Contains(ackedMarkerId))
+				markersRemoved.Insert(ackedMarkerId);
+		}
+
+		if (networks.IsEmpty() && networksRemoved.IsEmpty() && devices.IsEmpty() && devicesRemoved.IsEmpty()
+			&& markers.IsEmpty() && markersRemoved.IsEmpty())
+			return false;
+
+		json.WriteValue("type", "state_delta");
+		json.WriteValue("seq", m_iSeq + 1);
+		json.WriteValue("baseSeq", m_iAckedSeq);
+		json.WriteValue("keyframe", false);
+		json.WriteValue("networks", networks);
+		json.WriteValue("networksRemoved", networksRemoved);
+		json.WriteValue("devices", devices);
+		json.WriteValue("devicesRemoved", devicesRemoved);
+		json.WriteValue("totalDevices", snapshot.m_iTotalDevices);
+		json.WriteValue("markers", markers);
+		json.WriteValue("markersRemoved", markersRemoved);
+		return true;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! The API accepted the in-flight payload: it becomes the base for the next delta
+	void OnSyncAcknowledged()
+	{
+		if (!m_PendingSnapshot)
+			return;
+
+		m_mAckedNetworks = m_PendingSnapshot.m_mNetworkSigs;
+		m_mAckedDevices = m_PendingSnapshot.m_mDeviceSigs;
+		m_mAckedMarkers = m_PendingSnapshot.m_mMarkerSigs;
+		m_iAckedSeq = m_iPendingSeq;
+
+		if (m_bPendingKeyframe)
+			m_iSyncsSinceKeyframe = 0;
+
+		m_PendingSnapshot = null;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! The in-flight payload was lost or rejected; the acknowledged base is unchanged
+	void OnSyncFailed()
+	{
+		if (m_PendingSnapshot && m_bPendingKeyframe)
+			m_bKeyframeRequested = true;
+
+		m_PendingSnapshot = null;
+	}
+}
@@ -0,0 +1,263 @@
+//------------------------------------------------------------------------------------------------
+// AG0_TDLProfiler.c
+// Server-side performance telemetry for AG0_TDLSystem: per-stage timings with rolling
+// percentiles, and RPC / byte counters per outgoing RPC type.
+// Read by the #tdlperf admin command and, when enabled in the API config, the heartbeat.
+//------------------------------------------------------------------------------------------------
+
+// Timed stages of the server tick
+enum AG0_ETDLProfileStage
+{
+	FRAME_JOBS = 0,			// Everything the tick scheduler ran in one frame
+	NETWORK_CYCLE,			// One full network update cycle, summed over the frames it spanned
+	SPATIAL,
+	NETWORK_MERGES,
+	BRIDGE_LINKS,
+	CONNECTIVITY_SETUP,
+	COMPONENT_PUBLISH,
+	CONNECTIVITY_FINISH,
+	MEMBER_POSITIONS,
+	MESSAGE_RELAY,
+	VIDEO_STREAMING,
+	API_SERIALIZE,
+	COUNT
+}
+
+// Server -> client RPC families
+enum AG0_ETDLRpcType
+{
+	CONNECTED_PLAYERS = 0,
+	MEMBER_KEYFRAME,
+	MEMBER_DELTA,
+	MEMBER_POSITIONS,
+	CLEAR_NETWORK,
+	BROADCAST_SOURCES,
+	MESSAGE_DELTA,
+	SHAPES,
+	TERRAIN_STRUCTURES,
+	TERRAIN_ROADS,
+	COUNT
+}
+
+//------------------------------------------------------------------------------------------------
+// Timings for one stage: lifetime totals plus a rolling window for percentiles
+//------------------------------------------------------------------------------------------------
+class AG0_TDLStageStats
+{
+	static const int WINDOW = 256;
+
+	protected ref array<float> m_aWindow = {};
+	protected int m_iNext;
+
+	int m_iCount;
+	float m_fTotalMs;
+	float m_fMaxMs;
+
+	//------------------------------------------------------------------------------------------------
+	void AddSample(float ms)
+	{
+		if (m_aWindow.Count() < WINDOW)
+			m_aWindow.Insert(ms);
+		else
+			m_aWindow[m_iNext] = ms;
+		m_iNext = (m_iNext + 1) % WINDOW;
+
+		m_iCount++;
+		m_fTotalMs += ms;
+		if (ms > m_fMaxMs)
+			m_fMaxMs = ms;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Nearest-rank percentile over the last WINDOW samples, fraction in 0..1
+	float GetPercentile(float fraction)
+	{
+		int count = m_aWindow.Count();
+		if (count == 0) return 0;
+
+		array<float> sorted = {};
+		sorted.Copy(m_aWindow);
+		sorted.Sort();
+
+		int rank = Math.Ceil(fraction * count) - 1;
+		return sorted[Math.ClampInt(rank, 0, count - 1)];
+	}
+
+	//------------------------------------------------------------------------------------------------
+	void Reset()
+	{
+		m_aWindow.Clear();
+		m_iNext = 0;
+		m_iCount = 0;
+		m_fTotalMs = 0;
+		m_fMaxMs = 0;
+	}
+}
+
+//------------------------------------------------------------------------------------------------
+// Scoped timer: records the time from construction to destruction against one stage.
+// Hold it in a local — it is released, and the sample recorded, when the function returns.
+//------------------------------------------------------------------------------------------------
+class AG0_TDLProfileScope
+{
+	protected AG0_TDLProfiler m_Profiler;
+	protected AG0_ETDLProfileStage m_eStage;
+	protected int m_iStartTick;
+
+	//------------------------------------------------------------------------------------------------
+	void AG0_TDLProfileScope(AG0_TDLProfiler profiler, AG0_ETDLProfileStage stage)
+	{
+		m_Profiler = profiler;
+		m_eStage = stage;
+		m_iStartTick = System.GetTickCount();
+	}
+
+	//------------------------------------------------------------------------------------------------
+	void ~AG0_TDLProfileScope()
+	{
+		if (m_Profiler)
+			m_Profiler.AddSample(m_eStage, System.GetTickCount() - m_iStartTick);
+	}
+}
+
+//------------------------------------------------------------------------------------------------
+// Owned by AG0_TDLSystem (server only). Timings use System.GetTickCount, so resolution is one
+// millisecond: a stage that is usually sub-millisecond shows a p50 of 0 and only its spikes
+// register, which is what frame-spike correlation needs.
+//------------------------------------------------------------------------------------------------
+class AG0_TDLProfiler
+{
+	protected ref array<ref AG0_TDLStageStats> m_aStages = {};
+	protected ref array<int> m_aRpcCounts = {};
+	protected ref array<int> m_aRpcBytes = {};
+	protected int m_iSinceUnixTime;
+
+	//------------------------------------------------------------------------------------------------
+	void AG0_TDLProfiler()
+	{
+		for (int i = 0; i < AG0_ETDLProfileStage.COUNT; i++)
+			m_aStages.Insert(new AG0_TDLStageStats());
+
+		m_aRpcCounts.Resize(AG0_ETDLRpcType.COUNT);
+		m_aRpcBytes.Resize(AG0_ETDLRpcType.COUNT);
+		Reset();
+	}
+
+	//------------------------------------------------------------------------------------------------
+	AG0_TDLProfileScope Scope(AG0_ETDLProfileStage stage)
+	{
+		return new AG0_TDLProfileScope(this, stage);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	void AddSample(AG0_ETDLProfileStage stage, float ms)
+	{
+		m_aStages[stage].AddSample(ms);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	void CountRpc(AG0_ETDLRpcType type, int bytes)
+	{
+		m_aRpcCounts[type] = m_aRpcCounts[type] + 1;
+		m_aRpcBytes[type] = m_aRpcBytes[type] + bytes;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Count an outgoing RPC from code that has no system reference (the PlayerController
+	//! senders). No-op where the system does not run, i.e. on clients.
+	static void RecordRpc(AG0_ETDLRpcType type, int bytes)
+	{
+		AG0_TDLSystem system = AG0_TDLSystem.GetInstance();
+		if (system)
+			system.GetProfiler().CountRpc(type, bytes);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	AG0_TDLStageStats GetStage(AG0_ETDLProfileStage stage) { return m_aStages[stage]; }
+	int GetRpcCount(AG0_ETDLRpcType type) { return m_aRpcCounts[type]; }
+	int GetRpcBytes(AG0_ETDLRpcType type) { return m_aRpcBytes[type]; }
+	int GetSinceUnixTime() { return m_iSinceUnixTime; }
+
+	//------------------------------------------------------------------------------------------------
+	void Reset()
+	{
+		foreach (AG0_TDLStageStats stats : m_aStages)
+			stats.Reset();
+
+		for (int i = 0; i < AG0_ETDLRpcType.COUNT; i++)
+		{
+			m_aRpcCounts[i] = 0;
+			m_aRpcBytes[i] = 0;
+		}
+
+		m_iSinceUnixTime = System.GetUnixTime();
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Human-readable summary for the admin command. Stages and RPC types that never ran
+	//! are left out.
+	string FormatReport(float scheduleLag, int queuedJobs, int coalescedJobs)
+	{
+		string report = string.Format("TDL perf over %1s (schedule lag %2s, %3 queued, %4 coalesced)",
+			System.GetUnixTime() - m_iSinceUnixTime, scheduleLag.ToString(-1, 2), queuedJobs, coalescedJobs);
+
+		report += "\nStage: count p50/p99/max ms";
+		for (int i = 0; i < AG0_ETDLProfileStage.COUNT; i++)
+		{
+			AG0_TDLStageStats stats = m_aStages[i];
+			if (stats.m_iCount == 0) continue;
+
+			report += string.Format("\n %1: %2 %3/%4/%5",
+				typename.EnumToString(AG0_ETDLProfileStage, i), stats.m_iCount,
+				stats.GetPercentile(0.5), stats.GetPercentile(0.99), stats.m_fMaxMs);
+		}
+
+		report += "\nRPC: count bytes";
+		for (int i = 0; i < AG0_ETDLRpcType.COUNT; i++)
+		{
+			if (m_aRpcCounts[i] == 0) continue;
+
+			report += string.Format("\n %1: %2 %3",
+				typename.EnumToString(AG0_ETDLRpcType, i), m_aRpcCounts[i], m_aRpcBytes[i]);
+		}
+
+		return report;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Append the stage and RPC tables to an API payload (heartbeat)
+	void WriteJson(SCR_JsonSaveContext json)
+	{
+		array<ref AG0_TDLPerfStageState> stageStates = {};
+		for (int i = 0; i < AG0_ETDLProfileStage.COUNT; i++)
+		{
+			AG0_TDLStageStats stats = m_aStages[i];
+			if (stats.m_iCount == 0) continue;
+
+			AG0_TDLPerfStageState stageState = new AG0_TDLPerfStageState();
+			stageState.stage = typename.EnumToString(AG0_ETDLProfileStage, i);
+			stageState.count = stats.m_iCount;
+			stageState.totalMs = stats.m_fTotalMs;
+			stageState.p50Ms = stats.GetPercentile(0.5);
+			stageState.p99Ms = stats.GetPercentile(0.99);
+			stageState.maxMs = stats.m_fMaxMs;
+			stageStates.Insert(stageState);
+		}
+
+		array<ref AG0_TDLPerfRpcState> rpcStates = {};
+		for (int i = 0; i < AG0_ETDLRpcType.COUNT; i++)
+		{
+			if (m_aRpcCounts[i] == 0) continue;
+
+			AG0_TDLPerfRpcState rpcState = new AG0_TDLPerfRpcState();
+			rpcState.rpc = typename.EnumToString(AG0_ETDLRpcType, i);
+			rpcState.count = m_aRpcCounts[i];
+			rpcState.bytes = m_aRpcBytes[i];
+			rpcStates.Insert(rpcState);
+		}
+
+		json.WriteValue("perfSince", m_iSinceUnixTime);
+		json.WriteValue("perfStages", stageStates);
+		json.WriteValue("perfRpcs", rpcStates);
+	}
+}
@@ -1,5 +1,29 @@
 // AG0_TDLSystem.c - Device-Centric TDL Network Management
 
+//------------------------------------------------------------------------------------------------
+// Periodic server work queued by OnUpdatePoint timers and run by the budgeted tick scheduler
+//------------------------------------------------------------------------------------------------
+enum AG0_ETDLTickJob
+{
+	NETWORK_CYCLE = 0,
+	MEMBER_POSITIONS,
+	API_HEARTBEAT,
+	API_STATE_SYNC,
+	API_SHAPES_POLL
+}
+
+//------------------------------------------------------------------------------------------------
+// Stages of one resumable network update cycle (see AG0_TDLSystem.StepNetworkCycle)
+//------------------------------------------------------------------------------------------------
+enum AG0_ETDLNetworkCycleStage
+{
+	SPATIAL = 0,
+	MERGES,
+	BRIDGES,
+	CONNECTIVITY,
+	VIDEO
+}
+
 //------------------------------------------------------------------------------------------------
 // Bridge link between two networks with incompatible waveforms.
 // Registered each update cycle by UpdateBridgeLinks() and consumed by
@@ -31,6 +55,398 @@ class AG0_TDLBridgeLink
     }
 }
 
+//------------------------------------------------------------------------------------------------
+// Persistent mesh-graph vertex for one device in an AG0_TDLNetwork.
+// Remembers the inputs its edges were last evaluated against (position, range, power) so
+// UpdateMeshEdges() only re-tests links for devices whose inputs actually changed, and the
+// member snapshot last published so unchanged components skip NotifyNetworkConnectivity.
+//------------------------------------------------------------------------------------------------
+class AG0_TDLMeshNode
+{
+    AG0_TDLDeviceComponent m_Device;
+    ref array<AG0_TDLDeviceComponent> m_aNeighbours = {};
+
+    // Edge inputs as of the last evaluation
+    vector m_vEvaluatedPos;
+    float m_fEvaluatedRange = -1;
+    bool m_bEvaluatedPowered;
+    bool m_bNeedsEdgeEval = true;
+
+    // Set when an edge touching this node was added or removed since the last publish
+    bool m_bTopologyChanged = true;
+
+    // Member snapshot last sent to clients for this device
+    ref AG0_TDLNetworkMember m_LastPublished;
+
+    // Fast-path position update state for this device
+    ref AG0_TDLPositionTrack m_Track = new AG0_TDLPositionTrack();
+
+    void AG0_TDLMeshNode(AG0_TDLDeviceComponent device)
+    {
+        m_Device = device;
+    }
+
+    bool CanLink() { return m_fEvaluatedRange > 0; }
+}
+
+//------------------------------------------------------------------------------------------------
+// Kinematic state behind a member's fast-path position updates. Mirrors what clients
+// extrapolate from (last sent position and velocity), so the server knows how far their
+// dead-reckoned estimate has drifted and how urgently a fresh sample is needed.
+//------------------------------------------------------------------------------------------------
+class AG0_TDLPositionTrack
+{
+    // Client-side drift (metres) at which a member is due regardless of its interval
+    static const float ERROR_TOLERANCE = 10.0;
+    static const float MIN_INTERVAL = 1.0;
+    static const float MAX_INTERVAL = 30.0;
+    // Velocity change (m/s) against the last sent sample that counts as manoeuvring,
+    // and how long a manoeuvring member is held at the fastest rate
+    static const float MANOEUVRE_THRESHOLD = 3.0;
+    static const float MANOEUVRE_HOLD = 10.0;
+    // Faster than this between samples is a teleport, not motion
+    static const float MAX_PLAUSIBLE_SPEED = 400.0;
+
+    vector m_vSamplePos;
+    vector m_vVelocity;
+    float m_fSampleTime = -1;
+
+    vector m_vSentPos;
+    vector m_vSentVelocity;
+    float m_fSentTime = -1;
+    float m_fManoeuvreUntil = -1;
+
+    void Sample(vector pos, float now)
+    {
+        if (m_fSampleTime >= 0 && now > m_fSampleTime)
+        {
+            vector velocity = (pos - m_vSamplePos) * (1.0 / (now - m_fSampleTime));
+            if (velocity.Length() > MAX_PLAUSIBLE_SPEED)
+                velocity = vector.Zero;
+
+            if (vector.Distance(velocity, m_vSentVelocity) > MANOEUVRE_THRESHOLD)
+                m_fManoeuvreUntil = now + MANOEUVRE_HOLD;
+
+            m_vVelocity = velocity;
+        }
+
+        m_vSamplePos = pos;
+        m_fSampleTime = now;
+    }
+
+    // Where clients currently believe this member is
+    vector Predict(float now)
+    {
+        float elapsed = Math.Clamp(now - m_fSentTime, 0, AG0_TDLNetworkMember.MAX_EXTRAPOLATION_MS / 1000.0);
+        return m_vSentPos + m_vSentVelocity * elapsed;
+    }
+
+    // Fast movers and manoeuvring members refresh every MIN_INTERVAL; slower ones stretch
+    // towards MAX_INTERVAL as the distance they cover per interval shrinks
+    float GetInterval(float now)
+    {
+        if (now < m_fManoeuvreUntil) return MIN_INTERVAL;
+
+        float speed = m_vVelocity.Length();
+        if (speed < 0.01) return MAX_INTERVAL;
+        return Math.Clamp(ERROR_TOLERANCE / speed, MIN_INTERVAL, MAX_INTERVAL);
+    }
+
+    // 0 when not due; otherwise grows with client-side drift and with how overdue it is
+    float GetPriority(float now)
+    {
+        // Never published: the member list has to introduce it first
+        if (m_fSentTime < 0) return 0;
+
+        float age = now - m_fSentTime;
+        if (age < MIN_INTERVAL) return 0;
+
+        float error = vector.Distance(m_vSamplePos, Predict(now));
+        float interval = GetInterval(now);
+        if (age < interval && error < ERROR_TOLERANCE) return 0;
+
+        return error / ERROR_TOLERANCE + age / interval;
+    }
+
+    void OnSampleSent(float now)
+    {
+        m_vSentPos = m_vSamplePos;
+        m_vSentVelocity = m_vVelocity;
+        m_fSentTime = now;
+    }
+
+    // A member list carried this position; clients re-anchor on it and keep their velocity
+    void OnPositionPublished(vector pos, float now)
+    {
+        m_vSentPos = pos;
+        m_fSentTime = now;
+    }
+}
+
+//------------------------------------------------------------------------------------------------
+// One network's connectivity update in progress. Components are published one at a time, and
+// a component's per-viewer fan-out is resumable, so the scheduled tick can spread a large
+// network (or one large component) over several frames.
+//------------------------------------------------------------------------------------------------
+class AG0_TDLConnectivityPass
+{
+    AG0_TDLNetwork m_Network;
+    ref array<ref array<AG0_TDLDeviceComponent>> m_aComponents = {};
+    ref map<RplId, ref AG0_TDLNetworkMember> m_mBridgedMembers = new map<RplId, ref AG0_TDLNetworkMember>();
+    // Keyframe tick or changed bridged set: every component re-publishes
+    bool m_bForceAll;
+    bool m_bAnyPublished;
+    bool m_bComponentSkipped;
+    float m_fNow;
+    protected int m_iNextComponent;
+
+    // Component whose fan-out is in progress (see AG0_TDLSystem.StepPublishViewers): the
+    // per-member snapshots and ranges resolved once, and the next viewer to notify
+    ref array<AG0_TDLDeviceComponent> m_aPublishComponent;
+    ref array<ref AG0_TDLNetworkMember> m_aPublishSnapshots;
+    ref array<float> m_aPublishRanges;
+    int m_iNextViewer;
+
+    void AG0_TDLConnectivityPass(AG0_TDLNetwork network)
+    {
+        m_Network = network;
+    }
+
+    bool IsPublishing() { return m_aPublishComponent != null; }
+
+    void BeginPublish(array<AG0_TDLDeviceComponent> component, array<ref AG0_TDLNetworkMember> snapshots, array<float> ranges)
+    {
+        m_aPublishComponent = component;
+        m_aPublishSnapshots = snapshots;
+        m_aPublishRanges = ranges;
+        m_iNextViewer = 0;
+    }
+
+    void EndPublish()
+    {
+        m_aPublishComponent = null;
+        m_aPublishSnapshots = null;
+        m_aPublishRanges = null;
+    }
+
+    bool HasNextComponent() { return m_iNextComponent < m_aComponents.Count(); }
+
+    array<AG0_TDLDeviceComponent> NextComponent()
+    {
+        m_iNextComponent++;
+        return m_aComponents[m_iNextComponent - 1];
+    }
+}
+
+//------------------------------------------------------------------------------------------------
+// 2D spatial hash over registered devices, keyed by packed integer cell coordinates.
+// Altitude is ignored for bucketing — terrain relief is small next to radio range, and
+// AreDevicesConnected still tests the full 3D distance. Devices are inserted, moved and
+// removed incrementally; Query fills a caller-owned array so hot paths reuse one buffer.
+//------------------------------------------------------------------------------------------------
+class AG0_TDLSpatialHash
+{
+    protected float m_fCellSize = 2000.0;
+    protected ref map<int, ref array<AG0_TDLDeviceComponent>> m_mCells = new map<int, ref array<AG0_TDLDeviceComponent>>();
+    protected ref map<AG0_TDLDeviceComponent, int> m_mDeviceCell = new map<AG0_TDLDeviceComponent, int>();
+
+    float GetCellSize() { return m_fCellSize; }
+    int GetDeviceCount() { return m_mDeviceCell.Count(); }
+
+    //------------------------------------------------------------------------------------------------
+    // Pack a cell coordinate pair into one key, 16 bits per axis. Cells are at least a few
+    // hundred metres wide, so +/-32k cells per axis covers any Reforger terrain.
+    //------------------------------------------------------------------------------------------------
+    static int PackCellKey(int cellX, int cellZ)
+    {
+        return ((cellX & 0xFFFF) << 16) | (cellZ & 0xFFFF);
+    }
+
+    int GetCellKey(vector pos)
+    {
+        int cellX = Math.Floor(pos[0] / m_fCellSize);
+        int cellZ = Math.Floor(pos[2] / m_fCellSize);
+        return PackCellKey(cellX, cellZ);
+    }
+
+    void Insert(AG0_TDLDeviceComponent device, vector pos)
+    {
+        Move(device, pos);
+    }
+
+    void Remove(AG0_TDLDeviceComponent device)
+    {
+        int key;
+        if (!m_mDeviceCell.Find(device, key)) return;
+
+        RemoveFromCell(device, key);
+        m_mDeviceCell.Remove(device);
+    }
+
+    //------------------------------------------------------------------------------------------------
+    // Re-bucket a device at its new position. Inserts it if unknown. Returns true if the
+    // device changed cell (or was inserted).
+    //------------------------------------------------------------------------------------------------
+    bool Move(AG0_TDLDeviceComponent device, vector pos)
+    {
+        int key = GetCellKey(pos);
+        int previousKey;
+        if (m_mDeviceCell.Find(device, previousKey))
+        {
+            if (previousKey == key) return false;
+            RemoveFromCell(device, previousKey);
+        }
+
+        array<AG0_TDLDeviceComponent> cell = m_mCells.Get(key);
+        if (!cell)
+        {
+            cell = new array<AG0_TDLDeviceComponent>();
+            m_mCells.Set(key, cell);
+        }
+        cell.Insert(device);
+        m_mDeviceCell.Set(device, key);
+        return true;
+    }
+
+    //------------------------------------------------------------------------------------------------
+    // Change the cell size and re-bucket every device at its current origin. Only needed when
+    // the maximum device range shifts enough to warrant a different cell size.
+    //------------------------------------------------------------------------------------------------
+    void Rebuild(float cellSize, array<AG0_TDLDeviceComponent> devices)
+    {
+        m_fCellSize = Math.Max(cellSize, 1.0);
+        m_mCells.Clear();
+        m_mDeviceCell.Clear();
+
+        foreach (AG0_TDLDeviceComponent device : devices)
+        {
+            IEntity owner = device.GetOwner();
+            if (owner)
+                Move(device, owner.GetOrigin());
+        }
+    }
+
+    //------------------------------------------------------------------------------------------------
+    // Collect every device bucketed in a cell overlapping the XZ square [pos - radius, pos + radius]
+    // into outDevices (cleared first). Candidates only — callers still apply their exact range test.
+    //------------------------------------------------------------------------------------------------
+    int Query(vector pos, float radius, notnull array<AG0_TDLDeviceComponent> outDevices)
+    {
+        outDevices.Clear();
+
+        int minX = Math.Floor((pos[0] - radius) / m_fCellSize);
+        int maxX = Math.Floor((pos[0] + radius) / m_fCellSize);
+        int minZ = Math.Floor((pos[2] - radius) / m_fCellSize);
+        int maxZ = Math.Floor((pos[2] + radius) / m_fCellSize);
+
+        for (int cellX = minX; cellX <= maxX; cellX++)
+        {
+            for (int cellZ = minZ; cellZ <= maxZ; cellZ++)
+            {
+                array<AG0_TDLDeviceComponent> cell = m_mCells.Get(PackCellKey(cellX, cellZ));
+                if (!cell) continue;
+
+                foreach (AG0_TDLDeviceComponent device : cell)
+                    outDevices.Insert(device);
+            }
+        }
+
+        return outDevices.Count();
+    }
+
+    protected void RemoveFromCell(AG0_TDLDeviceComponent device, int key)
+    {
+        array<AG0_TDLDeviceComponent> cell = m_mCells.Get(key);
+        if (!cell) return;
+
+        cell.RemoveItem(device);
+        if (cell.IsEmpty())
+            m_mCells.Remove(key);
+    }
+}
+
+//------------------------------------------------------------------------------------------------
+// Server-side cache of one player's TDL devices and the values the tick derives from them.
+// The device list is re-collected only after an inventory change on the player's storage
+// manager, a respawn, or ROSTER_MAX_AGE_MS as a backstop; the capability mask and video
+// source are recomputed after a power or broadcast change on one of the listed devices.
+//------------------------------------------------------------------------------------------------
+class AG0_TDLPlayerRoster
+{
+    int m_iPlayerId;
+    IEntity m_Player;
+    ref array<AG0_TDLDeviceComponent> m_aDevices = {};
+    int m_iAggregatedCaps;
+    RplId m_VideoSourceRplId = RplId.Invalid();
+    int m_iCollectedAtMs;
+    bool m_bDevicesDirty = true;
+    bool m_bStateDirty = true;
+
+    protected SCR_InventoryStorageManagerComponent m_Storage;
+
+    void AG0_TDLPlayerRoster(int playerId)
+    {
+        m_iPlayerId = playerId;
+    }
+
+    void ~AG0_TDLPlayerRoster()
+    {
+        Unsubscribe();
+    }
+
+    //------------------------------------------------------------------------------------------------
+    // Point the roster at the player's current controlled entity and listen for its inventory changes.
+    //------------------------------------------------------------------------------------------------
+    void Bind(IEntity player)
+    {
+        Unsubscribe();
+        m_Player = player;
+        m_bDevicesDirty = true;
+        if (!player) return;
+
+        m_Storage = SCR_InventoryStorageManagerComponent.Cast(player.FindComponent(SCR_InventoryStorageManagerComponent));
+        if (m_Storage)
+        {
+            m_Storage.m_OnItemAddedInvoker.Insert(OnInventoryChanged);
+            m_Storage.m_OnItemRemovedInvoker.Insert(OnInventoryChanged);
+        }
+    }
+
+    void Unsubscribe()
+    {
+        if (!m_Storage) return;
+
+        m_Storage.m_OnItemAddedInvoker.Remove(OnInventoryChanged);
+        m_Storage.m_OnItemRemovedInvoker.Remove(OnInventoryChanged);
+        m_Storage = null;
+    }
+
+    void OnInventoryChanged(IEntity item, BaseInventoryStorageComponent storage)
+    {
+        m_bDevicesDirty = true;
+    }
+
+    //------------------------------------------------------------------------------------------------
+    // Recompute the aggregated capability mask and broadcasting video source from the cached list.
+    //------------------------------------------------------------------------------------------------
+    void RefreshState()
+    {
+        m_iAggregatedCaps = 0;
+        m_VideoSourceRplId = RplId.Invalid();
+
+        foreach (AG0_TDLDeviceComponent device : m_aDevices)
+        {
+            if (!device) continue;
+
+            if (device.IsCameraBroadcasting() && device.HasCapability(AG0_ETDLDeviceCapability.VIDEO_SOURCE))
+                m_VideoSourceRplId = device.GetDeviceRplId();
+            if (device.IsPowered())
+                m_iAggregatedCaps |= device.GetActiveCapabilities();
+        }
+        m_bStateDirty = false;
+    }
+}
+
 class AG0_TDLNetwork
 {
     protected int m_iNetworkID;
@@ -67,6 +483,21 @@ class AG0_TDLNetwork
     protected const int MAX_MESSAGES = 100;
     protected const int MESSAGE_EXPIRY_SECONDS = 3600;
 
+    // Persistent mesh adjacency, maintained incrementally by AG0_TDLSystem.UpdateMeshEdges()
+    protected ref map<AG0_TDLDeviceComponent, ref AG0_TDLMeshNode> m_mMeshNodes = new map<AG0_TDLDeviceComponent, ref AG0_TDLMeshNode>();
+    protected int m_iConnectivityTicks = 0;
+    protected ref map<RplId, ref AG0_TDLNetworkMember> m_mLastBridgedMembers = new map<RplId, ref AG0_TDLNetworkMember>();
+
+    // Connectivity components from the last UpdateNetworkConnectivity() pass, and the
+    // messages that still have undelivered recipients (see AG0_TDLMessage.AddPendingRecipient)
+    protected ref array<ref array<AG0_TDLDeviceComponent>> m_aComponents = {};
+    protected ref map<AG0_TDLDeviceComponent, int> m_mComponentIndex = new map<AG0_TDLDeviceComponent, int>();
+    protected ref array<ref AG0_TDLMessage> m_aPendingMessages = {};
+
+    // What each player's client holds of the message log, keyed by player ID, then viewer device
+    protected ref map<int, ref map<RplId, ref AG0_TDLMessageSyncCursor>> m_mMessageCursors = new map<int, ref map<RplId, ref AG0_TDLMessageSyncCursor>>();
+    // Member list keyframe/delta state per player, keyed by player ID
+    protected ref map<int, ref AG0_TDLMemberSyncCursor> m_mMemberCursors = new map<int, ref AG0_TDLMemberSyncCursor>();
 
     void AG0_TDLNetwork(int networkID, string name, string password, int waveform = AG0_ETDLWaveform.LEGACY)
     {
@@ -105,9 +536,17 @@ class AG0_TDLNetwork
 			memberData.SetOwnerPlayerId(ownerPlayerId);
             
             m_mDeviceData.Set(deviceRplId, memberData);
+            m_mMeshNodes.Set(device, new AG0_TDLMeshNode(device));
+
+            // A joining device is owed every retained broadcast (and any direct message to it)
+            foreach (AG0_TDLMessage msg : m_aMessages)
+            {
+                if (msg.AddPendingRecipient(deviceRplId) && !m_aPendingMessages.Contains(msg))
+                    m_aPendingMessages.Insert(msg);
+            }
         }
     }
-    
+
     void RemoveDevice(AG0_TDLDeviceComponent device)
     {
         int idx = m_aNetworkDevices.Find(device);
@@ -116,9 +555,225 @@ class AG0_TDLNetwork
             RplId deviceRplId = device.GetDeviceRplId();
             if (deviceRplId != RplId.Invalid())
                 m_mDeviceData.Remove(deviceRplId);
-            
+
             m_aNetworkDevices.Remove(idx);
+
+            AG0_TDLMeshNode node = m_mMeshNodes.Get(device);
+            if (node)
+            {
+                SetMeshNeighbours(node, new array<AG0_TDLDeviceComponent>());
+                m_mMeshNodes.Remove(device);
+            }
+
+            foreach (AG0_TDLMessage msg : m_aPendingMessages)
+            {
+                msg.RemovePendingRecipient(deviceRplId);
+            }
+        }
+    }
+
+    //------------------------------------------------------------------------------------------------
+    // Connectivity components
+    //------------------------------------------------------------------------------------------------
+    void SetComponents(array<ref array<AG0_TDLDeviceComponent>> components)
+    {
+        m_aComponents = components;
+        m_mComponentIndex.Clear();
+        foreach (int index, array<AG0_TDLDeviceComponent> component : components)
+        {
+            foreach (AG0_TDLDeviceComponent device : component)
+                m_mComponentIndex.Set(device, index);
+        }
+    }
+
+    array<AG0_TDLDeviceComponent> GetComponentOf(AG0_TDLDeviceComponent device)
+    {
+        int index;
+        if (!m_mComponentIndex.Find(device, index)) return null;
+        return m_aComponents[index];
+    }
+
+    bool AreInSameComponent(AG0_TDLDeviceComponent a, AG0_TDLDeviceComponent b)
+    {
+        int indexA, indexB;
+        if (!m_mComponentIndex.Find(a, indexA) || !m_mComponentIndex.Find(b, indexB)) return false;
+        return indexA == indexB;
+    }
+
+    //------------------------------------------------------------------------------------------------
+    // Seed a new message's undelivered set from the current membership
+    //------------------------------------------------------------------------------------------------
+    void TrackPendingMessage(AG0_TDLMessage msg)
+    {
+        if (msg.GetMessageType() == ETDLMessageType.DIRECT)
+        {
+            if (m_mDeviceData.Contains(msg.GetDirectRecipientRplId()))
+                msg.AddPendingRecipient(msg.GetDirectRecipientRplId());
+        }
+        else
+        {
+            foreach (AG0_TDLDeviceComponent device : m_aNetworkDevices)
+                msg.AddPendingRecipient(device.GetDeviceRplId());
+        }
+
+        if (msg.HasPendingRecipients())
+            m_aPendingMessages.Insert(msg);
+    }
+
+    //------------------------------------------------------------------------------------------------
+    // Stop tracking messages that were delivered everywhere or pruned from retention
+    //------------------------------------------------------------------------------------------------
+    void PrunePendingMessages()
+    {
+        for (int i = m_aPendingMessages.Count() - 1; i >= 0; i--)
+        {
+            AG0_TDLMessage msg = m_aPendingMessages[i];
+            if (!msg.HasPendingRecipients() || !m_aMessages.Contains(msg))
+                m_aPendingMessages.Remove(i);
+        }
+    }
+
+    array<ref AG0_TDLMessage> GetPendingMessages() { return m_aPendingMessages; }
+
+    AG0_TDLMessageSyncCursor GetMessageSyncCursor(int playerId, RplId viewerRplId)
+    {
+        map<RplId, ref AG0_TDLMessageSyncCursor> playerCursors = m_mMessageCursors.Get(playerId);
+        if (!playerCursors)
+        {
+            playerCursors = new map<RplId, ref AG0_TDLMessageSyncCursor>();
+            m_mMessageCursors.Set(playerId, playerCursors);
+        }
+
+        AG0_TDLMessageSyncCursor cursor = playerCursors.Get(viewerRplId);
+        if (!cursor)
+        {
+            cursor = new AG0_TDLMessageSyncCursor();
+            playerCursors.Set(viewerRplId, cursor);
+        }
+        return cursor;
+    }
+
+    AG0_TDLMessageSyncCursor FindMessageSyncCursor(int playerId, RplId viewerRplId)
+    {
+        map<RplId, ref AG0_TDLMessageSyncCursor> playerCursors = m_mMessageCursors.Get(playerId);
+        if (!playerCursors)
+            return null;
+        return playerCursors.Get(viewerRplId);
+    }
+
+    AG0_TDLMemberSyncCursor GetMemberSyncCursor(int playerId)
+    {
+        AG0_TDLMemberSyncCursor cursor = m_mMemberCursors.Get(playerId);
+        if (!cursor)
+        {
+            cursor = new AG0_TDLMemberSyncCursor();
+            m_mMemberCursors.Set(playerId, cursor);
+        }
+        return cursor;
+    }
+
+    AG0_TDLMemberSyncCursor FindMemberSyncCursor(int playerId) { return m_mMemberCursors.Get(playerId); }
+
+    //! Drop a player's sync state (disconnect); a returning player starts from base 0
+    void RemovePlayerSyncCursors(int playerId)
+    {
+        m_mMessageCursors.Remove(playerId);
+        m_mMemberCursors.Remove(playerId);
+    }
+
+    //------------------------------------------------------------------------------------------------
+    // Mesh graph
+    //------------------------------------------------------------------------------------------------
+    AG0_TDLMeshNode GetMeshNode(AG0_TDLDeviceComponent device) { return m_mMeshNodes.Get(device); }
+    map<AG0_TDLDeviceComponent, ref AG0_TDLMeshNode> GetMeshNodes() { return m_mMeshNodes; }
+
+    //------------------------------------------------------------------------------------------------
+    // Replace a node's edge list, keeping the reverse edges symmetric. Both endpoints of
+    // every edge that actually appears or disappears are flagged m_bTopologyChanged so the
+    // components they belong to get re-published.
+    //------------------------------------------------------------------------------------------------
+    void SetMeshNeighbours(AG0_TDLMeshNode node, array<AG0_TDLDeviceComponent> neighbours)
+    {
+        for (int i = node.m_aNeighbours.Count() - 1; i >= 0; i--)
+        {
+            AG0_TDLDeviceComponent previous = node.m_aNeighbours[i];
+            if (neighbours.Contains(previous)) continue;
+
+            node.m_aNeighbours.Remove(i);
+            node.m_bTopologyChanged = true;
+
+            AG0_TDLMeshNode previousNode = m_mMeshNodes.Get(previous);
+            if (previousNode)
+            {
+                previousNode.m_aNeighbours.RemoveItem(node.m_Device);
+                previousNode.m_bTopologyChanged = true;
+            }
+        }
+
+        foreach (AG0_TDLDeviceComponent neighbour : neighbours)
+        {
+            if (neighbour == node.m_Device || node.m_aNeighbours.Contains(neighbour)) continue;
+
+            AG0_TDLMeshNode neighbourNode = m_mMeshNodes.Get(neighbour);
+            if (!neighbourNode) continue;
+
+            node.m_aNeighbours.Insert(neighbour);
+            node.m_bTopologyChanged = true;
+
+            if (!neighbourNode.m_aNeighbours.Contains(node.m_Device))
+                neighbourNode.m_aNeighbours.Insert(node.m_Device);
+            neighbourNode.m_bTopologyChanged = true;
+        }
+    }
+
+    //------------------------------------------------------------------------------------------------
+    // Clear per-tick topology flags once every dirty component has been published
+    //------------------------------------------------------------------------------------------------
+    void ClearMeshTopologyFlags()
+    {
+        foreach (AG0_TDLDeviceComponent device, AG0_TDLMeshNode node : m_mMeshNodes)
+        {
+            node.m_bTopologyChanged = false;
+        }
+    }
+
+    //------------------------------------------------------------------------------------------------
+    // Advance the connectivity tick counter. Returns true on keyframe ticks (the first tick
+    // and every `interval` ticks after), when every component is re-published regardless
+    // of dirtiness as a safety net against missed change detection.
+    //------------------------------------------------------------------------------------------------
+    bool AdvanceConnectivityTick(int interval)
+    {
+        bool keyframe = (m_iConnectivityTicks % interval) == 0;
+        m_iConnectivityTicks++;
+        return keyframe;
+    }
+
+    //------------------------------------------------------------------------------------------------
+    // Store this tick's bridged member set; returns true if it differs from the last one
+    //------------------------------------------------------------------------------------------------
+    bool SetLastBridgedMembers(map<RplId, ref AG0_TDLNetworkMember> bridgedMembers, float positionTolerance)
+    {
+        bool changed = bridgedMembers.Count() != m_mLastBridgedMembers.Count();
+        if (!changed)
+        {
+            foreach (RplId rplId, AG0_TDLNetworkMember member : bridgedMembers)
+            {
+                if (!member.IsEquivalentTo(m_mLastBridgedMembers.Get(rplId), positionTolerance))
+                {
+                    changed = true;
+                    break;
+                }
+            }
+        }
+
+        if (changed)
+        {
+            m_mLastBridgedMembers.Clear();
+            foreach (RplId rplId, AG0_TDLNetworkMember member : bridgedMembers)
+                m_mLastBridgedMembers.Set(rplId, member);
         }
+        return changed;
     }
     
     void UpdateDevicePosition(RplId deviceRplId, vector position)
@@ -158,9 +813,11 @@ class AG0_TDLNetwork
         
         messages.Insert(msg);
         nextMessageId++;
+        network.TrackPendingMessage(msg);
         
         // Prune old messages if over limit
         PruneMessages(messages);
+        network.PrunePendingMessages();
         
         Print(string.Format("TDL_MESSAGE: Broadcast message %1 added from %2: '%3'", 
             msg.GetMessageId(), senderCallsign, content), LogLevel.DEBUG);
@@ -188,9 +845,11 @@ class AG0_TDLNetwork
         
         messages.Insert(msg);
         nextMessageId++;
+        network.TrackPendingMessage(msg);
         
         // Prune old messages if over limit
         PruneMessages(messages);
+        network.PrunePendingMessages();
         
         Print(string.Format("TDL_MESSAGE: Direct message %1 added from %2 to %3: '%4'", 
             msg.GetMessageId(), senderCallsign, recipientCallsign, content), LogLevel.DEBUG);
@@ -320,12 +979,18 @@ class AG0_TDLSystem : WorldSystem
 	protected float m_fApiStateSyncInterval = 5.0;
 	protected float m_fTimeSinceApiHeartbeat = 0;
 	protected float m_fTimeSinceApiStateSync = 0;
+	// Outbox ranks for events that coalesce per message recipient
+	protected const int API_EVENT_RANK_DELIVERED = 1;
+	protected const int API_EVENT_RANK_READ = 2;
+	// Last state the API acknowledged; state syncs are deltas against it
+	protected ref AG0_TDLApiStateTracker m_ApiStateTracker;
 	protected const float API_SHAPES_POLL_INTERVAL = 5.0;
     protected float m_fTimeSinceShapesPoll = 0;
 
-	// Lazy-registered handler for SCR_BaseGameMode.GetOnPlayerAuditSuccess.
-	// Used to deliver the terrain structures dataset to every player on session join,
+	// Lazy-registered handlers for SCR_BaseGameMode.GetOnPlayerAuditSuccess / GetOnPlayerDisconnected.
+	// Audit success delivers the terrain structures dataset to every player on session join,
 	// independent of TDL network membership — so the data is always there/available.
+	// Disconnect drops the player's per-network sync cursors.
 	protected bool m_bPlayerAuditHandlerRegistered = false;
 	
 
@@ -334,7 +999,7 @@ class AG0_TDLSystem : WorldSystem
     protected ref array<ref AG0_TDLNetwork> m_aNetworks = {};
     protected int m_iNextNetworkID = 1;
     
-    // Active bridge links — rebuilt every UpdateNetworks() cycle
+    // Active bridge links — rebuilt every network update cycle
     protected ref array<ref AG0_TDLBridgeLink> m_aBridgeLinks = {};
     
     // Configuration
@@ -354,12 +1019,60 @@ class AG0_TDLSystem : WorldSystem
 	protected ref map<RplId, AG0_TDLDeviceComponent> m_mDeviceCache = new map<RplId, AG0_TDLDeviceComponent>();
     
     protected float m_fGridCellSize = 2000.0;
-    protected ref map<string, ref array<AG0_TDLDeviceComponent>> m_mSpatialGrid = new map<string, ref array<AG0_TDLDeviceComponent>>();
-    protected float m_fTimeSinceGridRebuild = 999.0;
-    protected float m_fGridRebuildInterval = 5.0;
+    protected ref AG0_TDLSpatialHash m_SpatialHash = new AG0_TDLSpatialHash();
+    // Reused candidate buffer for GetNearbyDevices on the tick path
+    protected ref array<AG0_TDLDeviceComponent> m_aNearbyScratch = {};
+
+    // Per-player device rosters, keyed by player ID; see AG0_TDLPlayerRoster
+    protected ref map<int, ref AG0_TDLPlayerRoster> m_mPlayerRosters = new map<int, ref AG0_TDLPlayerRoster>();
+    protected ref map<AG0_TDLDeviceComponent, AG0_TDLPlayerRoster> m_mDeviceRosters = new map<AG0_TDLDeviceComponent, AG0_TDLPlayerRoster>();
+    // Backstop only (events cover inventory changes and respawns); well above the 5 s tick so
+    // a re-collect is the exception rather than every other pass
+    protected const int ROSTER_MAX_AGE_MS = 60000;
 	protected float m_fMaxDeviceRange = 1000.0;
 	protected bool m_bCellSizeNeedsUpdate = false;
 
+	// Incremental mesh maintenance — a device's edges are only re-tested once it has moved
+	// further than this since its last evaluation (or its range/power changed)
+	protected float m_fMeshMoveThreshold = 10.0;
+	// Published member positions closer than this to the last publish count as unchanged
+	protected const float MESH_PUBLISH_POSITION_TOLERANCE = 1.0;
+	// Every Nth connectivity tick re-publishes all components regardless of dirtiness
+	protected const int CONNECTIVITY_KEYFRAME_TICKS = 12;
+
+	// Fast-path member positions between connectivity ticks; see UpdateMemberPositions.
+	// The byte budget is server-wide and read from the API config when available.
+	protected const float POSITION_TICK_INTERVAL = 1.0;
+	protected float m_fTimeSincePositionTick = 0;
+	protected float m_fLastPositionUpdate = -1;
+	protected int m_iPositionBudgetBytesPerSec = 8192;
+	protected float m_fPositionBudgetBytes = 0;
+
+	// Terrain dataset delivery, streamed per frame under its own server-wide byte budget;
+	// see AG0_TDLTerrainTransfer and StepTerrainTransfers
+	protected ref array<ref AG0_TDLTerrainTransfer> m_aTerrainTransfers = {};
+	protected int m_iTerrainTransferCursor = 0;
+	protected int m_iTerrainBudgetBytesPerSec = 32768;
+	protected float m_fTerrainBudgetBytes = 0;
+
+	// Budgeted tick scheduler. Timers only queue jobs; RunScheduledJobs works through the
+	// queue until the per-frame budget is spent, so periodic work never lands on one frame.
+	protected int m_iTickBudgetMs = 3;
+	protected ref array<AG0_ETDLTickJob> m_aJobQueue = {};
+	protected ref array<float> m_aJobDueTimes = {};
+	protected int m_iCoalescedJobs = 0;
+	// CPU time spent so far on the network cycle in progress, across frames
+	protected int m_iCycleCpuMs = 0;
+
+	// Stage timings and RPC counters; see AG0_TDLProfiler
+	protected ref AG0_TDLProfiler m_Profiler = new AG0_TDLProfiler();
+
+	// Network update cycle in progress, advanced one unit per StepNetworkCycle call
+	protected AG0_ETDLNetworkCycleStage m_eCycleStage = AG0_ETDLNetworkCycleStage.SPATIAL;
+	protected ref array<AG0_TDLNetwork> m_aCycleNetworks = {};
+	protected int m_iCycleNetworkIndex = 0;
+	protected ref AG0_TDLConnectivityPass m_CyclePass;
+
 	
     //------------------------------------------------------------------------------------------------
     override static void InitInfo(WorldSystemInfo outInfo)
@@ -547,7 +1260,7 @@ class AG0_TDLSystem : WorldSystem
 	}
 
 	//------------------------------------------------------------------------------------------------
-	//! Drains the (messageId, deviceRplId) pairs collected during PropagateMessagesInNetwork
+	//! Drains the (messageId, deviceRplId) pairs collected during RelayMessagesInComponent
 	//! and fires one API delivery event per pair whose recipient is web-linked. Identity
 	//! resolution is cached by deviceRplId across the batch so each device costs at most one
 	//! SCR_PlayerIdentityUtils lookup, no matter how many messages targeted it.
@@ -618,12 +1331,28 @@ class AG0_TDLSystem : WorldSystem
 	    ApiNotifyMessageSendFailed(correlationId, reason, networkId, networkStableId);
 	}
 
+	//------------------------------------------------------------------------------------------------
+	//! Message delta sync bookkeeping, forwarded from PlayerController RPCs (see AG0_TDLMessageSyncCursor)
+	void AckTDLMessageSync(int playerId, int networkId, RplId viewerRplId, int seq)
+	{
+	    if (!Replication.IsServer()) return;
+	    AckMessageSync(this, playerId, networkId, viewerRplId, seq);
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	void ResyncTDLMessages(int playerId, int networkId, RplId viewerRplId)
+	{
+	    if (!Replication.IsServer()) return;
+	    ResyncMessages(this, playerId, networkId, viewerRplId);
+	}
+	
+	//------------------------------------------------------------------------------------------------
 	void MarkTDLMessageRead(RplId readerDeviceRplId, int messageId)
 	{
 	    MarkMessageRead(this, readerDeviceRplId, messageId);
 
 	    // After the static MarkMessageRead has flipped the bit and dispatched the
-	    // existing in-game read receipt RPC, mirror the state to the API — but only
+	    // READ status to the sender's next message delta, mirror the state to the API — but only
 	    // for web-linked readers, so the web inbox flips DELIVERED→READ. Non-linked
 	    // readers (NPCs, unattended devices) need no API state.
 	    AG0_TDLDeviceComponent readerDevice = GetDeviceByRplId(readerDeviceRplId);
@@ -678,6 +1407,9 @@ class AG0_TDLSystem : WorldSystem
 	    if (m_ApiManager.Initialize())
 	    {
 			m_fApiStateSyncInterval = m_ApiManager.GetStateSyncInterval();
+			m_iPositionBudgetBytesPerSec = m_ApiManager.GetPositionUpdateBudget();
+			m_iTerrainBudgetBytesPerSec = m_ApiManager.GetTerrainTransferBudget();
+			m_ApiStateTracker = new AG0_TDLApiStateTracker(m_ApiManager.GetStateSyncKeyframeInterval());
 	        Print("TDL_SYSTEM: API Manager initialized successfully", LogLevel.DEBUG);
 	    }
 	    else
@@ -703,9 +1435,16 @@ class AG0_TDLSystem : WorldSystem
         
         if (m_fTimeSinceLastUpdate >= m_fUpdateInterval)
         {
-            UpdateNetworks();
+            ScheduleJob(AG0_ETDLTickJob.NETWORK_CYCLE);
             m_fTimeSinceLastUpdate = 0;
         }
+        
+        m_fTimeSincePositionTick += timeSlice;
+        if (m_fTimeSincePositionTick >= POSITION_TICK_INTERVAL)
+        {
+            ScheduleJob(AG0_ETDLTickJob.MEMBER_POSITIONS);
+            m_fTimeSincePositionTick = 0;
+        }
 		
 		if (m_ApiManager)
 	    {
@@ -714,25 +1453,135 @@ class AG0_TDLSystem : WorldSystem
 	        m_fTimeSinceApiHeartbeat += timeSlice;
 	        if (m_fTimeSinceApiHeartbeat >= API_HEARTBEAT_INTERVAL)
 	        {
-	            ApiSendHeartbeat();
+	            ScheduleJob(AG0_ETDLTickJob.API_HEARTBEAT);
 	            m_fTimeSinceApiHeartbeat = 0;
 	        }
 	        
 	        m_fTimeSinceApiStateSync += timeSlice;
 	        if (m_fTimeSinceApiStateSync >= m_fApiStateSyncInterval)
 	        {
-	            ApiSyncFullState();
+	            ScheduleJob(AG0_ETDLTickJob.API_STATE_SYNC);
 	            m_fTimeSinceApiStateSync = 0;
 	        }
 			
 			m_fTimeSinceShapesPoll += timeSlice;
 			if (m_fTimeSinceShapesPoll >= API_SHAPES_POLL_INTERVAL)
 			{
-				m_ApiManager.PollShapes();
+				ScheduleJob(AG0_ETDLTickJob.API_SHAPES_POLL);
 				m_fTimeSinceShapesPoll = 0;
 			}
 	    }
+	    
+	    RunScheduledJobs();
+	    StepTerrainTransfers(timeSlice);
     }
+    
+    //------------------------------------------------------------------------------------------------
+    //! Queue a periodic job. A job still queued from its previous interval is not queued
+    //! twice — the schedule is behind, and the coalesced count records it.
+    protected void ScheduleJob(AG0_ETDLTickJob job)
+    {
+        if (m_aJobQueue.Contains(job))
+        {
+            m_iCoalescedJobs++;
+            Print(string.Format("TDL_SYSTEM: Tick job %1 still pending, schedule lag %2s",
+                typename.EnumToString(AG0_ETDLTickJob, job), GetScheduleLag()), LogLevel.DEBUG);
+            return;
+        }
+        
+        m_aJobQueue.Insert(job);
+        m_aJobDueTimes.Insert(GetWorld().GetWorldTime() / 1000.0);
+    }
+    
+    //------------------------------------------------------------------------------------------------
+    //! Work through queued jobs in order until m_iTickBudgetMs has elapsed. Resumable jobs
+    //! stay at the head of the queue until they report completion. Time is checked after each
+    //! step, so at least one step runs per frame however small the budget.
+    protected void RunScheduledJobs()
+    {
+        if (m_aJobQueue.IsEmpty()) return;
+        
+        int startTick = System.GetTickCount();
+        
+        while (!m_aJobQueue.IsEmpty())
+        {
+            AG0_ETDLTickJob job = m_aJobQueue[0];
+            int stepStart = System.GetTickCount();
+            bool more = RunJobStep(job);
+            
+            if (job == AG0_ETDLTickJob.NETWORK_CYCLE)
+            {
+                m_iCycleCpuMs += System.GetTickCount() - stepStart;
+                if (!more)
+                {
+                    m_Profiler.AddSample(AG0_ETDLProfileStage.NETWORK_CYCLE, m_iCycleCpuMs);
+                    m_iCycleCpuMs = 0;
+                }
+            }
+            
+            if (!more)
+            {
+                m_aJobQueue.RemoveOrdered(0);
+                m_aJobDueTimes.RemoveOrdered(0);
+            }
+            
+            if (System.GetTickCount() - startTick >= m_iTickBudgetMs)
+                break;
+        }
+        
+        m_Profiler.AddSample(AG0_ETDLProfileStage.FRAME_JOBS, System.GetTickCount() - startTick);
+    }
+    
+    //------------------------------------------------------------------------------------------------
+    //! Run one step of a job. Returns true while the job has more to do.
+    protected bool RunJobStep(AG0_ETDLTickJob job)
+    {
+        switch (job)
+        {
+            case AG0_ETDLTickJob.NETWORK_CYCLE:
+                return StepNetworkCycle();
+            
+            case AG0_ETDLTickJob.MEMBER_POSITIONS:
+                UpdateMemberPositions();
+                return false;
+            
+            case AG0_ETDLTickJob.API_HEARTBEAT:
+                if (m_ApiManager)
+                    ApiSendHeartbeat();
+                return false;
+            
+            case AG0_ETDLTickJob.API_STATE_SYNC:
+                if (m_ApiManager)
+                    ApiSyncState();
+                return false;
+            
+            case AG0_ETDLTickJob.API_SHAPES_POLL:
+                if (m_ApiManager)
+                    m_ApiManager.PollShapes();
+                return false;
+        }
+        
+        return false;
+    }
+    
+    //------------------------------------------------------------------------------------------------
+    //! Seconds the oldest queued job has waited since it fell due; 0 when nothing is queued
+    float GetScheduleLag()
+    {
+        if (m_aJobDueTimes.IsEmpty()) return 0;
+        
+        return GetWorld().GetWorldTime() / 1000.0 - m_aJobDueTimes[0];
+    }
+    
+    //------------------------------------------------------------------------------------------------
+    int GetScheduledJobCount() { return m_aJobQueue.Count(); }
+    
+    //------------------------------------------------------------------------------------------------
+    //! Job runs dropped because the previous run of the same job had not finished yet
+    int GetCoalescedJobCount() { return m_iCoalescedJobs; }
+    
+    //------------------------------------------------------------------------------------------------
+    void SetTickBudgetMs(int budgetMs) { m_iTickBudgetMs = Math.Max(budgetMs, 1); }
 	
 	//------------------------------------------------------------------------------------------------
 	void ~AG0_TDLSystem()
@@ -747,8 +1596,13 @@ class AG0_TDLSystem : WorldSystem
     {
         if (!player) return 0;
         
+        AG0_TDLPlayerRoster roster = GetPlayerRoster(player);
+        if (roster)
+            return roster.m_iAggregatedCaps;
+        
         int aggregated = 0;
-        array<AG0_TDLDeviceComponent> devices = GetPlayerAllTDLDevices(player);
+        array<AG0_TDLDeviceComponent> devices = {};
+        CollectPlayerTDLDevices(player, devices);
         
         foreach (AG0_TDLDeviceComponent device : devices)
         {
@@ -757,11 +1611,109 @@ class AG0_TDLSystem : WorldSystem
         }
         return aggregated;
     }
+    
+    //------------------------------------------------------------------------------------------------
+    //! RplId of the VIDEO_SOURCE device the player is broadcasting from, or invalid if none.
+    RplId GetPlayerVideoSource(IEntity player)
+    {
+        AG0_TDLPlayerRoster roster = GetPlayerRoster(player);
+        if (!roster) return RplId.Invalid();
+        return roster.m_VideoSourceRplId;
+    }
 	
+	//------------------------------------------------------------------------------------------------
+	//! All TDL devices the player carries. For controlled players this is the cached roster list —
+	//! callers must not modify it. Other entities fall back to a fresh inventory walk.
 	array<AG0_TDLDeviceComponent> GetPlayerAllTDLDevices(IEntity playerEntity)
 	{
+	    AG0_TDLPlayerRoster roster = GetPlayerRoster(playerEntity);
+	    if (roster)
+	        return roster.m_aDevices;
+	    
 	    array<AG0_TDLDeviceComponent> allDevices = {};
-	    if (!playerEntity) return allDevices;
+	    CollectPlayerTDLDevices(playerEntity, allDevices);
+	    return allDevices;
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Server-side roster for a controlled player, refreshed if its inventory changed or the player
+	//! respawned since it was last collected. Returns null for entities no player controls.
+	protected AG0_TDLPlayerRoster GetPlayerRoster(IEntity playerEntity)
+	{
+	    if (!playerEntity || !Replication.IsServer()) return null;
+	    
+	    PlayerManager playerMgr = GetGame().GetPlayerManager();
+	    if (!playerMgr) return null;
+	    
+	    int playerId = playerMgr.GetPlayerIdFromControlledEntity(playerEntity);
+	    if (playerId <= 0) return null;
+	    
+	    AG0_TDLPlayerRoster roster = m_mPlayerRosters.Get(playerId);
+	    if (!roster)
+	    {
+	        roster = new AG0_TDLPlayerRoster(playerId);
+	        m_mPlayerRosters.Set(playerId, roster);
+	    }
+	    
+	    if (roster.m_Player != playerEntity)
+	        roster.Bind(playerEntity);
+	    
+	    int now = System.GetTickCount();
+	    if (roster.m_bDevicesDirty || now - roster.m_iCollectedAtMs >= ROSTER_MAX_AGE_MS)
+	    {
+	        foreach (AG0_TDLDeviceComponent oldDevice : roster.m_aDevices)
+	            m_mDeviceRosters.Remove(oldDevice);
+	        
+	        roster.m_aDevices.Clear();
+	        CollectPlayerTDLDevices(playerEntity, roster.m_aDevices);
+	        
+	        foreach (AG0_TDLDeviceComponent newDevice : roster.m_aDevices)
+	            m_mDeviceRosters.Set(newDevice, roster);
+	        
+	        roster.m_iCollectedAtMs = now;
+	        roster.m_bDevicesDirty = false;
+	        roster.m_bStateDirty = true;
+	    }
+	    
+	    if (roster.m_bStateDirty)
+	        roster.RefreshState();
+	    
+	    return roster;
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Called by devices when their power or broadcast state changes, so the owning roster
+	//! recomputes its capability mask and video source on next access.
+	void OnDeviceStateChanged(AG0_TDLDeviceComponent device)
+	{
+	    AG0_TDLPlayerRoster roster = m_mDeviceRosters.Get(device);
+	    if (roster)
+	        roster.m_bStateDirty = true;
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Drop rosters whose player entity is gone (disconnect, or death without respawn yet).
+	protected void PruneRosters()
+	{
+	    array<int> staleIds = {};
+	    foreach (int playerId, AG0_TDLPlayerRoster roster : m_mPlayerRosters)
+	    {
+	        if (!roster.m_Player || roster.m_Player.IsDeleted())
+	            staleIds.Insert(playerId);
+	    }
+	    
+	    foreach (int staleId : staleIds)
+	    {
+	        AG0_TDLPlayerRoster staleRoster = m_mPlayerRosters.Get(staleId);
+	        foreach (AG0_TDLDeviceComponent device : staleRoster.m_aDevices)
+	            m_mDeviceRosters.Remove(device);
+	        m_mPlayerRosters.Remove(staleId);
+	    }
+	}
+	
+	protected void CollectPlayerTDLDevices(IEntity playerEntity, notnull array<AG0_TDLDeviceComponent> allDevices)
+	{
+	    if (!playerEntity) return;
 	    
 	    // Check held gadgets
 	    SCR_GadgetManagerComponent gadgetMgr = SCR_GadgetManagerComponent.Cast(
@@ -789,7 +1741,7 @@ class AG0_TDLSystem : WorldSystem
 	        {
 	            AG0_TDLDeviceComponent deviceComp = AG0_TDLDeviceComponent.Cast(
 	                item.FindComponent(AG0_TDLDeviceComponent));
-	            if (deviceComp)
+	            if (deviceComp && !allDevices.Contains(deviceComp))
 	                allDevices.Insert(deviceComp);
 	        }
 	    }
@@ -823,38 +1775,33 @@ class AG0_TDLSystem : WorldSystem
 	                {
 	                    AG0_TDLDeviceComponent deviceComp = AG0_TDLDeviceComponent.Cast(
 	                        clothItem.FindComponent(AG0_TDLDeviceComponent));
-	                    if (deviceComp)
+	                    if (deviceComp && !allDevices.Contains(deviceComp))
 	                        allDevices.Insert(deviceComp);
 	                }
 	            }
 	        }
 	    }
-	    
-	    return allDevices;
 	}
 	
-	string GetGridCellKey(vector pos)
-    {
-        int x = Math.Floor(pos[0] / m_fGridCellSize);
-        int y = Math.Floor(pos[1] / m_fGridCellSize);
-        int z = Math.Floor(pos[2] / m_fGridCellSize);
-        return string.Format("%1_%2_%3", x, y, z);
-    }
-    
-    void RebuildSpatialGrid()
-    {
-        m_mSpatialGrid.Clear();
-        
-        foreach (AG0_TDLDeviceComponent device : m_aRegisteredNetworkDevices)
-        {
-            string cellKey = GetGridCellKey(device.GetOwner().GetOrigin());
-            
-            if (!m_mSpatialGrid.Contains(cellKey))
-                m_mSpatialGrid.Set(cellKey, new array<AG0_TDLDeviceComponent>);
-            
-            m_mSpatialGrid.Get(cellKey).Insert(device);
-        }
-    }
+	//------------------------------------------------------------------------------------------------
+	//! Re-bucket every registered device whose origin crossed a cell boundary since last tick.
+	//! Cheap int-key compare per device; a full rebuild only happens when the cell size changes.
+	protected void UpdateSpatialIndex()
+	{
+	    if (m_bCellSizeNeedsUpdate)
+	    {
+	        m_SpatialHash.Rebuild(m_fGridCellSize, m_aRegisteredNetworkDevices);
+	        m_bCellSizeNeedsUpdate = false;
+	        return;
+	    }
+
+	    foreach (AG0_TDLDeviceComponent device : m_aRegisteredNetworkDevices)
+	    {
+	        IEntity owner = device.GetOwner();
+	        if (owner)
+	            m_SpatialHash.Move(device, owner.GetOrigin());
+	    }
+	}
 	
 	protected void UpdateMaxDeviceRange()
 	{
@@ -873,41 +1820,26 @@ class AG0_TDLSystem : WorldSystem
 	    {
 	        m_fMaxDeviceRange = currentMaxRange;
 	        m_fGridCellSize = 2.0 * m_fMaxDeviceRange;
-	        m_fTimeSinceGridRebuild = 999.0;
+	        m_bCellSizeNeedsUpdate = true;
 	    }
 	}
     
-    array<AG0_TDLDeviceComponent> GetNearbyDevices(vector pos, AG0_TDLNetwork network)
+    //------------------------------------------------------------------------------------------------
+    //! Fill outDevices with the devices of `network` bucketed within `radius` of pos.
+    //! Candidates only — the caller applies the exact range test. Pass a reused buffer
+    //! (e.g. m_aNearbyScratch) on hot paths to avoid allocating per query.
+    int GetNearbyDevices(vector pos, float radius, AG0_TDLNetwork network, notnull array<AG0_TDLDeviceComponent> outDevices)
     {
-        array<AG0_TDLDeviceComponent> nearby = {};
-        array<AG0_TDLDeviceComponent> networkDevices = network.GetNetworkDevices();
-        
-        int cx = Math.Floor(pos[0] / m_fGridCellSize);
-        int cy = Math.Floor(pos[1] / m_fGridCellSize);
-        int cz = Math.Floor(pos[2] / m_fGridCellSize);
-        
-        for (int dx = -1; dx <= 1; dx++)
+        m_SpatialHash.Query(pos, radius, outDevices);
+        if (!network)
+            return outDevices.Count();
+
+        for (int i = outDevices.Count() - 1; i >= 0; i--)
         {
-            for (int dy = -1; dy <= 1; dy++)
-            {
-                for (int dz = -1; dz <= 1; dz++)
-                {
-                    string cellKey = string.Format("%1_%2_%3", cx + dx, cy + dy, cz + dz);
-                    array<AG0_TDLDeviceComponent> cellDevices = m_mSpatialGrid.Get(cellKey);
-                    
-                    if (cellDevices)
-                    {
-                        foreach (AG0_TDLDeviceComponent device : cellDevices)
-                        {
-                            if (networkDevices.Contains(device))
-                                nearby.Insert(device);
-                        }
-                    }
-                }
-            }
+            if (!network.GetMeshNode(outDevices[i]))
+                outDevices.Remove(i);
         }
-        
-        return nearby;
+        return outDevices.Count();
     }
     
     //------------------------------------------------------------------------------------------------
@@ -1010,7 +1942,7 @@ class AG0_TDLSystem : WorldSystem
 
 	    LogDeviceRegistration(device, true);
 	    
-	    m_fTimeSinceGridRebuild = 999.0;
+	    m_SpatialHash.Insert(device, owner.GetOrigin());
 	    
 	    foreach (AG0_TDLMapMarkerEntry markerEntry : m_MarkerCallbacks)
 	    {
@@ -1023,6 +1955,14 @@ class AG0_TDLSystem : WorldSystem
 	{
 	    if (!Replication.IsServer()) return;
 	    
+	    // Any device, registered or not, may sit in a cached roster
+	    AG0_TDLPlayerRoster roster = m_mDeviceRosters.Get(device);
+	    if (roster)
+	    {
+	        roster.m_bDevicesDirty = true;
+	        m_mDeviceRosters.Remove(device);
+	    }
+	    
 	    int idx = m_aRegisteredNetworkDevices.Find(device);
 	    if (idx == -1)
 	    {
@@ -1038,7 +1978,7 @@ class AG0_TDLSystem : WorldSystem
 	    
 	    LogDeviceRegistration(device, false);
 	    
-	    m_fTimeSinceGridRebuild = 999.0;
+	    m_SpatialHash.Remove(device);
 	    
 	    foreach (AG0_TDLNetwork network : m_aNetworks)
 	    {
@@ -1314,28 +2254,103 @@ class AG0_TDLSystem : WorldSystem
     
     //------------------------------------------------------------------------------------------------
     // Network update logic with player capability aggregation
+    //
+    // One cycle: spatial/roster upkeep, merges, bridge links, a connectivity pass per network,
+    // then video streaming. Run one unit per call so the tick scheduler can spread a cycle over
+    // frames — every preparation step, each network's pass setup, each component's snapshot,
+    // each budget slice of its per-viewer fan-out and each pass finish is its own unit.
+    // Returns true while the cycle has more to do.
     //------------------------------------------------------------------------------------------------
-   	protected void UpdateNetworks()
+   	protected bool StepNetworkCycle()
 	{
-	    if (!Replication.IsServer()) return;
+	    if (!Replication.IsServer()) return false;
 	    
-	    UpdateMaxDeviceRange();
+	    switch (m_eCycleStage)
+	    {
+	        case AG0_ETDLNetworkCycleStage.SPATIAL:
+	            UpdateSpatialState();
+	            m_eCycleStage = AG0_ETDLNetworkCycleStage.MERGES;
+	            return true;
+	        
+	        case AG0_ETDLNetworkCycleStage.MERGES:
+	            CheckNetworkMerges();
+	            m_eCycleStage = AG0_ETDLNetworkCycleStage.BRIDGES;
+	            return true;
+	        
+	        case AG0_ETDLNetworkCycleStage.BRIDGES:
+	            UpdateBridgeLinks();
+	            
+	            // Networks created after this point wait for the next cycle
+	            m_aCycleNetworks.Clear();
+	            foreach (AG0_TDLNetwork network : m_aNetworks)
+	                m_aCycleNetworks.Insert(network);
+	            m_iCycleNetworkIndex = 0;
+	            m_CyclePass = null;
+	            m_eCycleStage = AG0_ETDLNetworkCycleStage.CONNECTIVITY;
+	            return true;
+	        
+	        case AG0_ETDLNetworkCycleStage.CONNECTIVITY:
+	            StepConnectivityCycle();
+	            return true;
+	        
+	        case AG0_ETDLNetworkCycleStage.VIDEO:
+	            UpdateVideoStreaming();
+	            m_eCycleStage = AG0_ETDLNetworkCycleStage.SPATIAL;
+	            return false;
+	    }
 	    
-	    m_fTimeSinceGridRebuild += GetWorld().GetFixedTimeSlice();
-	    if (m_fTimeSinceGridRebuild >= m_fGridRebuildInterval)
+	    return false;
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	protected void UpdateSpatialState()
+	{
+	    AG0_TDLProfileScope scope = m_Profiler.Scope(AG0_ETDLProfileStage.SPATIAL);
+	    
+	    UpdateMaxDeviceRange();
+	    UpdateSpatialIndex();
+	    PruneRosters();
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	protected void StepConnectivityCycle()
+	{
+	    if (m_CyclePass)
 	    {
-	        RebuildSpatialGrid();
-	        m_fTimeSinceGridRebuild = 0;
+	        // Merged away or deleted since its pass began — drop the rest of it
+	        if (m_aNetworks.Find(m_CyclePass.m_Network) < 0)
+	        {
+	            m_CyclePass = null;
+	        }
+	        else if (m_CyclePass.IsPublishing())
+	        {
+	            StepPublishViewers(m_CyclePass, m_iTickBudgetMs);
+	            return;
+	        }
+	        else if (m_CyclePass.HasNextComponent())
+	        {
+	            PublishComponent(m_CyclePass, m_CyclePass.NextComponent());
+	            return;
+	        }
+	        else
+	        {
+	            FinishConnectivityPass(m_CyclePass);
+	            m_CyclePass = null;
+	            return;
+	        }
 	    }
 	    
-	    CheckNetworkMerges();
-	    UpdateBridgeLinks();
-
-	    foreach (AG0_TDLNetwork network : m_aNetworks)
+	    while (m_iCycleNetworkIndex < m_aCycleNetworks.Count())
 	    {
-	        UpdateNetworkConnectivity(network);
+	        AG0_TDLNetwork network = m_aCycleNetworks[m_iCycleNetworkIndex];
+	        m_iCycleNetworkIndex++;
+	        if (!network || m_aNetworks.Find(network) < 0) continue;
+	        
+	        m_CyclePass = BeginConnectivityPass(network);
+	        if (m_CyclePass) return;
 	    }
-
+	    
+	    m_aCycleNetworks.Clear();
 	    // NOTE: the per-tick stale-network cleanup loop that used to live here was
 	    // removed deliberately. It walked every device in every network, derived
 	    // playerId via GetPlayerFromDevice → GetPlayerIdFromControlledEntity, then
@@ -1362,12 +2377,13 @@ class AG0_TDLSystem : WorldSystem
 	    // per-player active sets, (b) require multiple consecutive ticks of
 	    // confirmation before acting, and (c) be tested on a real dedicated
 	    // server — listen-server reproduces none of the relevant races.
-
-	    UpdateVideoStreaming();
+	    m_eCycleStage = AG0_ETDLNetworkCycleStage.VIDEO;
 	}
     
     protected void CheckNetworkMerges()
     {
+        AG0_TDLProfileScope scope = m_Profiler.Scope(AG0_ETDLProfileStage.NETWORK_MERGES);
+        
         for (int i = 0; i < m_aNetworks.Count() - 1; i++)
         {
             AG0_TDLNetwork networkA = m_aNetworks[i];
@@ -1447,6 +2463,8 @@ class AG0_TDLSystem : WorldSystem
     {
         if (!Replication.IsServer()) return;
         
+        AG0_TDLProfileScope scope = m_Profiler.Scope(AG0_ETDLProfileStage.BRIDGE_LINKS);
+        
         m_aBridgeLinks.Clear();
         
         PlayerManager playerMgr = GetGame().GetPlayerManager();
@@ -1520,12 +2538,14 @@ class AG0_TDLSystem : WorldSystem
     }
     
     //------------------------------------------------------------------------------------------------
-    // Append members from bridged networks into a device's connectedMembers map.
-    // Called from UpdateNetworkConnectivity before NotifyNetworkConnectivity so that
-    // bridged SA flows through the existing notification path transparently.
+    // Collect members from bridged networks into bridgedMembers.
+    // Bridged SA does not depend on which local device is viewing it, so this runs once per
+    // network per tick and UpdateNetworkConnectivity merges the result into every device's
+    // connectedMembers map before NotifyNetworkConnectivity — bridged SA flows through the
+    // existing notification path transparently.
     //------------------------------------------------------------------------------------------------
-    protected void AppendBridgedMembers(AG0_TDLNetwork network, AG0_TDLDeviceComponent device,
-                                        inout map<RplId, ref AG0_TDLNetworkMember> connectedMembers)
+    protected void AppendBridgedMembers(AG0_TDLNetwork network,
+                                        inout map<RplId, ref AG0_TDLNetworkMember> bridgedMembers)
     {
         int myNetworkId = network.GetNetworkID();
         
@@ -1542,8 +2562,8 @@ class AG0_TDLSystem : WorldSystem
                 RplId foreignRplId = foreignDevice.GetDeviceRplId();
                 if (foreignRplId == RplId.Invalid()) continue;
                 
-                // Don't duplicate a member already visible on this network
-                if (connectedMembers.Contains(foreignRplId)) continue;
+                // Two links to the same foreign network must not duplicate its members
+                if (bridgedMembers.Contains(foreignRplId)) continue;
                 
                 AG0_TDLNetworkMember foreignMemberData = foreignNetwork.GetDeviceData().Get(foreignRplId);
                 if (!foreignMemberData) continue;
@@ -1571,14 +2591,10 @@ class AG0_TDLSystem : WorldSystem
                     PlayerManager playerMgr = GetGame().GetPlayerManager();
                     foreignOwnerPlayerId = playerMgr.GetPlayerIdFromControlledEntity(foreignPlayer);
                     
-                    array<AG0_TDLDeviceComponent> foreignPlayerDevices = GetPlayerAllTDLDevices(foreignPlayer);
-                    foreach (AG0_TDLDeviceComponent dev : foreignPlayerDevices)
-                    {
-                        if (dev.IsCameraBroadcasting() && dev.HasCapability(AG0_ETDLDeviceCapability.VIDEO_SOURCE))
-                            bridgedData.SetVideoSourceRplId(dev.GetDeviceRplId());
-                        if (dev.IsPowered())
-                            aggregatedCaps |= dev.GetActiveCapabilities();
-                    }
+                    RplId foreignVideoSource = GetPlayerVideoSource(foreignPlayer);
+                    if (foreignVideoSource != RplId.Invalid())
+                        bridgedData.SetVideoSourceRplId(foreignVideoSource);
+                    aggregatedCaps = GetAggregatedPlayerCapabilities(foreignPlayer);
                 }
                 else
                 {
@@ -1594,111 +2610,474 @@ class AG0_TDLSystem : WorldSystem
                 bridgedData.SetIsBridged(true);
                 bridgedData.SetSourceNetworkId(foreignNetworkId);
                 
-                connectedMembers.Set(foreignRplId, bridgedData);
+                bridgedMembers.Set(foreignRplId, bridgedData);
             }
         }
     }
     
-    protected void UpdateNetworkConnectivity(AG0_TDLNetwork network)
+	//------------------------------------------------------------------------------------------------
+	//! Fast path for member positions between connectivity ticks. Every mesh node's track is
+	//! sampled once per call; members whose client-side dead reckoning has drifted, or whose
+	//! speed-scaled interval has lapsed, are due. Due members are served most urgent first
+	//! while the server-wide byte budget lasts — the rest stay due and gain priority. Each
+	//! sample carries velocity so clients can extrapolate until the next one.
+	protected void UpdateMemberPositions()
+	{
+	    AG0_TDLProfileScope scope = m_Profiler.Scope(AG0_ETDLProfileStage.MEMBER_POSITIONS);
+	    float now = GetWorld().GetWorldTime() / 1000.0;
+	    float elapsed = POSITION_TICK_INTERVAL;
+	    if (m_fLastPositionUpdate >= 0)
+	        elapsed = now - m_fLastPositionUpdate;
+	    m_fLastPositionUpdate = now;
+
+	    // Token bucket: a short burst above the steady rate is fine, a backlog is not
+	    m_fPositionBudgetBytes = Math.Min(m_fPositionBudgetBytes + m_iPositionBudgetBytesPerSec * elapsed,
+	        m_iPositionBudgetBytesPerSec * 2);
+
+	    array<AG0_TDLMeshNode> dueNodes = {};
+	    array<AG0_TDLNetwork> dueNetworks = {};
+	    array<int> dueKeys = {};
+
+	    foreach (AG0_TDLNetwork network : m_aNetworks)
+	    {
+	        foreach (AG0_TDLDeviceComponent device, AG0_TDLMeshNode node : network.GetMeshNodes())
+	        {
+	            IEntity deviceEntity = device.GetOwner();
+	            if (!deviceEntity) continue;
+
+	            node.m_Track.Sample(deviceEntity.GetOrigin(), now);
+	            if (!node.m_LastPublished) continue;
+
+	            float priority = node.m_Track.GetPriority(now);
+	            if (priority <= 0 || dueNodes.Count() > 0xFFFF) continue;
+
+	            // Sortable key: priority in the high bits, candidate index in the low 16
+	            int rank = Math.Min(priority * 100, 0x7FFF);
+	            dueKeys.Insert((rank << 16) | dueNodes.Count());
+	            dueNodes.Insert(node);
+	            dueNetworks.Insert(network);
+	        }
+	    }
+
+	    if (dueNodes.IsEmpty()) return;
+	    dueKeys.Sort(true);
+
+	    PlayerManager playerMgr = GetGame().GetPlayerManager();
+	    map<AG0_TDLDeviceComponent, int> viewerPlayerIds = new map<AG0_TDLDeviceComponent, int>();
+	    map<AG0_TDLNetwork, ref map<int, ref array<int>>> outgoing = new map<AG0_TDLNetwork, ref map<int, ref array<int>>>();
+	    int sampleBytes = AG0_TDLNetworkMember.POSITION_SAMPLE_INTS * 4;
+
+	    foreach (int key : dueKeys)
+	    {
+	        // The last sample may overdraw the bucket; the next tick pays it back
+	        if (m_fPositionBudgetBytes <= 0) break;
+
+	        int index = key & 0xFFFF;
+	        AG0_TDLMeshNode node = dueNodes[index];
+	        AG0_TDLNetwork network = dueNetworks[index];
+
+	        // Viewers are the devices the member list was last published to
+	        array<AG0_TDLDeviceComponent> component = network.GetComponentOf(node.m_Device);
+	        if (!component) continue;
+
+	        map<int, ref array<int>> perPlayer = outgoing.Get(network);
+	        if (!perPlayer)
+	        {
+	            perPlayer = new map<int, ref array<int>>();
+	            outgoing.Set(network, perPlayer);
+	        }
+
+	        set<int> served = new set<int>();
+	        foreach (AG0_TDLDeviceComponent viewer : component)
+	        {
+	            int playerId;
+	            if (!viewerPlayerIds.Find(viewer, playerId))
+	            {
+	                playerId = -1;
+	                IEntity playerEntity = GetPlayerFromDevice(viewer);
+	                if (playerEntity)
+	                    playerId = playerMgr.GetPlayerIdFromControlledEntity(playerEntity);
+	                viewerPlayerIds.Set(viewer, playerId);
+	            }
+	            if (playerId <= 0 || served.Contains(playerId)) continue;
+	            served.Insert(playerId);
+
+	            array<int> samples = perPlayer.Get(playerId);
+	            if (!samples)
+	            {
+	                samples = {};
+	                perPlayer.Set(playerId, samples);
+	            }
+
+	            AG0_TDLNetworkMember.AppendPositionSample(node.m_LastPublished.GetRplId(),
+	                node.m_Track.m_vSamplePos, node.m_Track.m_vVelocity, samples);
+	            m_fPositionBudgetBytes -= sampleBytes;
+	        }
+
+	        node.m_Track.OnSampleSent(now);
+	    }
+
+	    foreach (AG0_TDLNetwork network, map<int, ref array<int>> perPlayer : outgoing)
+	    {
+	        foreach (int playerId, array<int> samples : perPlayer)
+	        {
+	            SCR_PlayerController controller = SCR_PlayerController.Cast(playerMgr.GetPlayerController(playerId));
+	            if (!controller) continue;
+
+	            int seq = network.GetMemberSyncCursor(playerId).NextPositionSeq();
+	            controller.NotifyMemberPositions(network.GetNetworkID(), seq, samples);
+	        }
+	    }
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Snapshot the viewer-independent fields of one network member: callsign, live position,
+	//! network IP, owning player, aggregated capabilities and active video source.
+	//! Signal strength is left at 0 — it depends on the viewer and is stamped per copy by
+	//! UpdateNetworkConnectivity. Returns null when the device has no member record.
+	protected AG0_TDLNetworkMember BuildMemberSnapshot(AG0_TDLNetwork network, AG0_TDLDeviceComponent device)
 	{
-	    if (!network || !network.HasDevices()) return;
-	    
-	    foreach (AG0_TDLDeviceComponent device : network.GetNetworkDevices())
+	    RplId rplId = device.GetDeviceRplId();
+	    if (rplId == RplId.Invalid()) return null;
+
+	    IEntity deviceEntity = device.GetOwner();
+	    if (!deviceEntity) return null;
+
+	    AG0_TDLNetworkMember memberData = network.GetDeviceData().Get(rplId);
+	    if (!memberData) return null;
+
+	    AG0_TDLNetworkMember snapshot = new AG0_TDLNetworkMember();
+	    snapshot.SetRplId(memberData.GetRplId());
+	    snapshot.SetPlayerName(device.GetDisplayName());
+	    snapshot.SetPosition(deviceEntity.GetOrigin());
+	    snapshot.SetNetworkIP(memberData.GetNetworkIP());
+
+	    IEntity player = GetPlayerFromDevice(device);
+	    int ownerPlayerId = -1;
+	    if (player)
 	    {
-	        if (!device.CanAccessNetwork()) continue;
-	        
-	        RplId deviceRplId = device.GetDeviceRplId();
-	        if (deviceRplId != RplId.Invalid())
+	        PlayerManager playerMgr = GetGame().GetPlayerManager();
+	        ownerPlayerId = playerMgr.GetPlayerIdFromControlledEntity(player);
+	        snapshot.SetVideoSourceRplId(GetPlayerVideoSource(player));
+	        snapshot.SetCapabilities(GetAggregatedPlayerCapabilities(player));
+	    }
+	    else
+	    {
+	        snapshot.SetCapabilities(memberData.GetCapabilities());
+	    }
+	    snapshot.SetOwnerPlayerId(ownerPlayerId);
+
+	    return snapshot;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Bring a network's persistent mesh graph up to date. Only devices whose edge inputs
+	//! changed since their last evaluation — moved further than m_fMeshMoveThreshold, range
+	//! changed, powered on/off, or newly added — have their links re-tested against the
+	//! spatial grid. Static devices cost one position/range read per tick.
+	protected void UpdateMeshEdges(AG0_TDLNetwork network)
+	{
+	    float thresholdSq = m_fMeshMoveThreshold * m_fMeshMoveThreshold;
+	    array<AG0_TDLMeshNode> staleNodes = {};
+
+	    foreach (AG0_TDLDeviceComponent device, AG0_TDLMeshNode node : network.GetMeshNodes())
+	    {
+	        IEntity deviceEntity = device.GetOwner();
+	        if (!deviceEntity) continue;
+
+	        vector pos = deviceEntity.GetOrigin();
+	        float range = device.GetEffectiveNetworkRange();
+	        bool powered = device.IsPowered();
+
+	        if (!node.m_bNeedsEdgeEval && range == node.m_fEvaluatedRange && powered == node.m_bEvaluatedPowered
+	            && vector.DistanceSq(pos, node.m_vEvaluatedPos) <= thresholdSq)
+	            continue;
+
+	        node.m_vEvaluatedPos = pos;
+	        node.m_fEvaluatedRange = range;
+	        node.m_bEvaluatedPowered = powered;
+	        node.m_bNeedsEdgeEval = false;
+	        staleNodes.Insert(node);
+	    }
+
+	    foreach (AG0_TDLMeshNode node : staleNodes)
+	    {
+	        array<AG0_TDLDeviceComponent> linked = {};
+	        if (node.CanLink())
 	        {
-	            IEntity deviceEntity = device.GetOwner();
-	            if (deviceEntity)
+	            // A link needs both ranges to cover the distance, so this node's own range
+	            // bounds the search radius
+	            GetNearbyDevices(node.m_vEvaluatedPos, node.m_fEvaluatedRange, network, m_aNearbyScratch);
+	            foreach (AG0_TDLDeviceComponent candidate : m_aNearbyScratch)
 	            {
-	                vector currentPos = deviceEntity.GetOrigin();
-	                network.UpdateDevicePosition(deviceRplId, currentPos);
+	                if (candidate == node.m_Device) continue;
+	                if (AreDevicesConnected(node.m_Device, candidate))
+	                    linked.Insert(candidate);
 	            }
 	        }
-	        
-	        m_aProcessedDevices.Clear();
-	        m_aConnectedDevices.Clear();
-	        
-	        FindConnectedDevicesInNetwork(device, network);
-	        
-	        if (!m_aConnectedDevices.Contains(device))
-	            m_aConnectedDevices.Insert(device);
-	        
-	        ref map<RplId, ref AG0_TDLNetworkMember> connectedMembers = new map<RplId, ref AG0_TDLNetworkMember>();
-	        
-	        foreach (AG0_TDLDeviceComponent connectedDevice : m_aConnectedDevices)
+	        network.SetMeshNeighbours(node, linked);
+	    }
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Partition a network's devices into RF-connected components in one pass.
+	//! One BFS per component over the persistent mesh adjacency (see UpdateMeshEdges), so no
+	//! range checks happen here at all. Devices that cannot access the network are left out
+	//! of every component, as the old flood fill did.
+	protected void BuildNetworkComponents(AG0_TDLNetwork network, notnull array<ref array<AG0_TDLDeviceComponent>> outComponents)
+	{
+	    outComponents.Clear();
+
+	    array<AG0_TDLDeviceComponent> networkDevices = network.GetNetworkDevices();
+
+	    // Component index per network device; -1 = not yet reached
+	    map<AG0_TDLDeviceComponent, int> componentOf = new map<AG0_TDLDeviceComponent, int>();
+	    foreach (AG0_TDLDeviceComponent device : networkDevices)
+	        componentOf.Set(device, -1);
+
+	    array<AG0_TDLDeviceComponent> queue = {};
+
+	    foreach (AG0_TDLDeviceComponent seed : networkDevices)
+	    {
+	        if (componentOf.Get(seed) != -1) continue;
+
+	        AG0_TDLMeshNode seedNode = network.GetMeshNode(seed);
+	        if (!seedNode || !seedNode.CanLink() || !seed.GetOwner()) continue;
+
+	        int componentIndex = outComponents.Count();
+	        array<AG0_TDLDeviceComponent> component = {};
+	        outComponents.Insert(component);
+
+	        componentOf.Set(seed, componentIndex);
+	        component.Insert(seed);
+
+	        queue.Clear();
+	        queue.Insert(seed);
+	        int head = 0;
+
+	        while (head < queue.Count())
 	        {
-	            RplId connectedRplId = connectedDevice.GetDeviceRplId();
-	            
-	            if (connectedRplId != RplId.Invalid())
+	            AG0_TDLMeshNode sourceNode = network.GetMeshNode(queue[head]);
+	            head++;
+	            if (!sourceNode) continue;
+
+	            foreach (AG0_TDLDeviceComponent neighbour : sourceNode.m_aNeighbours)
 	            {
-	                IEntity connectedEntity = connectedDevice.GetOwner();
-	                if (connectedEntity)
-	                {
-	                    vector connectedCurrentPos = connectedEntity.GetOrigin();
-	                    network.UpdateDevicePosition(connectedRplId, connectedCurrentPos);
-	                }
-	                
-	                AG0_TDLNetworkMember memberData = network.GetDeviceData().Get(connectedRplId);
-	                if (memberData && connectedEntity)
-	                {
-	                    IEntity deviceEntity = device.GetOwner();
-	                    
-	                    if (deviceEntity)
-	                    {
-	                        vector devicePos = deviceEntity.GetOrigin();
-	                        vector connectedPos = connectedEntity.GetOrigin();
-	                        float distance = vector.Distance(devicePos, connectedPos);
-	                        
-	                        AG0_TDLNetworkMember connectedData = new AG0_TDLNetworkMember();
-	                        connectedData.SetRplId(memberData.GetRplId());
-	                        connectedData.SetPlayerName(connectedDevice.GetDisplayName());
-	                        connectedData.SetPosition(connectedPos);
-	                        connectedData.SetNetworkIP(memberData.GetNetworkIP());
-							IEntity connectedPlayer = GetPlayerFromDevice(connectedDevice);
-							int ownerPlayerId = -1;
-							if (connectedPlayer)
-							{
-							    PlayerManager playerMgr = GetGame().GetPlayerManager();
-							    ownerPlayerId = playerMgr.GetPlayerIdFromControlledEntity(connectedPlayer);
-								array<AG0_TDLDeviceComponent> playerDevices = GetPlayerAllTDLDevices(connectedPlayer);
-								int aggregatedCaps = 0;
-							    foreach (AG0_TDLDeviceComponent dev : playerDevices)
-							    {
-							        if (dev.IsCameraBroadcasting() && dev.HasCapability(AG0_ETDLDeviceCapability.VIDEO_SOURCE))
-							        {
-							            connectedData.SetVideoSourceRplId(dev.GetDeviceRplId());
-							        }
-									if (dev.IsPowered())
-                						aggregatedCaps |= dev.GetActiveCapabilities();
-							    }
-								connectedData.SetCapabilities(aggregatedCaps);
-							}
-							else {
-								connectedData.SetCapabilities(memberData.GetCapabilities());
-							}
-							connectedData.SetOwnerPlayerId(ownerPlayerId);
-	                        
-	                        float effectiveRange = Math.Min(device.GetEffectiveNetworkRange(), 
-							                                connectedDevice.GetEffectiveNetworkRange());
-							float signalStrength = Math.Clamp(100.0 * (1.0 - (distance / effectiveRange)), 0.0, 100.0);
-							connectedData.SetSignalStrength(signalStrength);
-	                        
-	                        connectedMembers.Set(connectedRplId, connectedData);
-	                    }
-	                }
+	                if (!componentOf.Contains(neighbour) || componentOf.Get(neighbour) != -1) continue;
+
+	                componentOf.Set(neighbour, componentIndex);
+	                component.Insert(neighbour);
+	                queue.Insert(neighbour);
 	            }
 	        }
-	        
-	        // Append SA from any networks bridged to this one
-	        AppendBridgedMembers(network, device, connectedMembers);
+	    }
+	}
+
+    //------------------------------------------------------------------------------------------------
+    //! Full connectivity update for one network in a single call. The scheduled tick runs the
+    //! same stages spread over frames (see StepNetworkCycle); this is for event-driven refreshes.
+    protected void UpdateNetworkConnectivity(AG0_TDLNetwork network)
+	{
+	    AG0_TDLConnectivityPass pass = BeginConnectivityPass(network);
+	    if (!pass) return;
+
+	    while (pass.HasNextComponent())
+	    {
+	        PublishComponent(pass, pass.NextComponent());
+	        while (pass.IsPublishing())
+	            StepPublishViewers(pass, m_iTickBudgetMs);
+	    }
+
+	    FinishConnectivityPass(pass);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! First stage of a connectivity update: refresh positions and mesh edges, rebuild the
+	//! components and resolve bridged SA. Returns null when the network has no devices.
+	protected AG0_TDLConnectivityPass BeginConnectivityPass(AG0_TDLNetwork network)
+	{
+	    if (!network || !network.HasDevices()) return null;
+
+	    AG0_TDLProfileScope scope = m_Profiler.Scope(AG0_ETDLProfileStage.CONNECTIVITY_SETUP);
+
+	    foreach (AG0_TDLDeviceComponent device : network.GetNetworkDevices())
+	    {
+	        RplId deviceRplId = device.GetDeviceRplId();
+	        IEntity deviceEntity = device.GetOwner();
+	        if (deviceRplId != RplId.Invalid() && deviceEntity)
+	            network.UpdateDevicePosition(deviceRplId, deviceEntity.GetOrigin());
+	    }
+
+	    UpdateMeshEdges(network);
+
+	    AG0_TDLConnectivityPass pass = new AG0_TDLConnectivityPass(network);
+	    BuildNetworkComponents(network, pass.m_aComponents);
+	    network.SetComponents(pass.m_aComponents);
+
+	    AppendBridgedMembers(network, pass.m_mBridgedMembers);
+
+	    // A changed bridged set or a keyframe tick forces every component to re-publish
+	    bool bridgedChanged = network.SetLastBridgedMembers(pass.m_mBridgedMembers, MESH_PUBLISH_POSITION_TOLERANCE);
+	    bool keyframe = network.AdvanceConnectivityTick(CONNECTIVITY_KEYFRAME_TICKS);
+	    pass.m_bForceAll = keyframe || bridgedChanged;
+	    pass.m_fNow = GetWorld().GetWorldTime() / 1000.0;
+
+	    return pass;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Publish one component of a connectivity pass, if anything its members could see changed.
+	//! Resolves the member snapshots and starts the fan-out; StepPublishViewers sends it.
+	protected void PublishComponent(AG0_TDLConnectivityPass pass, array<AG0_TDLDeviceComponent> component)
+	{
+	    AG0_TDLProfileScope scope = m_Profiler.Scope(AG0_ETDLProfileStage.COMPONENT_PUBLISH);
+	    AG0_TDLNetwork network = pass.m_Network;
+
+	    // A device may have left the network since the pass began; its neighbours are
+	    // flagged for the next pass, so leave this component until then
+	    foreach (AG0_TDLDeviceComponent member : component)
+	    {
+	        if (!member || !member.GetOwner() || !network.GetMeshNode(member))
+	        {
+	            pass.m_bComponentSkipped = true;
+	            return;
+	        }
+	    }
+
+	    // Every device in a component sees the same member set. Resolve the expensive
+	    // per-member fields once here; only signal strength is computed per viewer.
+	    int componentSize = component.Count();
+	    array<ref AG0_TDLNetworkMember> memberSnapshots = {};
+	    array<float> memberRanges = {};
+	    memberSnapshots.Resize(componentSize);
+	    memberRanges.Resize(componentSize);
 
-	        // Pass network.GetNetworkID() explicitly — see NotifyNetworkConnectivity doc.
-	        NotifyNetworkConnectivity(device, network.GetNetworkID(), connectedMembers);
-			PropagateMessagesForDevice(this, network, device, connectedMembers);
+	    bool componentDirty = pass.m_bForceAll;
+
+	    for (int i = 0; i < componentSize; i++)
+	    {
+	        AG0_TDLMeshNode memberNode = network.GetMeshNode(component[i]);
+	        memberSnapshots[i] = BuildMemberSnapshot(network, component[i]);
+	        memberRanges[i] = memberNode.m_fEvaluatedRange;
+
+	        if (componentDirty) continue;
+
+	        // Dirty when membership changed (an incident edge appeared/vanished) or any
+	        // client-visible member field differs from what was last published
+	        if (memberNode.m_bTopologyChanged)
+	            componentDirty = true;
+	        else if (memberSnapshots[i] && !memberSnapshots[i].IsEquivalentTo(memberNode.m_LastPublished, MESH_PUBLISH_POSITION_TOLERANCE))
+	            componentDirty = true;
+	        else if (!memberSnapshots[i] && memberNode.m_LastPublished)
+	            componentDirty = true;
+	    }
+
+	    // Nothing a client could see has changed — skip the per-device fan-out entirely
+	    if (!componentDirty) return;
+
+	    pass.m_bAnyPublished = true;
+	    for (int i = 0; i < componentSize; i++)
+	    {
+	        AG0_TDLMeshNode publishedNode = network.GetMeshNode(component[i]);
+	        publishedNode.m_LastPublished = memberSnapshots[i];
+	        if (memberSnapshots[i])
+	            publishedNode.m_Track.OnPositionPublished(memberSnapshots[i].GetPosition(), pass.m_fNow);
+	    }
+
+	    pass.BeginPublish(component, memberSnapshots, memberRanges);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Send the component being published to its viewers, one NotifyNetworkConnectivity each,
+	//! until budgetMs has elapsed (at least one viewer per call). The last viewer also relays
+	//! pending messages across the component and ends the fan-out.
+	protected void StepPublishViewers(AG0_TDLConnectivityPass pass, int budgetMs)
+	{
+	    AG0_TDLProfileScope scope = m_Profiler.Scope(AG0_ETDLProfileStage.COMPONENT_PUBLISH);
+	    int startTick = System.GetTickCount();
+
+	    AG0_TDLNetwork network = pass.m_Network;
+	    array<AG0_TDLDeviceComponent> component = pass.m_aPublishComponent;
+	    array<ref AG0_TDLNetworkMember> memberSnapshots = pass.m_aPublishSnapshots;
+	    array<float> memberRanges = pass.m_aPublishRanges;
+	    int componentSize = component.Count();
+
+	    while (pass.m_iNextViewer < componentSize)
+	    {
+	        int viewerIdx = pass.m_iNextViewer;
+	        pass.m_iNextViewer = viewerIdx + 1;
+
+	        // May have been deleted since the fan-out began
+	        AG0_TDLDeviceComponent device = component[viewerIdx];
+	        if (device && device.GetOwner())
+	            PublishToViewer(pass, device, memberRanges[viewerIdx], memberSnapshots, memberRanges);
+
+	        if (System.GetTickCount() - startTick >= budgetMs)
+	            break;
+	    }
+
+	    if (pass.m_iNextViewer < componentSize)
+	        return;
+
+	    // Membership of this component may have grown; hand pending messages across it
+	    RelayMessagesInComponent(this, network, component);
+	    pass.EndPublish();
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! One viewer's member list: the shared snapshots plus its own signal strength to each
+	protected void PublishToViewer(AG0_TDLConnectivityPass pass, AG0_TDLDeviceComponent device, float deviceRange,
+	                               array<ref AG0_TDLNetworkMember> memberSnapshots, array<float> memberRanges)
+	{
+	    AG0_TDLNetwork network = pass.m_Network;
+	    vector devicePos = device.GetOwner().GetOrigin();
+	    int componentSize = memberSnapshots.Count();
+
+	    map<RplId, ref AG0_TDLNetworkMember> connectedMembers = new map<RplId, ref AG0_TDLNetworkMember>();
+
+	    for (int memberIdx = 0; memberIdx < componentSize; memberIdx++)
+	    {
+	        AG0_TDLNetworkMember memberSnapshot = memberSnapshots[memberIdx];
+	        if (!memberSnapshot) continue;
+
+	        AG0_TDLNetworkMember connectedData = new AG0_TDLNetworkMember();
+	        connectedData.CopyFrom(memberSnapshot);
+
+	        float distance = vector.Distance(devicePos, memberSnapshot.GetPosition());
+	        float effectiveRange = Math.Min(deviceRange, memberRanges[memberIdx]);
+	        float signalStrength = Math.Clamp(100.0 * (1.0 - (distance / effectiveRange)), 0.0, 100.0);
+	        connectedData.SetSignalStrength(signalStrength);
+
+	        connectedMembers.Set(connectedData.GetRplId(), connectedData);
 	    }
+
+	    // Append SA from any networks bridged to this one, without shadowing a
+	    // member already visible on this network
+	    foreach (RplId bridgedRplId, AG0_TDLNetworkMember bridgedData : pass.m_mBridgedMembers)
+	    {
+	        if (!connectedMembers.Contains(bridgedRplId))
+	            connectedMembers.Set(bridgedRplId, bridgedData);
+	    }
+
+	    // Pass network.GetNetworkID() explicitly — see NotifyNetworkConnectivity doc.
+	    NotifyNetworkConnectivity(device, network.GetNetworkID(), connectedMembers);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Last stage of a connectivity pass: clear edge flags and re-derive player connectivity
+	protected void FinishConnectivityPass(AG0_TDLConnectivityPass pass)
+	{
+	    AG0_TDLProfileScope scope = m_Profiler.Scope(AG0_ETDLProfileStage.CONNECTIVITY_FINISH);
+	    AG0_TDLNetwork network = pass.m_Network;
+
+	    // Keep the edge flags of a skipped component so the next pass still sees it dirty
+	    if (!pass.m_bComponentSkipped)
+	        network.ClearMeshTopologyFlags();
+
+	    // Player-to-player connectivity is derived from the device sets published above,
+	    // so it cannot have changed if no component was re-published
+	    if (!pass.m_bAnyPublished) return;
+
 		// After all devices processed, derive player connectivity
 	    map<int, ref set<int>> playerConnections = new map<int, ref set<int>>();
 	    PlayerManager playerMgr = GetGame().GetPlayerManager();
@@ -1752,35 +3131,6 @@ class AG0_TDLSystem : WorldSystem
 		}
 	}
     
-   	protected void FindConnectedDevicesInNetwork(AG0_TDLDeviceComponent source, AG0_TDLNetwork network)
-	{
-	    if (m_aProcessedDevices.Contains(source)) return;
-	    
-	    m_aProcessedDevices.Insert(source);
-	    
-	    if (!source.CanAccessNetwork()) return;
-	    
-	    IEntity sourceEntity = source.GetOwner();
-	    if (!sourceEntity) return;
-	    
-	    vector sourcePos = sourceEntity.GetOrigin();
-	    
-	    array<AG0_TDLDeviceComponent> nearbyDevices = GetNearbyDevices(sourcePos, network);
-	    
-	    foreach (AG0_TDLDeviceComponent device : nearbyDevices)
-	    {
-	        if (device == source || m_aProcessedDevices.Contains(device)) continue;
-	        if (!device.CanAccessNetwork()) continue;
-	        
-	        if (AreDevicesConnected(source, device))
-	        {
-	            if (!m_aConnectedDevices.Contains(device))
-	                m_aConnectedDevices.Insert(device);
-	            FindConnectedDevicesInNetwork(device, network);
-	        }
-	    }
-	}
-    
 	//------------------------------------------------------------------------------------------------
 	//! Push aggregated shape data to a single player across all their network memberships.
 	protected void PushPlayerShapes(SCR_PlayerController controller, int playerId)
@@ -1854,70 +3204,236 @@ class AG0_TDLSystem : WorldSystem
 	}
 
 	//------------------------------------------------------------------------------------------------
-	//! Per-chunk wire-data budget for terrain structure delivery.
-	//!
-	//! Two distinct Reforger RPC constraints to respect:
-	//!   * Overall Reliable packet ceiling ~14 KB before forced fragmentation.
-	//!   * Per-string-parameter cap of 8191 bytes (8 KB − 1). Strings longer than
-	//!     this are silently truncated on the wire — observed empirically as
-	//!     5 chunks of 12000 each arriving as 5 chunks of 8191 each.
-	//!
-	//! 6000 keeps us well clear of the per-param cap with comfortable headroom
-	//! for the syncHash / index / totalChunks params and RPC envelope.
-	protected static const int TERRAIN_STRUCTURES_CHUNK_BYTES = 6000;
+	//! Per-chunk wire-data budget for terrain structure delivery.
+	//!
+	//! Two distinct Reforger RPC constraints to respect:
+	//!   * Overall Reliable packet ceiling ~14 KB before forced fragmentation.
+	//!   * Per-string-parameter cap of 8191 bytes (8 KB − 1). Strings longer than
+	//!     this are silently truncated on the wire — observed empirically as
+	//!     5 chunks of 12000 each arriving as 5 chunks of 8191 each.
+	//!
+	//! 6000 keeps us well clear of the per-param cap with comfortable headroom
+	//! for the syncHash / index / totalChunks params and RPC envelope.
+	protected static const int TERRAIN_STRUCTURES_CHUNK_BYTES = 6000;
+
+	//------------------------------------------------------------------------------------------------
+	//! Push the current terrain structures dataset to a single player as a sequence
+	//! of <14 KB Reliable RPCs. Clients buffer keyed on syncHash and parse only after
+	//! all `totalChunks` arrive — see RpcDo_ReceiveTDLTerrainStructuresChunk.
+	//! Chunks are not sent here but queued as an AG0_TDLTerrainTransfer and streamed
+	//! by StepTerrainTransfers, starting at resumeFrom (chunks the client already has).
+	//!
+	//! Empty payload + any (including empty) hash is a valid "clear local state"
+	//! signal, sent as one zero-length chunk so the client's reassembly bookkeeping
+	//! stays consistent.
+	//!
+	//! The payload is the packed base64(gzip(binary)) form; raw v1 JSON is only
+	//! sent while the server is still packing a freshly fetched JSON dataset.
+	protected void PushPlayerTerrainStructures(SCR_PlayerController controller, int playerId, int resumeFrom = 0)
+	{
+		if (!m_ApiManager || !controller) return;
+
+		AG0_TDLTerrainStructureManager mgr = m_ApiManager.GetTerrainStructureManager();
+		if (!mgr)
+		{
+			// No manager → tell client we have nothing.
+			controller.ReceiveTDLTerrainStructuresChunk(string.Empty, 1, 0, string.Empty);
+			return;
+		}
+
+		string raw = mgr.GetPackedPayload();
+		if (raw.IsEmpty())
+			raw = mgr.GetLastRawJson();
+		string hash = mgr.GetLastSyncHash();
+
+		int totalLen = raw.Length();
+		if (totalLen == 0)
+		{
+			// Empty dataset — single empty chunk so the client transitions cleanly.
+			controller.ReceiveTDLTerrainStructuresChunk(hash, 1, 0, string.Empty);
+			return;
+		}
+
+		QueueTerrainTransfer(playerId, AG0_ETDLTerrainDataset.STRUCTURES, hash, raw, resumeFrom);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Client's answer to RequestTDLTerrainCacheHash: the hash of the dataset it already
+	//! holds (in memory or in its AG0_TDLTerrainCache), empty if none. A match means the
+	//! client loads its own copy; anything else gets the full chunked transfer.
+	//! bufferedHash / bufferedChunks describe a partially received transfer the client
+	//! still holds; if it is for the current hash the transfer resumes after it.
+	//! Nothing is sent while the server has no dataset yet — the fetch's
+	//! Distribute*ToClients asks again when it lands.
+	void OnClientTerrainCacheHash(SCR_PlayerController controller, AG0_ETDLTerrainDataset dataset, string clientHash,
+		string bufferedHash, int bufferedChunks)
+	{
+		if (!m_ApiManager || !controller) return;
+
+		string currentHash;
+		if (dataset == AG0_ETDLTerrainDataset.STRUCTURES)
+		{
+			AG0_TDLTerrainStructureManager structures = m_ApiManager.GetTerrainStructureManager();
+			if (structures)
+				currentHash = structures.GetLastSyncHash();
+		}
+		else
+		{
+			AG0_TDLTerrainRoadManager roads = m_ApiManager.GetTerrainRoadManager();
+			if (roads)
+				currentHash = roads.GetLastSyncHash();
+		}
+
+		if (currentHash.IsEmpty())
+			return;
+
+		int playerId = controller.GetPlayerId();
+		if (clientHash == currentHash)
+		{
+			controller.UseCachedTDLTerrain(dataset, currentHash);
+			Print(string.Format("[TDL_TERRAIN_CACHE] Player %1 has %2 cached (hash=%3), transfer skipped",
+				playerId, typename.EnumToString(AG0_ETDLTerrainDataset, dataset), currentHash), LogLevel.DEBUG);
+			return;
+		}
+
+		int resumeFrom = 0;
+		if (bufferedHash == currentHash)
+			resumeFrom = bufferedChunks;
+
+		if (dataset == AG0_ETDLTerrainDataset.STRUCTURES)
+			PushPlayerTerrainStructures(controller, playerId, resumeFrom);
+		else
+			PushPlayerTerrainRoads(controller, playerId, resumeFrom);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Start (or keep) streaming a dataset to a player. An unfinished transfer of the same
+	//! hash keeps its progress; a different hash, or one backing off after repeated stalls,
+	//! is replaced (the client's buffered chunks still set the resume point).
+	protected void QueueTerrainTransfer(int playerId, AG0_ETDLTerrainDataset dataset, string hash, string payload, int resumeFrom)
+	{
+		float now = GetWorld().GetWorldTime() / 1000.0;
+
+		AG0_TDLTerrainTransfer transfer = FindTerrainTransfer(playerId, dataset);
+		if (transfer && (transfer.m_sHash != hash || transfer.IsBackingOff()))
+		{
+			m_aTerrainTransfers.RemoveItem(transfer);
+			transfer = null;
+		}
+
+		if (!transfer)
+		{
+			transfer = new AG0_TDLTerrainTransfer(playerId, dataset, hash, payload, TERRAIN_STRUCTURES_CHUNK_BYTES, now);
+			m_aTerrainTransfers.Insert(transfer);
+		}
+		transfer.ResumeFrom(resumeFrom, now);
+
+		Print(string.Format("[TDL_TERRAIN_TRANSFER] Queued %1 for player %2: %3 chunks (%4 bytes) from %5, hash=%6",
+			typename.EnumToString(AG0_ETDLTerrainDataset, dataset), playerId, transfer.m_iTotalChunks, payload.Length(),
+			transfer.m_iAckedChunks, hash), LogLevel.DEBUG);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected AG0_TDLTerrainTransfer FindTerrainTransfer(int playerId, AG0_ETDLTerrainDataset dataset)
+	{
+		foreach (AG0_TDLTerrainTransfer transfer : m_aTerrainTransfers)
+		{
+			if (transfer.m_iPlayerId == playerId && transfer.m_eDataset == dataset)
+				return transfer;
+		}
+		return null;
+	}
 
 	//------------------------------------------------------------------------------------------------
-	//! Push the current terrain structures dataset to a single player as a sequence
-	//! of <14 KB Reliable RPCs. Clients buffer keyed on syncHash and parse only after
-	//! all `totalChunks` arrive — see RpcDo_ReceiveTDLTerrainStructuresChunk.
-	//!
-	//! Empty payload + any (including empty) hash is a valid "clear local state"
-	//! signal, sent as one zero-length chunk so the client's reassembly bookkeeping
-	//! stays consistent.
-	protected void PushPlayerTerrainStructures(SCR_PlayerController controller, int playerId)
+	//! Client acknowledgement of the contiguous chunk prefix it holds for a transfer.
+	void OnTerrainChunkAck(int playerId, AG0_ETDLTerrainDataset dataset, string hash, int receivedChunks)
 	{
-		if (!m_ApiManager || !controller) return;
-
-		AG0_TDLTerrainStructureManager mgr = m_ApiManager.GetTerrainStructureManager();
-		if (!mgr)
-		{
-			// No manager → tell client we have nothing.
-			controller.ReceiveTDLTerrainStructuresChunk(string.Empty, 1, 0, string.Empty);
+		AG0_TDLTerrainTransfer transfer = FindTerrainTransfer(playerId, dataset);
+		if (!transfer || transfer.m_sHash != hash)
 			return;
-		}
 
-		string raw = mgr.GetLastRawJson();
-		string hash = mgr.GetLastSyncHash();
+		transfer.ResumeFrom(receivedChunks, GetWorld().GetWorldTime() / 1000.0);
+	}
 
-		int totalLen = raw.Length();
-		if (totalLen == 0)
+	//------------------------------------------------------------------------------------------------
+	//! Stream queued terrain chunks under the server-wide byte budget. Each pass sends at
+	//! most one chunk per transfer, starting after the transfer served last, so a large
+	//! backlog for one player never starves the others (or gameplay RPCs behind them).
+	protected void StepTerrainTransfers(float timeSlice)
+	{
+		if (m_aTerrainTransfers.IsEmpty())
 		{
-			// Empty dataset — single empty chunk so the client transitions cleanly.
-			controller.ReceiveTDLTerrainStructuresChunk(hash, 1, 0, string.Empty);
+			m_fTerrainBudgetBytes = 0;
 			return;
 		}
 
-		int chunkBytes = TERRAIN_STRUCTURES_CHUNK_BYTES;
-		int totalChunks = (totalLen + chunkBytes - 1) / chunkBytes;
+		// Token bucket capped at one second's worth, so an idle period never becomes a burst
+		m_fTerrainBudgetBytes = Math.Min(m_fTerrainBudgetBytes + m_iTerrainBudgetBytesPerSec * timeSlice,
+			m_iTerrainBudgetBytesPerSec);
+
+		float now = GetWorld().GetWorldTime() / 1000.0;
+		PlayerManager playerMgr = GetGame().GetPlayerManager();
 
-		for (int i = 0; i < totalChunks; i = i + 1)
+		// Retire finished and orphaned transfers; restart backed-off ones with a new handshake
+		for (int i = m_aTerrainTransfers.Count() - 1; i >= 0; i--)
 		{
-			int start = i * chunkBytes;
-			int len = Math.Min(chunkBytes, totalLen - start);
-			string chunk = raw.Substring(start, len);
-			controller.ReceiveTDLTerrainStructuresChunk(hash, totalChunks, i, chunk);
+			AG0_TDLTerrainTransfer transfer = m_aTerrainTransfers[i];
+			SCR_PlayerController owner;
+			if (playerMgr)
+				owner = SCR_PlayerController.Cast(playerMgr.GetPlayerController(transfer.m_iPlayerId));
+
+			if (!owner || transfer.IsComplete())
+			{
+				m_aTerrainTransfers.RemoveOrdered(i);
+				continue;
+			}
+
+			transfer.CheckStall(now);
+			if (transfer.ShouldRetryHandshake(now))
+			{
+				AG0_ETDLTerrainDataset dataset = transfer.m_eDataset;
+				m_aTerrainTransfers.RemoveOrdered(i);
+				owner.RequestTDLTerrainCacheHash(dataset);
+			}
 		}
 
-		Print(string.Format("[TDL_STRUCTURES] Sent %1 chunks (%2 bytes) to player %3, hash=%4",
-			totalChunks, totalLen, playerId, hash), LogLevel.DEBUG);
+		int count = m_aTerrainTransfers.Count();
+		bool sentAny = true;
+		while (sentAny && m_fTerrainBudgetBytes > 0)
+		{
+			sentAny = false;
+			for (int n = 0; n < count && m_fTerrainBudgetBytes > 0; n++)
+			{
+				m_iTerrainTransferCursor = (m_iTerrainTransferCursor + 1) % count;
+				AG0_TDLTerrainTransfer candidate = m_aTerrainTransfers[m_iTerrainTransferCursor];
+				if (!candidate.CanSend())
+					continue;
+
+				SCR_PlayerController controller = SCR_PlayerController.Cast(playerMgr.GetPlayerController(candidate.m_iPlayerId));
+				if (!controller)
+					continue;
+
+				// The last chunk may overdraw the bucket; the next frame pays it back
+				int index = candidate.m_iNextChunk;
+				string chunk = candidate.TakeNextChunk(now);
+				if (candidate.m_eDataset == AG0_ETDLTerrainDataset.STRUCTURES)
+					controller.ReceiveTDLTerrainStructuresChunk(candidate.m_sHash, candidate.m_iTotalChunks, index, chunk);
+				else
+					controller.ReceiveTDLTerrainRoadsChunk(candidate.m_sHash, candidate.m_iTotalChunks, index, chunk);
+
+				m_fTerrainBudgetBytes -= 16 + candidate.m_sHash.Length() + chunk.Length();
+				sentAny = true;
+			}
+		}
 	}
 
 	//------------------------------------------------------------------------------------------------
-	//! Distribute the current terrain structures dataset to all connected players.
-	//! Unlike shapes, structures are global to the world — not network-scoped — so
-	//! we iterate every player the PlayerManager knows about. The client RPC handler
-	//! short-circuits when its local hash already matches, so unchanged repeats are cheap.
-	void DistributeTerrainStructuresToClients()
+	int GetTerrainTransferCount() { return m_aTerrainTransfers.Count(); }
+
+	//------------------------------------------------------------------------------------------------
+	//! Ask every connected player which version of a terrain dataset it holds; the
+	//! replies (OnClientTerrainCacheHash) decide between a cache hit and a transfer.
+	protected void RequestTerrainCacheHashes(AG0_ETDLTerrainDataset dataset)
 	{
 		if (!Replication.IsServer()) return;
 
@@ -1936,16 +3452,26 @@ class AG0_TDLSystem : WorldSystem
 			);
 			if (!controller) continue;
 
-			PushPlayerTerrainStructures(controller, playerId);
+			controller.RequestTDLTerrainCacheHash(dataset);
 		}
 	}
 
+	//------------------------------------------------------------------------------------------------
+	//! Distribute the current terrain structures dataset to all connected players.
+	//! Unlike shapes, structures are global to the world — not network-scoped — so
+	//! every player the PlayerManager knows about is asked for its cached hash first;
+	//! only players without the current version receive the chunked transfer.
+	void DistributeTerrainStructuresToClients()
+	{
+		RequestTerrainCacheHashes(AG0_ETDLTerrainDataset.STRUCTURES);
+	}
+
 	//------------------------------------------------------------------------------------------------
 	//! Push the current terrain roads dataset to a single player as a sequence of
 	//! <14 KB Reliable RPCs (chunked at TERRAIN_STRUCTURES_CHUNK_BYTES, same budget).
 	//! See PushPlayerTerrainStructures for the rationale; the road network can be
 	//! larger than structures so chunking matters even more here.
-	protected void PushPlayerTerrainRoads(SCR_PlayerController controller, int playerId)
+	protected void PushPlayerTerrainRoads(SCR_PlayerController controller, int playerId, int resumeFrom = 0)
 	{
 		if (!m_ApiManager || !controller) return;
 
@@ -1956,7 +3482,9 @@ class AG0_TDLSystem : WorldSystem
 			return;
 		}
 
-		string raw = mgr.GetLastRawJson();
+		string raw = mgr.GetPackedPayload();
+		if (raw.IsEmpty())
+			raw = mgr.GetLastRawJson();
 		string hash = mgr.GetLastSyncHash();
 
 		int totalLen = raw.Length();
@@ -1966,19 +3494,7 @@ class AG0_TDLSystem : WorldSystem
 			return;
 		}
 
-		int chunkBytes = TERRAIN_STRUCTURES_CHUNK_BYTES;
-		int totalChunks = (totalLen + chunkBytes - 1) / chunkBytes;
-
-		for (int i = 0; i < totalChunks; i = i + 1)
-		{
-			int start = i * chunkBytes;
-			int len = Math.Min(chunkBytes, totalLen - start);
-			string chunk = raw.Substring(start, len);
-			controller.ReceiveTDLTerrainRoadsChunk(hash, totalChunks, i, chunk);
-		}
-
-		Print(string.Format("[TDL_ROADS] Sent %1 chunks (%2 bytes) to player %3, hash=%4",
-			totalChunks, totalLen, playerId, hash), LogLevel.DEBUG);
+		QueueTerrainTransfer(playerId, AG0_ETDLTerrainDataset.ROADS, hash, raw, resumeFrom);
 	}
 
 	//------------------------------------------------------------------------------------------------
@@ -1986,27 +3502,11 @@ class AG0_TDLSystem : WorldSystem
 	//! Same fan-out semantics as DistributeTerrainStructuresToClients.
 	void DistributeTerrainRoadsToClients()
 	{
-		if (!Replication.IsServer()) return;
-
-		PlayerManager playerMgr = GetGame().GetPlayerManager();
-		if (!playerMgr) return;
-
-		array<int> playerIds = {};
-		playerMgr.GetPlayers(playerIds);
-
-		foreach (int playerId : playerIds)
-		{
-			if (playerId <= 0) continue;
-			SCR_PlayerController controller = SCR_PlayerController.Cast(
-				playerMgr.GetPlayerController(playerId)
-			);
-			if (!controller) continue;
-			PushPlayerTerrainRoads(controller, playerId);
-		}
+		RequestTerrainCacheHashes(AG0_ETDLTerrainDataset.ROADS);
 	}
 
 	//------------------------------------------------------------------------------------------------
-	//! Register the OnPlayerAuditSuccess handler with SCR_BaseGameMode if not yet.
+	//! Register the OnPlayerAuditSuccess / OnPlayerDisconnected handlers with SCR_BaseGameMode if not yet.
 	//! Idempotent — safe to call every tick.
 	protected void EnsurePlayerAuditHandlerRegistered()
 	{
@@ -2022,20 +3522,30 @@ class AG0_TDLSystem : WorldSystem
 			return;
 
 		invoker.Insert(OnPlayerAuditSuccessHandler);
+		gameMode.GetOnPlayerDisconnected().Insert(OnPlayerDisconnectedHandler);
 		m_bPlayerAuditHandlerRegistered = true;
-		Print("[TDL_STRUCTURES] Registered OnPlayerAuditSuccess handler", LogLevel.DEBUG);
+		Print("[TDL_STRUCTURES] Registered OnPlayerAuditSuccess / OnPlayerDisconnected handlers", LogLevel.DEBUG);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Forget what the leaving player's client was sent; player IDs aren't reused within
+	//! a session, so without this the cursors would accumulate for every player ever seen.
+	protected void OnPlayerDisconnectedHandler(int playerId, KickCauseCode cause, int timeout)
+	{
+		foreach (AG0_TDLNetwork network : m_aNetworks)
+			network.RemovePlayerSyncCursors(playerId);
 	}
 
 	//------------------------------------------------------------------------------------------------
 	//! Fires once per session-joining player AFTER the audit succeeds — by which
-	//! point the player's controller is RPC-addressable. Push the current terrain
-	//! structures dataset so the player has it cached locally before they ever
-	//! open the TDL map. Independent of TDL network membership.
+	//! point the player's controller is RPC-addressable. Start the terrain cache
+	//! handshake so the player has the current datasets locally (from its own
+	//! $profile cache, or transferred) before they ever open the TDL map.
+	//! Independent of TDL network membership.
 	//!
-	//! If the API hasn't completed its initial fetch yet, the manager's raw JSON
-	//! is empty and we send (empty, empty) — perfectly fine. When the fetch
-	//! eventually lands, DistributeTerrainStructuresToClients() pushes again to
-	//! every connected player and this one will get the real data then.
+	//! If the API hasn't completed its initial fetch yet, the handshake sends
+	//! nothing. When the fetch eventually lands, DistributeTerrainStructuresToClients()
+	//! asks every connected player again and this one will get the real data then.
 	protected void OnPlayerAuditSuccessHandler(int playerId)
 	{
 		if (playerId <= 0) return;
@@ -2048,8 +3558,8 @@ class AG0_TDLSystem : WorldSystem
 		);
 		if (!controller) return;
 
-		PushPlayerTerrainStructures(controller, playerId);
-		PushPlayerTerrainRoads(controller, playerId);
+		controller.RequestTDLTerrainCacheHash(AG0_ETDLTerrainDataset.STRUCTURES);
+		controller.RequestTDLTerrainCacheHash(AG0_ETDLTerrainDataset.ROADS);
 	}
 	
     //------------------------------------------------------------------------------------------------
@@ -2121,6 +3631,15 @@ class AG0_TDLSystem : WorldSystem
 	    if (networkId > 0)
 	    {
 	        controller.NotifyClearNetwork(networkId);
+	        
+	        // The client just dropped its baseline for this network
+	        AG0_TDLNetwork network = FindNetworkByID(networkId);
+	        if (network)
+	        {
+	            AG0_TDLMemberSyncCursor cursor = network.FindMemberSyncCursor(playerId);
+	            if (cursor)
+	                cursor.RequestKeyframe();
+	        }
 	    }
 
 	    PushPlayerShapes(controller, playerId);
@@ -2176,7 +3695,54 @@ class AG0_TDLSystem : WorldSystem
 
 	    if (networkId <= 0) return;
 	    
-	    controller.NotifyNetworkMembers(networkId, membersArray);
+	    SendNetworkMembersToController(controller, playerId, networkId, membersArray);
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Ship a member list as a small unreliable delta against the player's last keyframe, or as
+	//! a reliable keyframe when one is due or the delta would not be meaningfully smaller.
+	protected void SendNetworkMembersToController(SCR_PlayerController controller, int playerId, int networkId,
+	                                              array<ref AG0_TDLNetworkMember> members)
+	{
+	    AG0_TDLNetwork network = FindNetworkByID(networkId);
+	    if (!network)
+	    {
+	        controller.NotifyNetworkMembersKeyframe(networkId, 0, members);
+	        return;
+	    }
+	    
+	    AG0_TDLMemberSyncCursor cursor = network.GetMemberSyncCursor(playerId);
+	    if (!cursor.NeedsKeyframe())
+	    {
+	        array<int> ops = {};
+	        array<string> names = {};
+	        int seq = cursor.BuildDelta(members, ops, names);
+	        
+	        // Names are the only variable-size part; budget them at the padded width
+	        int deltaBytes = ops.Count() * 4 + names.Count() * AG0_TDLNetworkMember.MAX_PLAYER_NAME_LENGTH;
+	        if (deltaBytes * 2 < members.Count() * AG0_TDLNetworkMember.DATA_SIZE)
+	        {
+	            controller.NotifyNetworkMembersDelta(networkId, cursor.GetKeyframeId(), seq, ops, names);
+	            return;
+	        }
+	    }
+	    
+	    int keyframeId = cursor.SetKeyframe(members);
+	    controller.NotifyNetworkMembersKeyframe(networkId, keyframeId, members);
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Client has no usable baseline for this network's member deltas
+	void RequestNetworkMembersKeyframe(int playerId, int networkId)
+	{
+	    if (!Replication.IsServer()) return;
+	    
+	    AG0_TDLNetwork network = FindNetworkByID(networkId);
+	    if (!network) return;
+	    
+	    AG0_TDLMemberSyncCursor cursor = network.FindMemberSyncCursor(playerId);
+	    if (cursor)
+	        cursor.RequestKeyframe();
 	}
     
     //------------------------------------------------------------------------------------------------
@@ -2251,6 +3817,7 @@ class AG0_TDLSystem : WorldSystem
 	    if (!Replication.IsServer()) return;
 	    
 	    Print(string.Format("TDL_VIDEO_SYSTEM: OnVideoBroadcastChanged for device %1", device.GetOwner()), LogLevel.DEBUG);
+	    OnDeviceStateChanged(device);
 	    
 	    IEntity player = GetPlayerFromDevice(device);
 	    if (!player)
@@ -2295,6 +3862,8 @@ class AG0_TDLSystem : WorldSystem
 	{
 	    if (!Replication.IsServer()) return;
 	    
+	    AG0_TDLProfileScope scope = m_Profiler.Scope(AG0_ETDLProfileStage.VIDEO_STREAMING);
+	    
 	    foreach (AG0_TDLDeviceComponent networkDevice : m_aRegisteredNetworkDevices)
 	    {
 	        if (!networkDevice.IsInNetwork()) continue;
@@ -2353,7 +3922,7 @@ class AG0_TDLSystem : WorldSystem
 	                // NOT push fresh member data (with the new callsign) through the primary
 	                // PlayerController snapshot channel. Force an immediate connectivity rebuild
 	                // so the updated GetDisplayName() flows to every member's
-	                // m_mTDLNetworkMembersMap this frame, not on the next UpdateNetworks tick.
+	                // m_mTDLNetworkMembersMap this frame, not on the next network update cycle.
 	                NotifyNetworkMembersUpdated(network);
 	                UpdateNetworkConnectivity(network);
 	            }
@@ -2418,8 +3987,8 @@ class AG0_TDLSystem : WorldSystem
 
             // Sender auto-delivery: CreateBroadcast/CreateDirect both insert the
             // sender into m_DeliveredTo at construction (AG0_TDLMessage.c:76, :100),
-            // which means PropagateMessagesInNetwork's CanDeliverTo short-circuits
-            // for the sender on every subsequent pass — MarkDeliveredTo is never
+            // which means the sender is never a pending recipient in
+            // RelayMessagesInComponent — MarkDeliveredTo is never
             // called for them. The hop logic considers this correct (sender always
             // has the message), but my ApiNotifyMessageDelivered hook only fires
             // from MarkDeliveredTo callsites, so the API never learns the sender is
@@ -2439,7 +4008,12 @@ class AG0_TDLSystem : WorldSystem
             }
         }
 
-        PropagateMessagesInNetwork(system, network);
+        // Hand the new message across the sender's component as of the last connectivity
+        // pass; later topology changes pick up anyone still pending
+        array<AG0_TDLDeviceComponent> senderComponent = network.GetComponentOf(senderDevice);
+        if (!senderComponent)
+            senderComponent = {senderDevice};
+        RelayMessagesInComponent(system, network, senderComponent, canonical);
     }
     
     //------------------------------------------------------------------------------------------------
@@ -2462,139 +4036,107 @@ class AG0_TDLSystem : WorldSystem
     }
     
     //------------------------------------------------------------------------------------------------
-    static void PropagateMessagesForDevice(AG0_TDLSystem system, AG0_TDLNetwork network,
-                                          AG0_TDLDeviceComponent device,
-                                          map<RplId, ref AG0_TDLNetworkMember> connectedMembers)
+    // Deliver pending messages across one connectivity component. Links within a component are
+    // transitive, so any member holding a message can relay it to every pending recipient in the
+    // same component in a single pass. Only messages with undelivered recipients are visited, and
+    // only devices that received something (plus the senders, for their receipt status) are
+    // re-sent their inbox. Pass newMessage to relay just that message and always echo it to its sender.
+    //------------------------------------------------------------------------------------------------
+    static void RelayMessagesInComponent(AG0_TDLSystem system, AG0_TDLNetwork network,
+                                         array<AG0_TDLDeviceComponent> component,
+                                         AG0_TDLMessage newMessage = null)
     {
         if (!Replication.IsServer()) return;
-        if (!network || !device) return;
-
-        RplId deviceRplId = device.GetDeviceRplId();
-        if (deviceRplId == RplId.Invalid()) return;
-
-        set<RplId> connectedRplIds = new set<RplId>();
-        foreach (RplId rplId, AG0_TDLNetworkMember member : connectedMembers)
-        {
-            connectedRplIds.Insert(rplId);
-        }
+        if (!network || !component) return;
+        
+        AG0_TDLProfileScope scope;
+        if (system)
+            scope = system.GetProfiler().Scope(AG0_ETDLProfileStage.MESSAGE_RELAY);
 
-        array<ref AG0_TDLMessage> deliverable = GetDeliverableMessages(network, deviceRplId, connectedRplIds);
+        array<ref AG0_TDLMessage> pending = network.GetPendingMessages();
+        set<RplId> devicesToRefresh = new set<RplId>();
+        if (newMessage)
+            devicesToRefresh.Insert(newMessage.GetSenderRplId());
 
-        if (deliverable.Count() > 0)
+        if (!pending.IsEmpty())
         {
-            Print(string.Format("TDL_MESSAGE_PROPAGATION: %1 new messages can be delivered to %2",
-                deliverable.Count(), device.GetDisplayName()), LogLevel.DEBUG);
-
-            // Resolve identity ONCE per device — only fire API delivery events for
-            // web-linked players (saves quota; the API ignores deliveries it can't
-            // surface anywhere). Empty identityId == not linked / NPC / AI.
-            int devicePlayerId = system.GetPlayerIdFromDeviceRplId(deviceRplId);
-            string deviceIdentity = "";
-            if (devicePlayerId > 0)
-                deviceIdentity = system.GetPlayerIdentityId(devicePlayerId);
-            string deviceCallsign = device.GetDisplayName();
-
-            foreach (AG0_TDLMessage msg : deliverable)
+            set<RplId> componentRplIds = new set<RplId>();
+            foreach (AG0_TDLDeviceComponent device : component)
             {
-                msg.MarkDeliveredTo(deviceRplId);
-
-                if (!deviceIdentity.IsEmpty())
-                {
-                    system.ApiNotifyMessageDelivered(network, msg.GetMessageId(),
-                        deviceRplId, deviceCallsign, deviceIdentity, devicePlayerId);
-                }
+                RplId rplId = device.GetDeviceRplId();
+                if (rplId != RplId.Invalid())
+                    componentRplIds.Insert(rplId);
             }
 
-            SendMessagesToClient(system, network, device);
-        }
-    }
-    
-    //------------------------------------------------------------------------------------------------
-    static void PropagateMessagesInNetwork(AG0_TDLSystem system, AG0_TDLNetwork network)
-    {
-        if (!Replication.IsServer()) return;
-        if (!network) return;
-
-        bool anyDelivered = true;
-        int iterations = 0;
-        const int MAX_ITERATIONS = 10;
-
-        // Buffer (msgId, deviceRplId) pairs that flipped to delivered during this
-        // multi-pass relay so we can fire API events ONCE at the end. Doing it
-        // inside the inner loop would re-emit duplicates as later passes revisit
-        // already-delivered messages, and would also slow the propagation loop with
-        // per-pair JSON serialization. Identity resolution is also expensive enough
-        // to want to amortize.
-        array<int> newlyDeliveredMessageIds = {};
-        array<RplId> newlyDeliveredDeviceIds = {};
+            // Buffer (msgId, deviceRplId) pairs so API delivery events fire once at the end
+            // with identity resolved per device, not per pair
+            array<int> newlyDeliveredMessageIds = {};
+            array<RplId> newlyDeliveredDeviceIds = {};
+            array<RplId> recipients = {};
 
-        while (anyDelivered && iterations < MAX_ITERATIONS)
-        {
-            anyDelivered = false;
-            iterations++;
-
-            foreach (AG0_TDLDeviceComponent device : network.GetNetworkDevices())
+            foreach (AG0_TDLMessage msg : pending)
             {
-                if (!device.CanAccessNetwork()) continue;
-
-                RplId deviceRplId = device.GetDeviceRplId();
-                if (deviceRplId == RplId.Invalid()) continue;
-
-                set<RplId> connectedRplIds = GetDeviceConnectedRplIds(system, device, network);
+                if (newMessage && msg != newMessage) continue;
+                if (!IsMessageHeldInComponent(msg, componentRplIds)) continue;
 
-                array<ref AG0_TDLMessage> messages = GetNetworkMessages(network);
-                foreach (AG0_TDLMessage msg : messages)
+                recipients.Clear();
+                foreach (RplId pendingRplId : msg.GetPendingRecipients())
                 {
-                    if (msg.CanDeliverTo(deviceRplId, connectedRplIds))
-                    {
-                        msg.MarkDeliveredTo(deviceRplId);
-                        anyDelivered = true;
-                        newlyDeliveredMessageIds.Insert(msg.GetMessageId());
-                        newlyDeliveredDeviceIds.Insert(deviceRplId);
+                    if (componentRplIds.Contains(pendingRplId))
+                        recipients.Insert(pendingRplId);
+                }
+                if (recipients.IsEmpty()) continue;
 
-                        Print(string.Format("TDL_MESSAGE_PROPAGATION: Message %1 delivered to %2",
-                            msg.GetMessageId(), device.GetDisplayName()), LogLevel.DEBUG);
-                    }
+                foreach (RplId recipientRplId : recipients)
+                {
+                    msg.MarkDeliveredTo(recipientRplId);
+                    newlyDeliveredMessageIds.Insert(msg.GetMessageId());
+                    newlyDeliveredDeviceIds.Insert(recipientRplId);
+                    devicesToRefresh.Insert(recipientRplId);
                 }
+                devicesToRefresh.Insert(msg.GetSenderRplId());
+
+                Print(string.Format("TDL_MESSAGE_PROPAGATION: Message %1 delivered to %2 devices",
+                    msg.GetMessageId(), recipients.Count()), LogLevel.DEBUG);
             }
+
+            network.PrunePendingMessages();
+
+            if (newlyDeliveredMessageIds.Count() > 0)
+                system.FlushApiDeliveryEvents(network, newlyDeliveredMessageIds, newlyDeliveredDeviceIds);
         }
 
-        foreach (AG0_TDLDeviceComponent device : network.GetNetworkDevices())
+        foreach (RplId refreshRplId : devicesToRefresh)
         {
-            SendMessagesToClient(system, network, device);
+            AG0_TDLDeviceComponent refreshDevice = system.GetDeviceByRplId(refreshRplId);
+            if (refreshDevice && network.GetMeshNode(refreshDevice))
+                SendMessagesToClient(system, network, refreshDevice);
         }
-
-        // After the relay settles, fan out delivery events to the API for each
-        // (message, web-linked recipient) pair that flipped this pass. Resolve
-        // identity per unique deviceRplId so we only call SCR_PlayerIdentityUtils once.
-        if (newlyDeliveredMessageIds.Count() > 0)
-            system.FlushApiDeliveryEvents(network, newlyDeliveredMessageIds, newlyDeliveredDeviceIds);
     }
-    
+
+    //------------------------------------------------------------------------------------------------
+    // True if any device in the component already has the message. Walks whichever of the two
+    // sets is smaller.
     //------------------------------------------------------------------------------------------------
-    static set<RplId> GetDeviceConnectedRplIds(AG0_TDLSystem system, AG0_TDLDeviceComponent device, 
-                                               AG0_TDLNetwork network)
+    static bool IsMessageHeldInComponent(AG0_TDLMessage msg, set<RplId> componentRplIds)
     {
-        set<RplId> result = new set<RplId>();
-        
-        RplId selfRplId = device.GetDeviceRplId();
-        if (selfRplId != RplId.Invalid())
-            result.Insert(selfRplId);
-        
-        foreach (AG0_TDLDeviceComponent otherDevice : network.GetNetworkDevices())
+        set<RplId> holders = msg.GetDeliveredTo();
+        if (holders.Count() < componentRplIds.Count())
         {
-            if (otherDevice == device) continue;
-            if (!otherDevice.CanAccessNetwork()) continue;
-            
-            if (system.AreDevicesConnected(device, otherDevice))
+            foreach (RplId holderRplId : holders)
             {
-                RplId otherRplId = otherDevice.GetDeviceRplId();
-                if (otherRplId != RplId.Invalid())
-                    result.Insert(otherRplId);
+                if (componentRplIds.Contains(holderRplId))
+                    return true;
             }
+            return false;
         }
-        
-        return result;
+
+        foreach (RplId rplId : componentRplIds)
+        {
+            if (holders.Contains(rplId))
+                return true;
+        }
+        return false;
     }
     
     //------------------------------------------------------------------------------------------------
@@ -2617,9 +4159,88 @@ class AG0_TDLSystem : WorldSystem
         );
         if (!controller) return;
         
-        array<ref AG0_TDLMessageClient> clientMessages = BuildClientMessages(network, deviceRplId);
+        // Diff the visible log against what this player's client was last sent for this
+        // device: unseen messages go out in full, already-sent ones only if their status flipped
+        AG0_TDLMessageSyncCursor cursor = network.GetMessageSyncCursor(playerId, deviceRplId);
+        if (cursor.NeedsReset())
+            cursor.Reset();
+        
+        array<ref AG0_TDLMessageClient> newMessages = {};
+        array<int> statusUpdates = {};
+        array<ref AG0_TDLMessage> messages = network.GetMessages();
+        
+        foreach (AG0_TDLMessage msg : messages)
+        {
+            if (!msg.IsRelevantTo(deviceRplId) || !msg.IsDeliveredTo(deviceRplId)) continue;
+            
+            int messageId = msg.GetMessageId();
+            int sentStatus;
+            if (!cursor.m_mSentStatus.Find(messageId, sentStatus))
+            {
+                AG0_TDLMessageClient clientMsg = AG0_TDLMessageClient.FromServerMessage(msg, deviceRplId);
+                newMessages.Insert(clientMsg);
+                cursor.m_mSentStatus.Set(messageId, clientMsg.status);
+                continue;
+            }
+            
+            ETDLMessageStatus status = AG0_TDLMessageClient.GetStatusForViewer(msg, deviceRplId);
+            if (status != sentStatus)
+            {
+                statusUpdates.Insert(AG0_TDLMessageClient.PackStatusUpdate(messageId, status));
+                cursor.m_mSentStatus.Set(messageId, status);
+            }
+        }
+        
+        // Drop entries for messages that aged out of retention
+        if (cursor.m_mSentStatus.Count() > messages.Count())
+        {
+            array<int> sentIds = {};
+            foreach (int sentId, int unused : cursor.m_mSentStatus)
+                sentIds.Insert(sentId);
+            foreach (int sentId : sentIds)
+            {
+                if (!network.GetMessageById(messages, sentId))
+                    cursor.m_mSentStatus.Remove(sentId);
+            }
+        }
+        
+        if (newMessages.IsEmpty() && statusUpdates.IsEmpty()) return;
+        
+        int baseSeq = cursor.m_iSentSeq;
+        cursor.m_iSentSeq++;
+        controller.ReceiveTDLMessageDelta(network.GetNetworkID(), deviceRplId, baseSeq, cursor.m_iSentSeq, newMessages, statusUpdates);
+    }
+    
+    //------------------------------------------------------------------------------------------------
+    // Client confirmed it applied the delta with this sequence number
+    //------------------------------------------------------------------------------------------------
+    static void AckMessageSync(AG0_TDLSystem system, int playerId, int networkId, RplId viewerRplId, int seq)
+    {
+        AG0_TDLNetwork network = system.GetNetworkById(networkId);
+        if (!network) return;
+        
+        AG0_TDLMessageSyncCursor cursor = network.FindMessageSyncCursor(playerId, viewerRplId);
+        if (cursor)
+            cursor.Ack(seq);
+    }
+    
+    //------------------------------------------------------------------------------------------------
+    // Client store is out of step with the cursor (missed base, fresh controller): start over
+    // from base 0 and send the viewer's full visible log
+    //------------------------------------------------------------------------------------------------
+    static void ResyncMessages(AG0_TDLSystem system, int playerId, int networkId, RplId viewerRplId)
+    {
+        AG0_TDLNetwork network = system.GetNetworkById(networkId);
+        if (!network) return;
+        
+        AG0_TDLMessageSyncCursor cursor = network.FindMessageSyncCursor(playerId, viewerRplId);
+        if (!cursor) return;
+        
+        AG0_TDLDeviceComponent viewerDevice = system.GetDeviceByRplId(viewerRplId);
+        cursor.Reset();
         
-        controller.ReceiveTDLMessages(network.GetNetworkID(), clientMessages);
+        if (viewerDevice && network.GetMeshNode(viewerDevice))
+            SendMessagesToClient(system, network, viewerDevice);
     }
     
     //------------------------------------------------------------------------------------------------
@@ -2643,11 +4264,12 @@ class AG0_TDLSystem : WorldSystem
         );
         if (!controller) return;
         
-        set<RplId> senderConnected = GetDeviceConnectedRplIds(system, senderDevice, network);
-        if (!senderConnected.Contains(readerRplId))
+        AG0_TDLDeviceComponent readerDevice = system.GetDeviceByRplId(readerRplId);
+        if (!readerDevice || !network.AreInSameComponent(senderDevice, readerDevice))
             return;
         
-        controller.ReceiveTDLReadReceipt(network.GetNetworkID(), msg.GetMessageId(), readerRplId);
+        // The READ flip reaches the sender as a status update in their next delta
+        SendMessagesToClient(system, network, senderDevice);
     }
     
     //------------------------------------------------------------------------------------------------
@@ -2699,15 +4321,6 @@ class AG0_TDLSystem : WorldSystem
         return network.GetMessages();
     }
     
-    //------------------------------------------------------------------------------------------------
-    static array<ref AG0_TDLMessage> GetDeliverableMessages(AG0_TDLNetwork network, RplId targetRplId,
-                                                           set<RplId> connectedDevices)
-    {
-        return network.GetDeliverableMessages(
-            network.GetMessages(), targetRplId, connectedDevices
-        );
-    }
-    
     //------------------------------------------------------------------------------------------------
     static array<ref AG0_TDLMessageClient> BuildClientMessages(AG0_TDLNetwork network, RplId viewerRplId)
     {
@@ -2732,6 +4345,8 @@ class AG0_TDLSystem : WorldSystem
 	    if (!m_ApiManager || !m_ApiManager.CanCommunicate())
 	        return;
 	    
+	    AG0_TDLProfileScope scope = m_Profiler.Scope(AG0_ETDLProfileStage.API_SERIALIZE);
+	    
 	    SCR_JsonSaveContext json = new SCR_JsonSaveContext();
 	    json.WriteValue("type", "heartbeat");
 	    json.WriteValue("timestamp", System.GetUnixTime());
@@ -2741,21 +4356,71 @@ class AG0_TDLSystem : WorldSystem
 	    json.WriteValue("deviceCount", m_aRegisteredNetworkDevices.Count());
 	    json.WriteValue("playerCount", GetConnectedPlayerCount());
 
+	    if (m_ApiManager.IsPerfInHeartbeatEnabled())
+	    {
+	        json.WriteValue("scheduleLag", GetScheduleLag());
+	        json.WriteValue("outboxQueued", m_ApiManager.GetOutboxCount());
+	        json.WriteValue("outboxCoalesced", m_ApiManager.GetOutboxCoalesced());
+	        json.WriteValue("outboxDropped", m_ApiManager.GetOutboxDropped());
+	        m_Profiler.WriteJson(json);
+	    }
+
 	    m_ApiManager.SubmitData(json.ExportToString());
 	}
 	
-	protected void ApiSyncFullState()
+	//! Send this interval's state to the API: a full state_sync keyframe, or a state_delta
+	//! against the last state the API acknowledged. Skipped while the previous one is unanswered.
+	protected void ApiSyncState()
 	{
-	    if (!m_ApiManager || !m_ApiManager.CanCommunicate())
+	    if (!m_ApiManager || !m_ApiManager.CanCommunicate() || !m_ApiStateTracker)
+	        return;
+	    
+	    if (m_ApiStateTracker.IsAwaitingAck())
 	        return;
 	    
+	    AG0_TDLProfileScope scope = m_Profiler.Scope(AG0_ETDLProfileStage.API_SERIALIZE);
+	    
 	    SCR_JsonSaveContext json = new SCR_JsonSaveContext();
-	    json.WriteValue("type", "state_sync");
+	    if (!m_ApiStateTracker.WritePayload(json, CollectApiState()))
+	        return;
+	    
 	    json.WriteValue("timestamp", System.GetUnixTime());
 	    json.WriteValue("worldFile", GetGame().GetWorldFile());
 	    json.WriteValue("worldId", AG0_MapSatelliteConfigHelper.GetCurrentWorldIdentifier());
-
-	    array<ref AG0_TDLNetworkState> networkStates = {};
+	    
+	    if (!m_ApiManager.SubmitStateSync(json.ExportToString()))
+	        m_ApiStateTracker.OnSyncFailed();
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Response to the state payload in flight (AG0_TDLApiManager state-sync callback)
+	void OnApiStateSyncResult(bool success, bool resyncRequested)
+	{
+	    if (!m_ApiStateTracker)
+	        return;
+	    
+	    if (success)
+	        m_ApiStateTracker.OnSyncAcknowledged();
+	    else
+	        m_ApiStateTracker.OnSyncFailed();
+	    
+	    if (resyncRequested)
+	        RequestApiStateKeyframe();
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Make the next state sync a full keyframe (API state_resync command or resync response)
+	void RequestApiStateKeyframe()
+	{
+	    if (m_ApiStateTracker)
+	        m_ApiStateTracker.RequestKeyframe();
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	protected AG0_TDLApiStateSnapshot CollectApiState()
+	{
+	    AG0_TDLApiStateSnapshot snapshot = new AG0_TDLApiStateSnapshot();
+	    
 	    foreach (AG0_TDLNetwork network : m_aNetworks)
 	    {
 	        AG0_TDLNetworkState netState = new AG0_TDLNetworkState();
@@ -2765,11 +4430,12 @@ class AG0_TDLSystem : WorldSystem
 			netState.waveform = network.GetWaveform();
 	        netState.deviceCount = network.GetNetworkDevices().Count();
 	        netState.messageCount = network.GetMessages().Count();
+	        snapshot.AddNetwork(netState);
 
-	        array<ref AG0_TDLDeviceState> deviceStates = {};
 	        foreach (AG0_TDLDeviceComponent device : network.GetNetworkDevices())
 	        {
 	            AG0_TDLDeviceState devState = new AG0_TDLDeviceState();
+	            devState.networkStableId = netState.networkStableId;
 	            // Send the actual replication id, not a presence flag. The web UI
 	            // round-trips this value back to us in message_send.recipientRplId
 	            // for direct traffic, so collapsing every valid device to "1" made
@@ -2820,16 +4486,11 @@ class AG0_TDLSystem : WorldSystem
 			        Print(string.Format("[TDL_API] No player found for device %1", device.GetDisplayName()), LogLevel.DEBUG);
 			    }
 	            
-	            deviceStates.Insert(devState);
+	            snapshot.AddDevice(netState, devState);
 	        }
-	        netState.devices = deviceStates;
-	        networkStates.Insert(netState);
 	    }
 	    
-	    json.WriteValue("networks", networkStates);
-	    json.WriteValue("totalDevices", m_aRegisteredNetworkDevices.Count());
-	    
-		array<ref AG0_TDLMapMarkerState> markerStates = {};
+	    snapshot.m_iTotalDevices = m_aRegisteredNetworkDevices.Count();
 	    
 	    SCR_MapMarkerManagerComponent markerMgr = SCR_MapMarkerManagerComponent.GetInstance();
 	    if (markerMgr)
@@ -2864,13 +4525,11 @@ class AG0_TDLSystem : WorldSystem
 	            else
 	                ms.ownerPlayerName = "";
 	            
-	            markerStates.Insert(ms);
+	            snapshot.AddMarker(ms);
 	        }
 	    }
 	    
-	    json.WriteValue("markers", markerStates);
-		
-	    m_ApiManager.SubmitData(json.ExportToString());
+	    return snapshot;
 	}
 	
 	protected void ApiNotifyNetworkCreated(AG0_TDLNetwork network, string creatorName)
@@ -2887,7 +4546,7 @@ class AG0_TDLSystem : WorldSystem
 	    json.WriteValue("networkName", network.GetNetworkName());
 	    json.WriteValue("creatorName", creatorName);
 
-	    m_ApiManager.SubmitData(json.ExportToString());
+	    m_ApiManager.QueueEvent(json.ExportToString());
 	}
 
 	//! Signature carries stableId because the API needs it to delete the right
@@ -2906,7 +4565,7 @@ class AG0_TDLSystem : WorldSystem
 	    json.WriteValue("networkStableId", networkStableId);
 	    json.WriteValue("networkName", networkName);
 
-	    m_ApiManager.SubmitData(json.ExportToString());
+	    m_ApiManager.QueueEvent(json.ExportToString());
 	}
 
 	protected void ApiNotifyDeviceJoined(AG0_TDLNetwork network, AG0_TDLDeviceComponent device)
@@ -2942,7 +4601,7 @@ class AG0_TDLSystem : WorldSystem
 	        }
 	    }
 	    
-	    m_ApiManager.SubmitData(json.ExportToString());
+	    m_ApiManager.QueueEvent(json.ExportToString());
 	}
 	
 	//! Same stableId-as-arg pattern as ApiNotifyNetworkDeleted — caller captures
@@ -2963,7 +4622,7 @@ class AG0_TDLSystem : WorldSystem
 	    json.WriteValue("networkName", networkName);
 	    json.WriteValue("deviceCallsign", deviceCallsign);
 
-	    m_ApiManager.SubmitData(json.ExportToString());
+	    m_ApiManager.QueueEvent(json.ExportToString());
 	}
 	
 	//------------------------------------------------------------------------------------------------
@@ -2972,7 +4631,7 @@ class AG0_TDLSystem : WorldSystem
 	//!
 	//! NOTE: this is NOT a delivery notification — the message's per-recipient delivery
 	//! state lives in the mod's hop graph (see ApiNotifyMessageDelivered, fired from
-	//! PropagateMessagesForDevice when MarkDeliveredTo lands on a web-linked player).
+	//! FlushApiDeliveryEvents when MarkDeliveredTo lands on a web-linked player).
 	//! The API must treat all recipients as PENDING until it receives a matching
 	//! message_delivered event for them.
 	//!
@@ -3038,17 +4697,17 @@ class AG0_TDLSystem : WorldSystem
 	        }
 	    }
 
-	    m_ApiManager.SubmitData(json.ExportToString());
+	    m_ApiManager.QueueEvent(json.ExportToString());
 	}
 
 	//------------------------------------------------------------------------------------------------
-	//! Fired from PropagateMessagesForDevice when MarkDeliveredTo lands on a device whose
+	//! Fired from FlushApiDeliveryEvents when MarkDeliveredTo lands on a device whose
 	//! owner is a web-linked player. The mod's hop logic stays authoritative — this just
 	//! mirrors the state change so the web inbox flips PENDING→DELIVERED in real time.
 	//!
 	//! We deliberately skip non-linked recipients: the API has no UI for them, so spamming
 	//! events for every NPC/AI device wastes bandwidth and the API quota. The check is in
-	//! the caller (PropagateMessagesForDevice) so this method just emits unconditionally.
+	//! the caller (FlushApiDeliveryEvents) so this method just emits unconditionally.
 	protected void ApiNotifyMessageDelivered(AG0_TDLNetwork network, int messageId,
 	                                          RplId recipientRplId, string recipientCallsign,
 	                                          string recipientIdentityId, int recipientPlayerId)
@@ -3072,7 +4731,8 @@ class AG0_TDLSystem : WorldSystem
 	    if (recipientPlayerId > 0)
 	        json.WriteValue("recipientPlayerId", recipientPlayerId);
 
-	    m_ApiManager.SubmitData(json.ExportToString());
+	    m_ApiManager.QueueEvent(json.ExportToString(),
+	        ApiMessageRecipientKey(network, messageId, recipientRplId), API_EVENT_RANK_DELIVERED);
 	}
 
 	//------------------------------------------------------------------------------------------------
@@ -3101,7 +4761,9 @@ class AG0_TDLSystem : WorldSystem
 	    if (readerPlayerId > 0)
 	        json.WriteValue("readerPlayerId", readerPlayerId);
 
-	    m_ApiManager.SubmitData(json.ExportToString());
+	    // Supersedes a still-queued message_delivered for the same recipient: read implies delivered
+	    m_ApiManager.QueueEvent(json.ExportToString(),
+	        ApiMessageRecipientKey(network, messageId, readerRplId), API_EVENT_RANK_READ);
 	}
 
 	//------------------------------------------------------------------------------------------------
@@ -3128,9 +4790,16 @@ class AG0_TDLSystem : WorldSystem
 	    if (!networkStableId.IsEmpty())
 	        json.WriteValue("networkStableId", networkStableId);
 
-	    m_ApiManager.SubmitData(json.ExportToString());
+	    m_ApiManager.QueueEvent(json.ExportToString());
 	}
 	
+	//------------------------------------------------------------------------------------------------
+	//! Outbox coalesce key for per-recipient message state events (delivered / read)
+	protected string ApiMessageRecipientKey(AG0_TDLNetwork network, int messageId, RplId recipientRplId)
+	{
+	    return string.Format("msg:%1:%2:%3", network.GetStableId(), messageId, recipientRplId);
+	}
+
 	protected int GetConnectedPlayerCount()
 	{
 	    PlayerManager playerMgr = GetGame().GetPlayerManager();
@@ -3147,6 +4816,11 @@ class AG0_TDLSystem : WorldSystem
 	    return m_ApiManager;
 	}
 	
+	AG0_TDLProfiler GetProfiler()
+	{
+	    return m_Profiler;
+	}
+	
 	bool IsApiConnected()
 	{
 	    return m_ApiManager && m_ApiManager.CanCommunicate();
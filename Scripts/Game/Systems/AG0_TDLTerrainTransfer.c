@@ -0,0 +1,126 @@
+//------------------------------------------------------------------------------------------------
+// AG0_TDLTerrainTransfer.c
+// One in-progress terrain dataset delivery to one player. AG0_TDLSystem owns the list and
+// streams chunks from it under a server-wide byte budget (StepTerrainTransfers), one chunk
+// per transfer per round so simultaneous joiners share the reliable channel fairly.
+//
+// Flow control: at most WINDOW chunks may be ahead of the client's acknowledged prefix.
+// Clients ack the contiguous prefix they hold (RpcAsk_TDLTerrainChunkAck); that prefix is
+// also the resume point — a stalled transfer rewinds to it instead of chunk 0, and a new
+// handshake for the same hash picks up where the client's buffer ends. A transfer that
+// keeps stalling backs off for RETRY_SECONDS and is then replaced by a fresh handshake
+// (StepTerrainTransfers), so a bad patch of connection never leaves a player without terrain.
+// Server-side only.
+//------------------------------------------------------------------------------------------------
+class AG0_TDLTerrainTransfer
+{
+	// Chunks in flight beyond the acknowledged prefix
+	static const int WINDOW = 8;
+	// No ack progress for this long → rewind to the acknowledged prefix and resend
+	static const float STALL_SECONDS = 20;
+	// Rewinds before the transfer backs off and is restarted through a new handshake
+	static const int MAX_REWINDS = 3;
+	// Pause after the last rewind before the handshake is re-sent
+	static const float RETRY_SECONDS = 30;
+
+	int m_iPlayerId;
+	AG0_ETDLTerrainDataset m_eDataset;
+	string m_sHash;
+	string m_sPayload;
+	int m_iChunkBytes;
+	int m_iTotalChunks;
+
+	int m_iNextChunk;			// next index to send
+	int m_iAckedChunks;			// contiguous prefix the client confirmed
+	float m_fLastProgress;		// world time (s) of the last send / ack progress
+	int m_iRewinds;
+	float m_fRetryAt = -1;		// world time (s) to re-send the handshake, -1 while streaming
+
+	//------------------------------------------------------------------------------------------------
+	void AG0_TDLTerrainTransfer(int playerId, AG0_ETDLTerrainDataset dataset, string hash, string payload, int chunkBytes, float now)
+	{
+		m_iPlayerId = playerId;
+		m_eDataset = dataset;
+		m_sHash = hash;
+		m_sPayload = payload;
+		m_iChunkBytes = chunkBytes;
+		m_iTotalChunks = (payload.Length() + chunkBytes - 1) / chunkBytes;
+		m_fLastProgress = now;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Skip chunks the client already holds (from its handshake or an ack)
+	void ResumeFrom(int receivedChunks, float now)
+	{
+		receivedChunks = Math.ClampInt(receivedChunks, 0, m_iTotalChunks);
+		if (receivedChunks <= m_iAckedChunks)
+			return;
+
+		m_iAckedChunks = receivedChunks;
+		if (m_iNextChunk < receivedChunks)
+			m_iNextChunk = receivedChunks;
+		m_fLastProgress = now;
+		m_iRewinds = 0;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	bool CanSend()
+	{
+		return m_fRetryAt < 0 && m_iNextChunk < m_iTotalChunks && m_iNextChunk - m_iAckedChunks < WINDOW;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	bool IsComplete()
+	{
+		return m_iAckedChunks >= m_iTotalChunks;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Rewind to the acknowledged prefix if acks stopped arriving. After MAX_REWINDS the
+	//! transfer stops sending and waits RETRY_SECONDS for ShouldRetryHandshake.
+	void CheckStall(float now)
+	{
+		if (IsBackingOff() || m_iNextChunk == m_iAckedChunks || now - m_fLastProgress < STALL_SECONDS)
+			return;
+
+		m_iRewinds++;
+		if (m_iRewinds > MAX_REWINDS)
+		{
+			Print(string.Format("[TDL_TERRAIN_TRANSFER] Player %1 %2 stalled at %3/%4 after %5 rewinds, retrying handshake in %6s",
+				m_iPlayerId, typename.EnumToString(AG0_ETDLTerrainDataset, m_eDataset), m_iAckedChunks, m_iTotalChunks,
+				MAX_REWINDS, RETRY_SECONDS), LogLevel.DEBUG);
+			m_fRetryAt = now + RETRY_SECONDS;
+			return;
+		}
+
+		Print(string.Format("[TDL_TERRAIN_TRANSFER] Player %1 %2 stalled at %3/%4, resending from %3",
+			m_iPlayerId, typename.EnumToString(AG0_ETDLTerrainDataset, m_eDataset), m_iAckedChunks, m_iTotalChunks), LogLevel.DEBUG);
+		m_iNextChunk = m_iAckedChunks;
+		m_fLastProgress = now;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	bool IsBackingOff()
+	{
+		return m_fRetryAt >= 0;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! True once the back-off has elapsed: drop this transfer and ask the client for its
+	//! hash again, so the new transfer resumes from whatever it still buffers
+	bool ShouldRetryHandshake(float now)
+	{
+		return m_fRetryAt >= 0 && now >= m_fRetryAt;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Chunk m_iNextChunk, advancing the cursor
+	string TakeNextChunk(float now)
+	{
+		int start = m_iNextChunk * m_iChunkBytes;
+		int len = Math.Min(m_iChunkBytes, m_sPayload.Length() - start);
+		m_iNextChunk++;
+		m_fLastProgress = now;
+		return m_sPayload.Substring(start, len);
+	}
+}
@@ -328,19 +328,23 @@ class AG0_TDLDisplayController
 		{
 			AG0_TDLMapShapeManager shapeMgr = controller.GetTDLShapeManager();
 			if (shapeMgr)
-				m_MapView.SetShapes(shapeMgr.GetShapes());
+			{
+				// GetShapes() rebuilds the list (and bumps the revision) when dirty — call it first
+				array<ref AG0_TDLMapShape> shapes = shapeMgr.GetShapes();
+				m_MapView.SetShapes(shapes, shapeMgr.GetShapeIndex(), shapeMgr.GetRevision());
+			}
 			else
 				m_MapView.SetShapes(null);
 
 			AG0_TDLTerrainStructureManager structMgr = controller.GetTDLTerrainStructureManager();
 			if (structMgr)
-				m_MapView.SetTerrainStructures(structMgr.GetStructures());
+				m_MapView.SetTerrainStructures(structMgr.GetStructures(), structMgr.GetGrid(), structMgr.GetRevision());
 			else
 				m_MapView.SetTerrainStructures(null);
 
 			AG0_TDLTerrainRoadManager roadMgr = controller.GetTDLTerrainRoadManager();
 			if (roadMgr)
-				m_MapView.SetTerrainRoads(roadMgr.GetFeatures());
+				m_MapView.SetTerrainRoads(roadMgr.GetFeatures(), roadMgr.GetRevision());
 			else
 				m_MapView.SetTerrainRoads(null);
 		}
@@ -14,20 +14,32 @@
 //     gzips THEN base64-encodes. The mod base64-decodes first (producing
 //     an array<int> of bytes) and hands those bytes to this class.
 //
-// Typical usage (paired with AG0_Base64 in AG0_TDLPhotoData.c):
+// Usage — resumable, a time slice per frame (photo decode, terrain codec job):
 //
-//     array<int> bytes     = AG0_Base64.Decode(jsonField_rgz);
-//     array<int> inflated  = AG0_TDLGzip.Gunzip(bytes);
-//     // ...parse your binary records out of `inflated`...
+//     AG0_TDLGzip gunzip = new AG0_TDLGzip();
+//     gunzip.InitGzip(bytes);              // false (and HasFailed) on a bad header
+//     ...each frame:
+//     if (gunzip.Step(budgetMs))           // true while more remains
+//         return;                          // resume next frame
+//     array<int> inflated = gunzip.GetOutput();   // empty on failure
+//
+// InitDeflate takes a raw deflate stream instead. Gunzip / Inflate run the
+// same decoder to completion in one call — only for payloads small enough
+// not to hitch a frame.
 //
 // Notes:
 //   * Binary-safe: consumes and produces array<int> (each element = one byte,
 //     values 0..255). Never touches strings after the caller's base64 step.
-//   * No CRC32 verification on gzip (HTTPS already guarantees integrity and
-//     adding a CRC32 table costs another ~1KB of table data for negligible
-//     benefit here). Easy to add if a use case appears.
-//   * Returns an empty array on any failure and Prints a LogLevel.ERROR line.
-//     Callers should check Count() before use.
+//   * The gzip CRC32 trailer is not verified. The encoder below has the CRC32
+//     table, but folding every inflated byte through it would add a table
+//     lookup per output byte to the hot loop, and HTTPS already guarantees
+//     integrity; ISIZE is only used to pre-size the output.
+//   * GetOutput returns an empty array on any failure (and a LogLevel.ERROR
+//     line is printed). Callers should check Count() before use.
+//
+// AG0_TDLGzipEncoder at the end of this file goes the other way, with the
+// same Init / Step / GetOutput shape: large /submit bodies (AG0_TDLApiManager)
+// and the packed terrain payloads (AG0_TDLTerrainCodecJob).
 //------------------------------------------------------------------------------------------------
 
 //------------------------------------------------------------------------------------------------
@@ -37,21 +49,55 @@
 //
 //   count[len]  = number of symbols assigned code length `len`
 //   symbol[k]   = symbols in order of ascending (length, value),
-//                 so DecodeSymbol can walk the canonical tree without
-//                 materialising it.
+//                 so DecodeSymbolWalk can walk the canonical tree without
+//                 materialising it (puff's reference decode, kept for
+//                 benchmarking).
+//   table[]     = zlib-style lookup: the first ROOT_BITS entries are indexed
+//                 by the next ROOT_BITS stream bits; codes longer than that
+//                 go through a link entry to a subtable appended after the
+//                 root. Entry layout:
+//                   direct: (symbol << 8) | codeLength
+//                   link:   (subtableOffset << 8) | TABLE_LINK | subtableBits
+//                   0       unused code (malformed stream)
 //------------------------------------------------------------------------------------------------
 class AG0_TDLHuffman
 {
     ref array<int> count;   // size = MAXBITS + 1
     ref array<int> symbol;  // size = number of symbols
+    ref array<int> table;   // ROOT_SIZE root entries + subtables
 
     void AG0_TDLHuffman()
     {
         count  = {};
         symbol = {};
+        table  = {};
     }
 }
 
+//------------------------------------------------------------------------------------------------
+// Where a resumable AG0_TDLGzip decode stands between Step calls
+//------------------------------------------------------------------------------------------------
+enum AG0_ETDLInflateState
+{
+    BLOCK_HEADER,   // next: BFINAL/BTYPE and the block's tables or stored length
+    STORED,         // copying m_iStoredLeft raw bytes
+    CODES,          // decoding literal/length symbols with m_LenCode / m_DistCode
+    DONE,
+    FAILED
+}
+
+//------------------------------------------------------------------------------------------------
+//! Resumable usage (same shape as AG0_TDLBase64Decoder):
+//!
+//!   AG0_TDLGzip d = new AG0_TDLGzip();
+//!   d.InitGzip(bytes);                  // or InitDeflate
+//!   while (d.Step(timeBudgetMs)) { /* yield to next frame */ }
+//!   array<int> out = d.GetOutput();     // empty on failure
+//!
+//! Decode state (current block, its Huffman tables, stored-block remainder,
+//! bit buffer, output window) lives in members, so a Step can stop between
+//! any two symbols. The whole input is in memory up front, so only the time
+//! budget ever pauses decoding — never missing input.
 //------------------------------------------------------------------------------------------------
 class AG0_TDLGzip
 {
@@ -70,6 +116,25 @@ class AG0_TDLGzip
     protected int m_iOutPos;             // write head into m_Output
     protected bool m_bError;
 
+    // --- resumable block state ---
+    protected const int SYMBOLS_PER_CHECK = 512;   // symbols decoded between clock reads
+    protected AG0_ETDLInflateState m_eState = AG0_ETDLInflateState.FAILED;
+    protected bool m_bFinalBlock;
+    protected int m_iStoredLeft;
+    protected ref AG0_TDLHuffman m_LenCode;
+    protected ref AG0_TDLHuffman m_DistCode;
+
+    // --- table-driven symbol decode ---
+    protected const int ROOT_BITS = 9;
+    protected const int ROOT_SIZE = 512;
+    protected const int ROOT_MASK = 511;
+    protected const int TABLE_LINK = 0x40;
+    protected bool m_bReferenceDecode;              // bit-by-bit canonical walk (Benchmark only)
+
+    // Fixed-Huffman tables (BTYPE = 01) are the same for every block: built once
+    protected static ref AG0_TDLHuffman s_FixedLenCode;
+    protected static ref AG0_TDLHuffman s_FixedDistCode;
+
     //------------------------------------------------------------------------------------------------
     //! Write one byte to the output buffer at m_iOutPos. Pre-Resize from
     //! ISIZE means almost all writes hit existing storage; the grow path
@@ -83,50 +148,135 @@ class AG0_TDLGzip
     }
 
     //------------------------------------------------------------------------------------------------
-    //! Inflate a gzip-wrapped payload.
+    //! Inflate a gzip-wrapped payload in one call. Blocks until done; use
+    //! InitGzip + Step for anything big enough to hitch a frame.
     //! @param gzipBytes  raw gzip stream (1F 8B 08 ...) as an array of bytes 0..255.
     //! @return decompressed bytes, or an empty array on failure.
     static array<int> Gunzip(array<int> gzipBytes)
     {
         AG0_TDLGzip d = new AG0_TDLGzip();
-        array<int> empty = new array<int>();
+        d.InitGzip(gzipBytes);
+        while (d.Step(1000000)) {}
+        return d.GetOutput();
+    }
 
-        if (!d.SkipGzipHeader(gzipBytes))
+    //------------------------------------------------------------------------------------------------
+    //! Inflate a raw deflate stream (no gzip/zlib wrapper) in one call.
+    static array<int> Inflate(array<int> deflateBytes)
+    {
+        AG0_TDLGzip d = new AG0_TDLGzip();
+        d.InitDeflate(deflateBytes);
+        while (d.Step(1000000)) {}
+        return d.GetOutput();
+    }
+
+    //------------------------------------------------------------------------------------------------
+    //! Start a resumable gunzip.
+    //! @return false on a bad header; Step then returns false straight away.
+    bool InitGzip(array<int> gzipBytes)
+    {
+        if (!SkipGzipHeader(gzipBytes))
         {
             Print("[TDLGzip] bad gzip header", LogLevel.ERROR);
-            return empty;
+            m_eState = AG0_ETDLInflateState.FAILED;
+            return false;
         }
 
-        if (!d.InflateDeflateStream())
-            return empty;
+        m_eState = AG0_ETDLInflateState.BLOCK_HEADER;
+        return true;
+    }
 
-        // Trim any over-allocation from the ISIZE-based pre-Resize.
-        d.m_Output.Resize(d.m_iOutPos);
-        return d.m_Output;
+    //------------------------------------------------------------------------------------------------
+    //! Start a resumable inflate of a raw deflate stream.
+    void InitDeflate(array<int> deflateBytes)
+    {
+        m_Input    = deflateBytes;
+        m_iPos     = 0;
+        m_iBitBuf  = 0;
+        m_iBitCnt  = 0;
+        m_Output   = new array<int>();
+        m_iOutPos  = 0;
+        m_bError   = false;
+        m_eState   = AG0_ETDLInflateState.BLOCK_HEADER;
     }
 
     //------------------------------------------------------------------------------------------------
-    //! Inflate a raw deflate stream (no gzip/zlib wrapper).
-    static array<int> Inflate(array<int> deflateBytes)
+    //! Decode until timeBudgetMs elapses or the stream ends. The clock is
+    //! read every SYMBOLS_PER_CHECK symbols (at most 258 output bytes each),
+    //! so a call overshoots its budget by one such batch at most.
+    //! @return true if more remains (call again next frame); false when
+    //!         finished or failed — check HasFailed / GetOutput.
+    bool Step(int timeBudgetMs)
     {
-        AG0_TDLGzip d = new AG0_TDLGzip();
-        array<int> empty = new array<int>();
+        int startTick = System.GetTickCount();
 
-        d.m_Input    = deflateBytes;
-        d.m_iPos     = 0;
-        d.m_iBitBuf  = 0;
-        d.m_iBitCnt  = 0;
-        d.m_Output   = new array<int>();
-        d.m_iOutPos  = 0;
-        d.m_bError   = false;
+        while (m_eState != AG0_ETDLInflateState.DONE && m_eState != AG0_ETDLInflateState.FAILED)
+        {
+            switch (m_eState)
+            {
+                case AG0_ETDLInflateState.BLOCK_HEADER:
+                    BeginBlock();
+                    break;
+                case AG0_ETDLInflateState.STORED:
+                    CopyStored(SYMBOLS_PER_CHECK * 8);
+                    break;
+                case AG0_ETDLInflateState.CODES:
+                    DecodeSymbols(SYMBOLS_PER_CHECK);
+                    break;
+            }
 
-        if (!d.InflateDeflateStream())
-            return empty;
+            if (System.GetTickCount() - startTick >= timeBudgetMs)
+                break;
+        }
 
-        d.m_Output.Resize(d.m_iOutPos);
-        return d.m_Output;
+        return m_eState != AG0_ETDLInflateState.DONE && m_eState != AG0_ETDLInflateState.FAILED;
     }
 
+    //------------------------------------------------------------------------------------------------
+    //! Decompressed bytes once Step has returned false; empty on failure.
+    array<int> GetOutput()
+    {
+        if (m_eState != AG0_ETDLInflateState.DONE)
+            return new array<int>();
+
+        // Trim any over-allocation from the ISIZE-based pre-Resize.
+        m_Output.Resize(m_iOutPos);
+        return m_Output;
+    }
+
+    //------------------------------------------------------------------------------------------------
+    bool HasFailed() { return m_eState == AG0_ETDLInflateState.FAILED; }
+
+    //------------------------------------------------------------------------------------------------
+    //! Time the table-driven decode against the bit-by-bit canonical walk
+    //! on the same gzip payload and print both (debug aid; blocks until
+    //! both decodes finish). Run from #tdlperf gzip (terrain payloads) or
+    //! AG0_TDLPhotoComponent.BenchmarkGunzip (photo rgz).
+    //! @return The printed result line
+    static string Benchmark(array<int> gzipBytes, string label)
+    {
+        int t0 = System.GetTickCount();
+        AG0_TDLGzip fast = new AG0_TDLGzip();
+        fast.InitGzip(gzipBytes);
+        while (fast.Step(1000000)) {}
+        int t1 = System.GetTickCount();
+
+        AG0_TDLGzip reference = new AG0_TDLGzip();
+        reference.m_bReferenceDecode = true;
+        reference.InitGzip(gzipBytes);
+        while (reference.Step(1000000)) {}
+        int t2 = System.GetTickCount();
+
+        string result = string.Format("[TDLGzip] benchmark %1: %2 -> %3 bytes, table %4ms, walk %5ms",
+            label, gzipBytes.Count(), fast.GetOutput().Count(), t1 - t0, t2 - t1);
+        Print(result, LogLevel.NORMAL);
+        return result;
+    }
+
+    //------------------------------------------------------------------------------------------------
+    int GetProgress() { return m_iPos; }
+    int GetTotal() { if (!m_Input) return 0; return m_Input.Count(); }
+
     //------------------------------------------------------------------------------------------------
     //! Parse and skip the gzip header, leaving m_iPos at the start of the
     //! embedded deflate stream. Initialises decoder state.
@@ -179,7 +329,7 @@ class AG0_TDLGzip
 
         // Pre-Reserve output to the uncompressed size from ISIZE (last 4
         // bytes, little-endian, modulo 2^32). For a 446 KB output this
-        // skips ~19 array growth reallocations during DecodeSymbols / DecodeStored
+        // skips ~19 array growth reallocations during DecodeSymbols / CopyStored
         // and noticeably reduces gunzip time on large payloads.
         if (src.Count() >= 18)  // 10-byte header + 8-byte trailer minimum
         {
@@ -199,33 +349,51 @@ class AG0_TDLGzip
     }
 
     //------------------------------------------------------------------------------------------------
-    //! Main deflate block loop. Each block:
+    //! Start the next block. Each block:
     //!   BFINAL : 1 bit   — set on the last block
     //!   BTYPE  : 2 bits  — 00 stored, 01 fixed huffman, 10 dynamic, 11 reserved/error
-    protected bool InflateDeflateStream()
+    //! Table construction for a block is done here in one go; it is small
+    //! next to the block body that CopyStored / DecodeSymbols slice up.
+    protected void BeginBlock()
     {
-        while (!m_bError)
+        int bfinal = ReadBits(1);
+        int btype  = ReadBits(2);
+        if (m_bError)
         {
-            int bfinal = ReadBits(1); if (m_bError) break;
-            int btype  = ReadBits(2); if (m_bError) break;
+            Fail("truncated block header");
+            return;
+        }
+        m_bFinalBlock = (bfinal == 1);
 
-            bool ok;
-            switch (btype)
-            {
-                case 0:  ok = DecodeStored();  break;
-                case 1:  ok = DecodeFixed();   break;
-                case 2:  ok = DecodeDynamic(); break;
-                default: ok = false;           break;  // btype == 3 is reserved
-            }
-            if (!ok)
-            {
-                Print(string.Format("[TDLGzip] block type %1 failed", btype), LogLevel.ERROR);
-                return false;
-            }
-            if (bfinal == 1)
-                return true;
+        bool ok;
+        switch (btype)
+        {
+            case 0:  ok = BeginStored();  break;
+            case 1:  ok = BeginFixed();   break;
+            case 2:  ok = BeginDynamic(); break;
+            default: ok = false;          break;  // btype == 3 is reserved
         }
-        return false;
+        if (!ok)
+            Fail(string.Format("block type %1 failed", btype));
+    }
+
+    //------------------------------------------------------------------------------------------------
+    //! Current block finished: next block, or done after the BFINAL one
+    protected void EndBlock()
+    {
+        m_LenCode = null;
+        m_DistCode = null;
+        if (m_bFinalBlock)
+            m_eState = AG0_ETDLInflateState.DONE;
+        else
+            m_eState = AG0_ETDLInflateState.BLOCK_HEADER;
+    }
+
+    //------------------------------------------------------------------------------------------------
+    protected void Fail(string reason)
+    {
+        Print(string.Format("[TDLGzip] %1", reason), LogLevel.ERROR);
+        m_eState = AG0_ETDLInflateState.FAILED;
     }
 
     //------------------------------------------------------------------------------------------------
@@ -266,10 +434,12 @@ class AG0_TDLGzip
 
     //------------------------------------------------------------------------------------------------
     //! BTYPE = 00: uncompressed block. Discards bit-buffer, reads LEN/NLEN
-    //! (complement check), then copies LEN bytes verbatim.
-    protected bool DecodeStored()
+    //! (complement check); CopyStored then copies LEN bytes verbatim.
+    protected bool BeginStored()
     {
-        // Align to byte boundary — discard any bits still in the buffer.
+        // Align to byte boundary — discard the partial byte still in the
+        // buffer, and hand back any whole bytes the table decoder prefetched.
+        m_iPos -= m_iBitCnt >> 3;
         m_iBitBuf = 0;
         m_iBitCnt = 0;
 
@@ -286,20 +456,36 @@ class AG0_TDLGzip
         if (m_iPos + len > m_Input.Count())
             return false;
 
-        for (int i = 0; i < len; i++)
+        m_iStoredLeft = len;
+        m_eState = AG0_ETDLInflateState.STORED;
+        return true;
+    }
+
+    //------------------------------------------------------------------------------------------------
+    //! Copy up to maxBytes of the current stored block
+    protected void CopyStored(int maxBytes)
+    {
+        int n = Math.Min(maxBytes, m_iStoredLeft);
+        for (int i = 0; i < n; i++)
         {
             EmitByte(m_Input[m_iPos + i]);
         }
-        m_iPos += len;
-        return true;
+        m_iPos += n;
+        m_iStoredLeft -= n;
+
+        if (m_iStoredLeft == 0)
+            EndBlock();
     }
 
     //------------------------------------------------------------------------------------------------
     //! BTYPE = 01: fixed huffman codes. Uses the precomputed tables defined
     //! in RFC 1951 §3.2.6 — literal/length lengths are hardcoded, distances
     //! are all 5 bits.
-    protected bool DecodeFixed()
+    protected bool BeginFixed()
     {
+        if (s_FixedLenCode)
+            return BeginCodes(s_FixedLenCode, s_FixedDistCode);
+
         array<int> lens = {};
         lens.Resize(FIXLCODES);
         int i = 0;
@@ -312,23 +498,26 @@ class AG0_TDLGzip
         if (!ConstructHuffman(lencode, lens, FIXLCODES))
             return false;
 
+        // All 32 five-bit codes, so the table is complete; codes 30/31 never
+        // occur in valid data and are rejected by DecodeSymbols.
         array<int> dlens = {};
-        dlens.Resize(MAXDCODES);
-        for (int d = 0; d < MAXDCODES; d++) dlens[d] = 5;
+        dlens.Resize(32);
+        for (int d = 0; d < 32; d++) dlens[d] = 5;
 
         AG0_TDLHuffman distcode = new AG0_TDLHuffman();
-        if (!ConstructHuffman(distcode, dlens, MAXDCODES))
+        if (!ConstructHuffman(distcode, dlens, 32))
             return false;
 
-        return DecodeSymbols(lencode, distcode);
+        s_FixedLenCode = lencode;
+        s_FixedDistCode = distcode;
+        return BeginCodes(lencode, distcode);
     }
 
     //------------------------------------------------------------------------------------------------
     //! BTYPE = 10: dynamic huffman. Reads HLIT/HDIST/HCLEN, builds the
     //! code-length huffman, then uses it to RLE-decode the literal/length
-    //! and distance code lengths, builds those tables, and finally runs
-    //! DecodeSymbols on the block.
-    protected bool DecodeDynamic()
+    //! and distance code lengths and builds those tables for DecodeSymbols.
+    protected bool BeginDynamic()
     {
         // The HCLEN code lengths arrive in this permuted order (RFC 1951 §3.2.7).
         const int order[] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
@@ -423,7 +612,16 @@ class AG0_TDLGzip
         if (!ConstructHuffman(lencode, llens, hlit))   return false;
         if (!ConstructHuffman(distcode, dlens, hdist)) return false;
 
-        return DecodeSymbols(lencode, distcode);
+        return BeginCodes(lencode, distcode);
+    }
+
+    //------------------------------------------------------------------------------------------------
+    protected bool BeginCodes(AG0_TDLHuffman lencode, AG0_TDLHuffman distcode)
+    {
+        m_LenCode = lencode;
+        m_DistCode = distcode;
+        m_eState = AG0_ETDLInflateState.CODES;
+        return true;
     }
 
     //------------------------------------------------------------------------------------------------
@@ -431,7 +629,8 @@ class AG0_TDLGzip
     //! bytes, 256 terminates the block, 257..285 trigger an LZ77 back-reference
     //! whose length comes from the length table + `extra` bits, and whose
     //! distance is decoded via distcode + distance table + `extra` bits.
-    protected bool DecodeSymbols(AG0_TDLHuffman lencode, AG0_TDLHuffman distcode)
+    //! Stops after maxSymbols; the block carries on in the next call.
+    protected void DecodeSymbols(int maxSymbols)
     {
         // Length base & extra bits for codes 257..285 (RFC 1951 §3.2.5).
         const int lens[] = {
@@ -451,10 +650,10 @@ class AG0_TDLGzip
             0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9,10,10,11,11,12,12,13,13
         };
 
-        while (true)
+        for (int n = 0; n < maxSymbols; n++)
         {
-            int sym = DecodeSymbol(lencode);
-            if (sym < 0) return false;
+            int sym = DecodeSymbol(m_LenCode);
+            if (sym < 0) { Fail("bad literal/length code"); return; }
 
             if (sym < 256)
             {
@@ -462,26 +661,27 @@ class AG0_TDLGzip
             }
             else if (sym == 256)
             {
-                return true;
+                EndBlock();
+                return;
             }
             else
             {
                 int li = sym - 257;
-                if (li < 0 || li >= 29) return false;
+                if (li < 0 || li >= 29) { Fail("bad length symbol"); return; }
 
                 int length = lens[li] + ReadBits(lext[li]);
-                if (m_bError) return false;
+                if (m_bError) { Fail("bit stream underrun"); return; }
 
-                int dsym = DecodeSymbol(distcode);
-                if (dsym < 0 || dsym >= 30) return false;
+                int dsym = DecodeSymbol(m_DistCode);
+                if (dsym < 0 || dsym >= 30) { Fail("bad distance code"); return; }
 
                 int dist = dists[dsym] + ReadBits(dext[dsym]);
-                if (m_bError) return false;
+                if (m_bError) { Fail("bit stream underrun"); return; }
 
                 // m_iOutPos is the logical end of decoded data; m_Output
                 // may extend further (pre-Resized to ISIZE) but those bytes
                 // are uninitialised. Use m_iOutPos for distance bounds.
-                if (dist > m_iOutPos) return false;
+                if (dist > m_iOutPos) { Fail("distance too far back"); return; }
 
                 // LZ77 copy. Overlapping copies (dist < length) are legal and
                 // idiomatic in deflate — the classic "run-length" compression
@@ -493,7 +693,6 @@ class AG0_TDLGzip
                 }
             }
         }
-        return true;
     }
 
     //------------------------------------------------------------------------------------------------
@@ -517,6 +716,7 @@ class AG0_TDLGzip
         if (h.count[0] == n)
         {
             h.symbol.Resize(n);
+            BuildTable(h, lengths, n);
             return true;
         }
 
@@ -558,13 +758,149 @@ class AG0_TDLGzip
                 if (h.count[L] != 0) singleton = false;
             if (!singleton) return false;
         }
+
+        BuildTable(h, lengths, n);
         return true;
     }
 
     //------------------------------------------------------------------------------------------------
-    //! Decode one symbol by walking the canonical tree bit-by-bit. Returns
-    //! the symbol value, or -1 on malformed stream.
+    //! Fill h.table from the code lengths (see AG0_TDLHuffman). Codes are
+    //! assigned canonically (RFC 1951 §3.2.2) and stored bit-reversed,
+    //! because the stream delivers them LSB-first: a code of length L
+    //! occupies every root slot whose low L bits equal it.
+    protected void BuildTable(AG0_TDLHuffman h, array<int> lengths, int n)
+    {
+        array<int> nextCode = {};
+        nextCode.Resize(MAXBITS + 1);
+        int code = 0;
+        nextCode[0] = 0;
+        for (int L = 1; L <= MAXBITS; L++)
+        {
+            int prevCount = 0;
+            if (L > 1) prevCount = h.count[L - 1];
+            code = (code + prevCount) << 1;
+            nextCode[L] = code;
+        }
+
+        // Reversed code per symbol, and the widest overflow below each root slot
+        array<int> reversed = {};
+        reversed.Resize(n);
+        array<int> subBits = {};
+        subBits.Resize(ROOT_SIZE);
+        for (int r = 0; r < ROOT_SIZE; r++) subBits[r] = 0;
+
+        for (int s = 0; s < n; s++)
+        {
+            int len = lengths[s];
+            if (len == 0) continue;
+
+            int rev = ReverseBits(nextCode[len], len);
+            nextCode[len] = nextCode[len] + 1;
+            reversed[s] = rev;
+
+            if (len > ROOT_BITS)
+            {
+                int extra = len - ROOT_BITS;
+                int root = rev & ROOT_MASK;
+                if (extra > subBits[root]) subBits[root] = extra;
+            }
+        }
+
+        h.table.Resize(ROOT_SIZE);
+        for (int e = 0; e < ROOT_SIZE; e++) h.table[e] = 0;
+
+        for (int root = 0; root < ROOT_SIZE; root++)
+        {
+            int bits = subBits[root];
+            if (bits == 0) continue;
+
+            int offset = h.table.Count();
+            int size = 1 << bits;
+            h.table.Resize(offset + size);
+            for (int z = 0; z < size; z++) h.table[offset + z] = 0;
+            h.table[root] = (offset << 8) | TABLE_LINK | bits;
+        }
+
+        for (int s = 0; s < n; s++)
+        {
+            int len = lengths[s];
+            if (len == 0) continue;
+
+            int entry = (s << 8) | len;
+            int rev = reversed[s];
+            if (len <= ROOT_BITS)
+            {
+                for (int idx = rev; idx < ROOT_SIZE; idx += 1 << len)
+                    h.table[idx] = entry;
+            }
+            else
+            {
+                int link = h.table[rev & ROOT_MASK];
+                int offset = link >> 8;
+                int size = 1 << (link & 0xF);
+                for (int idx = rev >> ROOT_BITS; idx < size; idx += 1 << (len - ROOT_BITS))
+                    h.table[offset + idx] = entry;
+            }
+        }
+    }
+
+    //------------------------------------------------------------------------------------------------
+    protected static int ReverseBits(int code, int len)
+    {
+        int r = 0;
+        for (int i = 0; i < len; i++)
+        {
+            r = (r << 1) | (code & 1);
+            code = code >> 1;
+        }
+        return r;
+    }
+
+    //------------------------------------------------------------------------------------------------
+    //! Decode one symbol with one (or, for codes over ROOT_BITS, two) table
+    //! lookups. Returns the symbol value, or -1 on malformed stream.
+    //!
+    //! The bit buffer is topped up to MAXBITS first so a whole code can be
+    //! peeked; at the end of input it holds fewer, and the code is only
+    //! accepted if its real length fits in what's actually buffered.
     protected int DecodeSymbol(AG0_TDLHuffman h)
+    {
+        if (m_bReferenceDecode)
+            return DecodeSymbolWalk(h);
+
+        while (m_iBitCnt < MAXBITS && m_iPos < m_Input.Count())
+        {
+            m_iBitBuf = m_iBitBuf | ((m_Input[m_iPos] & 0xFF) << m_iBitCnt);
+            m_iPos++;
+            m_iBitCnt += 8;
+        }
+
+        int entry = h.table[m_iBitBuf & ROOT_MASK];
+        if ((entry & TABLE_LINK) != 0)
+        {
+            int subMask = (1 << (entry & 0xF)) - 1;
+            entry = h.table[(entry >> 8) + ((m_iBitBuf >> ROOT_BITS) & subMask)];
+        }
+
+        int len = entry & 0xF;
+        if (len == 0 || len > m_iBitCnt)
+        {
+            if (len > m_iBitCnt)
+                Print("[TDLGzip] bit stream underrun", LogLevel.ERROR);
+            m_bError = true;
+            return -1;
+        }
+
+        m_iBitBuf = m_iBitBuf >> len;
+        m_iBitCnt -= len;
+        return entry >> 8;
+    }
+
+    //------------------------------------------------------------------------------------------------
+    //! Decode one symbol by walking the canonical tree bit-by-bit (puff.c).
+    //! Reference path for Benchmark. Returns the symbol value, or -1 on
+    //! malformed stream.
+    protected int DecodeSymbolWalk(AG0_TDLHuffman h)
     {
         int code  = 0;   // bits accumulated so far, MSB-first in-code
         int first = 0;   // first code value of current length
@@ -588,3 +924,394 @@ class AG0_TDLGzip
         return -1;  // ran off the end — invalid code
     }
 }
+
+//------------------------------------------------------------------------------------------------
+//! Resumable gzip encoder, the upload-side counterpart of AG0_TDLGzip.
+//!
+//! LZ77 over a 32 KB window with 3-byte hash chains, emitted as a single
+//! fixed-Huffman deflate block (BTYPE = 01) in an RFC 1952 wrapper with a
+//! real CRC32 trailer, so any stock gunzip / zlib accepts it. Fixed codes
+//! give up some ratio against dynamic tables, but JSON is dominated by
+//! repeated keys that LZ77 already catches, and there are no tables to
+//! build or transmit.
+//!
+//! Usage (time-sliced, same shape as AG0_TDLBase64Decoder):
+//!   AG0_TDLGzipEncoder e = new AG0_TDLGzipEncoder();
+//!   e.InitString(json);                 // or Init(bytes)
+//!   while (e.Step(timeBudgetMs)) { /* yield to next frame */ }
+//!   array<int> gz = e.GetOutput();
+//!
+//! InitString reads the script string with ToAscii, which is a proto call
+//! per character; that pass is sliced by Step as well.
+//------------------------------------------------------------------------------------------------
+class AG0_TDLGzipEncoder
+{
+    protected const int WINDOW_SIZE = 32768;
+    protected const int WINDOW_MASK = 32767;
+    protected const int HASH_SIZE = 32768;
+    protected const int HASH_MASK = 32767;
+    protected const int MIN_MATCH = 3;
+    protected const int MAX_MATCH = 258;
+    protected const int MAX_CHAIN = 16;      // candidates tried per position
+    protected const int GOOD_MATCH = 32;     // stop searching once a match this long is found
+    protected const int CHECK_INTERVAL = 256;
+
+    // Shared tables, built once: CRC32, fixed-Huffman codes (bit-reversed for
+    // LSB-first output) and the length -> symbol mapping.
+    protected static ref array<int> s_Crc;
+    protected static ref array<int> s_LitCode;
+    protected static ref array<int> s_LitBits;
+    protected static ref array<int> s_LenSym;     // index = match length (3..258)
+
+    protected string m_sInput;
+    protected int m_iReadPos;
+    protected bool m_bReading;
+
+    protected ref array<int> m_Input;
+    protected int m_iLen;
+    protected int m_iPos;
+    protected int m_iCrc;
+
+    protected ref array<int> m_aHead;
+    protected ref array<int> m_aPrev;
+
+    protected ref array<int> m_Output;
+    protected int m_iBitBuf;
+    protected int m_iBitCnt;
+    protected bool m_bDone;
+
+    //------------------------------------------------------------------------------------------------
+    //! One-shot convenience for small inputs (no time slicing)
+    static array<int> Gzip(array<int> bytes)
+    {
+        AG0_TDLGzipEncoder e = new AG0_TDLGzipEncoder();
+        e.Init(bytes);
+        while (e.Step(1000000)) {}
+        return e.GetOutput();
+    }
+
+    //------------------------------------------------------------------------------------------------
+    void Init(array<int> bytes)
+    {
+        InitTables();
+        m_Input = bytes;
+        m_iLen = bytes.Count();
+        m_bReading = false;
+        Begin();
+    }
+
+    //------------------------------------------------------------------------------------------------
+    //! Encode the bytes of a script string (UTF-8 as stored)
+    void InitString(string input)
+    {
+        InitTables();
+        m_sInput = input;
+        m_iLen = input.Length();
+        m_iReadPos = 0;
+        m_Input = new array<int>();
+        m_Input.Resize(m_iLen);
+        m_bReading = true;
+        Begin();
+    }
+
+    //------------------------------------------------------------------------------------------------
+    protected void Begin()
+    {
+        m_iPos = 0;
+        m_iCrc = -1;    // 0xFFFFFFFF
+
+        m_aHead = new array<int>();
+        m_aHead.Resize(HASH_SIZE);
+        for (int i = 0; i < HASH_SIZE; i++) m_aHead[i] = -1;
+        m_aPrev = new array<int>();
+        m_aPrev.Resize(WINDOW_SIZE);
+
+        m_Output = new array<int>();
+        m_Output.Reserve(m_iLen / 3 + 64);
+        m_iBitBuf = 0;
+        m_iBitCnt = 0;
+        m_bDone = false;
+
+        // Header: magic, CM = deflate, no flags, no mtime, XFL 0, OS unknown
+        m_Output.Insert(0x1F); m_Output.Insert(0x8B); m_Output.Insert(0x08); m_Output.Insert(0);
+        m_Output.Insert(0); m_Output.Insert(0); m_Output.Insert(0); m_Output.Insert(0);
+        m_Output.Insert(0); m_Output.Insert(0xFF);
+
+        // Single final block, fixed Huffman
+        WriteBits(1, 1);
+        WriteBits(1, 2);
+    }
+
+    //------------------------------------------------------------------------------------------------
+    //! Encode until timeBudgetMs elapses or the input is exhausted.
+    //! @return true if more remains (call again next frame), false when GetOutput is ready
+    bool Step(int timeBudgetMs)
+    {
+        if (m_bDone)
+            return false;
+
+        int startTick = System.GetTickCount();
+
+        if (m_bReading)
+        {
+            int sinceCheck = 0;
+            while (m_iReadPos < m_iLen)
+            {
+                m_Input[m_iReadPos] = m_sInput.ToAscii(m_iReadPos) & 0xFF;
+                m_iReadPos++;
+
+                sinceCheck++;
+                if (sinceCheck >= CHECK_INTERVAL)
+                {
+                    if (System.GetTickCount() - startTick >= timeBudgetMs)
+                        return true;
+                    sinceCheck = 0;
+                }
+            }
+            m_bReading = false;
+            m_sInput = string.Empty;
+        }
+
+        int nextCheck = m_iPos + CHECK_INTERVAL;
+        while (m_iPos < m_iLen)
+        {
+            EncodeAt();
+
+            if (m_iPos >= nextCheck)
+            {
+                if (System.GetTickCount() - startTick >= timeBudgetMs)
+                    return true;
+                nextCheck = m_iPos + CHECK_INTERVAL;
+            }
+        }
+
+        Finish();
+        return false;
+    }
+
+    //------------------------------------------------------------------------------------------------
+    array<int> GetOutput() { return m_Output; }
+    int GetProgress() { return m_iPos; }
+    int GetTotal() { return m_iLen; }
+
+    //------------------------------------------------------------------------------------------------
+    //! Emit a literal or the longest match found at m_iPos, and advance past it
+    protected void EncodeAt()
+    {
+        int bestLen = 0;
+        int bestDist = 0;
+
+        if (m_iPos + MIN_MATCH <= m_iLen)
+        {
+            int limit = Math.Min(MAX_MATCH, m_iLen - m_iPos);
+            int cand = m_aHead[Hash(m_iPos)];
+            int chain = MAX_CHAIN;
+            while (cand >= 0 && chain > 0 && m_iPos - cand <= WINDOW_SIZE)
+            {
+                if (m_Input[cand + bestLen] == m_Input[m_iPos + bestLen])
+                {
+                    int len = 0;
+                    while (len < limit && m_Input[cand + len] == m_Input[m_iPos + len])
+                        len++;
+
+                    if (len > bestLen)
+                    {
+                        bestLen = len;
+                        bestDist = m_iPos - cand;
+                        if (len >= GOOD_MATCH || len == limit)
+                            break;
+                    }
+                }
+
+                int next = m_aPrev[cand & WINDOW_MASK];
+                if (next >= cand)
+                    break;  // slot reused by a newer position: chain ended
+                cand = next;
+                chain--;
+            }
+        }
+
+        if (bestLen >= MIN_MATCH)
+        {
+            EmitMatch(bestLen, bestDist);
+            for (int i = 0; i < bestLen; i++)
+                Advance();
+        }
+        else
+        {
+            WriteBits(s_LitCode[m_Input[m_iPos]], s_LitBits[m_Input[m_iPos]]);
+            Advance();
+        }
+    }
+
+    //------------------------------------------------------------------------------------------------
+    //! Fold the byte at m_iPos into the CRC, index it in the hash chains, move on
+    protected void Advance()
+    {
+        int b = m_Input[m_iPos];
+        m_iCrc = s_Crc[(m_iCrc ^ b) & 0xFF] ^ ((m_iCrc >> 8) & 0x00FFFFFF);
+
+        if (m_iPos + MIN_MATCH <= m_iLen)
+        {
+            int h = Hash(m_iPos);
+            m_aPrev[m_iPos & WINDOW_MASK] = m_aHead[h];
+            m_aHead[h] = m_iPos;
+        }
+        m_iPos++;
+    }
+
+    //------------------------------------------------------------------------------------------------
+    protected int Hash(int pos)
+    {
+        return ((m_Input[pos] << 10) ^ (m_Input[pos + 1] << 5) ^ m_Input[pos + 2]) & HASH_MASK;
+    }
+
+    //------------------------------------------------------------------------------------------------
+    protected void EmitMatch(int length, int dist)
+    {
+        // Length / distance base & extra bits (RFC 1951 §3.2.5), as in AG0_TDLGzip.DecodeSymbols
+        const int lens[] = {
+              3,   4,   5,   6,   7,   8,   9,  10,  11,  13,  15,  17,  19,  23,  27,
+             31,  35,  43,  51,  59,  67,  83,  99, 115, 131, 163, 195, 227, 258
+        };
+        const int lext[] = {
+            0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+        };
+        const int dists[] = {
+               1,    2,    3,    4,    5,    7,    9,   13,   17,   25,
+              33,   49,   65,   97,  129,  193,  257,  385,  513,  769,
+            1025, 1537, 2049, 3073, 4097, 6145, 8193,12289,16385,24577
+        };
+        const int dext[] = {
+            0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9,10,10,11,11,12,12,13,13
+        };
+
+        int sym = s_LenSym[length];
+        WriteBits(s_LitCode[sym], s_LitBits[sym]);
+        int li = sym - 257;
+        if (lext[li] > 0)
+            WriteBits(length - lens[li], lext[li]);
+
+        int dsym = 29;
+        while (dists[dsym] > dist)
+            dsym--;
+        WriteBits(ReverseBits(dsym, 5), 5);
+        if (dext[dsym] > 0)
+            WriteBits(dist - dists[dsym], dext[dsym]);
+    }
+
+    //------------------------------------------------------------------------------------------------
+    //! End-of-block, flush the bit buffer, append CRC32 and ISIZE
+    protected void Finish()
+    {
+        WriteBits(s_LitCode[256], s_LitBits[256]);
+        if (m_iBitCnt > 0)
+        {
+            m_Output.Insert(m_iBitBuf & 0xFF);
+            m_iBitBuf = 0;
+            m_iBitCnt = 0;
+        }
+
+        int crc = ~m_iCrc;
+        WriteInt32(crc);
+        WriteInt32(m_iLen);
+
+        m_Input = null;
+        m_aHead = null;
+        m_aPrev = null;
+        m_bDone = true;
+    }
+
+    //------------------------------------------------------------------------------------------------
+    protected void WriteInt32(int v)
+    {
+        m_Output.Insert(v & 0xFF);
+        m_Output.Insert((v >> 8) & 0xFF);
+        m_Output.Insert((v >> 16) & 0xFF);
+        m_Output.Insert((v >> 24) & 0xFF);
+    }
+
+    //------------------------------------------------------------------------------------------------
+    //! Append `count` bits LSB-first. Never more than 16 at a time, so the
+    //! buffer stays below 24 bits and the sign bit is never involved.
+    protected void WriteBits(int value, int count)
+    {
+        m_iBitBuf = m_iBitBuf | (value << m_iBitCnt);
+        m_iBitCnt += count;
+        while (m_iBitCnt >= 8)
+        {
+            m_Output.Insert(m_iBitBuf & 0xFF);
+            m_iBitBuf = m_iBitBuf >> 8;
+            m_iBitCnt -= 8;
+        }
+    }
+
+    //------------------------------------------------------------------------------------------------
+    //! Huffman codes are defined MSB-first but packed LSB-first
+    protected static int ReverseBits(int code, int len)
+    {
+        int r = 0;
+        for (int i = 0; i < len; i++)
+        {
+            r = (r << 1) | (code & 1);
+            code = code >> 1;
+        }
+        return r;
+    }
+
+    //------------------------------------------------------------------------------------------------
+    protected static void InitTables()
+    {
+        if (s_Crc)
+            return;
+
+        // CRC32, reflected polynomial 0xEDB88320 (written signed: int is 32-bit).
+        // Right shifts are masked because >> sign-extends.
+        s_Crc = {};
+        s_Crc.Resize(256);
+        for (int n = 0; n < 256; n++)
+        {
+            int c = n;
+            for (int k = 0; k < 8; k++)
+            {
+                if ((c & 1) != 0)
+                    c = -306674912 ^ ((c >> 1) & 0x7FFFFFFF);
+                else
+                    c = (c >> 1) & 0x7FFFFFFF;
+            }
+            s_Crc[n] = c;
+        }
+
+        // Fixed literal/length codes (RFC 1951 §3.2.6)
+        s_LitCode = {};
+        s_LitBits = {};
+        s_LitCode.Resize(288);
+        s_LitBits.Resize(288);
+        for (int sym = 0; sym < 288; sym++)
+        {
+            int code;
+            int bits;
+            if (sym < 144)      { code = 0x30 + sym;          bits = 8; }
+            else if (sym < 256) { code = 0x190 + sym - 144;   bits = 9; }
+            else if (sym < 280) { code = sym - 256;           bits = 7; }
+            else                { code = 0xC0 + sym - 280;    bits = 8; }
+            s_LitCode[sym] = ReverseBits(code, bits);
+            s_LitBits[sym] = bits;
+        }
+
+        const int lens[] = {
+              3,   4,   5,   6,   7,   8,   9,  10,  11,  13,  15,  17,  19,  23,  27,
+             31,  35,  43,  51,  59,  67,  83,  99, 115, 131, 163, 195, 227, 258
+        };
+        s_LenSym = {};
+        s_LenSym.Resize(MAX_MATCH + 1);
+        int li = 0;
+        for (int len = MIN_MATCH; len <= MAX_MATCH; len++)
+        {
+            // 258 has its own code (285) rather than being 227 + 31 extra
+            while (li < 28 && lens[li + 1] <= len)
+                li++;
+            s_LenSym[len] = 257 + li;
+        }
+    }
+}
@@ -8,8 +8,9 @@
 // Shape types supported:
 //   circle, rectangle, polygon, freehand, route, range_rings, sector
 //
-// Shapes use parametric definitions (center + radius, etc.) — vertex tessellation
-// happens at render time in AG0_TDLMapView, not here.
+// Shapes use parametric definitions (center + radius, etc.). Each shape caches its
+// world AABB and unit-radius outlines per segment count (UpdateGeometry / GetUnitOutline);
+// AG0_TDLMapView scales and projects those to screen instead of re-tessellating.
 //------------------------------------------------------------------------------------------------
 
 //------------------------------------------------------------------------------------------------
@@ -68,6 +69,15 @@ class AG0_TDLMapShape
 	int m_iCreatedAt;                        // Unix timestamp
 	int m_iStaleAt;                          // Unix timestamp — shape auto-removes after this
 	
+	// Cached geometry (UpdateGeometry) — world AABB of everything the shape draws in world units
+	float m_fMinX;
+	float m_fMinZ;
+	float m_fMaxX;
+	float m_fMaxZ;
+	
+	// Unit-radius outlines in world orientation (X east, Z north), keyed by segment count
+	protected ref map<int, ref array<float>> m_mUnitOutlines;
+	
 	//------------------------------------------------------------------------------------------------
 	void AG0_TDLMapShape()
 	{
@@ -126,6 +136,259 @@ class AG0_TDLMapShape
 		
 		return 0;
 	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Recompute the cached AABB and drop cached outlines. Call after changing the geometry fields.
+	void UpdateGeometry()
+	{
+		m_mUnitOutlines = null;
+		
+		switch (m_eShapeType)
+		{
+			case AG0_ETDLShapeType.CIRCLE:
+			case AG0_ETDLShapeType.SECTOR:
+			case AG0_ETDLShapeType.RANGE_RINGS:
+			{
+				float r = GetBoundingRadius();
+				m_fMinX = m_vCenter[0] - r;
+				m_fMaxX = m_vCenter[0] + r;
+				m_fMinZ = m_vCenter[2] - r;
+				m_fMaxZ = m_vCenter[2] + r;
+				return;
+			}
+		}
+		
+		m_fMinX = m_vCenter[0];
+		m_fMaxX = m_vCenter[0];
+		m_fMinZ = m_vCenter[2];
+		m_fMaxZ = m_vCenter[2];
+		for (int i = 0; i + 1 < m_aVertices.Count(); i += 2)
+		{
+			m_fMinX = Math.Min(m_fMinX, m_aVertices[i]);
+			m_fMaxX = Math.Max(m_fMaxX, m_aVertices[i]);
+			m_fMinZ = Math.Min(m_fMinZ, m_aVertices[i + 1]);
+			m_fMaxZ = Math.Max(m_fMaxZ, m_aVertices[i + 1]);
+		}
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Outline of the shape at radius 1 around the origin, as flat [x0, z0, x1, z1, ...].
+	//! Circle / range rings: closed circle of `segments` points.
+	//! Sector: origin, then the arc from start to end bearing with a share of `segments`
+	//! proportional to the sweep (4..128 points).
+	//! Built once per segment count (the renderer's LOD bucket) and cached until UpdateGeometry.
+	array<float> GetUnitOutline(int segments)
+	{
+		if (!m_mUnitOutlines)
+			m_mUnitOutlines = new map<int, ref array<float>>();
+		
+		array<float> outline;
+		if (m_mUnitOutlines.Find(segments, outline))
+			return outline;
+		
+		outline = {};
+		if (m_eShapeType == AG0_ETDLShapeType.SECTOR)
+		{
+			// Sweep — always positive (CW in bearing)
+			float sweep = m_fEndAngle - m_fStartAngle;
+			if (sweep <= 0)
+				sweep += 360;
+			
+			int arcSegs = Math.Ceil(sweep / 360 * segments);
+			arcSegs = Math.ClampInt(arcSegs, 4, 128);
+			
+			outline.Reserve((arcSegs + 2) * 2);
+			outline.Insert(0);
+			outline.Insert(0);
+			for (int i = 0; i <= arcSegs; i++)
+			{
+				// Bearing 0 = north (+Z), 90 = east (+X)
+				float bearing = (m_fStartAngle + sweep * i / arcSegs) * Math.DEG2RAD;
+				outline.Insert(Math.Sin(bearing));
+				outline.Insert(Math.Cos(bearing));
+			}
+		}
+		else
+		{
+			outline.Reserve(segments * 2);
+			float step = Math.PI2 / segments;
+			for (int j = 0; j < segments; j++)
+			{
+				outline.Insert(Math.Sin(j * step));
+				outline.Insert(Math.Cos(j * step));
+			}
+		}
+		
+		m_mUnitOutlines.Insert(segments, outline);
+		return outline;
+	}
+}
+
+//------------------------------------------------------------------------------------------------
+// Uniform grid over a shape list's AABBs so the map view visits only shapes near the
+// viewport. A shape is listed in every cell its AABB overlaps (CSR layout, as in
+// AG0_TDLTerrainStructureGrid); shapes spanning more than MAX_CELLS_PER_SHAPE cells
+// go to m_aLargeShapes instead and are returned by every query.
+// Built lazily on the client by AG0_TDLMapShapeManager.GetShapeIndex().
+//------------------------------------------------------------------------------------------------
+class AG0_TDLMapShapeIndex
+{
+	static const float CELL_SIZE = 512;
+	static const int MAX_CELLS_PER_AXIS = 64;
+	static const int MAX_CELLS_PER_SHAPE = 64;
+	
+	protected float m_fOriginX;
+	protected float m_fOriginZ;
+	protected float m_fCellSize;
+	protected int m_iCols;
+	protected int m_iRows;
+	
+	protected ref array<int> m_aCellStart = {};
+	protected ref array<int> m_aCellShapes = {};
+	protected ref array<int> m_aLargeShapes = {};
+	
+	// Query de-duplication: a shape is taken once per query stamp
+	protected ref array<int> m_aStamp = {};
+	protected int m_iQueryStamp;
+	
+	//------------------------------------------------------------------------------------------------
+	void AG0_TDLMapShapeIndex(array<ref AG0_TDLMapShape> shapes)
+	{
+		int n = shapes.Count();
+		m_aStamp.Resize(n);
+		for (int s = 0; s < n; s++)
+			m_aStamp[s] = 0;
+		if (n == 0)
+			return;
+		
+		// --- Bounds ---
+		float minX = shapes[0].m_fMinX;
+		float minZ = shapes[0].m_fMinZ;
+		float maxX = shapes[0].m_fMaxX;
+		float maxZ = shapes[0].m_fMaxZ;
+		foreach (AG0_TDLMapShape boundsShape : shapes)
+		{
+			minX = Math.Min(minX, boundsShape.m_fMinX);
+			minZ = Math.Min(minZ, boundsShape.m_fMinZ);
+			maxX = Math.Max(maxX, boundsShape.m_fMaxX);
+			maxZ = Math.Max(maxZ, boundsShape.m_fMaxZ);
+		}
+		
+		m_fOriginX = minX;
+		m_fOriginZ = minZ;
+		m_fCellSize = Math.Max(CELL_SIZE, Math.Max(maxX - minX, maxZ - minZ) / MAX_CELLS_PER_AXIS);
+		m_iCols = Math.Floor((maxX - minX) / m_fCellSize) + 1;
+		m_iRows = Math.Floor((maxZ - minZ) / m_fCellSize) + 1;
+		int cellCount = m_iCols * m_iRows;
+		
+		// --- Count, prefix-sum, fill ---
+		m_aCellStart.Resize(cellCount + 1);
+		for (int c = 0; c <= cellCount; c++)
+			m_aCellStart[c] = 0;
+		
+		int col0, row0, col1, row1;
+		for (int i = 0; i < n; i++)
+		{
+			if (!GetShapeCells(shapes[i], col0, row0, col1, row1))
+				continue;
+			
+			for (int row = row0; row <= row1; row++)
+			{
+				for (int col = col0; col <= col1; col++)
+				{
+					int countCell = row * m_iCols + col + 1;
+					m_aCellStart[countCell] = m_aCellStart[countCell] + 1;
+				}
+			}
+		}
+		
+		for (int k = 0; k < cellCount; k++)
+			m_aCellStart[k + 1] = m_aCellStart[k + 1] + m_aCellStart[k];
+		
+		m_aCellShapes.Resize(m_aCellStart[cellCount]);
+		array<int> fill = {};
+		fill.Copy(m_aCellStart);
+		for (int j = 0; j < n; j++)
+		{
+			if (!GetShapeCells(shapes[j], col0, row0, col1, row1))
+			{
+				m_aLargeShapes.Insert(j);
+				continue;
+			}
+			
+			for (int fillRow = row0; fillRow <= row1; fillRow++)
+			{
+				for (int fillCol = col0; fillCol <= col1; fillCol++)
+				{
+					int fillCell = fillRow * m_iCols + fillCol;
+					m_aCellShapes[fill[fillCell]] = j;
+					fill[fillCell] = fill[fillCell] + 1;
+				}
+			}
+		}
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Cell range of a shape's AABB. @return false if it spans too many cells to list per cell
+	protected bool GetShapeCells(AG0_TDLMapShape shape, out int col0, out int row0, out int col1, out int row1)
+	{
+		col0 = Math.ClampInt(Math.Floor((shape.m_fMinX - m_fOriginX) / m_fCellSize), 0, m_iCols - 1);
+		row0 = Math.ClampInt(Math.Floor((shape.m_fMinZ - m_fOriginZ) / m_fCellSize), 0, m_iRows - 1);
+		col1 = Math.ClampInt(Math.Floor((shape.m_fMaxX - m_fOriginX) / m_fCellSize), 0, m_iCols - 1);
+		row1 = Math.ClampInt(Math.Floor((shape.m_fMaxZ - m_fOriginZ) / m_fCellSize), 0, m_iRows - 1);
+		return (col1 - col0 + 1) * (row1 - row0 + 1) <= MAX_CELLS_PER_SHAPE;
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Indices of shapes whose cells overlap a world rectangle, ascending (= list / draw order).
+	//! Candidates only — callers still test the shape AABB.
+	void Query(float minX, float minZ, float maxX, float maxZ, notnull array<int> outIndices)
+	{
+		outIndices.Clear();
+		m_iQueryStamp++;
+		
+		foreach (int large : m_aLargeShapes)
+		{
+			m_aStamp[large] = m_iQueryStamp;
+			outIndices.Insert(large);
+		}
+		
+		if (m_iCols > 0)
+		{
+			minX = minX - m_fOriginX;
+			minZ = minZ - m_fOriginZ;
+			maxX = maxX - m_fOriginX;
+			maxZ = maxZ - m_fOriginZ;
+			if (maxX >= 0 && maxZ >= 0 && minX < m_iCols * m_fCellSize && minZ < m_iRows * m_fCellSize)
+			{
+				int col0 = Math.ClampInt(Math.Floor(minX / m_fCellSize), 0, m_iCols - 1);
+				int row0 = Math.ClampInt(Math.Floor(minZ / m_fCellSize), 0, m_iRows - 1);
+				int col1 = Math.ClampInt(Math.Floor(maxX / m_fCellSize), 0, m_iCols - 1);
+				int row1 = Math.ClampInt(Math.Floor(maxZ / m_fCellSize), 0, m_iRows - 1);
+				for (int row = row0; row <= row1; row++)
+				{
+					// Columns col0..col1 of one row are a contiguous slot range
+					int slotEnd = m_aCellStart[row * m_iCols + col1 + 1];
+					for (int slot = m_aCellStart[row * m_iCols + col0]; slot < slotEnd; slot++)
+					{
+						int idx = m_aCellShapes[slot];
+						if (m_aStamp[idx] == m_iQueryStamp)
+							continue;
+						m_aStamp[idx] = m_iQueryStamp;
+						outIndices.Insert(idx);
+					}
+				}
+			}
+		}
+		
+		outIndices.Sort();
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	int GetCellCount()
+	{
+		return m_iCols * m_iRows;
+	}
 }
 
 //------------------------------------------------------------------------------------------------
@@ -142,6 +405,9 @@ class AG0_TDLMapShapeManager
 	// Flat array for iteration during rendering (rebuilt on change)
 	protected ref array<ref AG0_TDLMapShape> m_aShapeList = {};
 	protected bool m_bListDirty = true;
+	protected int m_iRevision;			// Bumped each time m_aShapeList is rebuilt
+	// Client-side: spatial index over m_aShapeList, built on first GetShapeIndex() after a rebuild
+	protected ref AG0_TDLMapShapeIndex m_ShapeIndex;
 	
 	// Version tracking for delta polling
 	protected string m_sLastSyncHash;
@@ -295,6 +561,7 @@ class AG0_TDLMapShapeManager
 		json.ReadValue("createdAt", shape.m_iCreatedAt);
 		json.ReadValue("staleAt", shape.m_iStaleAt);
 		
+		shape.UpdateGeometry();
 		return shape;
 	}
 	
@@ -355,9 +622,33 @@ class AG0_TDLMapShapeManager
 				m_aShapeList.Insert(m_mShapes.GetElement(i));
 			}
 			m_bListDirty = false;
+			m_iRevision++;
+			m_ShapeIndex = null;
 		}
 		return m_aShapeList;
 	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Spatial index over GetShapes(), indices refer into that array.
+	//! Built on first use after each list rebuild so the server, which never draws, doesn't pay for it.
+	AG0_TDLMapShapeIndex GetShapeIndex()
+	{
+		array<ref AG0_TDLMapShape> shapes = GetShapes();
+		if (!m_ShapeIndex && !shapes.IsEmpty())
+		{
+			m_ShapeIndex = new AG0_TDLMapShapeIndex(shapes);
+			Print(string.Format("[TDL_SHAPES] Built shape index: %1 shapes in %2 cells",
+				shapes.Count(), m_ShapeIndex.GetCellCount()), LogLevel.DEBUG);
+		}
+		return m_ShapeIndex;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Changes whenever the GetShapes() list was rebuilt (shapes added, updated or removed)
+	int GetRevision()
+	{
+		return m_iRevision;
+	}
 	
 	//------------------------------------------------------------------------------------------------
 	//! Get a specific shape by ID
@@ -385,6 +676,8 @@ class AG0_TDLMapShapeManager
 		m_mRawShapeJsons.Clear();
 		m_aShapeList.Clear();
 		m_bListDirty = false;
+		m_ShapeIndex = null;
+		m_iRevision++;
 		m_sLastSyncHash = string.Empty;
 	}
 	
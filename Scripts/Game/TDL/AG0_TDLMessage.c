@@ -47,12 +47,14 @@ class AG0_TDLMessage
     // Delivery tracking (server-side only, not serialized to clients)
     protected ref set<RplId> m_DeliveredTo;
     protected ref set<RplId> m_ReadBy;
+    protected ref set<RplId> m_PendingRecipients;  // Relevant network members still waiting for it
     
     //------------------------------------------------------------------------------------------------
     void AG0_TDLMessage()
     {
         m_DeliveredTo = new set<RplId>();
         m_ReadBy = new set<RplId>();
+        m_PendingRecipients = new set<RplId>();
     }
     
     //------------------------------------------------------------------------------------------------
@@ -126,6 +128,7 @@ class AG0_TDLMessage
     void MarkDeliveredTo(RplId deviceRplId)
     {
         m_DeliveredTo.Insert(deviceRplId);
+        m_PendingRecipients.RemoveItem(deviceRplId);
     }
     
     bool IsReadBy(RplId deviceRplId)
@@ -141,6 +144,28 @@ class AG0_TDLMessage
     set<RplId> GetDeliveredTo() { return m_DeliveredTo; }
     set<RplId> GetReadBy() { return m_ReadBy; }
     
+    //------------------------------------------------------------------------------------------------
+    // Undelivered recipient tracking (server-side). The network seeds this when the message is
+    // created and when a device joins; the relay only ever walks these entries.
+    //------------------------------------------------------------------------------------------------
+    bool AddPendingRecipient(RplId deviceRplId)
+    {
+        if (deviceRplId == RplId.Invalid()) return false;
+        if (m_DeliveredTo.Contains(deviceRplId) || !IsRelevantTo(deviceRplId)) return false;
+        if (m_PendingRecipients.Contains(deviceRplId)) return false;
+        
+        m_PendingRecipients.Insert(deviceRplId);
+        return true;
+    }
+    
+    void RemovePendingRecipient(RplId deviceRplId)
+    {
+        m_PendingRecipients.RemoveItem(deviceRplId);
+    }
+    
+    bool HasPendingRecipients() { return !m_PendingRecipients.IsEmpty(); }
+    set<RplId> GetPendingRecipients() { return m_PendingRecipients; }
+    
     //------------------------------------------------------------------------------------------------
     // Get delivery status for a specific device (used by sender to show receipt status)
     //------------------------------------------------------------------------------------------------
@@ -215,6 +240,13 @@ class AG0_TDLMessageClient
     string directRecipientCallsign;
     ETDLMessageStatus status; // Delivery status (for sender's messages)
     
+    //------------------------------------------------------------------------------------------------
+    //! Approximate encoded size: seven ints plus three length-prefixed strings
+    int EstimateWireSize()
+    {
+        return 28 + 12 + senderCallsign.Length() + content.Length() + directRecipientCallsign.Length();
+    }
+    
     //------------------------------------------------------------------------------------------------
     static bool Extract(AG0_TDLMessageClient instance, ScriptCtx ctx, SSnapSerializerBase snapshot)
     {
@@ -314,40 +346,46 @@ class AG0_TDLMessageClient
         clientMsg.messageType = serverMsg.GetMessageType();
         clientMsg.directRecipientRplId = serverMsg.GetDirectRecipientRplId();
         clientMsg.directRecipientCallsign = serverMsg.GetDirectRecipientCallsign();
+        clientMsg.status = GetStatusForViewer(serverMsg, viewerRplId);
         
+        return clientMsg;
+    }
+    
+    //------------------------------------------------------------------------------------------------
+    // Status a viewer sees for a server message
+    //------------------------------------------------------------------------------------------------
+    static ETDLMessageStatus GetStatusForViewer(AG0_TDLMessage serverMsg, RplId viewerRplId)
+    {
         // For sender, show delivery status to recipient
         // For recipient, status is always "delivered" (they have it)
-        if (viewerRplId == serverMsg.GetSenderRplId())
-        {
-            // Sender viewing - show status for the recipient
-            if (serverMsg.GetMessageType() == ETDLMessageType.DIRECT)
-            {
-                clientMsg.status = serverMsg.GetStatusForRecipient(serverMsg.GetDirectRecipientRplId());
-            }
-            else
-            {
-                // For broadcasts, show READ if anyone has read it, DELIVERED if anyone received
-                // This is simplified - could be enhanced to show per-recipient status
-                clientMsg.status = ETDLMessageStatus.DELIVERED;
-                foreach (RplId readerId : serverMsg.GetReadBy())
-                {
-                    if (readerId != viewerRplId)
-                    {
-                        clientMsg.status = ETDLMessageStatus.READ;
-                        break;
-                    }
-                }
-            }
-        }
-        else
+        if (viewerRplId != serverMsg.GetSenderRplId())
+            return ETDLMessageStatus.DELIVERED;
+        
+        // Sender viewing - show status for the recipient
+        if (serverMsg.GetMessageType() == ETDLMessageType.DIRECT)
+            return serverMsg.GetStatusForRecipient(serverMsg.GetDirectRecipientRplId());
+        
+        // For broadcasts, show READ if anyone has read it, DELIVERED if anyone received
+        // This is simplified - could be enhanced to show per-recipient status
+        foreach (RplId readerId : serverMsg.GetReadBy())
         {
-            // Recipient viewing - they have it, so it's delivered
-            clientMsg.status = ETDLMessageStatus.DELIVERED;
+            if (readerId != viewerRplId)
+                return ETDLMessageStatus.READ;
         }
-        
-        return clientMsg;
+        return ETDLMessageStatus.DELIVERED;
     }
     
+    //------------------------------------------------------------------------------------------------
+    // Status updates travel as one int each: messageId in the high bits, status in the low 2
+    //------------------------------------------------------------------------------------------------
+    static int PackStatusUpdate(int messageId, ETDLMessageStatus status)
+    {
+        return (messageId << 2) | (status & 0x3);
+    }
+    
+    static int UnpackStatusUpdateMessageId(int packed) { return packed >> 2; }
+    static ETDLMessageStatus UnpackStatusUpdateStatus(int packed) { return packed & 0x3; }
+    
     //------------------------------------------------------------------------------------------------
     // Helper to check if this is an outgoing message for a viewer
     //------------------------------------------------------------------------------------------------
@@ -381,14 +419,19 @@ class AG0_TDLMessageStore
 {
     protected ref array<ref AG0_TDLMessageClient> m_aMessages = {};
     protected ref map<int, int> m_mMessageIndex = new map<int, int>();  // messageId -> array index
+    protected int m_iSyncSeq = 0;  // Last delta sequence applied (see AG0_TDLMessageSyncCursor)
     
     //------------------------------------------------------------------------------------------------
     void Clear()
     {
         m_aMessages.Clear();
         m_mMessageIndex.Clear();
+        m_iSyncSeq = 0;
     }
     
+    int GetSyncSeq() { return m_iSyncSeq; }
+    void SetSyncSeq(int seq) { m_iSyncSeq = seq; }
+    
     //------------------------------------------------------------------------------------------------
     void AddOrUpdateMessage(AG0_TDLMessageClient msg)
     {
@@ -522,4 +565,42 @@ class AG0_TDLMessageStore
     //------------------------------------------------------------------------------------------------
     array<ref AG0_TDLMessageClient> GetAllMessages() { return m_aMessages; }
     int Count() { return m_aMessages.Count(); }
-}
\ No newline at end of file
+}
+
+//------------------------------------------------------------------------------------------------
+// Server-side record of what one player's client holds of one viewer device's message log
+// on a network (keyed by player and device, see AG0_TDLNetwork.GetMessageSyncCursor).
+// Each delta RPC advances m_iSentSeq and carries the previous value as its base; the
+// client applies it only on top of that base and acks the new seq. m_mSentStatus holds
+// the status last sent per message, so a delta carries only unseen messages and status flips.
+//------------------------------------------------------------------------------------------------
+class AG0_TDLMessageSyncCursor
+{
+    // A client this many deltas behind on acks is treated as lost and gets a full resync
+    static const int MAX_UNACKED_DELTAS = 32;
+    
+    int m_iSentSeq = 0;
+    int m_iAckedSeq = 0;
+    ref map<int, int> m_mSentStatus = new map<int, int>();  // messageId -> ETDLMessageStatus
+    
+    //------------------------------------------------------------------------------------------------
+    // Forget everything sent; the next delta has base 0, which makes the client clear its store
+    //------------------------------------------------------------------------------------------------
+    void Reset()
+    {
+        m_iSentSeq = 0;
+        m_iAckedSeq = 0;
+        m_mSentStatus.Clear();
+    }
+    
+    bool NeedsReset()
+    {
+        return m_iSentSeq - m_iAckedSeq > MAX_UNACKED_DELTAS;
+    }
+    
+    void Ack(int seq)
+    {
+        if (seq > m_iAckedSeq && seq <= m_iSentSeq)
+            m_iAckedSeq = seq;
+    }
+}
@@ -26,10 +26,31 @@ class AG0_TDLNetworkMember
 	protected bool m_bIsBridged = false;
 	protected int m_iSourceNetworkId = -1;
 
+	// Client-side dead reckoning, filled from fast-path position samples. Not part of the
+	// codec and always zero on the server, so GetPosition is the raw sample there.
+	protected vector m_vVelocity;
+	protected float m_fSampleTimeMs;
+	// Extrapolation stops this long after the last sample, bounding the error when one is lost
+	static const float MAX_EXTRAPOLATION_MS = 3000;
+
     // Getters
     RplId GetRplId() { return m_RplId; }
     string GetPlayerName() { return m_sPlayerName; }
-    vector GetPosition() { return m_vPosition; }
+    vector GetSampledPosition() { return m_vPosition; }
+    vector GetVelocity() { return m_vVelocity; }
+
+    // Last reported position, dead-reckoned forward by the reported velocity
+    vector GetPosition()
+    {
+        if (m_vVelocity == vector.Zero) return m_vPosition;
+
+        World world = GetGame().GetWorld();
+        if (!world) return m_vPosition;
+
+        float elapsedMs = Math.Clamp(world.GetWorldTime() - m_fSampleTimeMs, 0, MAX_EXTRAPOLATION_MS);
+        return m_vPosition + m_vVelocity * (elapsedMs / 1000.0);
+    }
+
     float GetSignalStrength() { return m_fSignalStrength; }
     int GetNetworkIP() { return m_iNetworkIP; }
     int GetCapabilities() { return m_iDeviceCapabilities; }
@@ -50,6 +71,296 @@ class AG0_TDLNetworkMember
 	void SetIsBridged(bool bridged) { m_bIsBridged = bridged; }
 	void SetSourceNetworkId(int networkId) { m_iSourceNetworkId = networkId; }
 
+	// Copy every field from another member. Used server-side to stamp per-viewer
+	// copies (signal strength differs per viewer) from one shared member snapshot.
+	void CopyFrom(AG0_TDLNetworkMember other)
+	{
+		if (!other) return;
+		m_RplId = other.m_RplId;
+		m_sPlayerName = other.m_sPlayerName;
+		m_vPosition = other.m_vPosition;
+		m_fSignalStrength = other.m_fSignalStrength;
+		m_iNetworkIP = other.m_iNetworkIP;
+		m_iDeviceCapabilities = other.m_iDeviceCapabilities;
+		m_bIsPowered = other.m_bIsPowered;
+		m_bGPSActive = other.m_bGPSActive;
+		m_iOwnerPlayerId = other.m_iOwnerPlayerId;
+		m_VideoSourceRplId = other.m_VideoSourceRplId;
+		m_bIsBridged = other.m_bIsBridged;
+		m_iSourceNetworkId = other.m_iSourceNetworkId;
+	}
+
+	// True when every client-visible field matches `other`, with positions compared
+	// within positionTolerance metres. Signal strength is ignored — it is derived from
+	// positions per viewer. Server uses this to skip re-publishing unchanged components.
+	bool IsEquivalentTo(AG0_TDLNetworkMember other, float positionTolerance)
+	{
+		if (!other) return false;
+		if (m_RplId != other.m_RplId) return false;
+		if (m_sPlayerName != other.m_sPlayerName) return false;
+		if (m_iNetworkIP != other.m_iNetworkIP) return false;
+		if (m_iDeviceCapabilities != other.m_iDeviceCapabilities) return false;
+		if (m_bIsPowered != other.m_bIsPowered || m_bGPSActive != other.m_bGPSActive) return false;
+		if (m_iOwnerPlayerId != other.m_iOwnerPlayerId) return false;
+		if (m_VideoSourceRplId != other.m_VideoSourceRplId) return false;
+		if (m_bIsBridged != other.m_bIsBridged || m_iSourceNetworkId != other.m_iSourceNetworkId) return false;
+		return vector.DistanceSq(m_vPosition, other.m_vPosition) <= positionTolerance * positionTolerance;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	// Delta encoding against a keyframe baseline (see AG0_TDLMemberSyncCursor)
+	//
+	// A delta is a flat int stream of per-slot records: a header int (slot | changed-field
+	// mask << 16) followed by one payload int per set field, in bit order (three for
+	// DELTA_POS_ABS). Names travel in a side string array, consumed in record order.
+	// Positions are quantized to POSITION_QUANTUM and usually sent as one packed offset
+	// from the baseline; signal strength is rounded to whole percent.
+	//------------------------------------------------------------------------------------------------
+	static const int DELTA_REMOVED    = 1 << 0;
+	static const int DELTA_RPLID      = 1 << 1;
+	static const int DELTA_NAME       = 1 << 2;
+	static const int DELTA_POS_OFFSET = 1 << 3;
+	static const int DELTA_POS_ABS    = 1 << 4;
+	static const int DELTA_SIGNAL     = 1 << 5;
+	static const int DELTA_NETWORK_IP = 1 << 6;
+	static const int DELTA_CAPS       = 1 << 7;
+	static const int DELTA_FLAGS      = 1 << 8;
+	static const int DELTA_OWNER      = 1 << 9;
+	static const int DELTA_VIDEO      = 1 << 10;
+	static const int DELTA_SOURCE_NET = 1 << 11;
+
+	static const float POSITION_QUANTUM = 0.5;
+	// Packed offset: X and Z 12 bits each, Y 8 bits, all signed quanta (+/-1023 m, +/-63 m)
+	static const int POS_OFFSET_XZ_LIMIT = 2047;
+	static const int POS_OFFSET_Y_LIMIT = 127;
+
+	static int QuantizeCoord(float value) { return Math.Round(value / POSITION_QUANTUM); }
+	static int QuantizeSignal(float strength) { return Math.Round(Math.Clamp(strength, 0, 100)); }
+
+	protected int PackFlags()
+	{
+		int flags = 0;
+		if (m_bIsPowered) flags |= 1;
+		if (m_bGPSActive) flags |= 2;
+		if (m_bIsBridged) flags |= 4;
+		return flags;
+	}
+
+	protected void UnpackFlags(int flags)
+	{
+		m_bIsPowered = (flags & 1) != 0;
+		m_bGPSActive = (flags & 2) != 0;
+		m_bIsBridged = (flags & 4) != 0;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	// Fast-path position samples (see AG0_TDLSystem.UpdateMemberPositions)
+	//
+	// POSITION_SAMPLE_INTS ints per member: RplId, X | Z << 16 in unsigned position quanta,
+	// Y in signed quanta, then velocity packed like a position offset (X/Z 12 bits, Y 8 bits)
+	// in signed VELOCITY_QUANTUM steps.
+	//------------------------------------------------------------------------------------------------
+	static const int POSITION_SAMPLE_INTS = 4;
+	static const float VELOCITY_QUANTUM = 0.5;
+
+	static void AppendPositionSample(RplId rplId, vector position, vector velocity, notnull array<int> samples)
+	{
+		int qx = Math.ClampInt(QuantizeCoord(position[0]), 0, 0xFFFF);
+		int qz = Math.ClampInt(QuantizeCoord(position[2]), 0, 0xFFFF);
+		int vx = Math.ClampInt(Math.Round(velocity[0] / VELOCITY_QUANTUM), -POS_OFFSET_XZ_LIMIT, POS_OFFSET_XZ_LIMIT);
+		int vy = Math.ClampInt(Math.Round(velocity[1] / VELOCITY_QUANTUM), -POS_OFFSET_Y_LIMIT, POS_OFFSET_Y_LIMIT);
+		int vz = Math.ClampInt(Math.Round(velocity[2] / VELOCITY_QUANTUM), -POS_OFFSET_XZ_LIMIT, POS_OFFSET_XZ_LIMIT);
+
+		samples.Insert(rplId);
+		samples.Insert(qx | (qz << 16));
+		samples.Insert(QuantizeCoord(position[1]));
+		samples.Insert((vx & 0xFFF) | ((vz & 0xFFF) << 12) | ((vy & 0xFF) << 24));
+	}
+
+	// Take a sample's payload (the ints after its RplId) and restart extrapolation from it
+	void ApplyPositionSample(int packedXZ, int quantY, int packedVelocity, float sampleTimeMs)
+	{
+		m_vPosition = Vector(
+			(packedXZ & 0xFFFF) * POSITION_QUANTUM,
+			quantY * POSITION_QUANTUM,
+			((packedXZ >> 16) & 0xFFFF) * POSITION_QUANTUM);
+		m_vVelocity = Vector(
+			SignExtend(packedVelocity & 0xFFF, 12) * VELOCITY_QUANTUM,
+			SignExtend((packedVelocity >> 24) & 0xFF, 8) * VELOCITY_QUANTUM,
+			SignExtend((packedVelocity >> 12) & 0xFFF, 12) * VELOCITY_QUANTUM);
+		m_fSampleTimeMs = sampleTimeMs;
+	}
+
+	// Carry a replaced member's velocity over, extrapolating from this member's fresher position
+	void InheritMotion(AG0_TDLNetworkMember previous, float sampleTimeMs)
+	{
+		if (!previous) return;
+		m_vVelocity = previous.m_vVelocity;
+		m_fSampleTimeMs = sampleTimeMs;
+	}
+
+	protected static int SignExtend(int value, int bits)
+	{
+		int half = 1 << (bits - 1);
+		if (value >= half)
+			return value - (1 << bits);
+		return value;
+	}
+
+	// Append the record that turns `baseline` (null = slot empty at keyframe) into `current`
+	// (null = member gone). Returns false, appending nothing, when no client-visible field differs.
+	static bool AppendDelta(AG0_TDLNetworkMember baseline, AG0_TDLNetworkMember current, int slot,
+		notnull array<int> ops, notnull array<string> names)
+	{
+		if (!current)
+		{
+			if (!baseline) return false;
+			ops.Insert(slot | (DELTA_REMOVED << 16));
+			return true;
+		}
+
+		int qx = QuantizeCoord(current.m_vPosition[0]);
+		int qy = QuantizeCoord(current.m_vPosition[1]);
+		int qz = QuantizeCoord(current.m_vPosition[2]);
+		int dx, dy, dz;
+
+		int mask = 0;
+		if (!baseline)
+		{
+			mask = DELTA_RPLID | DELTA_NAME | DELTA_POS_ABS | DELTA_SIGNAL | DELTA_NETWORK_IP | DELTA_CAPS
+				| DELTA_FLAGS | DELTA_OWNER | DELTA_VIDEO | DELTA_SOURCE_NET;
+		}
+		else
+		{
+			if (current.m_sPlayerName != baseline.m_sPlayerName) mask |= DELTA_NAME;
+
+			dx = qx - QuantizeCoord(baseline.m_vPosition[0]);
+			dy = qy - QuantizeCoord(baseline.m_vPosition[1]);
+			dz = qz - QuantizeCoord(baseline.m_vPosition[2]);
+			if (dx != 0 || dy != 0 || dz != 0)
+			{
+				if (Math.AbsInt(dx) <= POS_OFFSET_XZ_LIMIT && Math.AbsInt(dz) <= POS_OFFSET_XZ_LIMIT && Math.AbsInt(dy) <= POS_OFFSET_Y_LIMIT)
+					mask |= DELTA_POS_OFFSET;
+				else
+					mask |= DELTA_POS_ABS;
+			}
+
+			if (QuantizeSignal(current.m_fSignalStrength) != QuantizeSignal(baseline.m_fSignalStrength)) mask |= DELTA_SIGNAL;
+			if (current.m_iNetworkIP != baseline.m_iNetworkIP) mask |= DELTA_NETWORK_IP;
+			if (current.m_iDeviceCapabilities != baseline.m_iDeviceCapabilities) mask |= DELTA_CAPS;
+			if (current.PackFlags() != baseline.PackFlags()) mask |= DELTA_FLAGS;
+			if (current.m_iOwnerPlayerId != baseline.m_iOwnerPlayerId) mask |= DELTA_OWNER;
+			if (current.m_VideoSourceRplId != baseline.m_VideoSourceRplId) mask |= DELTA_VIDEO;
+			if (current.m_iSourceNetworkId != baseline.m_iSourceNetworkId) mask |= DELTA_SOURCE_NET;
+
+			if (mask == 0) return false;
+		}
+
+		ops.Insert(slot | (mask << 16));
+		if (mask & DELTA_RPLID) ops.Insert(current.m_RplId);
+		if (mask & DELTA_NAME) names.Insert(current.m_sPlayerName);
+		if (mask & DELTA_POS_OFFSET) ops.Insert((dx & 0xFFF) | ((dz & 0xFFF) << 12) | ((dy & 0xFF) << 24));
+		if (mask & DELTA_POS_ABS)
+		{
+			ops.Insert(qx);
+			ops.Insert(qy);
+			ops.Insert(qz);
+		}
+		if (mask & DELTA_SIGNAL) ops.Insert(QuantizeSignal(current.m_fSignalStrength));
+		if (mask & DELTA_NETWORK_IP) ops.Insert(current.m_iNetworkIP);
+		if (mask & DELTA_CAPS) ops.Insert(current.m_iDeviceCapabilities);
+		if (mask & DELTA_FLAGS) ops.Insert(current.PackFlags());
+		if (mask & DELTA_OWNER) ops.Insert(current.m_iOwnerPlayerId);
+		if (mask & DELTA_VIDEO) ops.Insert(current.m_VideoSourceRplId);
+		if (mask & DELTA_SOURCE_NET) ops.Insert(current.m_iSourceNetworkId);
+		return true;
+	}
+
+	// Rebuild the full member list from a keyframe baseline (slot = index) and a delta stream.
+	// Baseline members are copied, never modified. Returns false on a malformed stream.
+	static bool ApplyDelta(array<ref AG0_TDLNetworkMember> baseline, array<int> ops, array<string> names,
+		notnull array<ref AG0_TDLNetworkMember> outMembers)
+	{
+		map<int, ref AG0_TDLNetworkMember> slots = new map<int, ref AG0_TDLNetworkMember>();
+		foreach (int baselineSlot, AG0_TDLNetworkMember baselineMember : baseline)
+			slots.Set(baselineSlot, baselineMember);
+
+		int opIndex = 0;
+		int nameIndex = 0;
+		int opCount = ops.Count();
+		while (opIndex < opCount)
+		{
+			int header = ops[opIndex++];
+			int slot = header & 0xFFFF;
+			int mask = header >> 16;
+
+			if (mask & DELTA_REMOVED)
+			{
+				slots.Remove(slot);
+				continue;
+			}
+
+			AG0_TDLNetworkMember member = new AG0_TDLNetworkMember();
+			AG0_TDLNetworkMember previous = slots.Get(slot);
+			if (previous)
+				member.CopyFrom(previous);
+			else if (!(mask & DELTA_RPLID))
+				return false;
+
+			// Payload ints this record still needs
+			int needed = 0;
+			for (int bit = DELTA_RPLID; bit <= DELTA_SOURCE_NET; bit = bit << 1)
+			{
+				if (bit == DELTA_NAME || !(mask & bit)) continue;
+				if (bit == DELTA_POS_ABS)
+					needed += 3;
+				else
+					needed++;
+			}
+			if (opIndex + needed > opCount) return false;
+			if ((mask & DELTA_NAME) && nameIndex >= names.Count()) return false;
+
+			if (mask & DELTA_RPLID) member.m_RplId = ops[opIndex++];
+			if (mask & DELTA_NAME) member.m_sPlayerName = names[nameIndex++];
+			if (mask & DELTA_POS_OFFSET)
+			{
+				int packed = ops[opIndex++];
+				int dx = SignExtend(packed & 0xFFF, 12);
+				int dz = SignExtend((packed >> 12) & 0xFFF, 12);
+				int dy = SignExtend((packed >> 24) & 0xFF, 8);
+				member.m_vPosition = Vector(
+					(QuantizeCoord(member.m_vPosition[0]) + dx) * POSITION_QUANTUM,
+					(QuantizeCoord(member.m_vPosition[1]) + dy) * POSITION_QUANTUM,
+					(QuantizeCoord(member.m_vPosition[2]) + dz) * POSITION_QUANTUM);
+			}
+			if (mask & DELTA_POS_ABS)
+			{
+				float x = ops[opIndex++] * POSITION_QUANTUM;
+				float y = ops[opIndex++] * POSITION_QUANTUM;
+				float z = ops[opIndex++] * POSITION_QUANTUM;
+				member.m_vPosition = Vector(x, y, z);
+			}
+			if (mask & DELTA_SIGNAL) member.m_fSignalStrength = ops[opIndex++];
+			if (mask & DELTA_NETWORK_IP) member.m_iNetworkIP = ops[opIndex++];
+			if (mask & DELTA_CAPS) member.m_iDeviceCapabilities = ops[opIndex++];
+			if (mask & DELTA_FLAGS) member.UnpackFlags(ops[opIndex++]);
+			if (mask & DELTA_OWNER) member.m_iOwnerPlayerId = ops[opIndex++];
+			if (mask & DELTA_VIDEO) member.m_VideoSourceRplId = ops[opIndex++];
+			if (mask & DELTA_SOURCE_NET) member.m_iSourceNetworkId = ops[opIndex++];
+
+			slots.Set(slot, member);
+		}
+
+		array<int> slotOrder = {};
+		foreach (int slot, AG0_TDLNetworkMember unused : slots)
+			slotOrder.Insert(slot);
+		slotOrder.Sort();
+
+		foreach (int orderedSlot : slotOrder)
+			outMembers.Insert(slots.Get(orderedSlot));
+		return true;
+	}
+
     // Extract - following Mario's pattern exactly
     static bool Extract(AG0_TDLNetworkMember instance, ScriptCtx ctx, SSnapSerializerBase snapshot)
     {
@@ -370,4 +681,90 @@ class AG0_TDLNetworkMembers
             return false;
         return false;
     }
-}
\ No newline at end of file
+}
+
+// AG0_TDLMemberSyncCursor - server-side member sync state for one player on one network.
+// A reliable keyframe carries the full member list and fixes the slot layout (slot = index);
+// between keyframes each update is a small unreliable delta against that keyframe, so a
+// dropped delta costs nothing; the next one supersedes it.
+class AG0_TDLMemberSyncCursor
+{
+	// Deltas sent between reliable keyframes
+	static const int KEYFRAME_INTERVAL = 10;
+
+	protected int m_iKeyframeId = 0;
+	protected int m_iDeltaSeq = 0;
+	protected bool m_bKeyframeRequested = true;
+	protected int m_iPositionSeq = 0;
+	protected ref array<ref AG0_TDLNetworkMember> m_aBaseline = {};
+	protected ref map<RplId, int> m_mSlots = new map<RplId, int>();
+	protected int m_iNextSlot = 0;
+
+	int GetKeyframeId() { return m_iKeyframeId; }
+	int GetDeltaSeq() { return m_iDeltaSeq; }
+
+	// Position samples are absolute, so they only need ordering, not a baseline
+	int NextPositionSeq()
+	{
+		m_iPositionSeq++;
+		return m_iPositionSeq;
+	}
+
+	// Force the next update to be a keyframe (client lost its baseline, or left the network)
+	void RequestKeyframe() { m_bKeyframeRequested = true; }
+
+	bool NeedsKeyframe()
+	{
+		return m_bKeyframeRequested || m_iDeltaSeq >= KEYFRAME_INTERVAL;
+	}
+
+	// Adopt `members` as the new baseline. Returns the new keyframe ID.
+	int SetKeyframe(array<ref AG0_TDLNetworkMember> members)
+	{
+		m_aBaseline.Clear();
+		m_mSlots.Clear();
+		foreach (AG0_TDLNetworkMember member : members)
+		{
+			AG0_TDLNetworkMember copy = new AG0_TDLNetworkMember();
+			copy.CopyFrom(member);
+			m_mSlots.Set(copy.GetRplId(), m_aBaseline.Count());
+			m_aBaseline.Insert(copy);
+		}
+		m_iNextSlot = m_aBaseline.Count();
+		m_iDeltaSeq = 0;
+		m_bKeyframeRequested = false;
+		m_iKeyframeId++;
+		return m_iKeyframeId;
+	}
+
+	// Encode `members` against the baseline. Members new since the keyframe get the next free
+	// slot and keep it until the next keyframe. Returns the new delta sequence number.
+	int BuildDelta(array<ref AG0_TDLNetworkMember> members, notnull array<int> ops, notnull array<string> names)
+	{
+		set<int> liveSlots = new set<int>();
+		foreach (AG0_TDLNetworkMember member : members)
+		{
+			int slot;
+			if (!m_mSlots.Find(member.GetRplId(), slot))
+			{
+				slot = m_iNextSlot++;
+				m_mSlots.Set(member.GetRplId(), slot);
+			}
+			liveSlots.Insert(slot);
+
+			AG0_TDLNetworkMember baseline = null;
+			if (slot < m_aBaseline.Count())
+				baseline = m_aBaseline[slot];
+			AG0_TDLNetworkMember.AppendDelta(baseline, member, slot, ops, names);
+		}
+
+		for (int i = 0; i < m_aBaseline.Count(); i++)
+		{
+			if (!liveSlots.Contains(i))
+				AG0_TDLNetworkMember.AppendDelta(m_aBaseline[i], null, i, ops, names);
+		}
+
+		m_iDeltaSeq++;
+		return m_iDeltaSeq;
+	}
+}
@@ -8,9 +8,10 @@
 //   sharp + image-q  ──► JSON { w, h, p, rgz|r|d } ──►  SCR_JsonLoadContext
 //                           (base64, optionally gzipped)       │
 //                                                              ▼
-//                                                     AG0_Base64.Decode
-//                                                     AG0_TDLGzip.Gunzip  (rgz only)
+//                                                     AG0_TDLBase64Decoder
+//                                                     AG0_TDLGzip  (rgz only)
 //                                                     DecodeRectsFromBytes
+//                                           (frame-sliced, see DecodePendingPayload)
 //                                                              │
 //                                                              ▼
 //                                               AG0_TDLPhotoRenderer.Draw()
@@ -54,6 +55,15 @@ class AG0_Base64
             s_Lookup[chars.ToAscii(i)] = i;
     }
     
+    //! Encode bytes (0..255) in one call. For large inputs use AG0_TDLBase64Encoder.
+    static string Encode(array<int> bytes)
+    {
+        AG0_TDLBase64Encoder e = new AG0_TDLBase64Encoder();
+        e.Init(bytes);
+        while (e.Step(1000000)) {}
+        return e.GetOutput();
+    }
+    
     static array<int> Decode(string input)
     {
         InitLookup();
@@ -218,6 +228,119 @@ class AG0_TDLBase64Decoder
     int GetTotal()     { return m_iLen; }
 }
 
+//------------------------------------------------------------------------------------------------
+//! Resumable base64 encoder, the counterpart of AG0_TDLBase64Decoder for
+//! uploads (see AG0_TDLGzipEncoder).
+//!
+//! Script strings are immutable, so appending one character at a time
+//! would copy the whole output per quantum. Output is built in CHUNK_CHARS
+//! pieces and the pieces are joined pairwise in GetOutput, which keeps the
+//! total copying at O(n log n).
+//!
+//! Usage:
+//!   AG0_TDLBase64Encoder e = new AG0_TDLBase64Encoder();
+//!   e.Init(bytes);
+//!   while (e.Step(timeBudgetMs)) { /* yield to next frame */ }
+//!   string b64 = e.GetOutput();
+//------------------------------------------------------------------------------------------------
+class AG0_TDLBase64Encoder
+{
+    protected static const int CHUNK_CHARS = 4096;
+    protected static ref array<string> s_Chars;
+
+    protected ref array<int> m_aInput;
+    protected int    m_iLen;
+    protected int    m_iInPos;
+    protected string m_sChunk;
+    protected ref array<string> m_aChunks;
+
+    void Init(array<int> bytes)
+    {
+        if (!s_Chars)
+        {
+            s_Chars = {};
+            string chars = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+            for (int i = 0; i < 64; i++)
+                s_Chars.Insert(chars.Get(i));
+        }
+
+        m_aInput = bytes;
+        m_iLen   = bytes.Count();
+        m_iInPos = 0;
+        m_sChunk = string.Empty;
+        m_aChunks = {};
+    }
+
+    //! Encode until timeBudgetMs elapses or the input is exhausted.
+    //! Returns true if more remains, false when GetOutput is ready.
+    bool Step(int timeBudgetMs)
+    {
+        int startTick = System.GetTickCount();
+
+        while (m_iInPos < m_iLen)
+        {
+            int remaining = m_iLen - m_iInPos;
+            int a = m_aInput[m_iInPos] & 0xFF;
+            int b = 0;
+            int c = 0;
+            if (remaining > 1) b = m_aInput[m_iInPos + 1] & 0xFF;
+            if (remaining > 2) c = m_aInput[m_iInPos + 2] & 0xFF;
+
+            string quad = s_Chars[a >> 2] + s_Chars[((a & 0x3) << 4) | (b >> 4)];
+            if (remaining > 1)
+                quad += s_Chars[((b & 0xF) << 2) | (c >> 6)];
+            else
+                quad += "=";
+            if (remaining > 2)
+                quad += s_Chars[c & 0x3F];
+            else
+                quad += "=";
+
+            m_sChunk += quad;
+            m_iInPos = m_iInPos + 3;
+
+            if (m_sChunk.Length() >= CHUNK_CHARS)
+            {
+                m_aChunks.Insert(m_sChunk);
+                m_sChunk = string.Empty;
+
+                if (System.GetTickCount() - startTick >= timeBudgetMs)
+                    return m_iInPos < m_iLen;
+            }
+        }
+        return false;
+    }
+
+    string GetOutput()
+    {
+        if (!m_sChunk.IsEmpty())
+        {
+            m_aChunks.Insert(m_sChunk);
+            m_sChunk = string.Empty;
+        }
+
+        if (m_aChunks.IsEmpty())
+            return string.Empty;
+
+        while (m_aChunks.Count() > 1)
+        {
+            array<string> merged = {};
+            for (int i = 0; i < m_aChunks.Count(); i += 2)
+            {
+                if (i + 1 < m_aChunks.Count())
+                    merged.Insert(m_aChunks[i] + m_aChunks[i + 1]);
+                else
+                    merged.Insert(m_aChunks[i]);
+            }
+            m_aChunks = merged;
+        }
+        return m_aChunks[0];
+    }
+
+    int GetProgress()  { return m_iInPos; }
+    int GetTotal()     { return m_iLen; }
+}
+
 //------------------------------------------------------------------------------------------------
 // REST callback for image API
 //------------------------------------------------------------------------------------------------
@@ -339,30 +462,6 @@ class AG0_TDLPhotoData
         return DecodeRectsFromBytes(AG0_Base64.Decode(base64Input));
     }
 
-    //------------------------------------------------------------------------------------------------
-    //! Decode the server's "rgz" field — base64(gzip(rect records)). Cuts
-    //! payload another 20-50% on top of the already-dense rect encoding
-    //! because run indices and repeated (x,w) columns compress well.
-    //!
-    //! The double-wrap (gzip then base64) is deliberate: RestContext returns
-    //! responses as strings, which aren't binary-safe (null bytes truncate),
-    //! so the gzip bytes have to ride inside a printable ASCII envelope.
-    static array<int> DecodeRectsBase64Gzip(string base64Input)
-    {
-        array<int> gz = AG0_Base64.Decode(base64Input);
-        array<int> raw = AG0_TDLGzip.Gunzip(gz);
-        return DecodeRectsFromBytes(raw);
-    }
-
-    //------------------------------------------------------------------------------------------------
-    //! Decode the server's "dgz" field — base64(gzip(pixel bytes)). Companion
-    //! to "rgz" for the legacy per-pixel path, for parity.
-    static array<int> DecodePixelsBase64Gzip(string base64Input)
-    {
-        array<int> gz = AG0_Base64.Decode(base64Input);
-        return AG0_TDLGzip.Gunzip(gz);
-    }
-    
     //------------------------------------------------------------------------------------------------
     static AG0_TDLPhotoData CreateTestGradient(int size = 64)
     {
@@ -1181,15 +1280,16 @@ class AG0_TDLPhotoComponent : ScriptComponent
     protected string m_sPendingFieldKind;       // "rgz" | "r" | "d"
     protected ref AG0_TDLBase64Decoder m_PendingB64;
     protected ref array<int> m_aPendingBytes;   // base64 output → gunzip input handoff
+    protected ref AG0_TDLGzip m_PendingGunzip;
     protected int m_iPendingT0;                 // tick at which decode chain began
     protected int m_iPendingTBatch;             // tick at start of current step
 
-    // Tunable: how many ms to spend decoding base64 per frame. Lower =
+    // Tunable: how many ms to spend decoding base64 / gunzip per frame. Lower =
     // smoother FPS, longer total decode. Higher = faster decode, more hitch.
     // 60fps frame is 16.7ms; 8ms leaves the rest of the game half a frame
     // of headroom and is a good default. Set 4 for buttery smooth, 12 for
     // fast-as-possible-without-stutter.
-    [Attribute("8", UIWidgets.SpinBox, "Base64 decode time budget per frame (ms)", "1 16 1")]
+    [Attribute("8", UIWidgets.SpinBox, "Base64 / gunzip decode time budget per frame (ms)", "1 16 1")]
     protected int m_iB64MsPerFrame;
 
     //------------------------------------------------------------------------------------------------
@@ -1208,6 +1308,10 @@ class AG0_TDLPhotoComponent : ScriptComponent
     //!   3. "d"   — base64(pixel indices)           legacy per-pixel
     void OnImageDataReceived(string jsonData)
     {
+        // A newer response supersedes a decode still in flight: drop its state and its
+        // queued steps, or its output would land on this photo (different w/h/palette)
+        CancelPendingDecode();
+
         int t0 = System.GetTickCount();
         Print(string.Format("[TDLPhotoComponent] Parsing JSON, length: %1", jsonData.Length()), LogLevel.NORMAL);
 
@@ -1290,11 +1394,10 @@ class AG0_TDLPhotoComponent : ScriptComponent
     //! (more work pending) or hands off to the next step.
     //!
     //! Flow:
-    //!   DecodePendingPayload  ──► StepBase64 (loop) ──► StepGunzipAndRects ──► SetPhoto
+    //!   DecodePendingPayload  ──► StepBase64 (loop) ──► StepGunzipAndRects (loop) ──► SetPhoto
     //!
-    //! StepBase64 is the only step that needs frame chunking — gunzip
-    //! and rect parse are 1-2 orders of magnitude faster (gunzip ~700ms,
-    //! rect parse ~50ms on the same payload). They fit in one frame.
+    //! Base64 and gunzip are both frame-chunked on m_iB64MsPerFrame; the
+    //! rect parse (~50ms on the observed payload) runs in the final frame.
     protected void DecodePendingPayload()
     {
         if (!m_PendingPhoto || m_sPendingPayload.Length() == 0)
@@ -1347,34 +1450,52 @@ class AG0_TDLPhotoComponent : ScriptComponent
         Print(string.Format("[TDLPhotoComponent] T+%1ms: base64 done, %2 bytes",
             tNow - m_iPendingT0, m_aPendingBytes.Count()), LogLevel.NORMAL);
 
-        // Schedule gunzip on a clean frame. Even though gunzip itself is
-        // ~700ms (still hitchy) it doesn't pile on top of this frame's
-        // base64 batch. If gunzip becomes the new dominant hitch, it gets
-        // the same resumable treatment as AG0_TDLBase64Decoder.
+        // Start gunzip on a clean frame so its first slice doesn't pile on
+        // top of this frame's base64 batch.
+        m_iPendingTBatch = tNow;
         GetGame().GetCallqueue().CallLater(StepGunzipAndRects, 0, false);
     }
 
     //------------------------------------------------------------------------------------------------
-    //! Synchronous gunzip + rect parse, scheduled on its own frame.
-    //! Combined ~700-1000ms on the observed payload — meaningful but
-    //! not chunked yet because base64 dominated by 16x. If gunzip
-    //! becomes the new bottleneck after this lands, AG0_TDLGzip would
-    //! get the same resumable treatment as AG0_TDLBase64Decoder.
+    //! One frame of gunzip (rgz payloads), re-scheduling itself like
+    //! StepBase64 until the stream is inflated; then the rect parse and
+    //! SetPhoto. Uncompressed kinds go straight to the parse.
     protected void StepGunzipAndRects()
     {
-        if (!m_PendingPhoto || !m_aPendingBytes)
+        if (!m_PendingPhoto)
+            return;
+        if (!m_PendingGunzip && !m_aPendingBytes)
             return;
-
-        array<int> bytes = m_aPendingBytes;
-        m_aPendingBytes = null;
 
         if (m_sPendingFieldKind == "rgz")
         {
-            int tA = System.GetTickCount();
-            array<int> raw = AG0_TDLGzip.Gunzip(bytes);
+            if (!m_PendingGunzip)
+            {
+                m_PendingGunzip = new AG0_TDLGzip();
+                m_PendingGunzip.InitGzip(m_aPendingBytes);
+                m_aPendingBytes = null;
+            }
+
+            if (m_PendingGunzip.Step(m_iB64MsPerFrame))
+            {
+                int batchEnd = System.GetTickCount();
+                if (batchEnd - m_iPendingTBatch > 250)
+                {
+                    int progress = m_PendingGunzip.GetProgress();
+                    int total    = m_PendingGunzip.GetTotal();
+                    Print(string.Format("[TDLPhotoComponent] gunzip %1 / %2 bytes (%3%%)",
+                        progress, total, (progress * 100) / total), LogLevel.NORMAL);
+                    m_iPendingTBatch = batchEnd;
+                }
+                GetGame().GetCallqueue().CallLater(StepGunzipAndRects, 0, false);
+                return;
+            }
+
+            array<int> raw = m_PendingGunzip.GetOutput();
+            m_PendingGunzip = null;
             int tB = System.GetTickCount();
-            Print(string.Format("[TDLPhotoComponent] T+%1ms (+%2ms): gunzip produced %3 bytes",
-                tB - m_iPendingT0, tB - tA, raw.Count()), LogLevel.NORMAL);
+            Print(string.Format("[TDLPhotoComponent] T+%1ms: gunzip produced %2 bytes",
+                tB - m_iPendingT0, raw.Count()), LogLevel.NORMAL);
 
             if (raw.Count() == 0)
             {
@@ -1391,7 +1512,7 @@ class AG0_TDLPhotoComponent : ScriptComponent
         else if (m_sPendingFieldKind == "r")
         {
             int tA = System.GetTickCount();
-            m_PendingPhoto.m_aRects = AG0_TDLPhotoData.DecodeRectsFromBytes(bytes);
+            m_PendingPhoto.m_aRects = AG0_TDLPhotoData.DecodeRectsFromBytes(m_aPendingBytes);
             int tB = System.GetTickCount();
             Print(string.Format("[TDLPhotoComponent] T+%1ms (+%2ms): %3 rects parsed (uncompressed)",
                 tB - m_iPendingT0, tB - tA, m_PendingPhoto.GetRectCount()), LogLevel.NORMAL);
@@ -1399,7 +1520,7 @@ class AG0_TDLPhotoComponent : ScriptComponent
         else if (m_sPendingFieldKind == "d")
         {
             // Legacy: bytes ARE the pixel array
-            m_PendingPhoto.m_aPixels = bytes;
+            m_PendingPhoto.m_aPixels = m_aPendingBytes;
             int tA = System.GetTickCount();
             Print(string.Format("[TDLPhotoComponent] T+%1ms: %2 pixels (legacy)",
                 tA - m_iPendingT0, m_PendingPhoto.m_aPixels.Count()), LogLevel.NORMAL);
@@ -1410,6 +1531,16 @@ class AG0_TDLPhotoComponent : ScriptComponent
         SetPhoto(ready);
     }
 
+    //------------------------------------------------------------------------------------------------
+    //! Stop the async decode chain wherever it is
+    protected void CancelPendingDecode()
+    {
+        GetGame().GetCallqueue().Remove(DecodePendingPayload);
+        GetGame().GetCallqueue().Remove(StepBase64);
+        GetGame().GetCallqueue().Remove(StepGunzipAndRects);
+        ClearPendingPayload();
+    }
+
     //------------------------------------------------------------------------------------------------
     protected void ClearPendingPayload()
     {
@@ -1418,6 +1549,7 @@ class AG0_TDLPhotoComponent : ScriptComponent
         m_sPendingFieldKind = "";
         m_PendingB64        = null;
         m_aPendingBytes     = null;
+        m_PendingGunzip     = null;
     }
 
     //------------------------------------------------------------------------------------------------
@@ -1431,6 +1563,14 @@ class AG0_TDLPhotoComponent : ScriptComponent
         OnImageDataReceived(jsonData);
     }
 
+    //------------------------------------------------------------------------------------------------
+    //! Time AG0_TDLGzip's table decode against the reference bit walk on a
+    //! captured "rgz" field (base64 string as it appears in the response).
+    void BenchmarkGunzip(string rgzBase64)
+    {
+        AG0_TDLGzip.Benchmark(AG0_Base64.Decode(rgzBase64), "photo rgz");
+    }
+
     //------------------------------------------------------------------------------------------------
     //! Cycles through four offline test patterns so you can eyeball every
     //! render path without the API:
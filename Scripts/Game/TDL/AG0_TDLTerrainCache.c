@@ -0,0 +1,251 @@
+//------------------------------------------------------------------------------------------------
+// AG0_TDLTerrainCache.c
+// Client-side on-disk cache of the terrain structure / road payloads.
+//
+// Terrain only changes when the world changes, so clients keep the last payload
+// they received under $profile:TDL/terrain_cache, one file per world + dataset.
+// When the server asks (AG0_TDLSystem.OnClientTerrainCacheHash handshake), the
+// client answers with the hash it holds; if that is the server's current hash the
+// chunked transfer is skipped and the payload is loaded from here instead.
+//
+// File layout (text, one value per line):
+//   FILE_TAG
+//   <sync hash>
+//   <payload length>
+//   <line count>
+//   <payload, at most LINE_CHARS per line>
+// Each payload line starts with a marker for what followed it in the payload — nothing
+// (LINE_BREAK_NONE), "\n" or "\r" — so payloads with line breaks (the raw JSON fallback)
+// round-trip. A short or mismatching file, or one whose length doesn't add up, is a miss.
+//------------------------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------------------------
+enum AG0_ETDLTerrainDataset
+{
+    STRUCTURES,
+    ROADS
+}
+
+//------------------------------------------------------------------------------------------------
+class AG0_TDLTerrainCache
+{
+    protected static const string CACHE_ROOT = "$profile:TDL";
+    protected static const string CACHE_FOLDER = "$profile:TDL/terrain_cache";
+    protected static const string FILE_TAG = "TDL_TERRAIN_CACHE 2";
+
+    // Payload is split across lines so no single ReadLine has to hold megabytes
+    protected static const int LINE_CHARS = 4096;
+
+    // Payload line markers
+    protected static const string LINE_BREAK_NONE = "-";
+    protected static const string LINE_BREAK_LF = "n";
+    protected static const string LINE_BREAK_CR = "r";
+
+    //------------------------------------------------------------------------------------------------
+    //! Cache file for a dataset of the current world; empty if the world can't be identified
+    static string GetPath(AG0_ETDLTerrainDataset dataset)
+    {
+        string world = AG0_MapSatelliteConfigHelper.GetCurrentWorldIdentifier();
+        if (world.IsEmpty())
+            world = GetGame().GetWorldFile();
+        if (world.IsEmpty())
+            return string.Empty;
+
+        string suffix = "roads";
+        if (dataset == AG0_ETDLTerrainDataset.STRUCTURES)
+            suffix = "structures";
+
+        return string.Format("%1/%2_%3.txt", CACHE_FOLDER, SanitizeName(world), suffix);
+    }
+
+    //------------------------------------------------------------------------------------------------
+    //! Hash of the cached payload, without reading the payload itself
+    //! @return empty on a miss
+    static string ReadHash(AG0_ETDLTerrainDataset dataset)
+    {
+        string path = GetPath(dataset);
+        if (path.IsEmpty() || !FileIO.FileExists(path))
+            return string.Empty;
+
+        FileHandle file = FileIO.OpenFile(path, FileMode.READ);
+        if (!file)
+            return string.Empty;
+
+        string tag;
+        string hash;
+        file.ReadLine(tag);
+        file.ReadLine(hash);
+        file.Close();
+
+        if (tag != FILE_TAG)
+            return string.Empty;
+        return hash;
+    }
+
+    //------------------------------------------------------------------------------------------------
+    //! Load the cached payload if it was stored under expectedHash.
+    //! @return empty on a miss, a hash mismatch or a truncated file
+    static string ReadPayload(AG0_ETDLTerrainDataset dataset, string expectedHash)
+    {
+        string path = GetPath(dataset);
+        if (path.IsEmpty() || expectedHash.IsEmpty() || !FileIO.FileExists(path))
+            return string.Empty;
+
+        FileHandle file = FileIO.OpenFile(path, FileMode.READ);
+        if (!file)
+            return string.Empty;
+
+        string tag;
+        string hash;
+        string lengthLine;
+        string countLine;
+        file.ReadLine(tag);
+        file.ReadLine(hash);
+        file.ReadLine(lengthLine);
+        file.ReadLine(countLine);
+        if (tag != FILE_TAG || hash != expectedHash)
+        {
+            file.Close();
+            return string.Empty;
+        }
+
+        int lineCount = countLine.ToInt();
+        array<string> lines = {};
+        lines.Reserve(lineCount);
+        string line;
+        while (lines.Count() < lineCount && file.ReadLine(line) >= 0)
+        {
+            if (line.IsEmpty())
+                break;
+            lines.Insert(line.Substring(1, line.Length() - 1) + DecodeLineBreak(line.Get(0)));
+        }
+        file.Close();
+
+        if (lineCount <= 0 || lines.Count() != lineCount)
+        {
+            Print(string.Format("[TDL_TERRAIN_CACHE] %1 truncated (%2 / %3 lines)", path, lines.Count(), lineCount), LogLevel.WARNING);
+            return string.Empty;
+        }
+
+        // Join pairwise: appending line by line would copy the payload once per line
+        while (lines.Count() > 1)
+        {
+            array<string> merged = {};
+            for (int i = 0; i < lines.Count(); i += 2)
+            {
+                if (i + 1 < lines.Count())
+                    merged.Insert(lines[i] + lines[i + 1]);
+                else
+                    merged.Insert(lines[i]);
+            }
+            lines = merged;
+        }
+
+        if (lines[0].Length() != lengthLine.ToInt())
+        {
+            Print(string.Format("[TDL_TERRAIN_CACHE] %1 length mismatch (%2 / %3 chars)", path, lines[0].Length(), lengthLine), LogLevel.WARNING);
+            return string.Empty;
+        }
+        return lines[0];
+    }
+
+    //------------------------------------------------------------------------------------------------
+    //! Store a payload for the current world, replacing any previous one
+    static bool Write(AG0_ETDLTerrainDataset dataset, string hash, string payload)
+    {
+        string path = GetPath(dataset);
+        if (path.IsEmpty() || hash.IsEmpty() || payload.IsEmpty())
+            return false;
+
+        if (!FileIO.FileExists(CACHE_ROOT))
+            FileIO.MakeDirectory(CACHE_ROOT);
+        if (!FileIO.FileExists(CACHE_FOLDER))
+            FileIO.MakeDirectory(CACHE_FOLDER);
+
+        FileHandle file = FileIO.OpenFile(path, FileMode.WRITE);
+        if (!file)
+        {
+            Print(string.Format("[TDL_TERRAIN_CACHE] Could not write %1", path), LogLevel.WARNING);
+            return false;
+        }
+
+        // Cut at LINE_CHARS and at every line break; the break itself becomes the next marker
+        int len = payload.Length();
+        array<string> lines = {};
+        int nextLf = payload.IndexOfFrom(0, "\n");
+        int nextCr = payload.IndexOfFrom(0, "\r");
+        int start = 0;
+        while (start < len)
+        {
+            if (nextLf >= 0 && nextLf < start)
+                nextLf = payload.IndexOfFrom(start, "\n");
+            if (nextCr >= 0 && nextCr < start)
+                nextCr = payload.IndexOfFrom(start, "\r");
+
+            int end = Math.Min(start + LINE_CHARS, len);
+            string marker = LINE_BREAK_NONE;
+            if (nextLf >= 0 && nextLf < end && (nextCr < 0 || nextLf < nextCr))
+            {
+                end = nextLf;
+                marker = LINE_BREAK_LF;
+            }
+            else if (nextCr >= 0 && nextCr < end)
+            {
+                end = nextCr;
+                marker = LINE_BREAK_CR;
+            }
+
+            lines.Insert(marker + payload.Substring(start, end - start));
+            start = end;
+            if (marker != LINE_BREAK_NONE)
+                start++;
+        }
+
+        file.WriteLine(FILE_TAG);
+        file.WriteLine(hash);
+        file.WriteLine(len.ToString());
+        file.WriteLine(lines.Count().ToString());
+        foreach (string line : lines)
+            file.WriteLine(line);
+        file.Close();
+
+        Print(string.Format("[TDL_TERRAIN_CACHE] Stored %1 (%2 chars, hash=%3)", path, len, hash), LogLevel.DEBUG);
+        return true;
+    }
+
+    //------------------------------------------------------------------------------------------------
+    protected static string DecodeLineBreak(string marker)
+    {
+        if (marker == LINE_BREAK_LF)
+            return "\n";
+        if (marker == LINE_BREAK_CR)
+            return "\r";
+        return string.Empty;
+    }
+
+    //------------------------------------------------------------------------------------------------
+    static void Delete(AG0_ETDLTerrainDataset dataset)
+    {
+        string path = GetPath(dataset);
+        if (!path.IsEmpty() && FileIO.FileExists(path))
+            FileIO.DeleteFile(path);
+    }
+
+    //------------------------------------------------------------------------------------------------
+    //! World identifiers / resource paths → something safe to use as a file name
+    protected static string SanitizeName(string name)
+    {
+        string result;
+        int len = name.Length();
+        for (int i = 0; i < len; i++)
+        {
+            int c = name.ToAscii(i);
+            bool keep = (c >= 48 && c <= 57) || (c >= 65 && c <= 90) || (c >= 97 && c <= 122) || c == 45;
+            if (keep)
+                result += name.Get(i);
+            else
+                result += "_";
+        }
+        return result;
+    }
+}
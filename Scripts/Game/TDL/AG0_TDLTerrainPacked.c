@@ -0,0 +1,503 @@
+//------------------------------------------------------------------------------------------------
+// AG0_TDLTerrainPacked.c
+// Packed binary wire format for the terrain structure / road datasets.
+//
+// The v1 JSON columnar payloads are several MB on big maps and have to be
+// re-shipped to every client on join. The packed form is a compact binary
+// columnar layout carried as base64(gzip(binary)) — the same envelope the
+// photo pipeline uses — so it survives RestContext / RPC string params.
+//
+// Where it comes from:
+//   * The API returns it directly when asked for ?format=packed:
+//       { "v": 2, "hash": "<opaque>", "encoding": "gzip+base64", "data": "<packed>" }
+//   * Otherwise (v1 JSON) the server packs the parsed dataset itself, once.
+// Either way the server forwards only the packed string to clients. A packed
+// payload never starts with '{', which is how receivers tell it from v1 JSON.
+//
+// Binary layout (all multi-byte integers little-endian; "var" = LEB128
+// unsigned varint, "svar" = zigzag varint, "str" = var length + bytes):
+//
+//   Common header:  u8 'T', u8 'S' | 'R', u8 version (2), str hash
+//
+//   Structures ('S'):
+//     var prefabCount, str prefabs[...]
+//     var typeCount,   str types[...]
+//     i32 originX, i32 originZ          tile-aligned dataset origin (meters)
+//     var tileCount, then per tile (TILE_SIZE meters square):
+//       var tileX, var tileZ            tile index relative to origin
+//       var count
+//       i16 x[count], i16 z[count]      tile-local center, 1/POSITION_SCALE m
+//       u8  r[count]                    rotation, 2π/256 steps
+//       u16 h[count], w[count], d[count] decimeters
+//       var t[count], var p[count]      type / prefab palette indices
+//
+//   Roads ('R'):
+//     var typeCount, str types[...]
+//     i32 originX, i32 originZ
+//     var n, var m
+//     var t[n], u16 w[n] (dm), u8 pr[n], var len[n]
+//     svar dx, svar dz per point (m points, 1/ROAD_POINT_SCALE m), each the
+//     difference from the previous point in stream order — the first point of
+//     a feature is relative to the last point of the one before it.
+//------------------------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------------------------
+//! Append-only byte buffer for the packed format. One element per byte (0..255).
+//------------------------------------------------------------------------------------------------
+class AG0_TDLByteWriter
+{
+    protected ref array<int> m_aBytes = {};
+
+    //------------------------------------------------------------------------------------------------
+    void WriteU8(int value)
+    {
+        m_aBytes.Insert(value & 0xFF);
+    }
+
+    //------------------------------------------------------------------------------------------------
+    void WriteU16(int value)
+    {
+        m_aBytes.Insert(value & 0xFF);
+        m_aBytes.Insert((value >> 8) & 0xFF);
+    }
+
+    //------------------------------------------------------------------------------------------------
+    void WriteI32(int value)
+    {
+        m_aBytes.Insert(value & 0xFF);
+        m_aBytes.Insert((value >> 8) & 0xFF);
+        m_aBytes.Insert((value >> 16) & 0xFF);
+        m_aBytes.Insert((value >> 24) & 0xFF);
+    }
+
+    //------------------------------------------------------------------------------------------------
+    //! Unsigned LEB128. Negative values are written as their 32-bit pattern.
+    void WriteVarUInt(int value)
+    {
+        while (value < 0 || value >= 0x80)
+        {
+            m_aBytes.Insert((value & 0x7F) | 0x80);
+            value = (value >> 7) & 0x01FFFFFF;  // logical shift
+        }
+        m_aBytes.Insert(value);
+    }
+
+    //------------------------------------------------------------------------------------------------
+    //! Zigzag varint: small magnitudes of either sign stay short
+    void WriteVarInt(int value)
+    {
+        WriteVarUInt((value << 1) ^ (value >> 31));
+    }
+
+    //------------------------------------------------------------------------------------------------
+    void WriteString(string value)
+    {
+        int len = value.Length();
+        WriteVarUInt(len);
+        for (int i = 0; i < len; i++)
+            m_aBytes.Insert(value.ToAscii(i) & 0xFF);
+    }
+
+    //------------------------------------------------------------------------------------------------
+    array<int> GetBytes() { return m_aBytes; }
+    int GetCount() { return m_aBytes.Count(); }
+}
+
+//------------------------------------------------------------------------------------------------
+//! Cursor over a packed byte buffer. Reads past the end return 0 and latch
+//! HasOverrun(), so decoders can validate once per section instead of per value.
+//------------------------------------------------------------------------------------------------
+class AG0_TDLByteReader
+{
+    protected array<int> m_aBytes;
+    protected int m_iPos;
+    protected int m_iLen;
+    protected bool m_bOverrun;
+
+    //------------------------------------------------------------------------------------------------
+    void AG0_TDLByteReader(array<int> bytes)
+    {
+        m_aBytes = bytes;
+        m_iLen = bytes.Count();
+    }
+
+    //------------------------------------------------------------------------------------------------
+    int ReadU8()
+    {
+        if (m_iPos >= m_iLen)
+        {
+            m_bOverrun = true;
+            return 0;
+        }
+        int value = m_aBytes[m_iPos];
+        m_iPos++;
+        return value;
+    }
+
+    //------------------------------------------------------------------------------------------------
+    int ReadU16()
+    {
+        int lo = ReadU8();
+        return lo | (ReadU8() << 8);
+    }
+
+    //------------------------------------------------------------------------------------------------
+    int ReadI16()
+    {
+        int value = ReadU16();
+        if (value >= 0x8000)
+            value -= 0x10000;
+        return value;
+    }
+
+    //------------------------------------------------------------------------------------------------
+    int ReadI32()
+    {
+        int b0 = ReadU8();
+        int b1 = ReadU8();
+        int b2 = ReadU8();
+        int b3 = ReadU8();
+        return b0 | (b1 << 8) | (b2 << 16) | (b3 << 24);
+    }
+
+    //------------------------------------------------------------------------------------------------
+    int ReadVarUInt()
+    {
+        int value = 0;
+        int shift = 0;
+        while (shift < 35)
+        {
+            int b = ReadU8();
+            value = value | ((b & 0x7F) << shift);
+            if ((b & 0x80) == 0)
+                return value;
+            shift += 7;
+        }
+
+        m_bOverrun = true;  // malformed: more than 5 continuation bytes
+        return 0;
+    }
+
+    //------------------------------------------------------------------------------------------------
+    int ReadVarInt()
+    {
+        int raw = ReadVarUInt();
+        return ((raw >> 1) & 0x7FFFFFFF) ^ -(raw & 1);
+    }
+
+    //------------------------------------------------------------------------------------------------
+    string ReadString()
+    {
+        int len = ReadVarUInt();
+        if (len < 0 || m_iPos + len > m_iLen)
+        {
+            m_bOverrun = true;
+            return string.Empty;
+        }
+
+        string value;
+        for (int i = 0; i < len; i++)
+        {
+            int charByte = m_aBytes[m_iPos + i];
+            value += charByte.AsciiToString();
+        }
+        m_iPos += len;
+        return value;
+    }
+
+    //------------------------------------------------------------------------------------------------
+    bool HasOverrun() { return m_bOverrun; }
+    int GetRemaining() { return m_iLen - m_iPos; }
+}
+
+//------------------------------------------------------------------------------------------------
+//! Format constants and envelope helpers shared by both terrain managers.
+//------------------------------------------------------------------------------------------------
+class AG0_TDLTerrainPacked
+{
+    static const int MAGIC_0 = 0x54;            // 'T'
+    static const int KIND_STRUCTURES = 0x53;    // 'S'
+    static const int KIND_ROADS = 0x52;         // 'R'
+    static const int VERSION = 2;
+
+    static const int TILE_SIZE = 1024;          // meters per structure tile
+    static const int POSITION_SCALE = 32;       // structure centers: 1/32 m within a tile
+    static const int ROAD_POINT_SCALE = 8;      // road vertices: 1/8 m
+    static const int SIZE_SCALE = 10;           // heights / widths / depths: decimeters
+    static const int ROTATION_STEPS = 256;
+
+    //------------------------------------------------------------------------------------------------
+    //! True for a base64 packed payload, false for v1 JSON (or empty)
+    static bool IsPacked(string payload)
+    {
+        if (payload.IsEmpty())
+            return false;
+        return payload.Get(0) != "{";
+    }
+
+    //------------------------------------------------------------------------------------------------
+    //! Pull the packed data out of a v2 API response.
+    //! @return base64(gzip(binary)), or empty if the body is not a v2 envelope (e.g. v1 JSON)
+    static string ReadEnvelope(string jsonBody)
+    {
+        // Cheap pre-check so v1 bodies aren't imported twice
+        if (!jsonBody.Contains("\"encoding\""))
+            return string.Empty;
+
+        SCR_JsonLoadContext json = new SCR_JsonLoadContext();
+        if (!json.ImportFromString(jsonBody))
+            return string.Empty;
+
+        int v = 0;
+        json.ReadValue("v", v);
+        string encoding;
+        json.ReadValue("encoding", encoding);
+        if (v != VERSION || encoding != "gzip+base64")
+            return string.Empty;
+
+        string data;
+        json.ReadValue("data", data);
+        return data;
+    }
+
+    //------------------------------------------------------------------------------------------------
+    //! Write the common header. kind = KIND_STRUCTURES or KIND_ROADS.
+    static void WriteHeader(AG0_TDLByteWriter writer, int kind, string hash)
+    {
+        writer.WriteU8(MAGIC_0);
+        writer.WriteU8(kind);
+        writer.WriteU8(VERSION);
+        writer.WriteString(hash);
+    }
+
+    //------------------------------------------------------------------------------------------------
+    //! Check the common header and read the hash.
+    //! @return false (and logs) if the bytes aren't a packed dataset of this kind
+    static bool ReadHeader(AG0_TDLByteReader reader, int kind, out string hash)
+    {
+        int m0 = reader.ReadU8();
+        int m1 = reader.ReadU8();
+        int version = reader.ReadU8();
+        if (m0 != MAGIC_0 || m1 != kind)
+        {
+            Print(string.Format("[TDL_TERRAIN] Packed payload has bad magic %1 %2", m0, m1), LogLevel.WARNING);
+            return false;
+        }
+        if (version != VERSION)
+        {
+            Print(string.Format("[TDL_TERRAIN] Unsupported packed version: %1 (expected %2)",
+                version, VERSION), LogLevel.WARNING);
+            return false;
+        }
+
+        hash = reader.ReadString();
+        return !reader.HasOverrun();
+    }
+
+    //------------------------------------------------------------------------------------------------
+    static int FloorToTile(float value)
+    {
+        int tile = Math.Floor(value / TILE_SIZE);
+        return tile * TILE_SIZE;
+    }
+
+    //------------------------------------------------------------------------------------------------
+    static int QuantizeSize(float meters)
+    {
+        return Math.ClampInt(Math.Round(meters * SIZE_SCALE), 0, 0xFFFF);
+    }
+}
+
+//------------------------------------------------------------------------------------------------
+//! One resumable pack or parse of a terrain dataset, run by AG0_TDLTerrainCodecJob before
+//! gzip (writers) or after gunzip (readers). Subclasses keep a stage and a cursor and call
+//! Tick() per item, so a slice ends within BUDGET_CHECK_INTERVAL items of its budget.
+//! The managers create them (CreatePackedReader / CreatePackedWriter).
+//------------------------------------------------------------------------------------------------
+class AG0_TDLTerrainPackedPass
+{
+    protected static const int BUDGET_CHECK_INTERVAL = 256;
+
+    protected int m_iStartTick;
+    protected int m_iBudgetMs;
+    protected int m_iWork;
+
+    //------------------------------------------------------------------------------------------------
+    //! @return true while work remains
+    bool Step(int timeBudgetMs)
+    {
+        m_iStartTick = System.GetTickCount();
+        m_iBudgetMs = timeBudgetMs;
+        m_iWork = 0;
+        return Run();
+    }
+
+    //------------------------------------------------------------------------------------------------
+    //! Readers: the decoded binary, set before the first Step
+    void SetInput(array<int> bytes) {}
+
+    //------------------------------------------------------------------------------------------------
+    //! Writers: the serialized binary once done, null if the dataset changed underneath
+    array<int> GetOutput() { return null; }
+
+    //------------------------------------------------------------------------------------------------
+    //! Readers: records committed to the manager (0 on a malformed payload)
+    int GetCount() { return 0; }
+
+    //------------------------------------------------------------------------------------------------
+    //! Readers: true if the committed dataset has a different hash than the one it replaced
+    bool HasNewHash() { return false; }
+
+    //------------------------------------------------------------------------------------------------
+    //! One slice of work. @return true while work remains
+    protected bool Run() { return false; }
+
+    //------------------------------------------------------------------------------------------------
+    //! Count finished work; every BUDGET_CHECK_INTERVAL units, true if the slice is spent
+    protected bool Tick(int units = 1)
+    {
+        m_iWork += units;
+        if (m_iWork < BUDGET_CHECK_INTERVAL)
+            return false;
+
+        m_iWork = 0;
+        return System.GetTickCount() - m_iStartTick >= m_iBudgetMs;
+    }
+}
+
+//------------------------------------------------------------------------------------------------
+//! Resumable packed-payload transcoder, stepped a slice per frame:
+//!   decode: base64 string → gzip bytes → binary bytes (GetBytes) → reader pass (GetPass)
+//!   encode: writer pass → binary bytes → gzip bytes → base64 string (GetPacked)
+//! Runs on AG0_TDLBase64Decoder / AG0_TDLGzip, their encoder counterparts and the
+//! dataset's AG0_TDLTerrainPackedPass.
+//------------------------------------------------------------------------------------------------
+class AG0_TDLTerrainCodecJob
+{
+    protected ref AG0_TDLBase64Decoder m_Base64Decoder;
+    protected ref AG0_TDLGzip m_Gunzip;
+    protected ref AG0_TDLGzipEncoder m_Gzip;
+    protected ref AG0_TDLBase64Encoder m_Base64Encoder;
+    protected ref AG0_TDLTerrainPackedPass m_Pass;
+    protected bool m_bPassDone;
+
+    protected ref array<int> m_aBytes;
+    protected string m_sPacked;
+    protected bool m_bEncode;
+
+    //------------------------------------------------------------------------------------------------
+    //! @param reader Parses the decoded binary into its manager; null stops at GetBytes
+    void InitDecode(string packed, AG0_TDLTerrainPackedPass reader)
+    {
+        m_bEncode = false;
+        m_sPacked = packed;
+        m_Pass = reader;
+        m_Base64Decoder = new AG0_TDLBase64Decoder();
+        m_Base64Decoder.Init(packed);
+    }
+
+    //------------------------------------------------------------------------------------------------
+    void InitEncode(AG0_TDLTerrainPackedPass writer)
+    {
+        m_bEncode = true;
+        m_Pass = writer;
+    }
+
+    //------------------------------------------------------------------------------------------------
+    //! @return true while work remains
+    bool Step(int timeBudgetMs)
+    {
+        int startTick = System.GetTickCount();
+
+        if (m_bEncode)
+        {
+            if (!m_bPassDone)
+            {
+                if (m_Pass.Step(timeBudgetMs))
+                    return true;
+
+                m_bPassDone = true;
+                m_aBytes = m_Pass.GetOutput();
+                if (!m_aBytes)
+                    return false;
+
+                m_Gzip = new AG0_TDLGzipEncoder();
+                m_Gzip.Init(m_aBytes);
+            }
+
+            if (m_Gzip)
+            {
+                int gzipLeft = timeBudgetMs - (System.GetTickCount() - startTick);
+                if (m_Gzip.Step(Math.Max(gzipLeft, 1)))
+                    return true;
+
+                m_Base64Encoder = new AG0_TDLBase64Encoder();
+                m_Base64Encoder.Init(m_Gzip.GetOutput());
+                m_Gzip = null;
+            }
+
+            if (!m_Base64Encoder)
+                return false;
+
+            int encodeLeft = timeBudgetMs - (System.GetTickCount() - startTick);
+            if (m_Base64Encoder.Step(Math.Max(encodeLeft, 1)))
+                return true;
+
+            m_sPacked = m_Base64Encoder.GetOutput();
+            m_Base64Encoder = null;
+            return false;
+        }
+
+        if (m_Base64Decoder)
+        {
+            if (m_Base64Decoder.Step(timeBudgetMs))
+                return true;
+
+            m_Gunzip = new AG0_TDLGzip();
+            m_Gunzip.InitGzip(m_Base64Decoder.GetOutput());
+            m_Base64Decoder = null;
+        }
+
+        if (m_Gunzip)
+        {
+            int decodeLeft = timeBudgetMs - (System.GetTickCount() - startTick);
+            if (m_Gunzip.Step(Math.Max(decodeLeft, 1)))
+                return true;
+
+            m_aBytes = m_Gunzip.GetOutput();
+            m_Gunzip = null;
+
+            // A failed decode never reaches the reader, which leaves its manager untouched
+            if (!m_Pass || !m_aBytes || m_aBytes.IsEmpty())
+            {
+                m_bPassDone = true;
+                return false;
+            }
+            m_Pass.SetInput(m_aBytes);
+        }
+
+        if (!m_Pass || m_bPassDone)
+            return false;
+
+        int parseLeft = timeBudgetMs - (System.GetTickCount() - startTick);
+        if (m_Pass.Step(Math.Max(parseLeft, 1)))
+            return true;
+
+        m_bPassDone = true;
+        return false;
+    }
+
+    //------------------------------------------------------------------------------------------------
+    //! Decoded binary (decode jobs) / serialized binary (encode jobs) — empty or null on failure
+    array<int> GetBytes() { return m_aBytes; }
+
+    //------------------------------------------------------------------------------------------------
+    //! Packed string: the encode result, or the decode input
+    string GetPacked() { return m_sPacked; }
+
+    //------------------------------------------------------------------------------------------------
+    //! The reader / writer the job was created with (null for a plain decode)
+    AG0_TDLTerrainPackedPass GetPass() { return m_Pass; }
+
+    bool IsEncode() { return m_bEncode; }
+}
@@ -25,6 +25,10 @@
 // array<float> parser stops at the first integer-shaped token. Encoder
 // (terrain-roads-mod.ts) is responsible for that — the mod just trusts it
 // and column-length-checks defensively.
+//
+// Packed (v2) datasets carry the same columns in binary with polylines as
+// zigzag-varint deltas — see AG0_TDLTerrainPacked.c. As with structures, only
+// the packed form is forwarded to clients.
 //------------------------------------------------------------------------------------------------
 
 //------------------------------------------------------------------------------------------------
@@ -34,11 +38,19 @@
 //------------------------------------------------------------------------------------------------
 class AG0_TDLTerrainRoadFeature
 {
+    // Zoom LOD bands: band 0 is m_aPoints, band k > 0 is simplified (Douglas–Peucker)
+    // to LOD_BASE_TOLERANCE * 4^(k-1) world meters — 2 / 8 / 32 m.
+    static const int LOD_COUNT = 4;
+    static const float LOD_BASE_TOLERANCE = 2.0;
+
     int   m_iTypeIndex;             // Index into manager's m_aTypes
     float m_fWidth;                  // Road width in meters
     int   m_iPriority;              // 1=trail, 2=paved/road, 3=highway
     ref array<float> m_aPoints;     // [x0, z0, x1, z1, ...] in world meters
 
+    // Simplified copies of m_aPoints per LOD band (index 0 unused), see BuildLods
+    protected ref array<ref array<float>> m_aLodPoints;
+
     // World-space AABB, precomputed at parse time and used by the map renderer
     // for cheap per-feature viewport rejection (no WorldToScreen needed).
     float m_fMinX;
@@ -75,14 +87,149 @@ class AG0_TDLTerrainRoadFeature
             if (pz < m_fMinZ) m_fMinZ = pz;
             if (pz > m_fMaxZ) m_fMaxZ = pz;
         }
+
+        // Geometry changed — any simplified bands are stale
+        m_aLodPoints = null;
+    }
+
+    //------------------------------------------------------------------------------------------------
+    //! Simplification tolerance (world meters) of a LOD band
+    static float GetLodTolerance(int lod)
+    {
+        if (lod <= 0)
+            return 0;
+        return LOD_BASE_TOLERANCE * Math.Pow(4, lod - 1);
+    }
+
+    //------------------------------------------------------------------------------------------------
+    //! Coarsest band whose error stays under maxErrorMeters (e.g. half a pixel in world units)
+    static int SelectLod(float maxErrorMeters)
+    {
+        int lod = 0;
+        while (lod + 1 < LOD_COUNT && GetLodTolerance(lod + 1) <= maxErrorMeters)
+            lod++;
+        return lod;
+    }
+
+    //------------------------------------------------------------------------------------------------
+    //! Simplify every LOD band now. The client's packed reader calls this per feature as
+    //! it decodes, so the first zoomed-out frame only looks the bands up.
+    //! @return Points simplified, for the caller's budget accounting
+    int BuildLods()
+    {
+        for (int lod = 1; lod < LOD_COUNT; lod++)
+            GetLodPoints(lod);
+        return (m_aPoints.Count() / 2) * (LOD_COUNT - 1);
+    }
+
+    //------------------------------------------------------------------------------------------------
+    //! Polyline for a LOD band, same flat [x, z, ...] layout as m_aPoints.
+    //! Bands not built by BuildLods (a v1 JSON dataset) are simplified on first use.
+    array<float> GetLodPoints(int lod)
+    {
+        if (lod <= 0 || m_aPoints.Count() <= 4)
+            return m_aPoints;
+
+        lod = Math.ClampInt(lod, 1, LOD_COUNT - 1);
+        if (!m_aLodPoints)
+        {
+            m_aLodPoints = {};
+            m_aLodPoints.Resize(LOD_COUNT);
+        }
+
+        array<float> points = m_aLodPoints[lod];
+        if (!points)
+        {
+            points = {};
+            SimplifyPolyline(m_aPoints, GetLodTolerance(lod), points);
+            m_aLodPoints[lod] = points;
+        }
+        return points;
+    }
+
+    //------------------------------------------------------------------------------------------------
+    //! Douglas–Peucker over a flat [x, z, ...] polyline (iterative — roads can have
+    //! thousands of points). Endpoints are always kept.
+    static void SimplifyPolyline(array<float> points, float tolerance, notnull array<float> outPoints)
+    {
+        outPoints.Clear();
+        int count = points.Count() / 2;
+        if (count < 3)
+        {
+            outPoints.Copy(points);
+            return;
+        }
+
+        array<bool> keep = {};
+        keep.Resize(count);
+        keep[0] = true;
+        keep[count - 1] = true;
+
+        float tolSq = tolerance * tolerance;
+        array<int> stack = {0, count - 1};
+        while (!stack.IsEmpty())
+        {
+            int last = stack.Count() - 1;
+            int hi = stack[last];
+            int lo = stack[last - 1];
+            stack.Remove(last);
+            stack.Remove(last - 1);
+
+            float ax = points[lo * 2];
+            float az = points[lo * 2 + 1];
+            float dx = points[hi * 2] - ax;
+            float dz = points[hi * 2 + 1] - az;
+            float lenSq = dx * dx + dz * dz;
+
+            float maxDistSq = 0;
+            int maxIndex = -1;
+            for (int i = lo + 1; i < hi; i++)
+            {
+                float px = points[i * 2] - ax;
+                float pz = points[i * 2 + 1] - az;
+                float distSq;
+                if (lenSq > 0)
+                {
+                    float cross = px * dz - pz * dx;
+                    distSq = cross * cross / lenSq;
+                }
+                else
+                {
+                    distSq = px * px + pz * pz;
+                }
+
+                if (distSq > maxDistSq)
+                {
+                    maxDistSq = distSq;
+                    maxIndex = i;
+                }
+            }
+
+            if (maxIndex < 0 || maxDistSq <= tolSq)
+                continue;
+
+            keep[maxIndex] = true;
+            stack.Insert(lo);
+            stack.Insert(maxIndex);
+            stack.Insert(maxIndex);
+            stack.Insert(hi);
+        }
+
+        for (int k = 0; k < count; k++)
+        {
+            if (!keep[k])
+                continue;
+            outPoints.Insert(points[k * 2]);
+            outPoints.Insert(points[k * 2 + 1]);
+        }
     }
 }
 
 //------------------------------------------------------------------------------------------------
 //! Stores a parsed road network for a world load.
 //! Single-instance on the server (owned by AG0_TDLApiManager) and per-client
-//! on the player controller. Raw JSON retained server-side for chunked RPC
-//! redistribution without re-encoding.
+//! on the player controller. The packed payload is retained server-side for
+//! chunked RPC redistribution without re-encoding.
 //------------------------------------------------------------------------------------------------
 class AG0_TDLTerrainRoadManager
 {
@@ -94,6 +241,8 @@ class AG0_TDLTerrainRoadManager
     protected int m_iVersion;
     protected string m_sLastSyncHash;
     protected string m_sLastRawJson;
+    protected string m_sLastPacked;    // base64(gzip(binary)), forwarded to clients
+    protected int m_iRevision;         // Bumped whenever m_aFeatures changes
 
     //------------------------------------------------------------------------------------------------
     void AG0_TDLTerrainRoadManager()
@@ -154,7 +303,9 @@ class AG0_TDLTerrainRoadManager
             m_iVersion = v;
             m_sLastSyncHash = hash;
             m_sLastRawJson = jsonBody;
+            m_sLastPacked = string.Empty;
             m_aFeatures.Clear();
+            m_iRevision++;
             m_aTypes.Clear();
             Print("[TDL_ROADS] Parsed empty dataset (n=0)", LogLevel.DEBUG);
             return 0;
@@ -218,6 +369,7 @@ class AG0_TDLTerrainRoadManager
 
         // --- Materialize features by walking len[] ---
         m_aFeatures.Clear();
+        m_iRevision++;
         m_aFeatures.Reserve(n);
 
         int offset = 0;
@@ -245,6 +397,7 @@ class AG0_TDLTerrainRoadManager
         m_iVersion = v;
         m_sLastSyncHash = hash;
         m_sLastRawJson = jsonBody;
+        m_sLastPacked = string.Empty;
 
         Print(string.Format(
             "[TDL_ROADS] Parsed %1 features, %2 points (hash=%3, types=%4)",
@@ -253,14 +406,44 @@ class AG0_TDLTerrainRoadManager
         return n;
     }
 
+    //------------------------------------------------------------------------------------------------
+    //! Resumable parse of a decoded packed (v2) road dataset, see AG0_TDLTerrainRoadPackedReader
+    //! @param buildLods Also simplify every feature's LOD bands (clients that draw the map)
+    AG0_TDLTerrainRoadPackedReader CreatePackedReader(bool buildLods = false)
+    {
+        return new AG0_TDLTerrainRoadPackedReader(this, buildLods);
+    }
+
+    //------------------------------------------------------------------------------------------------
+    //! Resumable serialization of the current dataset into the packed binary layout
+    //! (before gzip / base64), see AG0_TDLTerrainRoadPackedWriter
+    AG0_TDLTerrainRoadPackedWriter CreatePackedWriter()
+    {
+        return new AG0_TDLTerrainRoadPackedWriter(this, m_aFeatures, m_aTypes, m_sLastSyncHash, m_iRevision);
+    }
+
+    //------------------------------------------------------------------------------------------------
+    //! Swap in a dataset read by AG0_TDLTerrainRoadPackedReader
+    void CommitPackedDataset(array<ref AG0_TDLTerrainRoadFeature> features, array<string> types, string hash)
+    {
+        m_aFeatures = features;
+        m_iRevision++;
+        m_aTypes = types;
+        m_iVersion = AG0_TDLTerrainPacked.VERSION;
+        m_sLastSyncHash = hash;
+        m_sLastRawJson = string.Empty;
+    }
+
     //------------------------------------------------------------------------------------------------
     void Clear()
     {
         m_aFeatures.Clear();
+        m_iRevision++;
         m_aTypes.Clear();
         m_iVersion = 0;
         m_sLastSyncHash = string.Empty;
         m_sLastRawJson = string.Empty;
+        m_sLastPacked = string.Empty;
     }
 
     //------------------------------------------------------------------------------------------------
@@ -268,12 +451,25 @@ class AG0_TDLTerrainRoadManager
     int GetVersion()           { return m_iVersion; }
     string GetLastSyncHash()   { return m_sLastSyncHash; }
     string GetLastRawJson()    { return m_sLastRawJson; }
+    string GetPackedPayload()  { return m_sLastPacked; }
+
+    void SetPackedPayload(string packed)
+    {
+        m_sLastPacked = packed;
+    }
 
     array<ref AG0_TDLTerrainRoadFeature> GetFeatures()
     {
         return m_aFeatures;
     }
 
+    //------------------------------------------------------------------------------------------------
+    //! Changes whenever GetFeatures() content changes (parse or Clear)
+    int GetRevision()
+    {
+        return m_iRevision;
+    }
+
     string GetTypeName(int idx)
     {
         if (idx < 0 || idx >= m_aTypes.Count())
@@ -281,3 +477,374 @@ class AG0_TDLTerrainRoadManager
         return m_aTypes[idx];
     }
 }
+
+//------------------------------------------------------------------------------------------------
+//! Resumable parse of a packed (v2) road dataset — the binary inside base64(gzip(...)).
+//! Each per-feature column is its own stage, then the point stream is read a feature at
+//! a time, simplifying its LOD bands as it goes when asked to. The manager keeps its
+//! previous dataset until the last feature has been read.
+//------------------------------------------------------------------------------------------------
+class AG0_TDLTerrainRoadPackedReader : AG0_TDLTerrainPackedPass
+{
+    protected static const int STAGE_HEADER = 0;
+    protected static const int STAGE_TYPES = 1;
+    protected static const int STAGE_WIDTHS = 2;
+    protected static const int STAGE_PRIORITIES = 3;
+    protected static const int STAGE_LENGTHS = 4;
+    protected static const int STAGE_POINTS = 5;
+    protected static const int STAGE_DONE = 6;
+
+    protected AG0_TDLTerrainRoadManager m_Manager;
+    protected bool m_bBuildLods;
+    protected ref AG0_TDLByteReader m_Reader;
+    protected int m_iByteCount;
+    protected int m_iStage = STAGE_HEADER;
+    protected int m_iCursor;
+
+    protected string m_sHash;
+    protected ref array<string> m_aTypes = {};
+    protected ref array<ref AG0_TDLTerrainRoadFeature> m_aFeatures = {};
+    protected ref array<int> m_aLengths = {};
+    protected int m_iOriginX;
+    protected int m_iOriginZ;
+    protected int m_iFeatureCount;
+    protected int m_iPointCount;
+    protected int m_iLengthSum;
+    protected int m_iQX;    // running point position, quantized
+    protected int m_iQZ;
+
+    protected int m_iCount;
+    protected bool m_bNewHash;
+
+    //------------------------------------------------------------------------------------------------
+    void AG0_TDLTerrainRoadPackedReader(AG0_TDLTerrainRoadManager manager, bool buildLods)
+    {
+        m_Manager = manager;
+        m_bBuildLods = buildLods;
+    }
+
+    //------------------------------------------------------------------------------------------------
+    override void SetInput(array<int> bytes)
+    {
+        m_Reader = new AG0_TDLByteReader(bytes);
+        m_iByteCount = bytes.Count();
+    }
+
+    //------------------------------------------------------------------------------------------------
+    override int GetCount() { return m_iCount; }
+    override bool HasNewHash() { return m_bNewHash; }
+
+    //------------------------------------------------------------------------------------------------
+    override protected bool Run()
+    {
+        if (m_iStage == STAGE_DONE || !m_Reader)
+            return false;
+
+        if (m_iStage == STAGE_HEADER)
+        {
+            if (!ReadTables())
+                return false;
+            m_iStage = STAGE_TYPES;
+        }
+
+        // --- Per-feature columns ---
+        while (m_iStage < STAGE_POINTS)
+        {
+            while (m_iCursor < m_iFeatureCount)
+            {
+                ReadColumnValue(m_iCursor);
+                m_iCursor++;
+                if (Tick())
+                    return true;
+            }
+
+            if (m_Reader.HasOverrun())
+                return Reject("feature columns");
+            m_iStage++;
+            m_iCursor = 0;
+        }
+        if (m_iLengthSum != m_iPointCount)
+            return Reject("feature columns");
+
+        // --- Polylines: one delta stream across all features ---
+        float pointStep = 1.0 / AG0_TDLTerrainPacked.ROAD_POINT_SCALE;
+        while (m_iCursor < m_iFeatureCount)
+        {
+            AG0_TDLTerrainRoadFeature road = m_aFeatures[m_iCursor];
+            int pointCount = m_aLengths[m_iCursor];
+            road.m_aPoints.Reserve(pointCount * 2);
+            for (int p = 0; p < pointCount; p = p + 1)
+            {
+                m_iQX = m_iQX + m_Reader.ReadVarInt();
+                m_iQZ = m_iQZ + m_Reader.ReadVarInt();
+                road.m_aPoints.Insert(m_iOriginX + m_iQX * pointStep);
+                road.m_aPoints.Insert(m_iOriginZ + m_iQZ * pointStep);
+            }
+            road.UpdateAABB();
+
+            int work = pointCount + 1;
+            if (m_bBuildLods)
+                work += road.BuildLods();
+
+            m_iCursor++;
+            if (Tick(work))
+                return true;
+        }
+        if (m_Reader.HasOverrun())
+            return Reject("points");
+
+        // --- Commit ---
+        string previousHash = m_Manager.GetLastSyncHash();
+        m_Manager.CommitPackedDataset(m_aFeatures, m_aTypes, m_sHash);
+        m_iCount = m_iFeatureCount;
+        m_bNewHash = m_sHash != previousHash;
+        m_iStage = STAGE_DONE;
+
+        Print(string.Format(
+            "[TDL_ROADS] Parsed %1 packed features, %2 points (%3 bytes, hash=%4)",
+            m_iFeatureCount, m_iPointCount, m_iByteCount, m_sHash), LogLevel.DEBUG);
+        return false;
+    }
+
+    //------------------------------------------------------------------------------------------------
+    //! Header, type table, origin and feature / point counts
+    protected bool ReadTables()
+    {
+        if (!AG0_TDLTerrainPacked.ReadHeader(m_Reader, AG0_TDLTerrainPacked.KIND_ROADS, m_sHash))
+            return Reject(string.Empty);
+
+        int typeCount = m_Reader.ReadVarUInt();
+        if (typeCount > m_Reader.GetRemaining())
+            return Reject("type table");
+        for (int ti = 0; ti < typeCount; ti = ti + 1)
+            m_aTypes.Insert(m_Reader.ReadString());
+
+        m_iOriginX = m_Reader.ReadI32();
+        m_iOriginZ = m_Reader.ReadI32();
+        int n = m_Reader.ReadVarUInt();
+        int m = m_Reader.ReadVarUInt();
+
+        // Every feature needs >= 4 column bytes and every point >= 2 delta bytes
+        if (m_Reader.HasOverrun() || n < 0 || m < 0 || n > m_Reader.GetRemaining() || m > m_Reader.GetRemaining()
+            || n * 4 + m * 2 > m_Reader.GetRemaining())
+            return Reject("header");
+
+        m_iFeatureCount = n;
+        m_iPointCount = m;
+        m_aFeatures.Reserve(n);
+        m_aLengths.Reserve(n);
+        return true;
+    }
+
+    //------------------------------------------------------------------------------------------------
+    //! Value f of the column the current stage reads
+    protected void ReadColumnValue(int f)
+    {
+        switch (m_iStage)
+        {
+            case STAGE_TYPES:
+            {
+                AG0_TDLTerrainRoadFeature feat = new AG0_TDLTerrainRoadFeature();
+                feat.m_iTypeIndex = m_Reader.ReadVarUInt();
+                m_aFeatures.Insert(feat);
+                break;
+            }
+            case STAGE_WIDTHS:
+            {
+                m_aFeatures[f].m_fWidth = m_Reader.ReadU16() * (1.0 / AG0_TDLTerrainPacked.SIZE_SCALE);
+                break;
+            }
+            case STAGE_PRIORITIES:
+            {
+                m_aFeatures[f].m_iPriority = m_Reader.ReadU8();
+                break;
+            }
+            case STAGE_LENGTHS:
+            {
+                int count = m_Reader.ReadVarUInt();
+                m_aLengths.Insert(count);
+                m_iLengthSum = m_iLengthSum + count;
+                break;
+            }
+        }
+    }
+
+    //------------------------------------------------------------------------------------------------
+    //! Give up on the payload; the manager keeps its current dataset.
+    //! @param section Empty when ReadHeader already logged the reason
+    protected bool Reject(string section)
+    {
+        if (!section.IsEmpty())
+            Print(string.Format("[TDL_ROADS] Packed payload truncated or malformed: %1", section), LogLevel.WARNING);
+        m_iStage = STAGE_DONE;
+        return false;
+    }
+}
+
+//------------------------------------------------------------------------------------------------
+//! Resumable serialization of a road dataset into the packed binary layout.
+//! Stages: bounds and header → one stage per feature column → point deltas a feature
+//! at a time. Works on the arrays the manager held when it was created and gives up
+//! (null output) if the manager's revision moves on in the meantime.
+//------------------------------------------------------------------------------------------------
+class AG0_TDLTerrainRoadPackedWriter : AG0_TDLTerrainPackedPass
+{
+    protected static const int STAGE_BOUNDS = 0;
+    protected static const int STAGE_TYPES = 1;
+    protected static const int STAGE_WIDTHS = 2;
+    protected static const int STAGE_PRIORITIES = 3;
+    protected static const int STAGE_LENGTHS = 4;
+    protected static const int STAGE_POINTS = 5;
+    protected static const int STAGE_DONE = 6;
+
+    protected AG0_TDLTerrainRoadManager m_Manager;
+    protected int m_iRevision;
+    protected ref array<ref AG0_TDLTerrainRoadFeature> m_aFeatures;
+    protected ref array<string> m_aTypes;
+    protected string m_sHash;
+
+    protected ref AG0_TDLByteWriter m_Writer = new AG0_TDLByteWriter();
+    protected int m_iStage = STAGE_BOUNDS;
+    protected int m_iCursor;
+    protected bool m_bFailed;
+
+    protected int m_iPointCount;
+    protected float m_fMinX;
+    protected float m_fMinZ;
+    protected int m_iOriginX;
+    protected int m_iOriginZ;
+    protected int m_iPrevX;     // last quantized point written
+    protected int m_iPrevZ;
+
+    //------------------------------------------------------------------------------------------------
+    void AG0_TDLTerrainRoadPackedWriter(AG0_TDLTerrainRoadManager manager,
+        array<ref AG0_TDLTerrainRoadFeature> features, array<string> types, string hash, int revision)
+    {
+        m_Manager = manager;
+        m_aFeatures = features;
+        m_aTypes = types;
+        m_sHash = hash;
+        m_iRevision = revision;
+    }
+
+    //------------------------------------------------------------------------------------------------
+    override array<int> GetOutput()
+    {
+        if (m_bFailed || m_iStage != STAGE_DONE)
+            return null;
+        return m_Writer.GetBytes();
+    }
+
+    //------------------------------------------------------------------------------------------------
+    override protected bool Run()
+    {
+        if (m_iStage == STAGE_DONE)
+            return false;
+
+        if (m_Manager.GetRevision() != m_iRevision)
+        {
+            Print("[TDL_ROADS] Dataset changed while packing, packing abandoned", LogLevel.DEBUG);
+            m_bFailed = true;
+            m_iStage = STAGE_DONE;
+            return false;
+        }
+
+        int n = m_aFeatures.Count();
+
+        if (m_iStage == STAGE_BOUNDS)
+        {
+            while (m_iCursor < n)
+            {
+                AG0_TDLTerrainRoadFeature bounds = m_aFeatures[m_iCursor];
+                m_iCursor++;
+                if (bounds.m_aPoints.Count() >= 2)
+                {
+                    if (m_iPointCount == 0 || bounds.m_fMinX < m_fMinX) m_fMinX = bounds.m_fMinX;
+                    if (m_iPointCount == 0 || bounds.m_fMinZ < m_fMinZ) m_fMinZ = bounds.m_fMinZ;
+                    m_iPointCount = m_iPointCount + bounds.m_aPoints.Count() / 2;
+                }
+                if (Tick())
+                    return true;
+            }
+
+            m_iOriginX = AG0_TDLTerrainPacked.FloorToTile(m_fMinX);
+            m_iOriginZ = AG0_TDLTerrainPacked.FloorToTile(m_fMinZ);
+
+            AG0_TDLTerrainPacked.WriteHeader(m_Writer, AG0_TDLTerrainPacked.KIND_ROADS, m_sHash);
+            m_Writer.WriteVarUInt(m_aTypes.Count());
+            foreach (string typeName : m_aTypes)
+                m_Writer.WriteString(typeName);
+            m_Writer.WriteI32(m_iOriginX);
+            m_Writer.WriteI32(m_iOriginZ);
+            m_Writer.WriteVarUInt(n);
+            m_Writer.WriteVarUInt(m_iPointCount);
+
+            m_iStage = STAGE_TYPES;
+            m_iCursor = 0;
+        }
+
+        while (m_iStage < STAGE_POINTS)
+        {
+            while (m_iCursor < n)
+            {
+                WriteColumnValue(m_aFeatures[m_iCursor]);
+                m_iCursor++;
+                if (Tick())
+                    return true;
+            }
+            m_iStage++;
+            m_iCursor = 0;
+        }
+
+        // Deltas are taken between quantized absolutes, so rounding never accumulates
+        while (m_iCursor < n)
+        {
+            AG0_TDLTerrainRoadFeature feat = m_aFeatures[m_iCursor];
+            int count = feat.m_aPoints.Count() / 2;
+            for (int p = 0; p < count; p = p + 1)
+            {
+                int qx = Math.Round((feat.m_aPoints[p * 2] - m_iOriginX) * AG0_TDLTerrainPacked.ROAD_POINT_SCALE);
+                int qz = Math.Round((feat.m_aPoints[p * 2 + 1] - m_iOriginZ) * AG0_TDLTerrainPacked.ROAD_POINT_SCALE);
+                m_Writer.WriteVarInt(qx - m_iPrevX);
+                m_Writer.WriteVarInt(qz - m_iPrevZ);
+                m_iPrevX = qx;
+                m_iPrevZ = qz;
+            }
+            m_iCursor++;
+            if (Tick(count + 1))
+                return true;
+        }
+
+        m_iStage = STAGE_DONE;
+        return false;
+    }
+
+    //------------------------------------------------------------------------------------------------
+    //! The feature's value in the column the current stage writes
+    protected void WriteColumnValue(AG0_TDLTerrainRoadFeature feat)
+    {
+        switch (m_iStage)
+        {
+            case STAGE_TYPES:
+            {
+                m_Writer.WriteVarUInt(Math.Max(feat.m_iTypeIndex, 0));
+                break;
+            }
+            case STAGE_WIDTHS:
+            {
+                m_Writer.WriteU16(AG0_TDLTerrainPacked.QuantizeSize(feat.m_fWidth));
+                break;
+            }
+            case STAGE_PRIORITIES:
+            {
+                m_Writer.WriteU8(feat.m_iPriority);
+                break;
+            }
+            case STAGE_LENGTHS:
+            {
+                m_Writer.WriteVarUInt(feat.m_aPoints.Count() / 2);
+                break;
+            }
+        }
+    }
+}
@@ -3,14 +3,18 @@
 // Streamed terrain structure (building footprint) store for the TDL map.
 //
 // Server flow:
-//   AG0_TDLApiManager fetches /api/mod/terrain/structures, hands the JSON body to
-//   ParseColumnarPayload(). The raw JSON is also retained verbatim so it can be
-//   redistributed to clients via RPC without a second encode pass.
+//   AG0_TDLApiManager fetches /api/mod/terrain/structures?format=packed. A packed
+//   (v2) response is decoded through CreatePackedReader() and its base64 string
+//   kept verbatim; a v1 JSON response goes through ParseColumnarPayload() and is
+//   then packed once through CreatePackedWriter(). Both passes run a slice per
+//   frame inside an AG0_TDLTerrainCodecJob. Only the packed string is redistributed
+//   to clients via RPC (see AG0_TDLTerrainPacked.c for the binary layout).
 //
 // Client flow:
-//   AG0_PlayerController_TDL receives the raw JSON over RPC, calls
-//   ParseColumnarPayload() locally, and the map view reads the expanded records
-//   directly via GetStructures().
+//   AG0_PlayerController_TDL receives the packed payload over RPC and decodes and
+//   parses it a slice per frame the same way (ParseColumnarPayload() for a v1
+//   JSON payload from an older server), and the map view reads the expanded
+//   records directly via GetStructures().
 //
 // Wire format (from app/lib/terrain-structures-mod.ts, mode=rect):
 //   {
@@ -47,11 +51,239 @@ class AG0_TDLTerrainStructureRecord
     int   m_iPrefabIndex;   // Index into manager's m_aPrefabs
 }
 
+//------------------------------------------------------------------------------------------------
+//! Uniform grid over a structure dataset, so renderers can visit only the
+//! records near the viewport instead of the whole map.
+//! Records are bucketed by center point into CELL_SIZE cells, stored CSR-style:
+//! cell c owns m_aCellRecords[m_aCellStart[c] .. m_aCellStart[c + 1]). Cells are
+//! row-major (z rows, x columns), so a run of columns in one row is one contiguous
+//! index range. A footprint can overhang its cell by up to m_fMaxHalfBound, which
+//! queries add to their rectangle.
+//! Each cell is also split DENSITY_SUBDIVISIONS × DENSITY_SUBDIVISIONS ways into
+//! density cells (footprint coverage 0..1, non-empty ones only, same CSR layout)
+//! that the map view draws instead of individual buildings when zoomed out.
+//! Built lazily on the client by AG0_TDLTerrainStructureManager.GetGrid().
+//------------------------------------------------------------------------------------------------
+class AG0_TDLTerrainStructureGrid
+{
+    static const float CELL_SIZE = 256;
+    // Bigger maps get coarser cells rather than an unbounded cell table
+    static const int MAX_CELLS_PER_AXIS = 256;
+
+    protected float m_fOriginX;
+    protected float m_fOriginZ;
+    protected float m_fCellSize;
+    protected int m_iCols;
+    protected int m_iRows;
+    protected float m_fMaxHalfBound;
+
+    static const int DENSITY_SUBDIVISIONS = 4;
+
+    protected ref array<int> m_aCellStart = {};
+    protected ref array<int> m_aCellRecords = {};
+
+    // Density cells: min corner + coverage, cell c owns [m_aDensityStart[c] .. m_aDensityStart[c + 1])
+    protected ref array<int> m_aDensityStart = {};
+    protected ref array<float> m_aDensityX = {};
+    protected ref array<float> m_aDensityZ = {};
+    protected ref array<float> m_aDensityCoverage = {};
+
+    //------------------------------------------------------------------------------------------------
+    void AG0_TDLTerrainStructureGrid(array<ref AG0_TDLTerrainStructureRecord> structures)
+    {
+        int n = structures.Count();
+        if (n == 0)
+            return;
+
+        // --- Bounds ---
+        float minX = structures[0].m_fCenterX;
+        float maxX = minX;
+        float minZ = structures[0].m_fCenterZ;
+        float maxZ = minZ;
+        for (int i = 1; i < n; i = i + 1)
+        {
+            AG0_TDLTerrainStructureRecord rec = structures[i];
+            minX = Math.Min(minX, rec.m_fCenterX);
+            maxX = Math.Max(maxX, rec.m_fCenterX);
+            minZ = Math.Min(minZ, rec.m_fCenterZ);
+            maxZ = Math.Max(maxZ, rec.m_fCenterZ);
+        }
+
+        m_fOriginX = minX;
+        m_fOriginZ = minZ;
+        m_fCellSize = Math.Max(CELL_SIZE, Math.Max(maxX - minX, maxZ - minZ) / MAX_CELLS_PER_AXIS);
+        m_iCols = Math.Floor((maxX - minX) / m_fCellSize) + 1;
+        m_iRows = Math.Floor((maxZ - minZ) / m_fCellSize) + 1;
+        int cellCount = m_iCols * m_iRows;
+
+        // --- Counting sort into cells ---
+        array<int> recordCell = {};
+        recordCell.Resize(n);
+        m_aCellStart.Resize(cellCount + 1);
+        for (int c = 0; c <= cellCount; c = c + 1)
+            m_aCellStart[c] = 0;
+
+        for (int j = 0; j < n; j = j + 1)
+        {
+            AG0_TDLTerrainStructureRecord cellRec = structures[j];
+            int cell = CellIndex(cellRec.m_fCenterX, cellRec.m_fCenterZ);
+            recordCell[j] = cell;
+            m_aCellStart[cell + 1] = m_aCellStart[cell + 1] + 1;
+            m_fMaxHalfBound = Math.Max(m_fMaxHalfBound, (cellRec.m_fWidth + cellRec.m_fDepth) * 0.5);
+        }
+
+        for (int k = 0; k < cellCount; k = k + 1)
+            m_aCellStart[k + 1] = m_aCellStart[k + 1] + m_aCellStart[k];
+
+        array<int> fill = {};
+        fill.Copy(m_aCellStart);
+        m_aCellRecords.Resize(n);
+        for (int m = 0; m < n; m = m + 1)
+        {
+            int slot = fill[recordCell[m]];
+            m_aCellRecords[slot] = m;
+            fill[recordCell[m]] = slot + 1;
+        }
+
+        BuildDensity(structures);
+    }
+
+    //------------------------------------------------------------------------------------------------
+    //! Footprint area per density cell, normalized by the density cell's area
+    protected void BuildDensity(array<ref AG0_TDLTerrainStructureRecord> structures)
+    {
+        int cellCount = m_iCols * m_iRows;
+        int subCount = DENSITY_SUBDIVISIONS * DENSITY_SUBDIVISIONS;
+        float subSize = GetDensityCellSize();
+        float subArea = subSize * subSize;
+
+        array<float> area = {};
+        area.Resize(subCount);
+
+        m_aDensityStart.Resize(cellCount + 1);
+        for (int c = 0; c < cellCount; c = c + 1)
+        {
+            m_aDensityStart[c] = m_aDensityX.Count();
+            int slotStart = m_aCellStart[c];
+            int slotEnd = m_aCellStart[c + 1];
+            if (slotStart == slotEnd)
+                continue;
+
+            float cellMinX = m_fOriginX + (c % m_iCols) * m_fCellSize;
+            float cellMinZ = m_fOriginZ + (c / m_iCols) * m_fCellSize;
+            for (int a = 0; a < subCount; a = a + 1)
+                area[a] = 0;
+
+            for (int slot = slotStart; slot < slotEnd; slot = slot + 1)
+            {
+                AG0_TDLTerrainStructureRecord rec = structures[m_aCellRecords[slot]];
+                int subX = Math.ClampInt(Math.Floor((rec.m_fCenterX - cellMinX) / subSize), 0, DENSITY_SUBDIVISIONS - 1);
+                int subZ = Math.ClampInt(Math.Floor((rec.m_fCenterZ - cellMinZ) / subSize), 0, DENSITY_SUBDIVISIONS - 1);
+                int sub = subZ * DENSITY_SUBDIVISIONS + subX;
+                area[sub] = area[sub] + rec.m_fWidth * rec.m_fDepth;
+            }
+
+            for (int s = 0; s < subCount; s = s + 1)
+            {
+                if (area[s] <= 0)
+                    continue;
+                m_aDensityX.Insert(cellMinX + (s % DENSITY_SUBDIVISIONS) * subSize);
+                m_aDensityZ.Insert(cellMinZ + (s / DENSITY_SUBDIVISIONS) * subSize);
+                m_aDensityCoverage.Insert(Math.Min(area[s] / subArea, 1));
+            }
+        }
+        m_aDensityStart[cellCount] = m_aDensityX.Count();
+    }
+
+    //------------------------------------------------------------------------------------------------
+    protected int CellIndex(float x, float z)
+    {
+        int col = Math.ClampInt(Math.Floor((x - m_fOriginX) / m_fCellSize), 0, m_iCols - 1);
+        int row = Math.ClampInt(Math.Floor((z - m_fOriginZ) / m_fCellSize), 0, m_iRows - 1);
+        return row * m_iCols + col;
+    }
+
+    //------------------------------------------------------------------------------------------------
+    //! Cell rectangle whose records may overlap the world rectangle (footprint overhang included).
+    //! @return false if the rectangle misses the dataset entirely
+    bool GetCellRange(float minX, float minZ, float maxX, float maxZ, out int col0, out int row0, out int col1, out int row1)
+    {
+        if (m_iCols == 0)
+            return false;
+
+        minX = minX - m_fMaxHalfBound - m_fOriginX;
+        minZ = minZ - m_fMaxHalfBound - m_fOriginZ;
+        maxX = maxX + m_fMaxHalfBound - m_fOriginX;
+        maxZ = maxZ + m_fMaxHalfBound - m_fOriginZ;
+
+        float extentX = m_iCols * m_fCellSize;
+        float extentZ = m_iRows * m_fCellSize;
+        if (maxX < 0 || maxZ < 0 || minX >= extentX || minZ >= extentZ)
+            return false;
+
+        col0 = Math.ClampInt(Math.Floor(minX / m_fCellSize), 0, m_iCols - 1);
+        row0 = Math.ClampInt(Math.Floor(minZ / m_fCellSize), 0, m_iRows - 1);
+        col1 = Math.ClampInt(Math.Floor(maxX / m_fCellSize), 0, m_iCols - 1);
+        row1 = Math.ClampInt(Math.Floor(maxZ / m_fCellSize), 0, m_iRows - 1);
+        return true;
+    }
+
+    //------------------------------------------------------------------------------------------------
+    //! First slot in GetCellRecord order for cell (col, row). Slots of cells
+    //! (col0..col1, row) are the contiguous range [GetCellStart(col0, row), GetCellStart(col1 + 1, row)).
+    int GetCellStart(int col, int row)
+    {
+        return m_aCellStart[row * m_iCols + col];
+    }
+
+    //------------------------------------------------------------------------------------------------
+    //! Index into the structure array for a slot
+    int GetCellRecord(int slot)
+    {
+        return m_aCellRecords[slot];
+    }
+
+    //------------------------------------------------------------------------------------------------
+    int GetCellCount()
+    {
+        return m_iCols * m_iRows;
+    }
+
+    //------------------------------------------------------------------------------------------------
+    //! Density cell range of grid cells (col0..col1, row), same contract as GetCellStart
+    int GetDensityStart(int col, int row)
+    {
+        return m_aDensityStart[row * m_iCols + col];
+    }
+
+    //------------------------------------------------------------------------------------------------
+    float GetDensityCellSize()
+    {
+        return m_fCellSize / DENSITY_SUBDIVISIONS;
+    }
+
+    //------------------------------------------------------------------------------------------------
+    //! Number of occupied density cells over the whole grid
+    int GetDensityCount()
+    {
+        return m_aDensityCoverage.Count();
+    }
+
+    //------------------------------------------------------------------------------------------------
+    //! Min corner (world XZ) and footprint coverage (0..1) of a density cell
+    void GetDensityCell(int index, out float minX, out float minZ, out float coverage)
+    {
+        minX = m_aDensityX[index];
+        minZ = m_aDensityZ[index];
+        coverage = m_aDensityCoverage[index];
+    }
+}
+
 //------------------------------------------------------------------------------------------------
 //! Stores a parsed structures dataset for a world load.
 //! Single-instance on the server (owned by AG0_TDLApiManager) and per-client on
-//! the player controller. The raw JSON received from /terrain/structures is
-//! retained on the server so it can be forwarded to clients without re-encoding.
+//! the player controller. The packed payload is retained on the server so it can
+//! be forwarded to clients without re-encoding.
 //------------------------------------------------------------------------------------------------
 class AG0_TDLTerrainStructureManager
 {
@@ -66,13 +298,22 @@ class AG0_TDLTerrainStructureManager
     protected ref array<string> m_aTypes = {};
 
     // Wire format echoes
-    protected int m_iVersion;          // Always 1 currently
+    protected int m_iVersion;          // 1 = JSON columnar, 2 = packed binary
     protected string m_sMode;          // "rect" — only mode requested by mod today
     protected string m_sLastSyncHash;  // Opaque token, send back as ?since=
 
     // Server-side: keep the raw JSON so we can forward to clients verbatim
     protected string m_sLastRawJson;
 
+    // Server-side: base64(gzip(binary)) of the current dataset, forwarded to clients
+    protected string m_sLastPacked;
+
+    // Client-side: spatial index over m_aStructures, built on first GetGrid() after a parse
+    protected ref AG0_TDLTerrainStructureGrid m_Grid;
+
+    // Bumped whenever m_aStructures changes, so renderers can keep derived data until then
+    protected int m_iRevision;
+
     //------------------------------------------------------------------------------------------------
     void AG0_TDLTerrainStructureManager()
     {
@@ -144,7 +385,10 @@ class AG0_TDLTerrainStructureManager
             m_sMode = mode;
             m_sLastSyncHash = hash;
             m_sLastRawJson = jsonBody;
+            m_sLastPacked = string.Empty;
             m_aStructures.Clear();
+            m_Grid = null;
+            m_iRevision++;
             m_aPrefabs.Clear();
             m_aTypes.Clear();
             Print("[TDL_STRUCTURES] Parsed empty dataset (n=0)", LogLevel.DEBUG);
@@ -200,6 +444,8 @@ class AG0_TDLTerrainStructureManager
 
         // --- Materialize records ---
         m_aStructures.Clear();
+        m_Grid = null;
+        m_iRevision++;
         m_aStructures.Reserve(n);
         for (int j = 0; j < n; j = j + 1)
         {
@@ -222,6 +468,7 @@ class AG0_TDLTerrainStructureManager
         m_sMode = mode;
         m_sLastSyncHash = hash;
         m_sLastRawJson = jsonBody;
+        m_sLastPacked = string.Empty;
 
         Print(string.Format("[TDL_STRUCTURES] Parsed %1 structures (mode=%2, hash=%3, prefabs=%4, types=%5)",
             n, mode, hash, prefabs.Count(), types.Count()), LogLevel.DEBUG);
@@ -229,18 +476,51 @@ class AG0_TDLTerrainStructureManager
         return n;
     }
 
+    //------------------------------------------------------------------------------------------------
+    //! Resumable parse of a decoded packed (v2) dataset, see AG0_TDLTerrainStructurePackedReader
+    AG0_TDLTerrainStructurePackedReader CreatePackedReader()
+    {
+        return new AG0_TDLTerrainStructurePackedReader(this);
+    }
+
+    //------------------------------------------------------------------------------------------------
+    //! Resumable serialization of the current dataset into the packed binary layout
+    //! (before gzip / base64), see AG0_TDLTerrainStructurePackedWriter
+    AG0_TDLTerrainStructurePackedWriter CreatePackedWriter()
+    {
+        return new AG0_TDLTerrainStructurePackedWriter(this, m_aStructures, m_aPrefabs, m_aTypes, m_sLastSyncHash, m_iRevision);
+    }
+
+    //------------------------------------------------------------------------------------------------
+    //! Swap in a dataset read by AG0_TDLTerrainStructurePackedReader
+    void CommitPackedDataset(array<ref AG0_TDLTerrainStructureRecord> structures, array<string> prefabs, array<string> types, string hash)
+    {
+        m_aStructures = structures;
+        m_Grid = null;
+        m_iRevision++;
+        m_aPrefabs = prefabs;
+        m_aTypes = types;
+        m_iVersion = AG0_TDLTerrainPacked.VERSION;
+        m_sMode = "rect";
+        m_sLastSyncHash = hash;
+        m_sLastRawJson = string.Empty;
+    }
+
     //------------------------------------------------------------------------------------------------
     //! Drop all stored structures and clear the sync hash.
     //! Use when the world changes or the operator disables the feature.
     void Clear()
     {
         m_aStructures.Clear();
+        m_Grid = null;
+        m_iRevision++;
         m_aPrefabs.Clear();
         m_aTypes.Clear();
         m_iVersion = 0;
         m_sMode = string.Empty;
         m_sLastSyncHash = string.Empty;
         m_sLastRawJson = string.Empty;
+        m_sLastPacked = string.Empty;
     }
 
     //------------------------------------------------------------------------------------------------
@@ -269,6 +549,18 @@ class AG0_TDLTerrainStructureManager
         return m_sLastRawJson;
     }
 
+    //------------------------------------------------------------------------------------------------
+    //! base64(gzip(binary)) for client redistribution; empty until the dataset has been packed
+    string GetPackedPayload()
+    {
+        return m_sLastPacked;
+    }
+
+    void SetPackedPayload(string packed)
+    {
+        m_sLastPacked = packed;
+    }
+
     //------------------------------------------------------------------------------------------------
     //! Direct access for renderers. Returned array is owned by the manager —
     //! treat as read-only. Stable across calls until the next ParseColumnarPayload.
@@ -277,6 +569,27 @@ class AG0_TDLTerrainStructureManager
         return m_aStructures;
     }
 
+    //------------------------------------------------------------------------------------------------
+    //! Changes whenever GetStructures() content changes (parse or Clear)
+    int GetRevision()
+    {
+        return m_iRevision;
+    }
+
+    //------------------------------------------------------------------------------------------------
+    //! Spatial index over GetStructures(), indices refer into that array.
+    //! Built on first use after each parse so the server, which never draws, doesn't pay for it.
+    AG0_TDLTerrainStructureGrid GetGrid()
+    {
+        if (!m_Grid && !m_aStructures.IsEmpty())
+        {
+            m_Grid = new AG0_TDLTerrainStructureGrid(m_aStructures);
+            Print(string.Format("[TDL_STRUCTURES] Built grid: %1 structures in %2 cells",
+                m_aStructures.Count(), m_Grid.GetCellCount()), LogLevel.DEBUG);
+        }
+        return m_Grid;
+    }
+
     //------------------------------------------------------------------------------------------------
     //! Resolve a prefab table index to the prefab path (with leading {GUID} stripped per spec).
     //! Returns empty if the index is out of range.
@@ -297,3 +610,348 @@ class AG0_TDLTerrainStructureManager
         return m_aTypes[idx];
     }
 }
+
+//------------------------------------------------------------------------------------------------
+//! Resumable parse of a packed (v2) structures dataset — the binary inside base64(gzip(...)).
+//! The string tables are read in the first slice, then whole tiles until the slice is
+//! spent. The manager keeps its previous dataset until the last tile has been read.
+//------------------------------------------------------------------------------------------------
+class AG0_TDLTerrainStructurePackedReader : AG0_TDLTerrainPackedPass
+{
+    protected AG0_TDLTerrainStructureManager m_Manager;
+    protected ref AG0_TDLByteReader m_Reader;
+    protected int m_iByteCount;
+
+    protected string m_sHash;
+    protected ref array<string> m_aPrefabs = {};
+    protected ref array<string> m_aTypes = {};
+    protected ref array<ref AG0_TDLTerrainStructureRecord> m_aStructures = {};
+    protected int m_iOriginX;
+    protected int m_iOriginZ;
+    protected int m_iTileCount = -1;    // -1 until the tables are read
+    protected int m_iNextTile;
+
+    protected bool m_bDone;
+    protected int m_iCount;
+    protected bool m_bNewHash;
+
+    //------------------------------------------------------------------------------------------------
+    void AG0_TDLTerrainStructurePackedReader(AG0_TDLTerrainStructureManager manager)
+    {
+        m_Manager = manager;
+    }
+
+    //------------------------------------------------------------------------------------------------
+    override void SetInput(array<int> bytes)
+    {
+        m_Reader = new AG0_TDLByteReader(bytes);
+        m_iByteCount = bytes.Count();
+    }
+
+    //------------------------------------------------------------------------------------------------
+    override int GetCount() { return m_iCount; }
+    override bool HasNewHash() { return m_bNewHash; }
+
+    //------------------------------------------------------------------------------------------------
+    override protected bool Run()
+    {
+        if (m_bDone || !m_Reader)
+            return false;
+
+        if (m_iTileCount < 0 && !ReadTables())
+            return false;
+
+        while (m_iNextTile < m_iTileCount)
+        {
+            int count = ReadTile();
+            if (count < 0)
+                return false;
+
+            m_iNextTile++;
+            if (Tick(count + 1))
+                return true;
+        }
+
+        string previousHash = m_Manager.GetLastSyncHash();
+        m_Manager.CommitPackedDataset(m_aStructures, m_aPrefabs, m_aTypes, m_sHash);
+        m_iCount = m_aStructures.Count();
+        m_bNewHash = m_sHash != previousHash;
+        m_bDone = true;
+
+        Print(string.Format("[TDL_STRUCTURES] Parsed %1 packed structures (%2 bytes, %3 tiles, hash=%4)",
+            m_iCount, m_iByteCount, m_iTileCount, m_sHash), LogLevel.DEBUG);
+        return false;
+    }
+
+    //------------------------------------------------------------------------------------------------
+    //! Header, string tables, origin and tile count
+    protected bool ReadTables()
+    {
+        if (!AG0_TDLTerrainPacked.ReadHeader(m_Reader, AG0_TDLTerrainPacked.KIND_STRUCTURES, m_sHash))
+            return Reject(string.Empty);
+
+        int prefabCount = m_Reader.ReadVarUInt();
+        if (prefabCount > m_Reader.GetRemaining())
+            return Reject("prefab table");
+        for (int pi = 0; pi < prefabCount; pi = pi + 1)
+            m_aPrefabs.Insert(m_Reader.ReadString());
+
+        int typeCount = m_Reader.ReadVarUInt();
+        if (typeCount > m_Reader.GetRemaining())
+            return Reject("type table");
+        for (int ti = 0; ti < typeCount; ti = ti + 1)
+            m_aTypes.Insert(m_Reader.ReadString());
+
+        m_iOriginX = m_Reader.ReadI32();
+        m_iOriginZ = m_Reader.ReadI32();
+
+        // Every tile needs >= 3 header bytes
+        int tileCount = m_Reader.ReadVarUInt();
+        if (m_Reader.HasOverrun() || tileCount < 0 || tileCount > m_Reader.GetRemaining())
+            return Reject("tile table");
+
+        m_iTileCount = tileCount;
+        return true;
+    }
+
+    //------------------------------------------------------------------------------------------------
+    //! One tile's column block. @return records read, -1 on a malformed tile
+    protected int ReadTile()
+    {
+        float posStep = 1.0 / AG0_TDLTerrainPacked.POSITION_SCALE;
+        float sizeStep = 1.0 / AG0_TDLTerrainPacked.SIZE_SCALE;
+        float rotStep = Math.PI2 / AG0_TDLTerrainPacked.ROTATION_STEPS;
+
+        int tileX = m_iOriginX + m_Reader.ReadVarUInt() * AG0_TDLTerrainPacked.TILE_SIZE;
+        int tileZ = m_iOriginZ + m_Reader.ReadVarUInt() * AG0_TDLTerrainPacked.TILE_SIZE;
+        int count = m_Reader.ReadVarUInt();
+        if (m_Reader.HasOverrun() || count < 0 || count > m_Reader.GetRemaining())
+        {
+            Reject("tile header");
+            return -1;
+        }
+
+        int first = m_aStructures.Count();
+        for (int k = 0; k < count; k = k + 1)
+        {
+            AG0_TDLTerrainStructureRecord rec = new AG0_TDLTerrainStructureRecord();
+            rec.m_fCenterX = tileX + m_Reader.ReadI16() * posStep;
+            m_aStructures.Insert(rec);
+        }
+
+        int end = first + count;
+        for (int iz = first; iz < end; iz = iz + 1)
+            m_aStructures[iz].m_fCenterZ = tileZ + m_Reader.ReadI16() * posStep;
+        for (int ir = first; ir < end; ir = ir + 1)
+            m_aStructures[ir].m_fRotation = m_Reader.ReadU8() * rotStep;
+        for (int ih = first; ih < end; ih = ih + 1)
+            m_aStructures[ih].m_fHeight = m_Reader.ReadU16() * sizeStep;
+        for (int iw = first; iw < end; iw = iw + 1)
+            m_aStructures[iw].m_fWidth = m_Reader.ReadU16() * sizeStep;
+        for (int id = first; id < end; id = id + 1)
+            m_aStructures[id].m_fDepth = m_Reader.ReadU16() * sizeStep;
+        for (int it = first; it < end; it = it + 1)
+            m_aStructures[it].m_iTypeIndex = m_Reader.ReadVarUInt();
+        for (int ip = first; ip < end; ip = ip + 1)
+            m_aStructures[ip].m_iPrefabIndex = m_Reader.ReadVarUInt();
+
+        if (m_Reader.HasOverrun())
+        {
+            Reject("tile columns");
+            return -1;
+        }
+        return count;
+    }
+
+    //------------------------------------------------------------------------------------------------
+    //! Give up on the payload; the manager keeps its current dataset.
+    //! @param section Empty when ReadHeader already logged the reason
+    protected bool Reject(string section)
+    {
+        if (!section.IsEmpty())
+            Print(string.Format("[TDL_STRUCTURES] Packed payload truncated or malformed: %1", section), LogLevel.WARNING);
+        m_bDone = true;
+        return false;
+    }
+}
+
+//------------------------------------------------------------------------------------------------
+//! Resumable serialization of a structures dataset into the packed binary layout.
+//! Stages: bounds → header and tables → tile bucketing → one tile block per step.
+//! Structures are regrouped by TILE_SIZE tile, so record order is not preserved.
+//! Works on the arrays the manager held when it was created and gives up (null output)
+//! if the manager's revision moves on in the meantime.
+//------------------------------------------------------------------------------------------------
+class AG0_TDLTerrainStructurePackedWriter : AG0_TDLTerrainPackedPass
+{
+    // Tile key = tileZ * stride + tileX while packing
+    protected static const int TILE_KEY_STRIDE = 65536;
+
+    protected static const int STAGE_BOUNDS = 0;
+    protected static const int STAGE_BUCKETS = 1;
+    protected static const int STAGE_TILES = 2;
+    protected static const int STAGE_DONE = 3;
+
+    protected AG0_TDLTerrainStructureManager m_Manager;
+    protected int m_iRevision;
+    protected ref array<ref AG0_TDLTerrainStructureRecord> m_aStructures;
+    protected ref array<string> m_aPrefabs;
+    protected ref array<string> m_aTypes;
+    protected string m_sHash;
+
+    protected ref AG0_TDLByteWriter m_Writer = new AG0_TDLByteWriter();
+    protected int m_iStage = STAGE_BOUNDS;
+    protected int m_iCursor;
+    protected bool m_bFailed;
+
+    protected float m_fMinX;
+    protected float m_fMinZ;
+    protected int m_iOriginX;
+    protected int m_iOriginZ;
+    protected ref map<int, ref array<int>> m_mTiles = new map<int, ref array<int>>();
+    protected ref array<int> m_aTileKeys = {};
+
+    //------------------------------------------------------------------------------------------------
+    void AG0_TDLTerrainStructurePackedWriter(AG0_TDLTerrainStructureManager manager,
+        array<ref AG0_TDLTerrainStructureRecord> structures, array<string> prefabs, array<string> types,
+        string hash, int revision)
+    {
+        m_Manager = manager;
+        m_aStructures = structures;
+        m_aPrefabs = prefabs;
+        m_aTypes = types;
+        m_sHash = hash;
+        m_iRevision = revision;
+    }
+
+    //------------------------------------------------------------------------------------------------
+    override array<int> GetOutput()
+    {
+        if (m_bFailed || m_iStage != STAGE_DONE)
+            return null;
+        return m_Writer.GetBytes();
+    }
+
+    //------------------------------------------------------------------------------------------------
+    override protected bool Run()
+    {
+        if (m_iStage == STAGE_DONE)
+            return false;
+
+        if (m_Manager.GetRevision() != m_iRevision)
+        {
+            Print("[TDL_STRUCTURES] Dataset changed while packing, packing abandoned", LogLevel.DEBUG);
+            m_bFailed = true;
+            m_iStage = STAGE_DONE;
+            return false;
+        }
+
+        int n = m_aStructures.Count();
+
+        // Tile-aligned origin at the dataset's minimum corner keeps every tile index >= 0
+        if (m_iStage == STAGE_BOUNDS)
+        {
+            while (m_iCursor < n)
+            {
+                AG0_TDLTerrainStructureRecord rec = m_aStructures[m_iCursor];
+                if (m_iCursor == 0 || rec.m_fCenterX < m_fMinX) m_fMinX = rec.m_fCenterX;
+                if (m_iCursor == 0 || rec.m_fCenterZ < m_fMinZ) m_fMinZ = rec.m_fCenterZ;
+                m_iCursor++;
+                if (Tick())
+                    return true;
+            }
+
+            m_iOriginX = AG0_TDLTerrainPacked.FloorToTile(m_fMinX);
+            m_iOriginZ = AG0_TDLTerrainPacked.FloorToTile(m_fMinZ);
+
+            AG0_TDLTerrainPacked.WriteHeader(m_Writer, AG0_TDLTerrainPacked.KIND_STRUCTURES, m_sHash);
+            m_Writer.WriteVarUInt(m_aPrefabs.Count());
+            foreach (string prefab : m_aPrefabs)
+                m_Writer.WriteString(prefab);
+            m_Writer.WriteVarUInt(m_aTypes.Count());
+            foreach (string typeName : m_aTypes)
+                m_Writer.WriteString(typeName);
+            m_Writer.WriteI32(m_iOriginX);
+            m_Writer.WriteI32(m_iOriginZ);
+
+            m_iStage = STAGE_BUCKETS;
+            m_iCursor = 0;
+        }
+
+        // Bucket record indices by tile; keys sort row-major (z, then x)
+        if (m_iStage == STAGE_BUCKETS)
+        {
+            while (m_iCursor < n)
+            {
+                AG0_TDLTerrainStructureRecord bucketRec = m_aStructures[m_iCursor];
+                int tx = Math.Floor((bucketRec.m_fCenterX - m_iOriginX) / AG0_TDLTerrainPacked.TILE_SIZE);
+                int tz = Math.Floor((bucketRec.m_fCenterZ - m_iOriginZ) / AG0_TDLTerrainPacked.TILE_SIZE);
+                int key = tz * TILE_KEY_STRIDE + tx;
+
+                array<int> members = m_mTiles.Get(key);
+                if (!members)
+                {
+                    members = {};
+                    m_mTiles.Insert(key, members);
+                    m_aTileKeys.Insert(key);
+                }
+                members.Insert(m_iCursor);
+                m_iCursor++;
+                if (Tick())
+                    return true;
+            }
+
+            m_aTileKeys.Sort();
+            m_Writer.WriteVarUInt(m_aTileKeys.Count());
+            m_iStage = STAGE_TILES;
+            m_iCursor = 0;
+        }
+
+        while (m_iCursor < m_aTileKeys.Count())
+        {
+            int written = WriteTile(m_aTileKeys[m_iCursor]);
+            m_iCursor++;
+            if (Tick(written + 1))
+                return true;
+        }
+
+        m_iStage = STAGE_DONE;
+        m_mTiles = null;
+        return false;
+    }
+
+    //------------------------------------------------------------------------------------------------
+    //! One tile's column block. @return records written
+    protected int WriteTile(int tileKey)
+    {
+        array<int> tileMembers = m_mTiles.Get(tileKey);
+        int tileIndexX = tileKey % TILE_KEY_STRIDE;
+        int tileIndexZ = tileKey / TILE_KEY_STRIDE;
+        float tileX = m_iOriginX + tileIndexX * AG0_TDLTerrainPacked.TILE_SIZE;
+        float tileZ = m_iOriginZ + tileIndexZ * AG0_TDLTerrainPacked.TILE_SIZE;
+        int maxOffset = AG0_TDLTerrainPacked.TILE_SIZE * AG0_TDLTerrainPacked.POSITION_SCALE - 1;
+
+        m_Writer.WriteVarUInt(tileIndexX);
+        m_Writer.WriteVarUInt(tileIndexZ);
+        m_Writer.WriteVarUInt(tileMembers.Count());
+
+        foreach (int mx : tileMembers)
+            m_Writer.WriteU16(Math.ClampInt(Math.Round((m_aStructures[mx].m_fCenterX - tileX) * AG0_TDLTerrainPacked.POSITION_SCALE), 0, maxOffset));
+        foreach (int mz : tileMembers)
+            m_Writer.WriteU16(Math.ClampInt(Math.Round((m_aStructures[mz].m_fCenterZ - tileZ) * AG0_TDLTerrainPacked.POSITION_SCALE), 0, maxOffset));
+        foreach (int mr : tileMembers)
+            m_Writer.WriteU8(Math.Round(m_aStructures[mr].m_fRotation * AG0_TDLTerrainPacked.ROTATION_STEPS / Math.PI2));
+        foreach (int mh : tileMembers)
+            m_Writer.WriteU16(AG0_TDLTerrainPacked.QuantizeSize(m_aStructures[mh].m_fHeight));
+        foreach (int mw : tileMembers)
+            m_Writer.WriteU16(AG0_TDLTerrainPacked.QuantizeSize(m_aStructures[mw].m_fWidth));
+        foreach (int md : tileMembers)
+            m_Writer.WriteU16(AG0_TDLTerrainPacked.QuantizeSize(m_aStructures[md].m_fDepth));
+        foreach (int mt : tileMembers)
+            m_Writer.WriteVarUInt(Math.Max(m_aStructures[mt].m_iTypeIndex, 0));
+        foreach (int mp : tileMembers)
+            m_Writer.WriteVarUInt(Math.Max(m_aStructures[mp].m_iPrefabIndex, 0));
+
+        return tileMembers.Count();
+    }
+}
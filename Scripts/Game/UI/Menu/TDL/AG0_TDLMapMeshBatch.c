@@ -0,0 +1,182 @@
+//------------------------------------------------------------------------------------------------
+// AG0_TDLMapMeshBatch.c
+// Colour-bucketed TriMeshDrawCommand builder for the TDL map view.
+//
+// Same approach as the photo renderer's EmitQuadToBucket: geometry is appended to
+// one vertex/index bucket per colour and each bucket becomes a single
+// TriMeshDrawCommand, split at 399 quads' worth of indices (2394) to stay under
+// the 2400-index limit. Lines are expanded to quads and round joins to triangle
+// fans, so a whole road network or building layer costs a handful of commands
+// instead of one (with its own vertex array) per segment.
+//
+// Usage: Begin(commands) → Add*() → End(). Nothing reaches the output before End(),
+// which emits every bucket's meshes (including ones split off when the bucket filled)
+// in first-use order; DeclareColor() fixes that order up front when layering between
+// colours matters.
+//------------------------------------------------------------------------------------------------
+class AG0_TDLMapMeshBatch
+{
+    // 399 quads × 6 indices — TriMeshDrawCommand rejects more than 2400
+    static const int MAX_INDICES = 2394;
+
+    protected ref array<ref CanvasWidgetCommand> m_aOutput;
+
+    protected ref map<int, int> m_mBucketByColor = new map<int, int>();
+    protected ref array<int> m_aColors = {};
+    protected ref array<ref array<float>> m_aVerts = {};
+    protected ref array<ref array<int>> m_aIndices = {};
+    // Meshes split off a bucket when it filled, held back so End() keeps the bucket order
+    protected ref array<ref array<ref CanvasWidgetCommand>> m_aFinished = {};
+
+    protected int m_iCommandCount;
+
+    //------------------------------------------------------------------------------------------------
+    //! Start a batch; finished commands are appended to output
+    void Begin(array<ref CanvasWidgetCommand> output)
+    {
+        m_aOutput = output;
+        m_mBucketByColor.Clear();
+        m_aColors.Clear();
+        m_aVerts.Clear();
+        m_aIndices.Clear();
+        m_aFinished.Clear();
+        m_iCommandCount = 0;
+    }
+
+    //------------------------------------------------------------------------------------------------
+    //! Flush every bucket and emit all meshes bucket by bucket (first-use order),
+    //! then release the output array.
+    //! @return Number of TriMeshDrawCommands emitted by this batch
+    int End()
+    {
+        int count = m_aColors.Count();
+        for (int i = 0; i < count; i++)
+        {
+            FlushBucket(i);
+            foreach (CanvasWidgetCommand cmd : m_aFinished[i])
+                m_aOutput.Insert(cmd);
+        }
+
+        m_aOutput = null;
+        m_aVerts.Clear();
+        m_aIndices.Clear();
+        m_aFinished.Clear();
+        return m_iCommandCount;
+    }
+
+    //------------------------------------------------------------------------------------------------
+    //! Create the bucket for a colour now, so it flushes (draws) before colours first used later
+    void DeclareColor(int color)
+    {
+        GetBucket(color);
+    }
+
+    //------------------------------------------------------------------------------------------------
+    //! Quad from four screen-space corners in winding order
+    void AddQuad(int color, float x0, float y0, float x1, float y1, float x2, float y2, float x3, float y3)
+    {
+        int bucket = Reserve(color, 6);
+        array<float> verts = m_aVerts[bucket];
+        array<int> idxs = m_aIndices[bucket];
+        int baseVert = verts.Count() / 2;
+
+        verts.Insert(x0); verts.Insert(y0);
+        verts.Insert(x1); verts.Insert(y1);
+        verts.Insert(x2); verts.Insert(y2);
+        verts.Insert(x3); verts.Insert(y3);
+
+        idxs.Insert(baseVert + 0); idxs.Insert(baseVert + 1); idxs.Insert(baseVert + 2);
+        idxs.Insert(baseVert + 0); idxs.Insert(baseVert + 2); idxs.Insert(baseVert + 3);
+    }
+
+    //------------------------------------------------------------------------------------------------
+    //! Line segment of the given pixel width, expanded to a quad (butt ends)
+    void AddLine(int color, float ax, float ay, float bx, float by, float width)
+    {
+        float dx = bx - ax;
+        float dy = by - ay;
+        float len = Math.Sqrt(dx * dx + dy * dy);
+        if (len <= 0)
+            return;
+
+        float scale = width * 0.5 / len;
+        float nx = -dy * scale;
+        float ny = dx * scale;
+        AddQuad(color, ax + nx, ay + ny, bx + nx, by + ny, bx - nx, by - ny, ax - nx, ay - ny);
+    }
+
+    //------------------------------------------------------------------------------------------------
+    //! Filled circle as a triangle fan (round line joins, dots)
+    void AddDisc(int color, float cx, float cy, float radius, int segments)
+    {
+        if (segments < 3 || radius <= 0)
+            return;
+
+        int bucket = Reserve(color, segments * 3);
+        array<float> verts = m_aVerts[bucket];
+        array<int> idxs = m_aIndices[bucket];
+        int center = verts.Count() / 2;
+
+        verts.Insert(cx);
+        verts.Insert(cy);
+        float step = Math.PI2 / segments;
+        for (int i = 0; i < segments; i++)
+        {
+            float angle = i * step;
+            verts.Insert(cx + Math.Cos(angle) * radius);
+            verts.Insert(cy + Math.Sin(angle) * radius);
+        }
+
+        for (int j = 0; j < segments; j++)
+        {
+            idxs.Insert(center);
+            idxs.Insert(center + 1 + j);
+            idxs.Insert(center + 1 + (j + 1) % segments);
+        }
+    }
+
+    //------------------------------------------------------------------------------------------------
+    protected int GetBucket(int color)
+    {
+        int bucket;
+        if (m_mBucketByColor.Find(color, bucket))
+            return bucket;
+
+        bucket = m_aColors.Count();
+        m_aColors.Insert(color);
+        m_aVerts.Insert(new array<float>());
+        m_aIndices.Insert(new array<int>());
+        m_aFinished.Insert(new array<ref CanvasWidgetCommand>());
+        m_mBucketByColor.Insert(color, bucket);
+        return bucket;
+    }
+
+    //------------------------------------------------------------------------------------------------
+    //! Bucket for color with room for indexCount more indices (flushing it first if full)
+    protected int Reserve(int color, int indexCount)
+    {
+        int bucket = GetBucket(color);
+        if (m_aIndices[bucket].Count() + indexCount > MAX_INDICES)
+            FlushBucket(bucket);
+        return bucket;
+    }
+
+    //------------------------------------------------------------------------------------------------
+    protected void FlushBucket(int bucket)
+    {
+        array<int> idxs = m_aIndices[bucket];
+        if (idxs.IsEmpty())
+            return;
+
+        TriMeshDrawCommand cmd = new TriMeshDrawCommand();
+        cmd.m_iColor = m_aColors[bucket];
+        cmd.m_Vertices = m_aVerts[bucket];
+        cmd.m_Indices = idxs;
+        m_aFinished[bucket].Insert(cmd);
+        m_iCommandCount++;
+
+        // The command owns the old arrays now
+        m_aVerts[bucket] = new array<float>();
+        m_aIndices[bucket] = new array<int>();
+    }
+}
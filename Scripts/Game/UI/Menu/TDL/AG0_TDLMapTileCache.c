@@ -0,0 +1,305 @@
+//------------------------------------------------------------------------------------------------
+// AG0_TDLMapTileCache.c
+// Pre-tessellated terrain tiles for the TDL map view.
+//
+// Roads and building footprints are binned once per zoom band into square tiles
+// (sliced across frames under a time budget; the map draws directly until binning is
+// done) and each tile is tessellated into world-space TriMesh templates the first time
+// it is in view (AG0_TDLMapMeshBatch output with world X/Z in place of screen X/Y).
+// Drawing a view is then a re-projection of the visible tiles' vertices through the
+// view transform — no culling, LOD, styling or trig per feature — so pans and rotations
+// re-composite cached tiles the same way DrawMapTexture re-samples the satellite image.
+//
+// Road segments are listed in every tile they cross and clipped to the tile when
+// tessellated, so only strokes, joins and buildings (all small) overhang a tile.
+//
+// Zoom bands are octaves of pixels-per-metre: band n covers
+// [BAND_BASE_PPU × 2^n, BAND_BASE_PPU × 2^(n+1)) and is styled for the geometric
+// middle, so pixel-sized strokes are off by at most √2 within a band. Tiles only
+// depend on the terrain data; AG0_TDLMapView clears the cache when a revision changes.
+//
+// Why geometry rather than raster tiles: the only widget-to-texture path is RTTextureWidget
+// (used by TDL_WorldSpaceDisplayComponent and AG0_ControlDisplayUnitComponent), which
+// re-renders its child widgets every frame into a texture bound to an entity's mesh
+// material via SetRenderTarget. The result can't be sampled back by a CanvasWidget image
+// command, so a raster tile would be a live widget tree costing a redraw per frame
+// anyway, and its fixed resolution would blur across a band. Tessellated world-space
+// meshes re-project exactly at any scale within a band and cost one vertex transform.
+//------------------------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------------------------
+// One tile of a band. The ref lists only live until the tile is tessellated.
+//------------------------------------------------------------------------------------------------
+class AG0_TDLMapTerrainTile
+{
+    // Build input: [roadIndex, firstFloatOfSegment] pairs, structure / density cell indices
+    ref array<int> m_aRoadRefs;
+    ref array<int> m_aStructureRefs;
+    ref array<int> m_aDensityRefs;
+    bool m_bTessellated;
+
+    // World-space TriMesh templates; roads of every tile draw before any buildings
+    ref array<ref CanvasWidgetCommand> m_aRoadMeshes = {};
+    ref array<ref CanvasWidgetCommand> m_aBuildingMeshes = {};
+
+    //------------------------------------------------------------------------------------------------
+    void ReleaseRefs()
+    {
+        m_aRoadRefs = null;
+        m_aStructureRefs = null;
+        m_aDensityRefs = null;
+    }
+}
+
+//------------------------------------------------------------------------------------------------
+// All tiles of one zoom band over the map extent
+//------------------------------------------------------------------------------------------------
+class AG0_TDLMapTerrainBand
+{
+    protected static const int MAX_TILES_PER_AXIS = 1024;
+    // Outer edge of the edge tiles (metres)
+    protected static const float UNBOUNDED = 1000000;
+
+    int m_iBand;
+
+    // Styling inputs, fixed per band (see AG0_TDLMapView.DrawTerrainTiles)
+    float m_fPixelsPerMeter;
+    int m_iRoadLod;
+    bool m_bDensity;
+
+    // Binning progress (AG0_TDLMapView.StepBinTerrainBand)
+    int m_iNextRoad;
+    int m_iNextStructure;
+    bool m_bBinned;
+
+    protected float m_fOriginX;
+    protected float m_fOriginZ;
+    protected float m_fTileSize;
+    protected int m_iCols;
+    protected int m_iRows;
+    // Furthest any tile's geometry reaches past the tile edge (metres): half the widest
+    // road stroke, or the largest building / density cell overhang
+    protected float m_fReach;
+    // cols × rows, row-major; null where the tile is empty
+    protected ref array<ref AG0_TDLMapTerrainTile> m_aTiles = {};
+
+    //------------------------------------------------------------------------------------------------
+    void AG0_TDLMapTerrainBand(int band, float originX, float originZ, float sizeX, float sizeZ, float tileSize)
+    {
+        m_iBand = band;
+        m_fOriginX = originX;
+        m_fOriginZ = originZ;
+        m_fTileSize = tileSize;
+        m_iCols = Math.ClampInt(Math.Ceil(sizeX / tileSize), 1, MAX_TILES_PER_AXIS);
+        m_iRows = Math.ClampInt(Math.Ceil(sizeZ / tileSize), 1, MAX_TILES_PER_AXIS);
+        m_aTiles.Resize(m_iCols * m_iRows);
+    }
+
+    //------------------------------------------------------------------------------------------------
+    //! Tile index for a world point; points off the map fold into the edge tiles
+    int GetTileIndex(float x, float z)
+    {
+        return GetRow(z) * m_iCols + GetCol(x);
+    }
+
+    //------------------------------------------------------------------------------------------------
+    //! World rectangle of a tile. Edge tiles extend without limit past the map edge,
+    //! matching the points GetTileIndex folds into them.
+    void GetTileBounds(int col, int row, out float minX, out float minZ, out float maxX, out float maxZ)
+    {
+        minX = m_fOriginX + col * m_fTileSize;
+        minZ = m_fOriginZ + row * m_fTileSize;
+        maxX = minX + m_fTileSize;
+        maxZ = minZ + m_fTileSize;
+        if (col == 0)
+            minX = -UNBOUNDED;
+        if (row == 0)
+            minZ = -UNBOUNDED;
+        if (col == m_iCols - 1)
+            maxX = UNBOUNDED;
+        if (row == m_iRows - 1)
+            maxZ = UNBOUNDED;
+    }
+
+    //------------------------------------------------------------------------------------------------
+    //! List segment [pointIndex, pointIndex + 3] of a road in every tile it crosses:
+    //! per tile row, the segment is clipped to the row's Z strip and the columns under
+    //! the clipped X span get the ref.
+    void AddSegmentRefs(int roadIndex, int pointIndex, float ax, float az, float bx, float bz)
+    {
+        float dx = bx - ax;
+        float dz = bz - az;
+        int row0 = GetRow(Math.Min(az, bz));
+        int row1 = GetRow(Math.Max(az, bz));
+        for (int row = row0; row <= row1; row++)
+        {
+            float stripMinX, stripMinZ, stripMaxX, stripMaxZ;
+            GetTileBounds(0, row, stripMinX, stripMinZ, stripMaxX, stripMaxZ);
+
+            float t0 = 0;
+            float t1 = 1;
+            if (dz != 0)
+            {
+                float ta = (stripMinZ - az) / dz;
+                float tb = (stripMaxZ - az) / dz;
+                t0 = Math.Max(t0, Math.Min(ta, tb));
+                t1 = Math.Min(t1, Math.Max(ta, tb));
+                if (t0 > t1)
+                    continue;
+            }
+
+            float x0 = ax + dx * t0;
+            float x1 = ax + dx * t1;
+            int col1 = GetCol(Math.Max(x0, x1));
+            for (int col = GetCol(Math.Min(x0, x1)); col <= col1; col++)
+            {
+                AG0_TDLMapTerrainTile tile = GetOrCreateTile(row * m_iCols + col);
+                if (!tile.m_aRoadRefs)
+                    tile.m_aRoadRefs = {};
+                tile.m_aRoadRefs.Insert(roadIndex);
+                tile.m_aRoadRefs.Insert(pointIndex);
+            }
+        }
+    }
+
+    //------------------------------------------------------------------------------------------------
+    protected int GetCol(float x)
+    {
+        return Math.ClampInt(Math.Floor((x - m_fOriginX) / m_fTileSize), 0, m_iCols - 1);
+    }
+
+    //------------------------------------------------------------------------------------------------
+    protected int GetRow(float z)
+    {
+        return Math.ClampInt(Math.Floor((z - m_fOriginZ) / m_fTileSize), 0, m_iRows - 1);
+    }
+
+    //------------------------------------------------------------------------------------------------
+    AG0_TDLMapTerrainTile GetOrCreateTile(int index)
+    {
+        AG0_TDLMapTerrainTile tile = m_aTiles[index];
+        if (!tile)
+        {
+            tile = new AG0_TDLMapTerrainTile();
+            m_aTiles[index] = tile;
+        }
+        return tile;
+    }
+
+    //------------------------------------------------------------------------------------------------
+    AG0_TDLMapTerrainTile GetTile(int col, int row)
+    {
+        return m_aTiles[row * m_iCols + col];
+    }
+
+    //------------------------------------------------------------------------------------------------
+    int GetTileCount()
+    {
+        return m_aTiles.Count();
+    }
+
+    //------------------------------------------------------------------------------------------------
+    int GetColumnCount()
+    {
+        return m_iCols;
+    }
+
+    //------------------------------------------------------------------------------------------------
+    //! Geometry listed in a tile extends this far past the tile edge
+    void ExtendReach(float reach)
+    {
+        if (reach > m_fReach)
+            m_fReach = reach;
+    }
+
+    //------------------------------------------------------------------------------------------------
+    //! Tiles whose geometry may intersect a world rectangle (inclusive range, clamped).
+    //! Edge tiles always qualify for rectangles past the map edge, since they hold the folded-in points.
+    void GetTileRange(float minX, float minZ, float maxX, float maxZ, out int col0, out int row0, out int col1, out int row1)
+    {
+        col0 = Math.ClampInt(Math.Floor((minX - m_fReach - m_fOriginX) / m_fTileSize), 0, m_iCols - 1);
+        row0 = Math.ClampInt(Math.Floor((minZ - m_fReach - m_fOriginZ) / m_fTileSize), 0, m_iRows - 1);
+        col1 = Math.ClampInt(Math.Floor((maxX + m_fReach - m_fOriginX) / m_fTileSize), 0, m_iCols - 1);
+        row1 = Math.ClampInt(Math.Floor((maxZ + m_fReach - m_fOriginZ) / m_fTileSize), 0, m_iRows - 1);
+    }
+}
+
+//------------------------------------------------------------------------------------------------
+// Most-recently-used bands, owned by AG0_TDLMapView
+//------------------------------------------------------------------------------------------------
+class AG0_TDLMapTerrainTileCache
+{
+    static const int BAND_COUNT = 8;
+    // Band edges; AG0_TDLMapView.BUILDING_AGGREGATE_PPU (0.15) is the edge of band 3,
+    // so no band straddles the buildings → density cells switch
+    static const float BAND_BASE_PPU = 0.01875;
+    // Tile edge length in screen pixels at the band's lowest scale
+    static const float TILE_PIXELS = 512;
+    // Bands kept at once (zooming back and forth between neighbouring bands stays cached)
+    static const int MAX_CACHED_BANDS = 3;
+
+    // Least recently used first
+    protected ref array<ref AG0_TDLMapTerrainBand> m_aBands = {};
+
+    //------------------------------------------------------------------------------------------------
+    //! @return band for a scale, or -1 outside the banded range
+    static int SelectBand(float pixelsPerWorldUnit)
+    {
+        float bandMin = BAND_BASE_PPU;
+        for (int band = 0; band < BAND_COUNT; band++)
+        {
+            if (pixelsPerWorldUnit >= bandMin && pixelsPerWorldUnit < bandMin * 2)
+                return band;
+            bandMin *= 2;
+        }
+        return -1;
+    }
+
+    //------------------------------------------------------------------------------------------------
+    static float GetBandMinPixelsPerMeter(int band)
+    {
+        return BAND_BASE_PPU * Math.Pow(2, band);
+    }
+
+    //------------------------------------------------------------------------------------------------
+    //! Scale a band is styled for (geometric middle of its range)
+    static float GetBandPixelsPerMeter(int band)
+    {
+        return GetBandMinPixelsPerMeter(band) * 1.41421356; // √2
+    }
+
+    //------------------------------------------------------------------------------------------------
+    AG0_TDLMapTerrainBand Find(int band)
+    {
+        int count = m_aBands.Count();
+        for (int i = 0; i < count; i++)
+        {
+            AG0_TDLMapTerrainBand cached = m_aBands[i];
+            if (cached.m_iBand != band)
+                continue;
+
+            // Move to the most-recent end
+            if (i != count - 1)
+            {
+                m_aBands.RemoveOrdered(i);
+                m_aBands.Insert(cached);
+            }
+            return cached;
+        }
+        return null;
+    }
+
+    //------------------------------------------------------------------------------------------------
+    void Store(AG0_TDLMapTerrainBand band)
+    {
+        while (m_aBands.Count() >= MAX_CACHED_BANDS)
+            m_aBands.RemoveOrdered(0);
+        m_aBands.Insert(band);
+    }
+
+    //------------------------------------------------------------------------------------------------
+    void Clear()
+    {
+        m_aBands.Clear();
+    }
+}
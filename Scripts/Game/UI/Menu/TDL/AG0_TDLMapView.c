@@ -36,17 +36,61 @@ class AG0_TDLMapView
     // Canvas dimensions (cached)
     protected float m_fCanvasWidth;
     protected float m_fCanvasHeight;
+
+    // Cached world → screen affine transform (see UpdateViewTransform):
+    //   screenX = m_fViewXX * worldX + m_fViewXZ * worldZ + m_fViewX0
+    //   screenY = m_fViewYX * worldX + m_fViewYZ * worldZ + m_fViewY0
+    protected float m_fViewXX;
+    protected float m_fViewXZ;
+    protected float m_fViewX0;
+    protected float m_fViewYX;
+    protected float m_fViewYZ;
+    protected float m_fViewY0;
+    // View inputs the transform was built from
+    protected vector m_vViewKeyCenter;
+    protected float m_fViewKeyZoom = -1;
+    protected float m_fViewKeyRotation;
+    protected float m_fViewKeyWidth;
+    protected float m_fViewKeyHeight;
+    // Reused screen-space output of TransformPoints for polylines
+    protected ref array<float> m_aScreenScratch = {};
+
+    // Retained-mode layers (see Draw). Markers are rebuilt every frame and are not a layer.
+    protected static const int LAYER_BACKGROUND = 0;     // Satellite, overlays, edge mask
+    protected static const int LAYER_TERRAIN = 1;        // API roads + structures
+    protected static const int LAYER_GRID = 2;
+    protected static const int LAYER_SHAPES = 3;
+    protected static const int LAYER_COUNT = 4;
+    protected ref array<ref AG0_TDLMapLayer> m_aLayers = {};
+    // Extra off-canvas margin (px) culled-in while building a layer, so it can be panned that far
+    protected float m_fCullMarginPx;
+    protected int m_iShapesRevision = -1;
+    protected int m_iStructuresRevision = -1;
+    protected int m_iRoadsRevision = -1;
+
+    // Colour-bucketed TriMesh builder shared by the roads, buildings and grid passes
+    protected ref AG0_TDLMapMeshBatch m_MeshBatch = new AG0_TDLMapMeshBatch();
+    // Roads and buildings pre-tessellated per zoom band (see DrawTerrainTiles)
+    protected ref AG0_TDLMapTerrainTileCache m_TerrainTiles = new AG0_TDLMapTerrainTileCache();
+    // Set by DrawTerrainTiles while the band in view isn't ready; keeps the terrain layer rebuilding
+    protected bool m_bTerrainTilesPending;
     
     // Member markers
     protected ref array<ref AG0_TDLMapMarker> m_aMarkers = {};
 	// Shape overlay (populated externally via SetShapes)
     protected ref array<ref AG0_TDLMapShape> m_aShapes;
+	// Spatial index over m_aShapes; null → full scan
+	protected ref AG0_TDLMapShapeIndex m_ShapeIndex;
+	// Reused candidate list for m_ShapeIndex queries
+	protected ref array<int> m_aShapeQuery = {};
 	// Streamed terrain structures (populated externally via SetTerrainStructures).
 	// Authoritative source for building footprints on the map view; API data is
 	// broader and more accurate than the legacy runtime MapDescriptorComponent
 	// query that previously sat here. Mirrors the m_aShapes pattern: ref to keep
 	// the manager-owned array alive while we hold it.
 	protected ref array<ref AG0_TDLTerrainStructureRecord> m_aTerrainStructures;
+	// Spatial index over m_aTerrainStructures; null → full scan
+	protected ref AG0_TDLTerrainStructureGrid m_TerrainStructureGrid;
 
 	// Streamed terrain roads (populated externally via SetTerrainRoads).
 	// Drawn before structures so buildings render on top of road overlays.
@@ -65,10 +109,35 @@ class AG0_TDLMapView
     protected static const float SHAPE_LABEL_PAD = 3;            // Background padding
     protected static const int SHAPE_LABEL_BG_COLOR = 0xCC000000; // Semi-transparent black background
     protected static const int SHAPE_LABEL_TEXT_COLOR = 0xFFFFFFFF; // White text
+
+    // Road colours (also the TriMesh bucket keys)
+    protected static const int ROAD_HIGHWAY_COLOR = 0xFFE8C57A;    // Warm tan — highways
+    protected static const int ROAD_PAVED_COLOR = 0xFFC9B98A;      // Muted sand — paved/road
+    protected static const int ROAD_TRAIL_COLOR = 0xFF9C8964;      // Dim olive — trails
+    protected static const int BUILDING_OUTLINE_COLOR = 0xFF000000;
+    protected static const float BUILDING_OUTLINE_PX = 1.5;        // Outline expansion around each footprint
+
+    // Terrain level of detail
+    protected static const float ROAD_LOD_PIXEL_ERROR = 0.75;      // Max on-screen deviation of a simplified road (px)
+    protected static const float ROAD_MIN_EXTENT_PX = 2.0;         // Roads smaller than this on both axes are skipped
+    protected static const float TRAIL_MIN_WIDTH_PX = 0.3;         // Trails hidden below this real width on screen
+    protected static const float PAVED_MIN_WIDTH_PX = 0.12;        // Paved roads hidden below this real width on screen
+    protected static const float BUILDING_AGGREGATE_PPU = 0.15;    // Below this px/m, buildings draw as density cells
+    protected static const int BUILDING_DENSITY_MIN_ALPHA = 0x50;  // Alpha of the sparsest density cell
+    protected static const int TERRAIN_TILE_BUDGET_MS = 4;         // Terrain band binning / tessellation per frame
+    protected static const int TERRAIN_BIN_CHECK_INTERVAL = 64;    // Structures binned between budget checks
+
+    // Layer reuse tolerances
+    protected static const float LAYER_PAN_MARGIN_PX = 160;        // Pannable layers are built this far past the canvas
+    protected static const float LAYER_PAN_TOLERANCE_PX = 0.25;    // Smaller pans don't touch the cached commands
+    protected static const float LAYER_ROTATION_TOLERANCE = 0.05;  // Degrees
+    protected static const float LAYER_ZOOM_TOLERANCE = 0.0001;    // Relative
     
     //------------------------------------------------------------------------------------------------
     void AG0_TDLMapView()
     {
+        for (int i = 0; i < LAYER_COUNT; i++)
+            m_aLayers.Insert(new AG0_TDLMapLayer());
     }
     
     //------------------------------------------------------------------------------------------------
@@ -77,6 +146,7 @@ class AG0_TDLMapView
         m_pMapTexture = null;
         m_aDrawCommands = null;
         m_aMarkers = null;
+        m_aLayers = null;
 		// Add to destructor alongside existing cleanup:
     	m_aOverlayTextures = null;
     	m_aOverlayOpacities = null;
@@ -397,31 +467,108 @@ class AG0_TDLMapView
     }
     
     //------------------------------------------------------------------------------------------------
-	// World position to screen position (SCREEN PIXELS for canvas drawing)
-	void WorldToScreen(vector worldPos, out float screenX, out float screenY)
+	//! Rebuild the cached world → screen transform if the view changed since it was built.
+	//! Folds the center offset, rotation (negated to match texture rotation direction),
+	//! zoom scale and Y flip into one 2×3 affine matrix, so projecting a point is
+	//! four multiplies and no trig.
+	protected void UpdateViewTransform()
 	{
-	    // Offset from view center
-	    float offsetX = worldPos[0] - m_vCenterWorld[0];
-	    float offsetZ = worldPos[2] - m_vCenterWorld[2];
-	    
-	    // Apply rotation (negated to match texture rotation direction)
+	    if (m_fViewKeyZoom == m_fZoom && m_fViewKeyRotation == m_fRotation && m_vViewKeyCenter == m_vCenterWorld
+	        && m_fViewKeyWidth == m_fCanvasWidth && m_fViewKeyHeight == m_fCanvasHeight)
+	        return;
+
+	    m_vViewKeyCenter = m_vCenterWorld;
+	    m_fViewKeyZoom = m_fZoom;
+	    m_fViewKeyRotation = m_fRotation;
+	    m_fViewKeyWidth = m_fCanvasWidth;
+	    m_fViewKeyHeight = m_fCanvasHeight;
+
 	    float rotRad = -m_fRotation * Math.DEG2RAD;
 	    float cosR = Math.Cos(rotRad);
 	    float sinR = Math.Sin(rotRad);
-	    
-	    float rotatedX = offsetX * cosR - offsetZ * sinR;
-	    float rotatedZ = offsetX * sinR + offsetZ * cosR;
-	    
+
 	    // Use aspect-corrected view size (same as DrawMapTexture)
-	    float viewWorldSizeX = m_fMapSizeX * m_fZoom;
-	    
-	    // Scale to screen based on zoom and view width (SCREEN PIXELS)
-	    float pixelsPerWorldUnit = m_fCanvasWidth / viewWorldSizeX;
-	    
-	    // Convert to screen coords (center of canvas is center of view)
-	    screenX = (m_fCanvasWidth * 0.5) + (rotatedX * pixelsPerWorldUnit);
-	    // Flip Y for screen coordinates
-	    screenY = (m_fCanvasHeight * 0.5) - (rotatedZ * pixelsPerWorldUnit);
+	    float pixelsPerWorldUnit = m_fCanvasWidth / (m_fMapSizeX * m_fZoom);
+	    float centerX = m_vCenterWorld[0];
+	    float centerZ = m_vCenterWorld[2];
+
+	    // screenX = W/2 + ((x - cx) cos - (z - cz) sin) * ppu
+	    m_fViewXX = cosR * pixelsPerWorldUnit;
+	    m_fViewXZ = -sinR * pixelsPerWorldUnit;
+	    m_fViewX0 = m_fCanvasWidth * 0.5 - (m_fViewXX * centerX + m_fViewXZ * centerZ);
+	    // screenY = H/2 - ((x - cx) sin + (z - cz) cos) * ppu   (Y flip)
+	    m_fViewYX = -sinR * pixelsPerWorldUnit;
+	    m_fViewYZ = -cosR * pixelsPerWorldUnit;
+	    m_fViewY0 = m_fCanvasHeight * 0.5 - (m_fViewYX * centerX + m_fViewYZ * centerZ);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	// World position to screen position (SCREEN PIXELS for canvas drawing)
+	void WorldToScreen(vector worldPos, out float screenX, out float screenY)
+	{
+	    UpdateViewTransform();
+	    screenX = m_fViewXX * worldPos[0] + m_fViewXZ * worldPos[2] + m_fViewX0;
+	    screenY = m_fViewYX * worldPos[0] + m_fViewYZ * worldPos[2] + m_fViewY0;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! WorldToScreen for a bare XZ pair, without the vector temporary or the staleness
+	//! check — only valid inside Draw(), which brings the transform up to date first.
+	protected void ProjectXZ(float worldX, float worldZ, out float screenX, out float screenY)
+	{
+	    screenX = m_fViewXX * worldX + m_fViewXZ * worldZ + m_fViewX0;
+	    screenY = m_fViewYX * worldX + m_fViewYZ * worldZ + m_fViewY0;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Project a flat [x0, z0, x1, z1, ...] world array (the AG0_TDLTerrainRoadFeature /
+	//! AG0_TDLMapShape vertex layout) into [sx0, sy0, sx1, sy1, ...] screen coordinates.
+	//! outScreen is resized to match and can be reused across calls.
+	void TransformPoints(array<float> worldXZ, notnull array<float> outScreen)
+	{
+	    UpdateViewTransform();
+
+	    int count = worldXZ.Count() & ~1;
+	    outScreen.Resize(count);
+
+	    float xx = m_fViewXX;
+	    float xz = m_fViewXZ;
+	    float x0 = m_fViewX0;
+	    float yx = m_fViewYX;
+	    float yz = m_fViewYZ;
+	    float y0 = m_fViewY0;
+	    for (int i = 0; i < count; i += 2)
+	    {
+	        float wx = worldXZ[i];
+	        float wz = worldXZ[i + 1];
+	        outScreen[i] = xx * wx + xz * wz + x0;
+	        outScreen[i + 1] = yx * wx + yz * wz + y0;
+	    }
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! TransformPoints for a unit-radius outline (AG0_TDLMapShape.GetUnitOutline) placed at a
+	//! world center with a world radius — scale, translate and project in one pass.
+	void TransformUnitPoints(array<float> unitXZ, float centerX, float centerZ, float radius, notnull array<float> outScreen)
+	{
+	    UpdateViewTransform();
+
+	    int count = unitXZ.Count() & ~1;
+	    outScreen.Resize(count);
+
+	    float originX, originY;
+	    ProjectXZ(centerX, centerZ, originX, originY);
+	    float xx = m_fViewXX * radius;
+	    float xz = m_fViewXZ * radius;
+	    float yx = m_fViewYX * radius;
+	    float yz = m_fViewYZ * radius;
+	    for (int i = 0; i < count; i += 2)
+	    {
+	        float ux = unitXZ[i];
+	        float uz = unitXZ[i + 1];
+	        outScreen[i] = originX + xx * ux + xz * uz;
+	        outScreen[i + 1] = originY + yx * ux + yz * uz;
+	    }
 	}
 	
 	//------------------------------------------------------------------------------------------------
@@ -488,26 +635,60 @@ class AG0_TDLMapView
 	//------------------------------------------------------------------------------------------------
 	//! Set shapes to render from the shape manager
 	//! Call each frame or when shapes update — the array is read during Draw()
-	void SetShapes(array<ref AG0_TDLMapShape> shapes)
+	//! @param index Manager's GetShapeIndex() over the same array; null → every shape is tested
+	//! @param revision Manager's GetRevision(); the cached shape layer is kept while it
+	//!        and the array are unchanged. -1 = unknown, rebuild every frame.
+	void SetShapes(array<ref AG0_TDLMapShape> shapes, AG0_TDLMapShapeIndex index = null, int revision = -1)
 	{
+		if (revision < 0 || revision != m_iShapesRevision || shapes != m_aShapes || index != m_ShapeIndex)
+			InvalidateLayer(LAYER_SHAPES);
+
 		m_aShapes = shapes;
+		m_ShapeIndex = index;
+		m_iShapesRevision = revision;
 	}
 
 	//------------------------------------------------------------------------------------------------
 	//! Set terrain structure records to render. Pass null or an empty array
 	//! when no API dataset is available (no buildings will draw on the map view).
 	//! The array is read during Draw(); call each frame from the controller.
-	void SetTerrainStructures(array<ref AG0_TDLTerrainStructureRecord> structures)
+	//! @param grid Optional spatial index over structures (manager's GetGrid()); with it
+	//!        Draw() only visits grid cells under the viewport.
+	//! @param revision Manager's GetRevision(), as for SetShapes
+	void SetTerrainStructures(array<ref AG0_TDLTerrainStructureRecord> structures, AG0_TDLTerrainStructureGrid grid = null, int revision = -1)
 	{
+		if (revision < 0 || revision != m_iStructuresRevision || structures != m_aTerrainStructures || grid != m_TerrainStructureGrid)
+		{
+			InvalidateLayer(LAYER_TERRAIN);
+			m_TerrainTiles.Clear();
+		}
+
 		m_aTerrainStructures = structures;
+		m_TerrainStructureGrid = grid;
+		m_iStructuresRevision = revision;
 	}
 
 	//------------------------------------------------------------------------------------------------
 	//! Set terrain road features to render. Pass null/empty for no roads.
 	//! Read during Draw(); refreshed each frame from the controller.
-	void SetTerrainRoads(array<ref AG0_TDLTerrainRoadFeature> roads)
+	//! @param revision Manager's GetRevision(), as for SetShapes
+	void SetTerrainRoads(array<ref AG0_TDLTerrainRoadFeature> roads, int revision = -1)
 	{
+		if (revision < 0 || revision != m_iRoadsRevision || roads != m_aTerrainRoads)
+		{
+			InvalidateLayer(LAYER_TERRAIN);
+			m_TerrainTiles.Clear();
+		}
+
 		m_aTerrainRoads = roads;
+		m_iRoadsRevision = revision;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Force a layer to be regenerated on the next Draw()
+	protected void InvalidateLayer(int layerIndex)
+	{
+		m_aLayers[layerIndex].m_bValid = false;
 	}
     
     //------------------------------------------------------------------------------------------------
@@ -537,6 +718,12 @@ class AG0_TDLMapView
     //------------------------------------------------------------------------------------------------
     // RENDERING
     //------------------------------------------------------------------------------------------------
+    //! Retained mode: each layer keeps the commands it generated and is only rebuilt
+    //! when its data changed (setters invalidate it) or the zoom, rotation or canvas
+    //! size moved past a tolerance. A pure pan shifts the cached commands in screen
+    //! space instead; pannable layers are culled LAYER_PAN_MARGIN_PX past the canvas
+    //! so content panned in is already there, and rebuild once a pan exceeds that.
+    //! The layer commands are re-concatenated into m_aDrawCommands every frame.
     void Draw()
     {
         if (!m_wCanvas)
@@ -549,51 +736,138 @@ class AG0_TDLMapView
 	    if (m_fCanvasHeight <= 0 || m_fCanvasWidth <= 0)
 	        return;
 
+        // View is fixed for the rest of the frame; ProjectXZ relies on this
+        UpdateViewTransform();
+
         // Clear previous commands
         m_aDrawCommands.Clear();
-        
-        // Draw map background
-        if (m_bTextureLoaded && m_pMapTexture)
-            DrawMapTexture();
-        else
-            DrawFallbackBackground();
-        
-        // Draw overlay layers (structures, roads, water, contours)
-        DrawOverlays();
-
-        // Mask the 8 ghost tiles produced by the texture sampler's Repeat mode
-        // when the view extends past the map's world extent. Runs AFTER the
-        // satellite + overlay draws (both use the same unclamped UV math and
-        // therefore both tile), and BEFORE buildings/shapes/markers so on-map
-        // content is not occluded. No-op when we have no satellite loaded
-        // (DrawFallbackBackground already fills the whole canvas in that case).
-        if (m_bTextureLoaded && m_pMapTexture)
-            DrawMapEdgeMask();
-
-        // Roads first so they sit under buildings (real-world layering).
-        DrawApiTerrainRoads();
-
-        // Building draw priority:
-        //   1. Baked structure overlay texture (set in MapSatelliteConfig) — drawn above
-        //   2. API-streamed terrain structures (from /api/mod/terrain/structures)
-        // The legacy runtime MapDescriptorComponent query has been removed; the
-        // API path is authoritative and the per-frame entity query was both more
-        // expensive and less accurate (and shared the rotation bug fixed below).
-        if (!m_bHasStructureOverlay)
-            DrawApiTerrainStructures();
-        
-		//Draw grid (over buildings)
-		DrawGrid();
-		
-		//Draw TDL shapes
-		DrawShapes();
+
+        for (int layerIndex = 0; layerIndex < LAYER_COUNT; layerIndex++)
+        {
+            AG0_TDLMapLayer layer = m_aLayers[layerIndex];
+            if (!ReuseLayer(layer, layerIndex != LAYER_BACKGROUND))
+                BuildLayer(layer, layerIndex);
+
+            foreach (CanvasWidgetCommand cmd : layer.m_aCommands)
+                m_aDrawCommands.Insert(cmd);
+        }
 		
-        // Draw markers (on top)
+        // Draw markers (on top) — fed fresh every frame, so never cached
         DrawMarkers();
         
         // Submit draw commands
         m_wCanvas.SetDrawCommands(m_aDrawCommands);
     }
+
+    //------------------------------------------------------------------------------------------------
+    //! Regenerate a layer's commands for the current view
+    protected void BuildLayer(AG0_TDLMapLayer layer, int layerIndex)
+    {
+        // Draw helpers all emit into m_aDrawCommands — point it at the layer while building
+        array<ref CanvasWidgetCommand> frameCommands = m_aDrawCommands;
+        m_aDrawCommands = layer.m_aCommands;
+        m_aDrawCommands.Clear();
+        if (layerIndex != LAYER_BACKGROUND)
+            m_fCullMarginPx = LAYER_PAN_MARGIN_PX;
+
+        switch (layerIndex)
+        {
+            case LAYER_BACKGROUND:
+            {
+                // Draw map background
+                if (m_bTextureLoaded && m_pMapTexture)
+                    DrawMapTexture();
+                else
+                    DrawFallbackBackground();
+
+                // Draw overlay layers (structures, roads, water, contours)
+                DrawOverlays();
+
+                // Mask the 8 ghost tiles produced by the texture sampler's Repeat mode
+                // when the view extends past the map's world extent. Runs AFTER the
+                // satellite + overlay draws (both use the same unclamped UV math and
+                // therefore both tile), and BEFORE buildings/shapes/markers so on-map
+                // content is not occluded. No-op when we have no satellite loaded
+                // (DrawFallbackBackground already fills the whole canvas in that case).
+                if (m_bTextureLoaded && m_pMapTexture)
+                    DrawMapEdgeMask();
+                break;
+            }
+
+            case LAYER_TERRAIN:
+            {
+                // Cached tiles cover the usual zoom range; outside it (or until the
+                // band in view is built), draw directly
+                if (DrawTerrainTiles())
+                    break;
+
+                // Roads first so they sit under buildings (real-world layering).
+                DrawApiTerrainRoads();
+
+                // Building draw priority:
+                //   1. Baked structure overlay texture (set in MapSatelliteConfig) — drawn above
+                //   2. API-streamed terrain structures (from /api/mod/terrain/structures)
+                // The legacy runtime MapDescriptorComponent query has been removed; the
+                // API path is authoritative and the per-frame entity query was both more
+                // expensive and less accurate (and shared the rotation bug fixed below).
+                if (!m_bHasStructureOverlay)
+                    DrawApiTerrainStructures();
+                break;
+            }
+
+            case LAYER_GRID:
+            {
+                // Draw grid (over buildings)
+                DrawGrid();
+                break;
+            }
+
+            case LAYER_SHAPES:
+            {
+                // Draw TDL shapes
+                DrawShapes();
+                break;
+            }
+        }
+
+        m_fCullMarginPx = 0;
+        m_aDrawCommands = frameCommands;
+        layer.Capture(m_vCenterWorld, m_fZoom, m_fRotation, m_fCanvasWidth, m_fCanvasHeight);
+
+        // Drawn directly while the cached band is still being built — rebuild next frame
+        if (layerIndex == LAYER_TERRAIN && m_bTerrainTilesPending)
+            layer.m_bValid = false;
+    }
+
+    //------------------------------------------------------------------------------------------------
+    //! Bring a cached layer up to date without regenerating it, if the view allows.
+    //! @param pannable Layer was built with the pan margin and may be shifted
+    //! @return false if the layer must be rebuilt
+    protected bool ReuseLayer(AG0_TDLMapLayer layer, bool pannable)
+    {
+        if (!layer.m_bValid || layer.m_fCanvasWidth != m_fCanvasWidth || layer.m_fCanvasHeight != m_fCanvasHeight)
+            return false;
+        if (Math.AbsFloat(layer.m_fZoom - m_fZoom) > m_fZoom * LAYER_ZOOM_TOLERANCE)
+            return false;
+        if (Math.AbsFloat(layer.m_fRotation - m_fRotation) > LAYER_ROTATION_TOLERANCE)
+            return false;
+
+        // Where the layer's build center lands now, relative to the canvas center
+        float centerX, centerY;
+        WorldToScreen(layer.m_vCenterWorld, centerX, centerY);
+        float offsetX = centerX - m_fCanvasWidth * 0.5;
+        float offsetY = centerY - m_fCanvasHeight * 0.5;
+
+        float limit = LAYER_PAN_TOLERANCE_PX;
+        if (pannable)
+            limit = LAYER_PAN_MARGIN_PX;
+        if (Math.AbsFloat(offsetX) > limit || Math.AbsFloat(offsetY) > limit)
+            return false;
+
+        if (pannable)
+            layer.ShiftTo(offsetX, offsetY, LAYER_PAN_TOLERANCE_PX);
+        return true;
+    }
     
     //------------------------------------------------------------------------------------------------
     protected void DrawMapTexture()
@@ -814,9 +1088,11 @@ class AG0_TDLMapView
 	//! Draw road network from /api/mod/terrain/roads.
 	//!
 	//! Each AG0_TDLTerrainRoadFeature is a polyline rendered as a sequence of
-	//! LineDrawCommand segments. At each interior vertex we drop a small filled
-	//! circle ("round join") so consecutive segments meeting at an angle share
-	//! a continuous outline instead of leaving a gap on the outside of the bend.
+	//! segment quads. At each interior vertex we drop a small filled circle
+	//! ("round join") so consecutive segments meeting at an angle share a
+	//! continuous outline instead of leaving a gap on the outside of the bend.
+	//! Segments and joins go into m_MeshBatch, one TriMesh per road colour,
+	//! declared trail → highway so major roads draw on top.
 	//!
 	//! Performance:
 	//!   1. Per-frame: compute a world-space viewport AABB once.
@@ -825,12 +1101,18 @@ class AG0_TDLMapView
 	//!      features. Cheap test, high payoff for Eden-scale datasets.
 	//!   3. Per-segment: keep a screen-space reject for partially-on-screen roads
 	//!      so off-screen segments of long polylines still cost nothing.
+	//!
+	//! Level of detail: polylines come from the feature's simplified LOD band whose
+	//! error stays under ROAD_LOD_PIXEL_ERROR on screen, trails and paved roads are
+	//! hidden once their real width drops below TRAIL_MIN_WIDTH_PX / PAVED_MIN_WIDTH_PX,
+	//! and features spanning less than ROAD_MIN_EXTENT_PX are skipped.
 	protected void DrawApiTerrainRoads()
 	{
 	    if (!m_aTerrainRoads || m_aTerrainRoads.IsEmpty())
 	        return;
 
 	    float pixelsPerWorldUnit = m_fCanvasWidth / (m_fMapSizeX * m_fZoom);
+	    int lod = AG0_TDLTerrainRoadFeature.SelectLod(ROAD_LOD_PIXEL_ERROR / pixelsPerWorldUnit);
 
 	    // World-space viewport AABB (rotation-safe via the diagonal-sized square,
 	    // same trick DrawMapTexture uses for satellite UV sampling). Off-screen
@@ -841,18 +1123,27 @@ class AG0_TDLMapView
 	    float viewWorldSizeZ = viewWorldSizeX / canvasAspect;
 	    float diagonal = Math.Sqrt(viewWorldSizeX * viewWorldSizeX + viewWorldSizeZ * viewWorldSizeZ);
 	    const float ROAD_CULL_MARGIN = 50.0;
-	    float viewMinX = m_vCenterWorld[0] - diagonal * 0.5 - ROAD_CULL_MARGIN;
-	    float viewMaxX = m_vCenterWorld[0] + diagonal * 0.5 + ROAD_CULL_MARGIN;
-	    float viewMinZ = m_vCenterWorld[2] - diagonal * 0.5 - ROAD_CULL_MARGIN;
-	    float viewMaxZ = m_vCenterWorld[2] + diagonal * 0.5 + ROAD_CULL_MARGIN;
+	    float cullMargin = ROAD_CULL_MARGIN + m_fCullMarginPx / pixelsPerWorldUnit;
+	    float viewMinX = m_vCenterWorld[0] - diagonal * 0.5 - cullMargin;
+	    float viewMaxX = m_vCenterWorld[0] + diagonal * 0.5 + cullMargin;
+	    float viewMinZ = m_vCenterWorld[2] - diagonal * 0.5 - cullMargin;
+	    float viewMaxZ = m_vCenterWorld[2] + diagonal * 0.5 + cullMargin;
+	    // Screen-space reject bounds, widened by the layer pan margin
+	    float edgeMin = -20 - m_fCullMarginPx;
+	    float edgeMaxX = m_fCanvasWidth + 20 + m_fCullMarginPx;
+	    float edgeMaxY = m_fCanvasHeight + 20 + m_fCullMarginPx;
+
+	    m_MeshBatch.Begin(m_aDrawCommands);
+	    m_MeshBatch.DeclareColor(ROAD_TRAIL_COLOR);
+	    m_MeshBatch.DeclareColor(ROAD_PAVED_COLOR);
+	    m_MeshBatch.DeclareColor(ROAD_HIGHWAY_COLOR);
 
 	    foreach (AG0_TDLTerrainRoadFeature road : m_aTerrainRoads)
 	    {
 	        if (!road)
 	            continue;
 
-	        int rawCount = road.m_aPoints.Count();
-	        if (rawCount < 4)
+	        if (road.m_aPoints.Count() < 4)
 	            continue; // need at least 2 points (4 floats)
 
 	        // World-space AABB-vs-viewport reject. Skips the whole feature
@@ -861,38 +1152,17 @@ class AG0_TDLMapView
 	            road.m_fMaxZ < viewMinZ || road.m_fMinZ > viewMaxZ)
 	            continue;
 
-	        // Style by priority: 3=highway thickest/lightest, 1=trail thinnest/dimmest.
-	        // Stroke is the road's actual width in world meters scaled to screen,
-	        // floored so it stays readable when zoomed out.
-	        float baseWidthPx = road.m_fWidth * pixelsPerWorldUnit;
-	        float minStroke;
+	        // LOD reject: stubs that would collapse to a dot, minor classes too thin to read
 	        int color;
-	        switch (road.m_iPriority)
-	        {
-	            case 3:
-	                minStroke = 2.5;
-	                color = 0xFFE8C57A; // warm tan — highways
-	                break;
-	            case 2:
-	                minStroke = 1.8;
-	                color = 0xFFC9B98A; // muted sand — paved/road
-	                break;
-	            default:
-	                minStroke = 1.2;
-	                color = 0xFF9C8964; // dim olive — trails
-	                break;
-	        }
-	        float stroke = Math.Max(baseWidthPx, minStroke);
+	        float stroke;
+	        if (!GetRoadStyle(road, pixelsPerWorldUnit, color, stroke))
+	            continue;
+
+	        array<float> points = road.GetLodPoints(lod);
+	        int rawCount = points.Count();
 
-	        // Round-join radius — half the stroke width covers the gap on the
-	        // outside of the bend exactly. Skip drawing joins below 1 px since
-	        // they'd add nothing visible at high-zoom-out levels.
 	        float joinRadius = stroke * 0.5;
-	        bool drawJoins = (joinRadius >= 1.0);
-	        // Adaptive segment count — small circles get fewer triangles.
-	        int joinSegments = 6;
-	        if (joinRadius >= 4.0) joinSegments = 10;
-	        if (joinRadius >= 8.0) joinSegments = 14;
+	        int joinSegments = GetRoadJoinSegments(stroke);
 
 	        // Walk the polyline. Skip segments fully off-canvas, and emit a join
 	        // circle at each interior vertex whose surrounding segments were
@@ -901,43 +1171,34 @@ class AG0_TDLMapView
 	        bool havePrev = false;
 	        bool prevSegmentDrawn = false;
 
+	        // Project the whole polyline in one pass
+	        TransformPoints(points, m_aScreenScratch);
 	        for (int i = 0; i + 1 < rawCount; i += 2)
 	        {
-	            float sx, sy;
-	            WorldToScreen(Vector(road.m_aPoints[i], 0, road.m_aPoints[i + 1]), sx, sy);
+	            float sx = m_aScreenScratch[i];
+	            float sy = m_aScreenScratch[i + 1];
 
 	            if (havePrev)
 	            {
 	                // Per-segment screen-space reject (handles long polylines
 	                // partially on-screen).
-	                bool offLeft   = (prevSX < -20 && sx < -20);
-	                bool offRight  = (prevSX > m_fCanvasWidth + 20 && sx > m_fCanvasWidth + 20);
-	                bool offTop    = (prevSY < -20 && sy < -20);
-	                bool offBottom = (prevSY > m_fCanvasHeight + 20 && sy > m_fCanvasHeight + 20);
+	                bool offLeft   = (prevSX < edgeMin && sx < edgeMin);
+	                bool offRight  = (prevSX > edgeMaxX && sx > edgeMaxX);
+	                bool offTop    = (prevSY < edgeMin && sy < edgeMin);
+	                bool offBottom = (prevSY > edgeMaxY && sy > edgeMaxY);
 
 	                bool segVisible = !(offLeft || offRight || offTop || offBottom);
 
 	                if (segVisible)
 	                {
-	                    LineDrawCommand line = new LineDrawCommand();
-	                    line.m_iColor = color;
-	                    line.m_fWidth = stroke;
-	                    line.m_Vertices = {prevSX, prevSY, sx, sy};
-	                    m_aDrawCommands.Insert(line);
+	                    m_MeshBatch.AddLine(color, prevSX, prevSY, sx, sy, stroke);
 
 	                    // Round-join at the SHARED vertex between this segment
 	                    // and the previous one (i.e. at prevSX/prevSY), but only
 	                    // if there actually was a previous segment drawn — no
 	                    // join at the very first endpoint of the polyline.
-	                    if (drawJoins && prevSegmentDrawn)
-	                    {
-	                        array<float> joinVerts = {};
-	                        TessellateCircle(prevSX, prevSY, joinRadius, joinSegments, joinVerts);
-	                        PolygonDrawCommand join = new PolygonDrawCommand();
-	                        join.m_iColor = color;
-	                        join.m_Vertices = joinVerts;
-	                        m_aDrawCommands.Insert(join);
-	                    }
+	                    if (joinSegments > 0 && prevSegmentDrawn)
+	                        m_MeshBatch.AddDisc(color, prevSX, prevSY, joinRadius, joinSegments);
 	                }
 
 	                prevSegmentDrawn = segVisible;
@@ -948,6 +1209,64 @@ class AG0_TDLMapView
 	            havePrev = true;
 	        }
 	    }
+
+	    m_MeshBatch.End();
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Colour and on-screen stroke width of a road at the given scale.
+	//! Style by priority: 3=highway thickest/lightest, 1=trail thinnest/dimmest.
+	//! Stroke is the road's actual width in world meters scaled to screen,
+	//! floored so it stays readable when zoomed out.
+	//! @return false if the road is not drawn at this scale (a stub that would collapse
+	//! to a dot, or a minor class too thin to read)
+	protected bool GetRoadStyle(AG0_TDLTerrainRoadFeature road, float pixelsPerWorldUnit, out int color, out float strokePx)
+	{
+	    float minExtentWorld = ROAD_MIN_EXTENT_PX / pixelsPerWorldUnit;
+	    if (road.m_fMaxX - road.m_fMinX < minExtentWorld && road.m_fMaxZ - road.m_fMinZ < minExtentWorld)
+	        return false;
+
+	    float baseWidthPx = road.m_fWidth * pixelsPerWorldUnit;
+	    if (road.m_iPriority <= 1 && baseWidthPx < TRAIL_MIN_WIDTH_PX)
+	        return false;
+	    if (road.m_iPriority == 2 && baseWidthPx < PAVED_MIN_WIDTH_PX)
+	        return false;
+
+	    float minStroke;
+	    switch (road.m_iPriority)
+	    {
+	        case 3:
+	            minStroke = 2.5;
+	            color = ROAD_HIGHWAY_COLOR;
+	            break;
+	        case 2:
+	            minStroke = 1.8;
+	            color = ROAD_PAVED_COLOR;
+	            break;
+	        default:
+	            minStroke = 1.2;
+	            color = ROAD_TRAIL_COLOR;
+	            break;
+	    }
+	    strokePx = Math.Max(baseWidthPx, minStroke);
+	    return true;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Triangle count of the round joins for a road stroke, 0 for no joins.
+	//! Join radius is half the stroke width, which covers the gap on the outside
+	//! of the bend exactly. Below 1 px radius joins would add nothing visible at
+	//! high-zoom-out levels; small circles get fewer triangles.
+	protected int GetRoadJoinSegments(float strokePx)
+	{
+	    float joinRadius = strokePx * 0.5;
+	    if (joinRadius < 1.0)
+	        return 0;
+	    if (joinRadius >= 8.0)
+	        return 14;
+	    if (joinRadius >= 4.0)
+	        return 10;
+	    return 6;
 	}
 
 	//------------------------------------------------------------------------------------------------
@@ -966,8 +1285,13 @@ class AG0_TDLMapView
 	//! legacy runtime building path also suffered from.
 	//!
 	//! Cull aggressively — Everon-scale datasets can be many thousands of buildings
-	//! and we redraw every frame. World-space AABB reject before WorldToScreen
-	//! avoids the sin/cos for any building outside the viewport.
+	//! and we redraw every frame. With a structure grid only the cells under the
+	//! viewport are visited; within them a world-space AABB reject before
+	//! WorldToScreen still avoids the sin/cos for any building off-screen.
+	//!
+	//! Level of detail: below BUILDING_AGGREGATE_PPU a typical building is a pixel
+	//! or two, so the grid's density cells are drawn instead — one shaded square per
+	//! occupied cell, darker where footprint coverage is higher.
 	protected void DrawApiTerrainStructures()
 	{
 	    if (!m_aTerrainStructures || m_aTerrainStructures.IsEmpty())
@@ -985,85 +1309,559 @@ class AG0_TDLMapView
 	    float viewWorldSizeZ = viewWorldSizeX / canvasAspect;
 	    float diagonal = Math.Sqrt(viewWorldSizeX * viewWorldSizeX + viewWorldSizeZ * viewWorldSizeZ);
 	    const float STRUCT_CULL_MARGIN = 50.0;
-	    float viewMinX = m_vCenterWorld[0] - diagonal * 0.5 - STRUCT_CULL_MARGIN;
-	    float viewMaxX = m_vCenterWorld[0] + diagonal * 0.5 + STRUCT_CULL_MARGIN;
-	    float viewMinZ = m_vCenterWorld[2] - diagonal * 0.5 - STRUCT_CULL_MARGIN;
-	    float viewMaxZ = m_vCenterWorld[2] + diagonal * 0.5 + STRUCT_CULL_MARGIN;
+	    float cullMargin = STRUCT_CULL_MARGIN + m_fCullMarginPx / pixelsPerWorldUnit;
+	    float viewMinX = m_vCenterWorld[0] - diagonal * 0.5 - cullMargin;
+	    float viewMaxX = m_vCenterWorld[0] + diagonal * 0.5 + cullMargin;
+	    float viewMinZ = m_vCenterWorld[2] - diagonal * 0.5 - cullMargin;
+	    float viewMaxZ = m_vCenterWorld[2] + diagonal * 0.5 + cullMargin;
+
+	    // One TriMesh bucket for all outlines, one for all fills (declared so fills draw on top)
+	    m_MeshBatch.Begin(m_aDrawCommands);
+	    m_MeshBatch.DeclareColor(BUILDING_OUTLINE_COLOR);
+	    m_MeshBatch.DeclareColor(m_iBuildingColor);
+
+	    if (m_TerrainStructureGrid)
+	    {
+	        int col0, row0, col1, row1;
+	        if (m_TerrainStructureGrid.GetCellRange(viewMinX, viewMinZ, viewMaxX, viewMaxZ, col0, row0, col1, row1))
+	        {
+	            if (pixelsPerWorldUnit < BUILDING_AGGREGATE_PPU)
+	            {
+	                DrawApiTerrainStructureDensity(col0, row0, col1, row1, pixelsPerWorldUnit, mapRotRad);
+	            }
+	            else
+	            {
+	                int count = m_aTerrainStructures.Count();
+	                for (int row = row0; row <= row1; row = row + 1)
+	                {
+	                    // Columns col0..col1 of one row are a contiguous slot range
+	                    int slotEnd = m_TerrainStructureGrid.GetCellStart(col1 + 1, row);
+	                    for (int slot = m_TerrainStructureGrid.GetCellStart(col0, row); slot < slotEnd; slot = slot + 1)
+	                    {
+	                        int idx = m_TerrainStructureGrid.GetCellRecord(slot);
+	                        if (idx < count)
+	                            DrawApiTerrainStructure(m_aTerrainStructures[idx], viewMinX, viewMinZ, viewMaxX, viewMaxZ, pixelsPerWorldUnit, mapRotRad);
+	                    }
+	                }
+	            }
+	        }
+	    }
+	    else
+	    {
+	        foreach (AG0_TDLTerrainStructureRecord rec : m_aTerrainStructures)
+	        {
+	            DrawApiTerrainStructure(rec, viewMinX, viewMinZ, viewMaxX, viewMaxZ, pixelsPerWorldUnit, mapRotRad);
+	        }
+	    }
+
+	    m_MeshBatch.End();
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Zoomed-out building layer: the grid's density cells in the given cell range
+	protected void DrawApiTerrainStructureDensity(int col0, int row0, int col1, int row1, float pixelsPerWorldUnit, float mapRotRad)
+	{
+	    float cellSize = m_TerrainStructureGrid.GetDensityCellSize();
+	    float half = cellSize * 0.5;
+	    float halfPx = half * pixelsPerWorldUnit;
+
+	    // Cells are world-axis-aligned, so only the map rotation applies (see
+	    // DrawApiTerrainStructures for the sign); corner offsets are shared by all cells.
+	    float cosR = Math.Cos(-mapRotRad);
+	    float sinR = Math.Sin(-mapRotRad);
+	    float p = halfPx * (cosR + sinR);
+	    float q = halfPx * (cosR - sinR);
+
+	    for (int row = row0; row <= row1; row = row + 1)
+	    {
+	        int end = m_TerrainStructureGrid.GetDensityStart(col1 + 1, row);
+	        for (int i = m_TerrainStructureGrid.GetDensityStart(col0, row); i < end; i = i + 1)
+	        {
+	            float minX, minZ, coverage;
+	            m_TerrainStructureGrid.GetDensityCell(i, minX, minZ, coverage);
+
+	            float centerX, centerY;
+	            ProjectXZ(minX + half, minZ + half, centerX, centerY);
+	            float reach = halfPx * 1.5 + m_fCullMarginPx;
+	            if (centerX + reach < 0 || centerX - reach > m_fCanvasWidth ||
+	                centerY + reach < 0 || centerY - reach > m_fCanvasHeight)
+	                continue;
+
+	            // Corners (-h,-h), (h,-h), (h,h), (-h,h) rotated, Y-flipped
+	            m_MeshBatch.AddQuad(GetDensityColor(coverage),
+	                centerX - q, centerY + p,
+	                centerX + p, centerY + q,
+	                centerX + q, centerY - p,
+	                centerX - p, centerY - q);
+	        }
+	    }
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Building colour for a density cell of the given footprint coverage (0..1).
+	//! Town blocks reach ~25% coverage; scale so they read as solid.
+	//! Alpha is quantized to 16 levels so cells share a few TriMesh buckets.
+	protected int GetDensityColor(float coverage)
+	{
+	    int level = Math.Round(Math.Min(coverage * 4, 1) * 15);
+	    int alpha = BUILDING_DENSITY_MIN_ALPHA + (0xFF - BUILDING_DENSITY_MIN_ALPHA) * level / 15;
+	    return (alpha << 24) | (m_iBuildingColor & 0x00FFFFFF);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! One building footprint for DrawApiTerrainStructures (outline + fill, culled to the view AABB)
+	protected void DrawApiTerrainStructure(AG0_TDLTerrainStructureRecord rec, float viewMinX, float viewMinZ, float viewMaxX, float viewMaxZ, float pixelsPerWorldUnit, float mapRotRad)
+	{
+	    if (!rec)
+	        return;
+
+	    // World-space cull. Half-extent bound = (w + d) * 0.5 is a tiny bit
+	    // larger than the true half-diagonal sqrt(w² + d²)/2 (since
+	    // (w+d)² >= w² + d²) and avoids a per-feature sqrt.
+	    float halfBound = (rec.m_fWidth + rec.m_fDepth) * 0.5;
+	    if (rec.m_fCenterX + halfBound < viewMinX ||
+	        rec.m_fCenterX - halfBound > viewMaxX ||
+	        rec.m_fCenterZ + halfBound < viewMinZ ||
+	        rec.m_fCenterZ - halfBound > viewMaxZ)
+	        return;
+
+	    // World center → screen (handles map rotation, zoom, and Y-flip for position)
+	    float centerX, centerY;
+	    ProjectXZ(rec.m_fCenterX, rec.m_fCenterZ, centerX, centerY);
+
+	    // Half-extents in screen pixels (API delivers full width/depth).
+	    float halfW = rec.m_fWidth * 0.5 * pixelsPerWorldUnit;
+	    float halfL = rec.m_fDepth * 0.5 * pixelsPerWorldUnit;
+
+	    // Skip sub-pixel buildings — keeps the canvas readable when zoomed out.
+	    if (halfW < 1 && halfL < 1)
+	        return;
+
+	    // Total rotation: see DrawApiTerrainStructures for the negation rationale.
+	    // Building rotation is world-CCW; map rotation is also world-CCW (track
+	    // mode rotates the world frame). Combine then negate to take both into
+	    // the Y-flipped screen frame in one step.
+	    float totalRot = -(rec.m_fRotation + mapRotRad);
+	    float cosR = Math.Cos(totalRot);
+	    float sinR = Math.Sin(totalRot);
+
+	    // Outline (slightly expanded) first, fill on top — separate buckets, see m_MeshBatch setup
+	    AddOrientedRect(BUILDING_OUTLINE_COLOR, centerX, centerY, halfW + BUILDING_OUTLINE_PX, halfL + BUILDING_OUTLINE_PX, cosR, sinR);
+	    AddOrientedRect(m_iBuildingColor, centerX, centerY, halfW, halfL, cosR, sinR);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Rectangle of half-extents (halfW, halfL) rotated by (cosR, sinR) around a screen point,
+	//! into m_MeshBatch. Corners (-w,-l), (w,-l), (w,l), (-w,l); Y-flipped at output.
+	protected void AddOrientedRect(int color, float centerX, float centerY, float halfW, float halfL, float cosR, float sinR)
+	{
+	    // Rotated local axes, scaled by the half-extents
+	    float ax = halfW * cosR;
+	    float ay = halfW * sinR;
+	    float bx = -halfL * sinR;
+	    float by = halfL * cosR;
+
+	    m_MeshBatch.AddQuad(color,
+	        centerX - ax - bx, centerY + ay + by,
+	        centerX + ax - bx, centerY - ay + by,
+	        centerX + ax + bx, centerY - ay - by,
+	        centerX - ax + bx, centerY + ay - by);
+	}
+
+	// -----------------------------------------------------------------------
+	// TERRAIN TILE CACHE
+	// -----------------------------------------------------------------------
+
+	//------------------------------------------------------------------------------------------------
+	//! Terrain layer from m_TerrainTiles: re-project the visible tiles of the current
+	//! zoom band. Same output as DrawApiTerrainRoads + DrawApiTerrainStructures, but
+	//! styled for the band's middle scale instead of the exact one (see AG0_TDLMapTileCache.c).
+	//! A new band is binned, and its tiles tessellated as they come into view, under
+	//! TERRAIN_TILE_BUDGET_MS per frame; until the view is covered the caller draws directly.
+	//! @return false when the caller must draw directly (outside the banded range, or not ready)
+	protected bool DrawTerrainTiles()
+	{
+	    m_bTerrainTilesPending = false;
+
+	    bool hasRoads = m_aTerrainRoads && !m_aTerrainRoads.IsEmpty();
+	    bool hasStructures = !m_bHasStructureOverlay && m_aTerrainStructures && !m_aTerrainStructures.IsEmpty();
+	    if (!hasRoads && !hasStructures)
+	        return true;
+
+	    float pixelsPerWorldUnit = m_fCanvasWidth / (m_fMapSizeX * m_fZoom);
+	    int bandIndex = AG0_TDLMapTerrainTileCache.SelectBand(pixelsPerWorldUnit);
+	    if (bandIndex < 0)
+	        return false;
 
-	    foreach (AG0_TDLTerrainStructureRecord rec : m_aTerrainStructures)
+	    AG0_TDLMapTerrainBand band = m_TerrainTiles.Find(bandIndex);
+	    if (!band)
 	    {
+	        band = CreateTerrainBand(bandIndex);
+	        m_TerrainTiles.Store(band);
+	    }
+
+	    int startTick = System.GetTickCount();
+	    if (!band.m_bBinned && !StepBinTerrainBand(band, startTick))
+	    {
+	        m_bTerrainTilesPending = true;
+	        return false;
+	    }
+
+	    // Viewport AABB as in DrawApiTerrainRoads; the band widens it by its own reach
+	    float canvasAspect = m_fCanvasWidth / m_fCanvasHeight;
+	    float viewWorldSizeX = m_fMapSizeX * m_fZoom;
+	    float viewWorldSizeZ = viewWorldSizeX / canvasAspect;
+	    float halfDiagonal = Math.Sqrt(viewWorldSizeX * viewWorldSizeX + viewWorldSizeZ * viewWorldSizeZ) * 0.5;
+	    float cullMargin = m_fCullMarginPx / pixelsPerWorldUnit;
+	    float reach = halfDiagonal + cullMargin;
+
+	    int col0, row0, col1, row1;
+	    band.GetTileRange(m_vCenterWorld[0] - reach, m_vCenterWorld[2] - reach,
+	        m_vCenterWorld[0] + reach, m_vCenterWorld[2] + reach, col0, row0, col1, row1);
+
+	    // Tessellate tiles seen for the first time; stop at the budget and finish next frame
+	    int row, col;
+	    AG0_TDLMapTerrainTile tile;
+	    for (row = row0; row <= row1; row++)
+	    {
+	        for (col = col0; col <= col1; col++)
+	        {
+	            tile = band.GetTile(col, row);
+	            if (!tile || tile.m_bTessellated)
+	                continue;
+
+	            if (System.GetTickCount() - startTick >= TERRAIN_TILE_BUDGET_MS)
+	            {
+	                m_bTerrainTilesPending = true;
+	                return false;
+	            }
+	            TessellateTerrainTile(band, tile, col, row);
+	        }
+	    }
+
+	    // All roads before any buildings, so a road stroke overhanging from a neighbouring
+	    // tile can't cover a building
+	    for (int pass = 0; pass < 2; pass++)
+	    {
+	        for (row = row0; row <= row1; row++)
+	        {
+	            for (col = col0; col <= col1; col++)
+	            {
+	                tile = band.GetTile(col, row);
+	                if (!tile)
+	                    continue;
+
+	                array<ref CanvasWidgetCommand> meshes = tile.m_aRoadMeshes;
+	                if (pass == 1)
+	                    meshes = tile.m_aBuildingMeshes;
+
+	                foreach (CanvasWidgetCommand mesh : meshes)
+	                    EmitTileMesh(TriMeshDrawCommand.Cast(mesh));
+	            }
+	        }
+	    }
+	    return true;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Screen-space copy of a world-space tile mesh
+	protected void EmitTileMesh(TriMeshDrawCommand template)
+	{
+	    if (!template)
+	        return;
+
+	    TriMeshDrawCommand cmd = new TriMeshDrawCommand();
+	    cmd.m_iColor = template.m_iColor;
+	    // Indices don't depend on the view and are never modified — share the template's
+	    cmd.m_Indices = template.m_Indices;
+	    cmd.m_Vertices = new array<float>();
+	    TransformPoints(template.m_Vertices, cmd.m_Vertices);
+	    m_aDrawCommands.Insert(cmd);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Empty band with its styling inputs; StepBinTerrainBand fills it
+	protected AG0_TDLMapTerrainBand CreateTerrainBand(int bandIndex)
+	{
+	    float minPixelsPerWorldUnit = AG0_TDLMapTerrainTileCache.GetBandMinPixelsPerMeter(bandIndex);
+	    float tileSize = AG0_TDLMapTerrainTileCache.TILE_PIXELS / minPixelsPerWorldUnit;
+	    AG0_TDLMapTerrainBand band = new AG0_TDLMapTerrainBand(bandIndex, m_fMapOffsetX, m_fMapOffsetY, m_fMapSizeX, m_fMapSizeY, tileSize);
+
+	    band.m_fPixelsPerMeter = AG0_TDLMapTerrainTileCache.GetBandPixelsPerMeter(bandIndex);
+	    // Simplify for the top of the band so the error stays under ROAD_LOD_PIXEL_ERROR throughout
+	    band.m_iRoadLod = AG0_TDLTerrainRoadFeature.SelectLod(ROAD_LOD_PIXEL_ERROR / (minPixelsPerWorldUnit * 2));
+	    // Band edges line up with BUILDING_AGGREGATE_PPU, so a band is all-density or all-footprint
+	    band.m_bDensity = minPixelsPerWorldUnit < BUILDING_AGGREGATE_PPU;
+	    return band;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Continue binning roads, then structures, into the band's tiles until the frame budget runs out
+	//! @param startTick System.GetTickCount() at the start of this frame's terrain work
+	//! @return true once the band is fully binned
+	protected bool StepBinTerrainBand(AG0_TDLMapTerrainBand band, int startTick)
+	{
+	    if (m_aTerrainRoads)
+	    {
+	        int roadCount = m_aTerrainRoads.Count();
+	        while (band.m_iNextRoad < roadCount)
+	        {
+	            if (System.GetTickCount() - startTick >= TERRAIN_TILE_BUDGET_MS)
+	                return false;
+
+	            BinTerrainRoad(band, band.m_iNextRoad);
+	            band.m_iNextRoad = band.m_iNextRoad + 1;
+	        }
+	    }
+
+	    if (!m_bHasStructureOverlay && !StepBinTerrainStructures(band, startTick))
+	        return false;
+
+	    band.m_bBinned = true;
+	    Print(string.Format("[TDLMapView] Terrain band %1 binned (%2 tile slots)", band.m_iBand, band.GetTileCount()), LogLevel.DEBUG);
+	    return true;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! List every drawn segment of one road in each tile it crosses
+	protected void BinTerrainRoad(AG0_TDLMapTerrainBand band, int roadIndex)
+	{
+	    AG0_TDLTerrainRoadFeature road = m_aTerrainRoads[roadIndex];
+	    if (!road || road.m_aPoints.Count() < 4)
+	        return;
+
+	    int color;
+	    float stroke;
+	    if (!GetRoadStyle(road, band.m_fPixelsPerMeter, color, stroke))
+	        return;
+
+	    // Segments are clipped to their tiles, so only the stroke overhangs
+	    band.ExtendReach(stroke * 0.5 / band.m_fPixelsPerMeter);
+
+	    array<float> points = road.GetLodPoints(band.m_iRoadLod);
+	    int last = points.Count() - 2;
+	    for (int i = 0; i < last; i += 2)
+	        band.AddSegmentRefs(roadIndex, i, points[i], points[i + 1], points[i + 2], points[i + 3]);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Continue assigning buildings (or, zoomed out, the grid's density cells) to the tile
+	//! holding their center
+	//! @return true once all are assigned
+	protected bool StepBinTerrainStructures(AG0_TDLMapTerrainBand band, int startTick)
+	{
+	    if (!m_aTerrainStructures)
+	        return true;
+
+	    AG0_TDLMapTerrainTile tile;
+	    int idx;
+	    if (band.m_bDensity && m_TerrainStructureGrid)
+	    {
+	        float half = m_TerrainStructureGrid.GetDensityCellSize() * 0.5;
+	        int densityCount = m_TerrainStructureGrid.GetDensityCount();
+	        for (idx = band.m_iNextStructure; idx < densityCount; idx++)
+	        {
+	            if (idx % TERRAIN_BIN_CHECK_INTERVAL == 0 && System.GetTickCount() - startTick >= TERRAIN_TILE_BUDGET_MS)
+	            {
+	                band.m_iNextStructure = idx;
+	                return false;
+	            }
+
+	            float minX, minZ, coverage;
+	            m_TerrainStructureGrid.GetDensityCell(idx, minX, minZ, coverage);
+	            tile = band.GetOrCreateTile(band.GetTileIndex(minX + half, minZ + half));
+	            if (!tile.m_aDensityRefs)
+	                tile.m_aDensityRefs = {};
+	            tile.m_aDensityRefs.Insert(idx);
+	        }
+	        band.m_iNextStructure = densityCount;
+	        band.ExtendReach(half * 1.41421356); // √2
+	        return true;
+	    }
+
+	    float pixelsPerWorldUnit = band.m_fPixelsPerMeter;
+	    float outlineWorld = BUILDING_OUTLINE_PX / pixelsPerWorldUnit;
+	    int count = m_aTerrainStructures.Count();
+	    for (idx = band.m_iNextStructure; idx < count; idx++)
+	    {
+	        if (idx % TERRAIN_BIN_CHECK_INTERVAL == 0 && System.GetTickCount() - startTick >= TERRAIN_TILE_BUDGET_MS)
+	        {
+	            band.m_iNextStructure = idx;
+	            return false;
+	        }
+
+	        AG0_TDLTerrainStructureRecord rec = m_aTerrainStructures[idx];
 	        if (!rec)
 	            continue;
 
-	        // World-space cull. Half-extent bound = (w + d) * 0.5 is a tiny bit
-	        // larger than the true half-diagonal sqrt(w² + d²)/2 (since
-	        // (w+d)² >= w² + d²) and avoids a per-feature sqrt.
-	        float halfBound = (rec.m_fWidth + rec.m_fDepth) * 0.5;
-	        if (rec.m_fCenterX + halfBound < viewMinX ||
-	            rec.m_fCenterX - halfBound > viewMaxX ||
-	            rec.m_fCenterZ + halfBound < viewMinZ ||
-	            rec.m_fCenterZ - halfBound > viewMaxZ)
+	        // Sub-pixel buildings are skipped, as in DrawApiTerrainStructure
+	        if (rec.m_fWidth * 0.5 * pixelsPerWorldUnit < 1 && rec.m_fDepth * 0.5 * pixelsPerWorldUnit < 1)
 	            continue;
 
-	        // World center → screen (handles map rotation, zoom, and Y-flip for position)
-	        vector worldCenter = Vector(rec.m_fCenterX, 0, rec.m_fCenterZ);
-	        float centerX, centerY;
-	        WorldToScreen(worldCenter, centerX, centerY);
+	        tile = band.GetOrCreateTile(band.GetTileIndex(rec.m_fCenterX, rec.m_fCenterZ));
+	        if (!tile.m_aStructureRefs)
+	            tile.m_aStructureRefs = {};
+	        tile.m_aStructureRefs.Insert(idx);
+	        band.ExtendReach((rec.m_fWidth + rec.m_fDepth) * 0.5 + outlineWorld);
+	    }
+	    band.m_iNextStructure = count;
+	    return true;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Build a tile's world-space meshes from its refs, then drop the refs
+	protected void TessellateTerrainTile(AG0_TDLMapTerrainBand band, AG0_TDLMapTerrainTile tile, int col, int row)
+	{
+	    TessellateTileRoads(band, tile, col, row);
+	    TessellateTileStructures(tile, band.m_fPixelsPerMeter);
+	    tile.ReleaseRefs();
+	    tile.m_bTessellated = true;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! World-space road meshes of one tile (segments + round joins, colours as in DrawApiTerrainRoads).
+	//! Each segment is clipped to the tile, so a segment crossing several tiles is drawn as
+	//! abutting pieces; a join is drawn by the tile holding its vertex.
+	//! @return Number of meshes added
+	protected int TessellateTileRoads(AG0_TDLMapTerrainBand band, AG0_TDLMapTerrainTile tile, int col, int row)
+	{
+	    if (!tile.m_aRoadRefs)
+	        return 0;
+
+	    float minX, minZ, maxX, maxZ;
+	    band.GetTileBounds(col, row, minX, minZ, maxX, maxZ);
+	    int tileIndex = row * band.GetColumnCount() + col;
+	    float pixelsPerWorldUnit = band.m_fPixelsPerMeter;
+
+	    m_MeshBatch.Begin(tile.m_aRoadMeshes);
+	    m_MeshBatch.DeclareColor(ROAD_TRAIL_COLOR);
+	    m_MeshBatch.DeclareColor(ROAD_PAVED_COLOR);
+	    m_MeshBatch.DeclareColor(ROAD_HIGHWAY_COLOR);
 
-	        // Half-extents in screen pixels (API delivers full width/depth).
-	        float halfW = rec.m_fWidth * 0.5 * pixelsPerWorldUnit;
-	        float halfL = rec.m_fDepth * 0.5 * pixelsPerWorldUnit;
+	    int refCount = tile.m_aRoadRefs.Count();
+	    for (int k = 0; k + 1 < refCount; k += 2)
+	    {
+	        AG0_TDLTerrainRoadFeature road = m_aTerrainRoads[tile.m_aRoadRefs[k]];
+	        int i = tile.m_aRoadRefs[k + 1];
+
+	        int color;
+	        float stroke;
+	        GetRoadStyle(road, pixelsPerWorldUnit, color, stroke);
+	        float strokeWorld = stroke / pixelsPerWorldUnit;
 
-	        // Skip sub-pixel buildings — keeps the canvas readable when zoomed out.
-	        if (halfW < 1 && halfL < 1)
+	        array<float> points = road.GetLodPoints(band.m_iRoadLod);
+	        float ax = points[i];
+	        float az = points[i + 1];
+	        float dx = points[i + 2] - ax;
+	        float dz = points[i + 3] - az;
+
+	        // Liang–Barsky: parameter range of the segment inside the tile
+	        float t0 = 0;
+	        float t1 = 1;
+	        if (!ClipSegmentParam(-dx, ax - minX, t0, t1) || !ClipSegmentParam(dx, maxX - ax, t0, t1)
+	            || !ClipSegmentParam(-dz, az - minZ, t0, t1) || !ClipSegmentParam(dz, maxZ - az, t0, t1))
 	            continue;
 
-	        // Total rotation: see comment above for the negation rationale.
-	        // Building rotation is world-CCW; map rotation is also world-CCW (track
-	        // mode rotates the world frame). Combine then negate to take both into
-	        // the Y-flipped screen frame in one step.
-	        float totalRot = -(rec.m_fRotation + mapRotRad);
-	        float cosR = Math.Cos(totalRot);
-	        float sinR = Math.Sin(totalRot);
-
-	        // Local corners (unrotated, screen-space sized)
-	        array<float> localX = {-halfW,  halfW, halfW, -halfW};
-	        array<float> localY = {-halfL, -halfL, halfL,  halfL};
-
-	        // Rotated fill verts. Y-flip at output to match screen coords.
-	        array<float> verts = {};
-	        for (int i = 0; i < 4; i = i + 1)
+	        m_MeshBatch.AddLine(color, ax + dx * t0, az + dz * t0, ax + dx * t1, az + dz * t1, strokeWorld);
+
+	        // Round join where the previous segment ends
+	        int joinSegments = GetRoadJoinSegments(stroke);
+	        if (joinSegments > 0 && i > 0 && band.GetTileIndex(ax, az) == tileIndex)
+	            m_MeshBatch.AddDisc(color, ax, az, strokeWorld * 0.5, joinSegments);
+	    }
+
+	    return m_MeshBatch.End();
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! One Liang–Barsky boundary test: narrow [t0, t1] to where p·t <= q
+	//! @return false if nothing of the segment is left
+	protected static bool ClipSegmentParam(float p, float q, inout float t0, inout float t1)
+	{
+	    if (p == 0)
+	        return q >= 0;
+
+	    float t = q / p;
+	    if (p < 0)
+	    {
+	        if (t > t1)
+	            return false;
+	        if (t > t0)
+	            t0 = t;
+	    }
+	    else
+	    {
+	        if (t < t0)
+	            return false;
+	        if (t < t1)
+	            t1 = t;
+	    }
+	    return true;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! World-space building (or density cell) meshes of one tile
+	//! @return Number of meshes added
+	protected int TessellateTileStructures(AG0_TDLMapTerrainTile tile, float pixelsPerWorldUnit)
+	{
+	    if (!tile.m_aStructureRefs && !tile.m_aDensityRefs)
+	        return 0;
+
+	    m_MeshBatch.Begin(tile.m_aBuildingMeshes);
+	    m_MeshBatch.DeclareColor(BUILDING_OUTLINE_COLOR);
+	    m_MeshBatch.DeclareColor(m_iBuildingColor);
+
+	    if (tile.m_aStructureRefs)
+	    {
+	        float outlineWorld = BUILDING_OUTLINE_PX / pixelsPerWorldUnit;
+	        foreach (int idx : tile.m_aStructureRefs)
 	        {
-	            float rotX = localX[i] * cosR - localY[i] * sinR;
-	            float rotY = localX[i] * sinR + localY[i] * cosR;
-	            verts.Insert(centerX + rotX);
-	            verts.Insert(centerY - rotY);
-	        }
+	            AG0_TDLTerrainStructureRecord rec = m_aTerrainStructures[idx];
+	            float halfW = rec.m_fWidth * 0.5;
+	            float halfL = rec.m_fDepth * 0.5;
 
-	        // Outline polygon (slightly expanded)
-	        float outlineOffset = 1.5;
-	        array<float> outLocalX = {-halfW - outlineOffset,  halfW + outlineOffset, halfW + outlineOffset, -halfW - outlineOffset};
-	        array<float> outLocalY = {-halfL - outlineOffset, -halfL - outlineOffset, halfL + outlineOffset,  halfL + outlineOffset};
+	            // World frame, so only the building's own rotation (negated, see
+	            // DrawApiTerrainStructures); the view transform adds the map rotation.
+	            float cosR = Math.Cos(-rec.m_fRotation);
+	            float sinR = Math.Sin(-rec.m_fRotation);
+	            AddWorldOrientedRect(BUILDING_OUTLINE_COLOR, rec.m_fCenterX, rec.m_fCenterZ, halfW + outlineWorld, halfL + outlineWorld, cosR, sinR);
+	            AddWorldOrientedRect(m_iBuildingColor, rec.m_fCenterX, rec.m_fCenterZ, halfW, halfL, cosR, sinR);
+	        }
+	    }
 
-	        array<float> outlineVerts = {};
-	        for (int j = 0; j < 4; j = j + 1)
+	    if (tile.m_aDensityRefs)
+	    {
+	        float cellSize = m_TerrainStructureGrid.GetDensityCellSize();
+	        foreach (int cell : tile.m_aDensityRefs)
 	        {
-	            float rotX = outLocalX[j] * cosR - outLocalY[j] * sinR;
-	            float rotY = outLocalX[j] * sinR + outLocalY[j] * cosR;
-	            outlineVerts.Insert(centerX + rotX);
-	            outlineVerts.Insert(centerY - rotY);
+	            float minX, minZ, coverage;
+	            m_TerrainStructureGrid.GetDensityCell(cell, minX, minZ, coverage);
+	            m_MeshBatch.AddQuad(GetDensityColor(coverage),
+	                minX, minZ,
+	                minX + cellSize, minZ,
+	                minX + cellSize, minZ + cellSize,
+	                minX, minZ + cellSize);
 	        }
+	    }
 
-	        PolygonDrawCommand outline = new PolygonDrawCommand();
-	        outline.m_iColor = 0xFF000000;
-	        outline.m_Vertices = outlineVerts;
-	        m_aDrawCommands.Insert(outline);
+	    return m_MeshBatch.End();
+	}
 
-	        PolygonDrawCommand fill = new PolygonDrawCommand();
-	        fill.m_iColor = m_iBuildingColor;
-	        fill.m_Vertices = verts;
-	        m_aDrawCommands.Insert(fill);
-	    }
+	//------------------------------------------------------------------------------------------------
+	//! AddOrientedRect in world X/Z (no Y flip) for tile templates.
+	//! Corners (-w,-l), (w,-l), (w,l), (-w,l) land on the same screen corners once projected.
+	protected void AddWorldOrientedRect(int color, float centerX, float centerZ, float halfW, float halfL, float cosR, float sinR)
+	{
+	    float ax = halfW * cosR;
+	    float az = halfW * sinR;
+	    float bx = -halfL * sinR;
+	    float bz = halfL * cosR;
+
+	    m_MeshBatch.AddQuad(color,
+	        centerX - ax - bx, centerZ - az - bz,
+	        centerX + ax - bx, centerZ + az - bz,
+	        centerX + ax + bx, centerZ + az + bz,
+	        centerX - ax + bx, centerZ - az + bz);
 	}
 
 	// -----------------------------------------------------------------------
@@ -1096,6 +1894,9 @@ class AG0_TDLMapView
 	// -----------------------------------------------------------------------
 	
 	//------------------------------------------------------------------------------------------------
+	//! Viewport culling uses each shape's cached world AABB against the rotation-safe view
+	//! square (as in DrawApiTerrainRoads); with a shape index only the shapes listed in
+	//! cells under the view are tested at all.
 	protected void DrawShapes()
 	{
 		if (!m_aShapes || m_aShapes.IsEmpty())
@@ -1103,20 +1904,45 @@ class AG0_TDLMapView
 		
 		float pixelsPerWorldUnit = m_fCanvasWidth / (m_fMapSizeX * m_fZoom);
 		
-		foreach (AG0_TDLMapShape shape : m_aShapes)
+		// World-space view square, widened by 20 px for strokes / labels and the layer pan margin
+		float canvasAspect = m_fCanvasWidth / m_fCanvasHeight;
+		float viewWorldSizeX = m_fMapSizeX * m_fZoom;
+		float viewWorldSizeZ = viewWorldSizeX / canvasAspect;
+		float reach = Math.Sqrt(viewWorldSizeX * viewWorldSizeX + viewWorldSizeZ * viewWorldSizeZ) * 0.5
+			+ (20 + m_fCullMarginPx) / pixelsPerWorldUnit;
+		float viewMinX = m_vCenterWorld[0] - reach;
+		float viewMaxX = m_vCenterWorld[0] + reach;
+		float viewMinZ = m_vCenterWorld[2] - reach;
+		float viewMaxZ = m_vCenterWorld[2] + reach;
+		
+		int candidateCount = m_aShapes.Count();
+		if (m_ShapeIndex)
 		{
-			// Viewport culling — skip shapes entirely off-screen
-			float screenX, screenY;
-			WorldToScreen(shape.m_vCenter, screenX, screenY);
-			
-			float boundingScreenR = shape.GetBoundingRadius() * pixelsPerWorldUnit;
-			float margin = boundingScreenR + 20;
+			m_ShapeIndex.Query(viewMinX, viewMinZ, viewMaxX, viewMaxZ, m_aShapeQuery);
+			candidateCount = m_aShapeQuery.Count();
+		}
+		
+		int shapeCount = m_aShapes.Count();
+		for (int c = 0; c < candidateCount; c++)
+		{
+			int shapeIdx = c;
+			if (m_ShapeIndex)
+				shapeIdx = m_aShapeQuery[c];
+			if (shapeIdx >= shapeCount)
+				continue;
 			
-			if (screenX + margin < 0 || screenX - margin > m_fCanvasWidth)
+			AG0_TDLMapShape shape = m_aShapes[shapeIdx];
+			if (!shape)
 				continue;
-			if (screenY + margin < 0 || screenY - margin > m_fCanvasHeight)
+			
+			// Viewport culling — skip shapes entirely off-screen
+			if (shape.m_fMaxX < viewMinX || shape.m_fMinX > viewMaxX ||
+				shape.m_fMaxZ < viewMinZ || shape.m_fMinZ > viewMaxZ)
 				continue;
 			
+			float screenX, screenY;
+			ProjectXZ(shape.m_vCenter[0], shape.m_vCenter[2], screenX, screenY);
+			
 			switch (shape.m_eShapeType)
 			{
 				case AG0_ETDLShapeType.CIRCLE:
@@ -1155,10 +1981,10 @@ class AG0_TDLMapView
 		if (screenRadius < 1)
 			return;
 		
+		// Cached unit circle for this LOD bucket, scaled and projected
 		int segments = GetAdaptiveSegments(screenRadius);
-		
 		array<float> verts = {};
-		TessellateCircle(cx, cy, screenRadius, segments, verts);
+		TransformUnitPoints(shape.GetUnitOutline(segments), shape.m_vCenter[0], shape.m_vCenter[2], shape.m_fRadius, verts);
 		
 		// Fill
 		if (shape.m_iFillColor != 0)
@@ -1189,39 +2015,10 @@ class AG0_TDLMapView
 		
 		int fullCircleSegs = GetAdaptiveSegments(screenRadius);
 		
-		// Convert bearings (0=North, CW) to screen angles.
-		// Screen coords: +X=right, +Y=down.
-		// Bearing 0 (N) → up on screen → angle -π/2 in standard math.
-		// Bearing 90 (E) → right → angle 0.
-		// Formula: screenAngle = (bearing - 90) degrees
-		// Map rotation shifts all bearings on screen.
-		float startDeg = shape.m_fStartAngle - 90.0 + m_fRotation;
-		float endDeg   = shape.m_fEndAngle   - 90.0 + m_fRotation;
-		
-		float startRad = startDeg * Math.DEG2RAD;
-		float endRad   = endDeg   * Math.DEG2RAD;
-		
-		// Sweep — always positive (CW in bearing = CW on screen with Y-down)
-		float sweep = endRad - startRad;
-		if (sweep <= 0)
-			sweep += Math.PI * 2;
-		
-		// Arc segment count proportional to sweep fraction of full circle
-		int arcSegs = Math.Ceil(sweep / (Math.PI * 2) * fullCircleSegs);
-		if (arcSegs < 4)  arcSegs = 4;
-		if (arcSegs > 128) arcSegs = 128;
-		
-		// Build vertex list: center → arc → (implicit close back to center)
+		// Vertex list: center → arc → (implicit close back to center), from the cached
+		// unit-space fan (bearings are world-fixed; the view transform applies map rotation)
 		array<float> verts = {};
-		verts.Insert(cx);
-		verts.Insert(cy);
-		
-		for (int i = 0; i <= arcSegs; i++)
-		{
-			float angle = startRad + sweep * i / arcSegs;
-			verts.Insert(cx + Math.Cos(angle) * screenRadius);
-			verts.Insert(cy + Math.Sin(angle) * screenRadius);
-		}
+		TransformUnitPoints(shape.GetUnitOutline(fullCircleSegs), shape.m_vCenter[0], shape.m_vCenter[2], shape.m_fRadius, verts);
 		
 		// Fill (PolygonDrawCommand auto-closes last vertex to first)
 		if (shape.m_iFillColor != 0)
@@ -1260,10 +2057,13 @@ class AG0_TDLMapView
 		// Label — positioned at visual center of the fan (half-radius along bisector)
 		if (!shape.m_sLabel.IsEmpty())
 		{
-			float midAngle = startRad + sweep * 0.5;
-			float labelDist = screenRadius * 0.5;
-			float labelX = cx + Math.Cos(midAngle) * labelDist;
-			float labelY = cy + Math.Sin(midAngle) * labelDist;
+			float sweep = shape.m_fEndAngle - shape.m_fStartAngle;
+			if (sweep <= 0)
+				sweep += 360;
+			float midBearing = (shape.m_fStartAngle + sweep * 0.5) * Math.DEG2RAD;
+			float labelDist = shape.m_fRadius * 0.5;
+			float labelX, labelY;
+			ProjectXZ(shape.m_vCenter[0] + Math.Sin(midBearing) * labelDist, shape.m_vCenter[2] + Math.Cos(midBearing) * labelDist, labelX, labelY);
 			DrawShapeLabel(shape, labelX, labelY);
 		}
 	}
@@ -1285,7 +2085,7 @@ class AG0_TDLMapView
 			int segments = GetAdaptiveSegments(screenR);
 			
 			array<float> verts = {};
-			TessellateCircle(cx, cy, screenR, segments, verts);
+			TransformUnitPoints(shape.GetUnitOutline(segments), shape.m_vCenter[0], shape.m_vCenter[2], ringRadius, verts);
 			
 			DrawClosedStroke(verts, shape.m_iStrokeColor, shape.m_fStrokeWidth);
 		}
@@ -1340,13 +2140,7 @@ class AG0_TDLMapView
 		
 		// Convert world vertices → screen
 		array<float> screenVerts = {};
-		for (int i = 0; i + 1 < rawCount; i += 2)
-		{
-			float sx, sy;
-			WorldToScreen(Vector(shape.m_aVertices[i], 0, shape.m_aVertices[i + 1]), sx, sy);
-			screenVerts.Insert(sx);
-			screenVerts.Insert(sy);
-		}
+		TransformPoints(shape.m_aVertices, screenVerts);
 		
 		// Fill (need 3+ vertices = 6+ floats for a meaningful polygon)
 		if (shape.m_iFillColor != 0 && screenVerts.Count() >= 6)
@@ -1379,13 +2173,7 @@ class AG0_TDLMapView
 		
 		// Convert world vertices → screen
 		array<float> screenVerts = {};
-		for (int i = 0; i + 1 < rawCount; i += 2)
-		{
-			float sx, sy;
-			WorldToScreen(Vector(shape.m_aVertices[i], 0, shape.m_aVertices[i + 1]), sx, sy);
-			screenVerts.Insert(sx);
-			screenVerts.Insert(sy);
-		}
+		TransformPoints(shape.m_aVertices, screenVerts);
 		
 		// Route line — open (not closed)
 		DrawOpenStroke(screenVerts, shape.m_iStrokeColor, shape.m_fStrokeWidth);
@@ -1612,11 +2400,15 @@ class AG0_TDLMapView
 	    float viewWorldSizeX = m_fMapSizeX * m_fZoom;
 	    float viewWorldSizeZ = viewWorldSizeX / canvasAspect;
 	    float diagonal = Math.Sqrt(viewWorldSizeX * viewWorldSizeX + viewWorldSizeZ * viewWorldSizeZ) * 0.5;
+	    diagonal += m_fCullMarginPx * viewWorldSizeX / m_fCanvasWidth;
 	    
 	    float minX = m_vCenterWorld[0] - diagonal;
 	    float maxX = m_vCenterWorld[0] + diagonal;
 	    float minZ = m_vCenterWorld[2] - diagonal;
 	    float maxZ = m_vCenterWorld[2] + diagonal;
+
+	    // All lines of a weight share one TriMesh; minor bucket first so major lines draw over it
+	    m_MeshBatch.Begin(m_aDrawCommands);
 	    
 	    // Minor lines (100m) - only draw when zoomed in enough to see them
 	    if (m_fZoom < 0.3)
@@ -1632,6 +2424,8 @@ class AG0_TDLMapView
 	    int majorColor = 0x60000000; // Semi-transparent black
 	    
 	    DrawGridLines(minX, maxX, minZ, maxZ, majorSpacing, majorColor, 2.0);
+
+	    m_MeshBatch.End();
 	}
 	
 	//------------------------------------------------------------------------------------------------
@@ -1645,28 +2439,18 @@ class AG0_TDLMapView
 	    for (float x = startX; x <= maxX; x += spacing)
 	    {
 	        float x0, y0, x1, y1;
-	        WorldToScreen(Vector(x, 0, minZ), x0, y0);
-	        WorldToScreen(Vector(x, 0, maxZ), x1, y1);
-	        
-	        LineDrawCommand line = new LineDrawCommand();
-	        line.m_iColor = color;
-	        line.m_fWidth = width;
-	        line.m_Vertices = {x0, y0, x1, y1};
-	        m_aDrawCommands.Insert(line);
+	        ProjectXZ(x, minZ, x0, y0);
+	        ProjectXZ(x, maxZ, x1, y1);
+	        m_MeshBatch.AddLine(color, x0, y0, x1, y1, width);
 	    }
 	    
 	    // Horizontal lines (constant Z, vary X)
 	    for (float z = startZ; z <= maxZ; z += spacing)
 	    {
 	        float x0, y0, x1, y1;
-	        WorldToScreen(Vector(minX, 0, z), x0, y0);
-	        WorldToScreen(Vector(maxX, 0, z), x1, y1);
-	        
-	        LineDrawCommand line = new LineDrawCommand();
-	        line.m_iColor = color;
-	        line.m_fWidth = width;
-	        line.m_Vertices = {x0, y0, x1, y1};
-	        m_aDrawCommands.Insert(line);
+	        ProjectXZ(minX, z, x0, y0);
+	        ProjectXZ(maxX, z, x1, y1);
+	        m_MeshBatch.AddLine(color, x0, y0, x1, y1, width);
 	    }
 	}
     
@@ -1739,7 +2523,10 @@ class AG0_TDLMapView
     void SetOverlayEnabled(int index, bool enabled)
     {
         if (index >= 0 && index < m_aOverlayEnabled.Count())
+        {
             m_aOverlayEnabled[index] = enabled;
+            InvalidateLayer(LAYER_BACKGROUND);
+        }
     }
     
     //------------------------------------------------------------------------------------------------
@@ -1754,6 +2541,7 @@ class AG0_TDLMapView
             if (layerName.Contains(name))
             {
                 m_aOverlayEnabled[i] = enabled;
+                InvalidateLayer(LAYER_BACKGROUND);
                 return;
             }
         }
@@ -1793,6 +2581,91 @@ class AG0_TDLMapView
     bool IsTextureLoaded() { return m_bTextureLoaded; }
 }
 
+//------------------------------------------------------------------------------------------------
+// Retained draw layer for AG0_TDLMapView: cached commands plus the view they were built for.
+// Commands must own their vertex arrays (no sharing), since ShiftTo moves them in place.
+//------------------------------------------------------------------------------------------------
+class AG0_TDLMapLayer
+{
+    ref array<ref CanvasWidgetCommand> m_aCommands = {};
+    bool m_bValid;
+
+    // View at build time
+    vector m_vCenterWorld;
+    float m_fZoom;
+    float m_fRotation;
+    float m_fCanvasWidth;
+    float m_fCanvasHeight;
+
+    // Screen-space shift currently applied to m_aCommands
+    float m_fOffsetX;
+    float m_fOffsetY;
+
+    //------------------------------------------------------------------------------------------------
+    void Capture(vector center, float zoom, float rotation, float canvasWidth, float canvasHeight)
+    {
+        m_vCenterWorld = center;
+        m_fZoom = zoom;
+        m_fRotation = rotation;
+        m_fCanvasWidth = canvasWidth;
+        m_fCanvasHeight = canvasHeight;
+        m_fOffsetX = 0;
+        m_fOffsetY = 0;
+        m_bValid = true;
+    }
+
+    //------------------------------------------------------------------------------------------------
+    //! Translate all commands so the total shift since Capture is (offsetX, offsetY)
+    void ShiftTo(float offsetX, float offsetY, float tolerance)
+    {
+        float dx = offsetX - m_fOffsetX;
+        float dy = offsetY - m_fOffsetY;
+        if (Math.AbsFloat(dx) <= tolerance && Math.AbsFloat(dy) <= tolerance)
+            return;
+
+        vector delta = Vector(dx, dy, 0);
+        foreach (CanvasWidgetCommand cmd : m_aCommands)
+        {
+            array<float> verts;
+            TriMeshDrawCommand mesh = TriMeshDrawCommand.Cast(cmd);
+            PolygonDrawCommand poly = PolygonDrawCommand.Cast(cmd);
+            if (mesh)
+            {
+                verts = mesh.m_Vertices;
+            }
+            else if (poly)
+            {
+                verts = poly.m_Vertices;
+            }
+            else
+            {
+                LineDrawCommand line = LineDrawCommand.Cast(cmd);
+                if (line)
+                {
+                    verts = line.m_Vertices;
+                }
+                else
+                {
+                    TextDrawCommand text = TextDrawCommand.Cast(cmd);
+                    if (text)
+                        text.m_Position = text.m_Position + delta;
+                    continue;
+                }
+            }
+
+            int count = verts.Count();
+            for (int i = 0; i + 1 < count; i += 2)
+            {
+                verts[i] = verts[i] + dx;
+                verts[i + 1] = verts[i + 1] + dy;
+            }
+        }
+
+        m_fOffsetX = offsetX;
+        m_fOffsetY = offsetY;
+    }
+}
+
 //------------------------------------------------------------------------------------------------
 // Marker data structure
 //------------------------------------------------------------------------------------------------